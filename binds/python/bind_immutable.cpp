@@ -185,7 +185,37 @@ void bind_mitochondria(py::module& m) {
                                DOC(morphio, Mitochondria, sections))
         .def_property_readonly("root_sections",
                                &morphio::Mitochondria::rootSections,
-                               DOC(morphio, Mitochondria, rootSections));
+                               DOC(morphio, Mitochondria, rootSections))
+        .def_property_readonly(
+            "neurite_section_ids",
+            [](const morphio::Mitochondria& mito) {
+                const auto& data = mito.neuriteSectionIds();
+                return py::array(static_cast<py::ssize_t>(data.size()), data.data());
+            },
+            "Returns the neurite section ids of all points, in section order")
+        .def_property_readonly(
+            "relative_path_lengths",
+            [](const morphio::Mitochondria& mito) {
+                const auto& data = mito.relativePathLengths();
+                return py::array(static_cast<py::ssize_t>(data.size()), data.data());
+            },
+            "Returns the relative path lengths of all points, in section order")
+        .def_property_readonly(
+            "diameters",
+            [](const morphio::Mitochondria& mito) {
+                const auto& data = mito.diameters();
+                return py::array(static_cast<py::ssize_t>(data.size()), data.data());
+            },
+            "Returns the diameters of all points, in section order")
+        .def_property_readonly(
+            "section_offsets",
+            [](const morphio::Mitochondria& mito) { return as_pyarray(mito.sectionOffsets()); },
+            "Returns the offset of the first point of each section, followed by the number of "
+            "points")
+        .def_property_readonly(
+            "section_parents",
+            [](const morphio::Mitochondria& mito) { return as_pyarray(mito.sectionParents()); },
+            "Returns the parent id of each section, -1 for root sections");
 }
 
 void bind_mitosection(py::module& m) {
@@ -18,6 +18,75 @@
 
 namespace py = pybind11;
 
+namespace {
+/** `(contents, extension)` pairs returned by Python, as `MorphologyBytes` */
+std::vector<morphio::MorphologyBytes> to_morphology_bytes(const py::handle& batch) {
+    std::vector<morphio::MorphologyBytes> result;
+    for (auto& bytes : batch.cast<std::vector<std::pair<std::string, std::string>>>()) {
+        result.push_back({std::move(bytes.first), std::move(bytes.second)});
+    }
+    return result;
+}
+
+/** Lets Python classes implement `morphio::ByteSource` */
+class PyByteSource: public morphio::ByteSource
+{
+  public:
+    morphio::MorphologyBytes get(const std::string& morph_name) const override {
+        py::gil_scoped_acquire gil;
+        py::function override = py::get_override(this, "get");
+        if (!override) {
+            throw morphio::MorphioError("ByteSource.get is not implemented.");
+        }
+        auto bytes = override(morph_name).cast<std::pair<std::string, std::string>>();
+        return {std::move(bytes.first), std::move(bytes.second)};
+    }
+
+    std::vector<morphio::MorphologyBytes> get_batch(
+        const std::vector<std::string>& morph_names) const override {
+        {
+            py::gil_scoped_acquire gil;
+            py::function override = py::get_override(this, "get_batch");
+            if (override) {
+                return to_morphology_bytes(override(morph_names));
+            }
+        }
+        return morphio::ByteSource::get_batch(morph_names);
+    }
+
+    std::future<std::vector<morphio::MorphologyBytes>> get_async(
+        std::vector<std::string> morph_names) const override {
+        {
+            py::gil_scoped_acquire gil;
+            py::function override = py::get_override(this, "get_async");
+            if (override) {
+                // The Python future may be released by a thread not holding the GIL
+                std::shared_ptr<py::object> pending(new py::object(override(morph_names)),
+                                                    [](py::object* object) {
+                                                        py::gil_scoped_acquire release_gil;
+                                                        delete object;
+                                                    });
+                return std::async(std::launch::deferred, [pending]() {
+                    py::gil_scoped_acquire result_gil;
+                    return to_morphology_bytes(pending->attr("result")());
+                });
+            }
+        }
+        return morphio::ByteSource::get_async(std::move(morph_names));
+    }
+
+    std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const override {
+        PYBIND11_OVERRIDE(std::vector<size_t>, morphio::ByteSource, argsort, morphology_names);
+    }
+};
+
+void check_cell_family(morphio::CellFamily cell_family, bool is_mutable) {
+    if (is_mutable && cell_family != morphio::CellFamily::NEURON) {
+        throw py::value_error("Glial cells and dendritic spines can't be loaded as mutable.");
+    }
+}
+}  // namespace
+
 void bind_misc(py::module& m) {
     using namespace py::literals;
 
@@ -166,8 +235,66 @@ void bind_misc(py::module& m) {
                       &morphio::Property::DendriticSpine::PostSynapticDensity::offset,
                       "Returns `offset` of post-synaptic density");
 
+    py::class_<morphio::ByteSource, PyByteSource, std::shared_ptr<morphio::ByteSource>>(
+        m,
+        "ByteSource",
+        R"(A storage from which a `Collection` reads its morphologies.
+
+Subclasses implement `get(morph_name)`, returning a `(contents, extension)`
+pair where `contents` are the bytes of the file and `extension` is one of
+"h5", "asc" or "swc". They may also implement:
+
+- `get_batch(morph_names)`, returning a list of such pairs, to read several
+  morphologies at once; the default calls `get` for every name,
+- `get_async(morph_names)`, returning a `concurrent.futures.Future` of what
+  `get_batch` returns, which `Collection.load_unordered` uses to read the
+  next batch while the current one is parsed; the default reads the batch
+  when it is needed,
+- `argsort(morphology_names)` to suggest an order for
+  `Collection.load_unordered`.)")
+        .def(py::init<>())
+        .def(
+            "get_batch",
+            [](const morphio::ByteSource& source, const std::vector<std::string>& morph_names) {
+                py::list batch;
+                for (auto& bytes : source.morphio::ByteSource::get_batch(morph_names)) {
+                    batch.append(py::make_tuple(py::bytes(bytes.contents), bytes.extension));
+                }
+                return batch;
+            },
+            "morph_names"_a)
+        .def("argsort", &morphio::ByteSource::argsort, "morphology_names"_a);
+
+    py::class_<morphio::AccessTrace, std::shared_ptr<morphio::AccessTrace>>(
+        m,
+        "AccessTrace",
+        R"(The names of the morphologies a `Collection` loaded, in order.
+
+See `Collection.record_accesses` and `reorder_container`.)")
+        .def(py::init<>())
+        .def("record", &morphio::AccessTrace::record, "morph_name"_a, "Append a name")
+        .def_property_readonly("names",
+                               &morphio::AccessTrace::names,
+                               "The names recorded so far")
+        .def("clear", &morphio::AccessTrace::clear, "Forget the names recorded so far")
+        .def(
+            "save",
+            [](const morphio::AccessTrace& trace, py::object path) { trace.save(py::str(path)); },
+            "path"_a,
+            "Write the names recorded so far, one per line")
+        .def_static(
+            "read",
+            [](py::object path) { return morphio::AccessTrace::read(py::str(path)); },
+            "path"_a,
+            "Read the names of a trace written by `save`");
+
     py::class_<morphio::Collection>(m, "Collection", "A collection of morphologies")
         .def(py::init<std::string>(), "collection_path"_a)
+        .def(py::init<std::shared_ptr<morphio::ByteSource>>(),
+             "source"_a,
+             // The Python half of `source` implements `get`, keep it alive
+             py::keep_alive<1, 2>(),
+             "Create a collection reading its morphologies from a `ByteSource`.")
         .def(py::init([](py::object arg) { return morphio::Collection(py::str(arg)); }),
              "collection_path"_a,
              "Create a collection from a Path-like object.")
@@ -183,8 +310,18 @@ void bind_misc(py::module& m) {
                const std::string& morph_name,
                unsigned int options,
                bool is_mutable,
-               std::shared_ptr<morphio::WarningHandler> warning_handler) -> py::object {
-                if (is_mutable) {
+               std::shared_ptr<morphio::WarningHandler> warning_handler,
+               morphio::CellFamily cell_family) -> py::object {
+                check_cell_family(cell_family, is_mutable);
+                if (cell_family == morphio::CellFamily::GLIA) {
+                    return py::cast(collection->load<morphio::GlialCell>(morph_name,
+                                                                         options,
+                                                                         warning_handler));
+                } else if (cell_family == morphio::CellFamily::SPINE) {
+                    return py::cast(collection->load<morphio::DendriticSpine>(morph_name,
+                                                                              options,
+                                                                              warning_handler));
+                } else if (is_mutable) {
                     return py::cast(collection->load<morphio::mut::Morphology>(morph_name,
                                                                                options,
                                                                                warning_handler));
@@ -198,15 +335,27 @@ void bind_misc(py::module& m) {
             "options"_a = morphio::enums::Option::NO_MODIFIER,
             "mutable"_a = false,
             "warning_handler"_a = std::shared_ptr<morphio::WarningHandler>(nullptr),
-            "Load the morphology named 'morph_name' form the collection.")
+            "cell_family"_a = morphio::CellFamily::NEURON,
+            R"(Load the morphology named 'morph_name' form the collection.
+
+With `cell_family` GLIA or SPINE, a `GlialCell` or a `DendriticSpine` is
+returned; these are only available as immutable morphologies.)")
         .def(
             "load_unordered",
             [](morphio::Collection* collection,
                std::vector<std::string> morphology_names,
                unsigned int options,
                bool is_mutable,
-               std::shared_ptr<morphio::WarningHandler> warning_handler) -> py::object {
-                if (is_mutable) {
+               std::shared_ptr<morphio::WarningHandler> warning_handler,
+               morphio::CellFamily cell_family) -> py::object {
+                check_cell_family(cell_family, is_mutable);
+                if (cell_family == morphio::CellFamily::GLIA) {
+                    return py::cast(collection->load_unordered<morphio::GlialCell>(
+                        morphology_names, options, warning_handler));
+                } else if (cell_family == morphio::CellFamily::SPINE) {
+                    return py::cast(collection->load_unordered<morphio::DendriticSpine>(
+                        morphology_names, options, warning_handler));
+                } else if (is_mutable) {
                     return py::cast(collection->load_unordered<morphio::mut::Morphology>(
                         morphology_names, options, warning_handler));
                 } else {
@@ -218,6 +367,7 @@ void bind_misc(py::module& m) {
             "options"_a = morphio::enums::Option::NO_MODIFIER,
             "mutable"_a = false,
             "warning_handler"_a = std::shared_ptr<morphio::WarningHandler>(nullptr),
+            "cell_family"_a = morphio::CellFamily::NEURON,
             R"(Create an iterable of loop index and morphology.
 
 When reading from containers, the order in which morphologies are read can
@@ -254,6 +404,15 @@ Note: This API is 'experimental', meaning it might change in the future.
 
 Note: This API is 'experimental', meaning it might change in the future.
 )")
+        .def("record_accesses",
+             &morphio::Collection::record_accesses,
+             "trace"_a,
+             R"(Record the names of the morphologies loaded from now on into `trace`.
+
+Pass `None` to stop recording.)")
+        .def_property_readonly("access_trace",
+                               &morphio::Collection::access_trace,
+                               "The AccessTrace the collection records into, or None")
         .def("__enter__", [](morphio::Collection* collection) { return collection; })
         .def("__exit__",
              [](morphio::Collection* collection,
@@ -284,4 +443,26 @@ Note: This API is 'experimental', meaning it might change in the future.
             // lifetime of the returned iterator (0).
             py::keep_alive<0, 1>());
 
+    py::class_<morphio::LoadUnordered<morphio::GlialCell>>(m,
+                                                           "LoadGlialCellUnordered",
+                                                           "An iterable of glial cells.")
+        .def(
+            "__iter__",
+            [](const morphio::LoadUnordered<morphio::GlialCell>& iterable) {
+                return py::make_iterator(iterable.begin(), iterable.end());
+            },
+            // Bind the lifetime of the `morphio::LoadUnordered` (1) to the
+            // lifetime of the returned iterator (0).
+            py::keep_alive<0, 1>());
+
+    py::class_<morphio::LoadUnordered<morphio::DendriticSpine>>(
+        m, "LoadDendriticSpineUnordered", "An iterable of dendritic spines.")
+        .def(
+            "__iter__",
+            [](const morphio::LoadUnordered<morphio::DendriticSpine>& iterable) {
+                return py::make_iterator(iterable.begin(), iterable.end());
+            },
+            // Bind the lifetime of the `morphio::LoadUnordered` (1) to the
+            // lifetime of the returned iterator (0).
+            py::keep_alive<0, 1>());
 }
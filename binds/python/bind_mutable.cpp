@@ -14,6 +14,8 @@
 #include <morphio/mut/glial_cell.h>
 #include <morphio/mut/mitochondria.h>
 #include <morphio/mut/morphology.h>
+#include <morphio/mut/stream_writer.h>
+#include <morphio/mut/write_queue.h>
 
 #include <memory>  // std::make_unique
 
@@ -32,6 +34,8 @@ void bind_mut_section(py::module& m);
 void bind_mut_soma(py::module& m);
 void bind_mut_endoplasmic_reticulum(py::module& m);
 void bind_mut_dendritic_spine(py::module& m);
+void bind_mut_stream_writer(py::module& m);
+void bind_mut_write_queue(py::module& m);
 
 void bind_mutable(py::module& m) {
     bind_mut_morphology(m);
@@ -42,6 +46,8 @@ void bind_mutable(py::module& m) {
     bind_mut_soma(m);
     bind_mut_endoplasmic_reticulum(m);
     bind_mut_dendritic_spine(m);
+    bind_mut_stream_writer(m);
+    bind_mut_write_queue(m);
 }
 
 void bind_mut_morphology(py::module& m) {
@@ -187,7 +193,16 @@ void bind_mut_mitochondria(py::module& m) {
                                &Mitochondria::rootSections,
                                D(rootSections),
                                py::return_value_policy::reference)
-        .def_property_readonly("sections", &Mitochondria::sections, D(sections))
+        .def_property_readonly(
+            "sections",
+            [](const Mitochondria& mitochondria) {
+                py::dict sections;
+                for (const auto& section : mitochondria.sections()) {
+                    sections[py::int_(section->id())] = section;
+                }
+                return sections;
+            },
+            D(sections))
         .def("is_root", &Mitochondria::isRoot, D(isRoot), "section_id"_a)
         .def("parent", &Mitochondria::parent, D(parent), "section_id"_a)
         .def("children", &Mitochondria::children, D(children), "section_id"_a)
@@ -212,6 +227,16 @@ void bind_mut_mitochondria(py::module& m) {
              D(appendRootSection_2),
              "section"_a,
              "recursive"_a = true)
+        .def("append_sections",
+             &Mitochondria::appendSections,
+             R"(Append all the sections of flat mitochondria data at once
+
+`sections` holds the (offset of the first point in `points`, parent index)
+pair of each section, as in the H5 'structure' dataset. The parent index
+refers to `sections` and is -1 for root sections. Returns the appended root
+sections.)",
+             "sections"_a,
+             "points"_a)
         .def(
             "depth_begin",
             [](Mitochondria* morph, std::shared_ptr<MitoSection> section) {
@@ -548,3 +573,91 @@ void bind_mut_dendritic_spine(py::module& m) {
             [](morphio::mut::DendriticSpine* morph, py::object arg) { morph->write(py::str(arg)); },
             "filename"_a);
 }
+
+void bind_mut_stream_writer(py::module& m) {
+    using morphio::mut::writer::StreamWriter;
+
+    py::class_<StreamWriter>(m,
+                             "StreamWriter",
+                             R"(Write a morphology section by section.
+
+Sections must be added in depth-first order: the parent of a new section is -1
+(a new neurite), the last added section or one of its ancestors. Only the path
+to the last section is kept in memory, except that SWC holds back the first
+child of a section until its sibling comes, and that H5 is written by finish().
+The output is the same as writing the equivalent mut.Morphology; the format is
+picked from the file extension.
+
+Used as a context manager, the file is finished when leaving the block.)")
+        .def(py::init([](py::object filename, morphio::CellFamily cell_family) {
+                 return std::unique_ptr<StreamWriter>(
+                     new StreamWriter(py::str(filename), nullptr, cell_family));
+             }),
+             "filename"_a,
+             "cell_family"_a = morphio::CellFamily::NEURON)
+        .def("begin_soma",
+             &StreamWriter::beginSoma,
+             "Set the soma, before adding any section",
+             "soma_type"_a,
+             "points"_a,
+             "diameters"_a)
+        .def("add_section",
+             &StreamWriter::addSection,
+             "Write a section and return its id; `parent` is -1 for root sections",
+             "section_type"_a,
+             "parent"_a,
+             "points"_a,
+             "diameters"_a,
+             "perimeters"_a = std::vector<morphio::floatType>())
+        .def("finish", &StreamWriter::finish, "Close the remaining sections and complete the file")
+        .def("__enter__", [](StreamWriter& writer) -> StreamWriter& { return writer; })
+        .def("__exit__",
+             [](StreamWriter& writer, py::object exc_type, py::object, py::object) {
+                 if (exc_type.is_none()) {
+                     writer.finish();
+                 }
+             });
+}
+
+void bind_mut_write_queue(py::module& m) {
+    using morphio::mut::WriteQueue;
+
+    py::class_<WriteQueue>(m,
+                           "WriteQueue",
+                           R"(Write morphologies on background threads.
+
+push() copies the morphology and returns as soon as the queue holds less than
+`capacity` morphologies. Errors are raised by flush(), as a WriterError listing
+the files that could not be written. Used as a context manager, the queue is
+flushed when leaving the block.)")
+        .def(py::init<unsigned int, size_t>(), "n_threads"_a = 1, "capacity"_a = 16)
+        .def(
+            "push",
+            [](WriteQueue& queue, const morphio::mut::Morphology& morphology, py::object filename) {
+                auto copy = std::make_unique<morphio::mut::Morphology>(morphology);
+                const std::string path = py::str(filename);
+                py::gil_scoped_release release;
+                queue.push(std::move(copy), path);
+            },
+            "morphology"_a,
+            "filename"_a,
+            "Queue a copy of the morphology to be written to filename")
+        .def(
+            "flush",
+            [](WriteQueue& queue) {
+                py::gil_scoped_release release;
+                queue.flush();
+            },
+            "Wait until every pushed morphology is written; raise WriterError on failures")
+        .def_property_readonly("pending",
+                               &WriteQueue::pending,
+                               "Number of morphologies queued or being written")
+        .def("__enter__", [](WriteQueue& queue) -> WriteQueue& { return queue; })
+        .def("__exit__",
+             [](WriteQueue& queue, py::object exc_type, py::object, py::object) {
+                 if (exc_type.is_none()) {
+                     py::gil_scoped_release release;
+                     queue.flush();
+                 }
+             });
+}
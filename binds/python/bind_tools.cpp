@@ -0,0 +1,1325 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "bind_tools.h"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <morphio/arrow.h>
+#include <morphio/bounding_volumes.h>
+#include <morphio/circuit.h>
+#include <morphio/clip.h>
+#include <morphio/clones.h>
+#include <morphio/collection.h>
+#include <morphio/compartments.h>
+#include <morphio/delta.h>
+#include <morphio/layout.h>
+#include <morphio/mesh.h>
+#include <morphio/morphology.h>
+#include <morphio/parallel.h>
+#include <morphio/section.h>
+#include <morphio/sidecar.h>
+#include <morphio/spines.h>
+#include <morphio/subtree.h>
+#include <morphio/tmd.h>
+#include <morphio/unravel.h>
+
+#include <stdexcept>  // std::invalid_argument
+
+#include "bindings_utils.h"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+namespace {
+
+void bind_tmd(py::module& m) {
+    py::enum_<morphio::tmd::Filtration>(m, "TMDFiltration", py::arithmetic())
+        .value("radial_distance",
+               morphio::tmd::Filtration::RADIAL_DISTANCE,
+               "Euclidean distance to the first point of the neurite")
+        .value("path_distance",
+               morphio::tmd::Filtration::PATH_DISTANCE,
+               "Path length along the neurite from its first point");
+
+    m.def(
+        "persistence_barcode",
+        [](const morphio::Morphology& morphology,
+           morphio::SectionType neurite_type,
+           morphio::tmd::Filtration filtration) {
+            return as_pyarray_of_arrays(
+                morphio::tmd::persistenceBarcode(morphology, neurite_type, filtration));
+        },
+        "morphology"_a,
+        "neurite_type"_a = morphio::SECTION_ALL,
+        "filtration"_a = morphio::tmd::RADIAL_DISTANCE,
+        R"(Return the TMD persistence barcode of the neurites of the given type.
+
+Returns a (N, 2) array of (birth, death) pairs, one per tip. The bars of all
+the matching neurites are concatenated, in root section order.)");
+
+    m.def(
+        "persistence_barcodes",
+        [](const morphio::Collection& collection,
+           const std::vector<std::string>& morphology_names,
+           morphio::SectionType neurite_type,
+           morphio::tmd::Filtration filtration,
+           unsigned int options,
+           unsigned int n_threads) {
+            std::vector<morphio::tmd::Barcode> barcodes;
+            {
+                py::gil_scoped_release release;
+                barcodes = morphio::tmd::persistenceBarcodes(
+                    collection, morphology_names, neurite_type, filtration, options, n_threads);
+            }
+            py::list result;
+            for (auto& barcode : barcodes) {
+                result.append(as_pyarray_of_arrays(std::move(barcode)));
+            }
+            return result;
+        },
+        "collection"_a,
+        "morphology_names"_a,
+        "neurite_type"_a = morphio::SECTION_ALL,
+        "filtration"_a = morphio::tmd::RADIAL_DISTANCE,
+        "options"_a = morphio::enums::Option::NO_MODIFIER,
+        "n_threads"_a = 0,
+        R"(Return the persistence barcodes of morphologies of a collection.
+
+Morphologies are loaded and processed in parallel using `n_threads` threads
+(0 means one per hardware thread). The barcodes are returned in the order of
+`morphology_names`.)");
+}
+
+py::array_t<morphio::floatType> bounding_box_array(const morphio::BoundingBox& box) {
+    const std::array<morphio::Point, 2> corners{box.min, box.max};
+    return py::array_t<morphio::floatType>({2, 3}, corners.data()->data());
+}
+
+void bind_bounding_volumes(py::module& m) {
+    using morphio::Bounds;
+    using morphio::BoundingVolumes;
+
+    py::class_<Bounds>(m, "Bounds", "Bounding volumes of a set of points")
+        .def_property_readonly(
+            "bounding_box",
+            [](const Bounds& bounds) { return bounding_box_array(bounds.boundingBox); },
+            "Axis aligned bounding box, as a (2, 3) array: [min, max]")
+        .def_property_readonly(
+            "oriented_center",
+            [](const Bounds& bounds) {
+                return py::array_t<morphio::floatType>(3,
+                                                       bounds.orientedBoundingBox.center.data());
+            },
+            "Center of the oriented bounding box")
+        .def_property_readonly(
+            "oriented_axes",
+            [](const Bounds& bounds) {
+                return py::array_t<morphio::floatType>(
+                    {3, 3}, bounds.orientedBoundingBox.axes.data()->data());
+            },
+            "Principal axes of the oriented bounding box, one per row, by decreasing variance")
+        .def_property_readonly(
+            "oriented_half_extents",
+            [](const Bounds& bounds) {
+                return py::array_t<morphio::floatType>(
+                    3, bounds.orientedBoundingBox.halfExtents.data());
+            },
+            "Half sizes of the oriented bounding box along its axes")
+        .def_property_readonly(
+            "oriented_volume",
+            [](const Bounds& bounds) { return bounds.orientedBoundingBox.volume(); },
+            "Volume of the oriented bounding box")
+        .def_property_readonly(
+            "hull_vertices",
+            [](const Bounds& bounds) {
+                const auto& vertices = bounds.convexHull.vertices;
+                return py::array_t<morphio::floatType>(
+                    {static_cast<py::ssize_t>(vertices.size()), py::ssize_t(3)},
+                    reinterpret_cast<const morphio::floatType*>(vertices.data()));
+            },
+            "Vertices of the convex hull")
+        .def_property_readonly(
+            "hull_volume",
+            [](const Bounds& bounds) { return bounds.convexHull.volume; },
+            "Volume of the convex hull")
+        .def_property_readonly(
+            "hull_area",
+            [](const Bounds& bounds) { return bounds.convexHull.area; },
+            "Surface area of the convex hull, a flat hull counts both of its sides");
+
+    py::class_<BoundingVolumes, std::shared_ptr<BoundingVolumes>>(
+        m,
+        "BoundingVolumes",
+        R"(Bounding volumes of the neurites of a morphology.
+
+Bounding boxes, PCA oriented bounding boxes and convex hulls are computed once
+per morphology, for each neurite, each neurite type and the whole morphology:
+constructing it again for the same morphology returns the cached volumes.
+The soma is not taken into account.)")
+        .def(py::init([](const morphio::Morphology& morphology, unsigned int n_threads) {
+                 py::gil_scoped_release release;
+                 // The bound API is read only
+                 return std::const_pointer_cast<BoundingVolumes>(
+                     BoundingVolumes::cached(morphology, n_threads));
+             }),
+             "morphology"_a,
+             "n_threads"_a = 0)
+        .def_property_readonly("morphology",
+                               &BoundingVolumes::morphology,
+                               "Volumes enclosing all the neurites",
+                               py::return_value_policy::reference_internal)
+        .def_property_readonly("neurites",
+                               &BoundingVolumes::neurites,
+                               "Volumes of each neurite, in root section order")
+        .def_property_readonly(
+            "neurite_types",
+            [](const BoundingVolumes& volumes) { return volumes.neuriteTypes(); },
+            "Type of each neurite, in root section order")
+        .def_property_readonly(
+            "neurite_bounding_boxes",
+            [](const BoundingVolumes& volumes) {
+                std::vector<std::array<morphio::Point, 2>> boxes;
+                for (const auto& bounds : volumes.neurites()) {
+                    boxes.push_back({bounds.boundingBox.min, bounds.boundingBox.max});
+                }
+                return py::array_t<morphio::floatType>(
+                    {static_cast<py::ssize_t>(boxes.size()), py::ssize_t(2), py::ssize_t(3)},
+                    reinterpret_cast<const morphio::floatType*>(boxes.data()));
+            },
+            "Bounding box of each neurite, as a (N, 2, 3) array")
+        .def_property_readonly(
+            "neurite_hull_volumes",
+            [](const BoundingVolumes& volumes) {
+                std::vector<morphio::floatType> result;
+                for (const auto& bounds : volumes.neurites()) {
+                    result.push_back(bounds.convexHull.volume);
+                }
+                return as_pyarray(std::move(result));
+            },
+            "Convex hull volume of each neurite")
+        .def_property_readonly(
+            "neurite_hull_areas",
+            [](const BoundingVolumes& volumes) {
+                std::vector<morphio::floatType> result;
+                for (const auto& bounds : volumes.neurites()) {
+                    result.push_back(bounds.convexHull.area);
+                }
+                return as_pyarray(std::move(result));
+            },
+            "Convex hull area of each neurite")
+        .def("neurite_type",
+             &BoundingVolumes::neuriteType,
+             "Volumes enclosing all the neurites of the given type",
+             "type"_a,
+             py::return_value_policy::reference_internal);
+}
+
+void bind_mesh(py::module& m) {
+    using morphio::mesh::Mesh;
+
+    py::enum_<morphio::mesh::Style>(m, "MeshStyle", py::arithmetic())
+        .value("tubes", morphio::mesh::TUBES, "One closed tube per section")
+        .value("frustums", morphio::mesh::FRUSTUMS, "One closed frustum per segment")
+        .value("capsules",
+               morphio::mesh::CAPSULES,
+               "One closed frustum capped by half spheres per segment");
+
+    py::class_<Mesh>(m, "Mesh", "Indexed triangle mesh of the neurites of a morphology")
+        .def_property_readonly(
+            "vertices",
+            [](const Mesh& mesh) {
+                return py::array_t<float>({static_cast<py::ssize_t>(mesh.vertices.size()),
+                                           py::ssize_t(3)},
+                                          reinterpret_cast<const float*>(mesh.vertices.data()));
+            },
+            "Vertex positions, as a (N, 3) float32 array")
+        .def_property_readonly(
+            "triangles",
+            [](const Mesh& mesh) {
+                return py::array_t<uint32_t>(
+                    {static_cast<py::ssize_t>(mesh.triangles.size()), py::ssize_t(3)},
+                    reinterpret_cast<const uint32_t*>(mesh.triangles.data()));
+            },
+            "Vertex indices of each triangle, as a (M, 3) array")
+        .def_property_readonly(
+            "triangle_sections",
+            [](const Mesh& mesh) {
+                return py::array_t<uint32_t>(static_cast<py::ssize_t>(mesh.triangleSections.size()),
+                                             mesh.triangleSections.data());
+            },
+            "Id of the section each triangle belongs to")
+        .def(
+            "write_ply",
+            [](const Mesh& mesh, py::object filename) {
+                morphio::mesh::writePLY(mesh, py::str(filename));
+            },
+            "filename"_a,
+            "Write the mesh in binary PLY format")
+        .def(
+            "write_obj",
+            [](const Mesh& mesh, py::object filename) {
+                morphio::mesh::writeOBJ(mesh, py::str(filename));
+            },
+            "filename"_a,
+            "Write the mesh in Wavefront OBJ format");
+
+    m.def(
+        "tessellate",
+        [](const morphio::Morphology& morphology,
+           morphio::mesh::Style style,
+           unsigned int resolution,
+           unsigned int level_of_detail,
+           unsigned int n_threads) {
+            morphio::mesh::MeshOptions options;
+            options.style = style;
+            options.resolution = resolution;
+            options.levelOfDetail = level_of_detail;
+            options.nThreads = n_threads;
+            py::gil_scoped_release release;
+            return morphio::mesh::tessellate(morphology, options);
+        },
+        "morphology"_a,
+        "style"_a = morphio::mesh::TUBES,
+        "resolution"_a = 12,
+        "level_of_detail"_a = 0,
+        "n_threads"_a = 0,
+        R"(Mesh the neurites of the morphology into closed triangle surfaces.
+
+`resolution` is the number of vertices around the neurites; each level of
+detail halves it (down to 3) and keeps one point out of two along the sections.
+The soma is not meshed.)");
+}
+
+template <typename T>
+py::array_t<T> vector_array(const std::vector<T>& values) {
+    return py::array_t<T>(static_cast<py::ssize_t>(values.size()), values.data());
+}
+
+void bind_compartments(py::module& m) {
+    using namespace morphio::compartments;
+
+    py::enum_<Ordering>(m, "CompartmentOrdering", py::arithmetic())
+        .value("concatenated", CONCATENATED, "Cells one after the other, each depth first")
+        .value("interleaved",
+               INTERLEAVED,
+               "Nodes of a group of cells sorted by level, the cells taking turns in a level");
+
+    py::class_<CompartmentTree>(
+        m,
+        "CompartmentTree",
+        R"(A forest of compartments in Hines order: the parent of a node always has a
+smaller index. Nodes are at the center of their compartment.)")
+        .def_property_readonly(
+            "parents",
+            [](const CompartmentTree& tree) { return vector_array(tree.parents); },
+            "Parent node of every node, -1 for the root of a cell")
+        .def_property_readonly(
+            "cells",
+            [](const CompartmentTree& tree) { return vector_array(tree.cells); },
+            "Cell (index in the input morphologies) of every node")
+        .def_property_readonly(
+            "sections",
+            [](const CompartmentTree& tree) { return vector_array(tree.sections); },
+            "Section of every node, -1 for the soma")
+        .def_property_readonly(
+            "cell_nodes",
+            [](const CompartmentTree& tree) { return vector_array(tree.cellNodes); },
+            "Index of every node in the depth first numbering of its own cell")
+        .def_property_readonly(
+            "centers",
+            [](const CompartmentTree& tree) {
+                return py::array_t<morphio::floatType>(
+                    {static_cast<py::ssize_t>(tree.centers.size()), py::ssize_t(3)},
+                    reinterpret_cast<const morphio::floatType*>(tree.centers.data()));
+            },
+            "Position of every node, as a (N, 3) array")
+        .def_property_readonly(
+            "diameters",
+            [](const CompartmentTree& tree) { return vector_array(tree.diameters); },
+            "Diameter at the position of every node")
+        .def_property_readonly(
+            "areas",
+            [](const CompartmentTree& tree) { return vector_array(tree.areas); },
+            "Membrane area of every compartment")
+        .def_property_readonly(
+            "axial_resistance_factors",
+            [](const CompartmentTree& tree) { return vector_array(tree.axialResistanceFactors); },
+            R"(Integral of 1 / (pi r^2) along the path between every node and its parent;
+multiplied by the axial resistivity, it gives the axial resistance)")
+        .def("__len__", &CompartmentTree::size);
+
+    const auto options = [](morphio::floatType max_length,
+                            bool with_soma,
+                            Ordering ordering,
+                            unsigned int group_size,
+                            unsigned int n_threads) {
+        CompartmentOptions options;
+        options.maxLength = max_length;
+        options.withSoma = with_soma;
+        options.ordering = ordering;
+        options.groupSize = group_size;
+        options.nThreads = n_threads;
+        return options;
+    };
+
+    m.def(
+        "compartmentalize",
+        [options](const morphio::Morphology& morphology,
+                  morphio::floatType max_length,
+                  bool with_soma) {
+            const auto opts = options(max_length, with_soma, CONCATENATED, 1, 1);
+            py::gil_scoped_release release;
+            return compartmentalize(morphology, opts);
+        },
+        "morphology"_a,
+        "max_length"_a = 0,
+        "with_soma"_a = true,
+        R"(Discretise the morphology into compartments, numbered depth first from the soma.
+
+Sections are split into compartments of equal length, no longer than
+`max_length` (0 means one compartment per section).)");
+
+    m.def(
+        "compartmentalize",
+        [options](const std::vector<morphio::Morphology>& morphologies,
+                  morphio::floatType max_length,
+                  bool with_soma,
+                  Ordering ordering,
+                  unsigned int group_size,
+                  unsigned int n_threads) {
+            const auto opts = options(max_length, with_soma, ordering, group_size, n_threads);
+            py::gil_scoped_release release;
+            return compartmentalize(morphologies, opts);
+        },
+        "morphologies"_a,
+        "max_length"_a = 0,
+        "with_soma"_a = true,
+        "ordering"_a = CONCATENATED,
+        "group_size"_a = 32,
+        "n_threads"_a = 0,
+        R"(Discretise several morphologies, in parallel, into one forest.
+
+With CompartmentOrdering.interleaved, cells are grouped by `group_size` and the
+nodes of a group are sorted by level, as CoreNEURON's interleaved permutation.)");
+}
+
+void bind_arrow(py::module& m) {
+    using namespace morphio::arrow;
+
+    py::enum_<Format>(m, "ArrowFormat", py::arithmetic())
+        .value("stream", IPC_STREAM, "Arrow IPC streaming format (pyarrow.ipc.open_stream)")
+        .value("file", IPC_FILE, "Arrow IPC file format (pyarrow.ipc.open_file)");
+
+    py::enum_<Table>(m, "ArrowTable", py::arithmetic())
+        .value("morphologies", MORPHOLOGIES, "One row per morphology")
+        .value("sections", SECTIONS, "One row per section")
+        .value("points", POINTS, "One row per point, soma points included");
+
+    const auto to_tuple = [](Population&& population) {
+        return py::make_tuple(std::move(population.names), std::move(population.morphologies));
+    };
+
+    m.def(
+        "arrow_serialize",
+        [](Table table,
+           const std::vector<std::string>& names,
+           const std::vector<morphio::Morphology>& morphologies,
+           Format format) {
+            std::string contents;
+            {
+                py::gil_scoped_release release;
+                contents = serialize(table, names, morphologies, format);
+            }
+            return py::bytes(contents);
+        },
+        "table"_a,
+        "names"_a,
+        "morphologies"_a,
+        "format"_a = IPC_FILE,
+        R"(Serialize one table of a population of morphologies as Arrow IPC data.
+
+The result can be opened by pyarrow.ipc.open_file (or open_stream).)");
+
+    m.def(
+        "arrow_deserialize",
+        [to_tuple](const py::bytes& morphologies, const py::bytes& sections, const py::bytes& points) {
+            return to_tuple(deserialize(morphologies, sections, points));
+        },
+        "morphologies"_a,
+        "sections"_a,
+        "points"_a,
+        "Return the (names, morphologies) of the population from its three Arrow IPC tables");
+
+    m.def(
+        "write_arrow",
+        [](py::object directory,
+           const std::vector<std::string>& names,
+           const std::vector<morphio::Morphology>& morphologies,
+           Format format) {
+            const std::string path = py::str(directory);
+            py::gil_scoped_release release;
+            write(path, names, morphologies, format);
+        },
+        "directory"_a,
+        "names"_a,
+        "morphologies"_a,
+        "format"_a = IPC_FILE,
+        R"(Write the morphologies.arrow, sections.arrow and points.arrow tables of the
+population in `directory`.)");
+
+    m.def(
+        "read_arrow",
+        [to_tuple](py::object directory) { return to_tuple(read(py::str(directory))); },
+        "directory"_a,
+        "Return the (names, morphologies) of the population written by write_arrow");
+}
+
+py::array_t<morphio::floatType> points_array(const morphio::Points& points) {
+    return py::array_t<morphio::floatType>(
+        {static_cast<py::ssize_t>(points.size()), py::ssize_t(3)},
+        reinterpret_cast<const morphio::floatType*>(points.data()));
+}
+
+void bind_spines(py::module& m) {
+    using namespace morphio::spines;
+
+    py::class_<PlacedSpine>(m, "PlacedSpine", "A spine of a SpineLibrary, placed onto a dendrite")
+        .def_readonly("spine", &PlacedSpine::spine, "Index of the spine in the library")
+        .def_readonly("section", &PlacedSpine::section, "Section of the host morphology")
+        .def_readonly("offset",
+                      &PlacedSpine::offset,
+                      "Position along the section, as a fraction of its path length")
+        .def_property_readonly(
+            "rotation",
+            [](const PlacedSpine& placed) {
+                return py::array_t<morphio::floatType>(
+                    {py::ssize_t(3), py::ssize_t(3)},
+                    reinterpret_cast<const morphio::floatType*>(
+                        placed.transform.rotation.data()));
+            },
+            "Rotation of the library spine, a (3, 3) array")
+        .def_property_readonly(
+            "translation",
+            [](const PlacedSpine& placed) {
+                return py::array_t<morphio::floatType>(3, placed.transform.translation.data());
+            },
+            "Translation of the rotated library spine");
+
+    py::class_<SpineLibrary>(
+        m,
+        "SpineLibrary",
+        R"(Spine morphologies to instantiate onto dendrites.
+
+The root of a spine (first point of its first root section) goes on the dendrite surface and its
+axis, toward its first post synaptic density or else its farthest point, along the dendrite
+normal.)")
+        .def(py::init<const std::vector<morphio::DendriticSpine>&>(), "spines"_a)
+        .def(py::init<const std::vector<morphio::Morphology>&>(), "spines"_a)
+        .def("__len__", &SpineLibrary::size)
+        .def("spine", &SpineLibrary::spine, "index"_a, "The morphology of a spine")
+        .def_property_readonly(
+            "roots",
+            [](const SpineLibrary& library) { return points_array(library.roots()); },
+            "Root of every spine, in its own coordinates")
+        .def_property_readonly(
+            "axes",
+            [](const SpineLibrary& library) { return points_array(library.axes()); },
+            "Unit axis of every spine, in its own coordinates")
+        .def(
+            "points",
+            [](const SpineLibrary& library, const PlacedSpine& placed) {
+                return points_array(library.points(placed));
+            },
+            "placed"_a,
+            "The points of a placed spine")
+        .def("instantiate",
+             &SpineLibrary::instantiate,
+             "placed"_a,
+             "A placed spine as a standalone mutable morphology, e.g. to write it");
+
+    m.def(
+        "place_spines",
+        [](const morphio::Morphology& morphology,
+           const SpineLibrary& library,
+           const std::vector<uint32_t>& spines,
+           const std::vector<uint32_t>& sections,
+           const std::vector<morphio::floatType>& offsets,
+           const std::vector<morphio::floatType>& angles,
+           unsigned int n_threads) {
+            if (sections.size() != spines.size() || offsets.size() != spines.size() ||
+                (!angles.empty() && angles.size() != spines.size())) {
+                throw std::invalid_argument("The location arrays must have the same length");
+            }
+            std::vector<SpineLocation> locations(spines.size());
+            for (size_t i = 0; i < spines.size(); ++i) {
+                const morphio::floatType angle = angles.empty() ? 0 : angles[i];
+                locations[i] = {spines[i], sections[i], offsets[i], angle};
+            }
+            py::gil_scoped_release release;
+            return place(morphology, library, locations, n_threads);
+        },
+        "morphology"_a,
+        "library"_a,
+        "spines"_a,
+        "sections"_a,
+        "offsets"_a,
+        "angles"_a = std::vector<morphio::floatType>(),
+        "n_threads"_a = 0,
+        R"(Place spines of the library onto the dendrites of the morphology.
+
+The spine spines[i] grows at offsets[i] (fraction of the path length) along the section
+sections[i], at angles[i] radians around the dendrite from a reference direction.)");
+}
+
+void bind_delta(py::module& m) {
+    using namespace morphio::delta;
+
+    py::class_<MorphologyDelta>(
+        m,
+        "MorphologyDelta",
+        R"(The difference between a morphology variant and its base.
+
+The sections the variant shares verbatim with its base are stored as references to the base
+sections; the other ones are stored with their points.)")
+        .def("__len__", &MorphologyDelta::size)
+        .def_readonly("base", &MorphologyDelta::base, "Name of the base morphology")
+        .def_readonly("soma_changed",
+                      &MorphologyDelta::somaChanged,
+                      "Whether the soma differs from the base one")
+        .def_readonly("has_perimeters",
+                      &MorphologyDelta::hasPerimeters,
+                      "Whether the variant has perimeters")
+        .def_property_readonly(
+            "base_sections",
+            [](const MorphologyDelta& delta) {
+                return py::array_t<int32_t>(static_cast<py::ssize_t>(delta.baseSections.size()),
+                                            delta.baseSections.data());
+            },
+            "Base section copied by every section of the variant, -1 if its points are stored")
+        .def_property_readonly(
+            "parents",
+            [](const MorphologyDelta& delta) {
+                return py::array_t<int32_t>(static_cast<py::ssize_t>(delta.parents.size()),
+                                            delta.parents.data());
+            },
+            "Parent of every section of the variant, -1 for root sections")
+        .def_property_readonly(
+            "points",
+            [](const MorphologyDelta& delta) { return points_array(delta.points); },
+            "Points of the stored sections");
+
+    m.def(
+        "delta_diff",
+        [](const morphio::Morphology& base,
+           const morphio::Morphology& variant,
+           const std::string& base_name) {
+            py::gil_scoped_release release;
+            return diff(base, variant, base_name);
+        },
+        "base"_a,
+        "variant"_a,
+        "base_name"_a = "",
+        "The delta turning `base` into `variant`, the latter must have no organelles");
+
+    m.def(
+        "delta_apply",
+        [](const morphio::Morphology& base, const MorphologyDelta& delta) {
+            py::gil_scoped_release release;
+            return apply(base, delta);
+        },
+        "base"_a,
+        "delta"_a,
+        "Rebuild the variant from its base");
+
+    m.def(
+        "delta_serialize",
+        [](const MorphologyDelta& delta) { return py::bytes(serialize(delta)); },
+        "delta"_a,
+        "The contents of the `.delta` file of the delta");
+
+    m.def(
+        "delta_deserialize",
+        [](const py::bytes& contents) { return deserialize(contents); },
+        "contents"_a,
+        "Read a delta from the contents of a `.delta` file");
+
+    m.def(
+        "write_delta",
+        [](const MorphologyDelta& delta, py::object filename) {
+            write(delta, py::str(filename));
+        },
+        "delta"_a,
+        "filename"_a,
+        "Write the delta to a `.delta` file");
+
+    m.def(
+        "read_delta",
+        [](py::object filename) { return read(py::str(filename)); },
+        "filename"_a,
+        "Read the delta written by write_delta");
+
+    py::class_<VariantCollection>(
+        m,
+        "VariantCollection",
+        R"(A collection of variants stored as deltas, with their bases in another collection.
+
+The deltas are `<name>.delta` files of a directory, or the contents returned by a `ByteSource`.
+The `cache_size` most recently used bases are kept in memory.)")
+        .def(py::init(
+                 [](const morphio::Collection& bases, py::object directory, size_t cache_size) {
+                     return std::make_unique<VariantCollection>(bases,
+                                                                py::str(directory),
+                                                                cache_size);
+                 }),
+             "bases"_a,
+             "directory"_a,
+             "cache_size"_a = 16)
+        .def(py::init<morphio::Collection, std::shared_ptr<morphio::ByteSource>, size_t>(),
+             "bases"_a,
+             "source"_a,
+             "cache_size"_a = 16,
+             // The Python half of `source` implements `get`, keep it alive
+             py::keep_alive<1, 3>())
+        .def("load", &VariantCollection::load, "name"_a, "Load the variant `name`")
+        .def("base", &VariantCollection::base, "name"_a, "Load the base `name`");
+}
+
+
+void bind_clones(py::module& m) {
+    using namespace morphio::clones;
+
+    py::class_<CloneParameters>(
+        m,
+        "CloneParameters",
+        R"(The random transformations of clone_morphologies, all of them default to none.
+
+Scaling factors are log-normal, exp(sigma * N(0, 1)), angles are in radians.)")
+        .def(py::init([](morphio::floatType scale_sigma,
+                         morphio::floatType length_sigma,
+                         morphio::floatType angle_sigma,
+                         morphio::floatType subtree_rotation) {
+                 return CloneParameters{scale_sigma, length_sigma, angle_sigma, subtree_rotation};
+             }),
+             "scale_sigma"_a = 0,
+             "length_sigma"_a = 0,
+             "angle_sigma"_a = 0,
+             "subtree_rotation"_a = 0)
+        .def_readwrite("scale_sigma",
+                       &CloneParameters::scaleSigma,
+                       "Sigma of the scaling factor of the whole morphology")
+        .def_readwrite("length_sigma",
+                       &CloneParameters::lengthSigma,
+                       "Sigma of the scaling factor of the length of every section")
+        .def_readwrite("angle_sigma",
+                       &CloneParameters::angleSigma,
+                       "Standard deviation of the angle by which every section is bent")
+        .def_readwrite("subtree_rotation",
+                       &CloneParameters::subtreeRotation,
+                       "Maximum rotation of every subtree around the end of its parent section");
+
+    m.def(
+        "clone_morphology",
+        [](const morphio::Morphology& morphology,
+           const CloneParameters& parameters,
+           uint64_t seed,
+           uint64_t index) {
+            py::gil_scoped_release release;
+            return clone(morphology, parameters, seed, index);
+        },
+        "morphology"_a,
+        "parameters"_a,
+        "seed"_a,
+        "index"_a = 0,
+        R"(Clone number `index` of the morphology for the given `seed`.
+
+Only the point coordinates are transformed; a clone only depends on the seed and its index.)");
+
+    m.def(
+        "clone_morphologies",
+        [](const morphio::Morphology& morphology,
+           const CloneParameters& parameters,
+           size_t count,
+           uint64_t seed,
+           uint64_t first_index,
+           unsigned int n_threads) {
+            py::gil_scoped_release release;
+            return clones(morphology, parameters, count, seed, first_index, n_threads);
+        },
+        "morphology"_a,
+        "parameters"_a,
+        "count"_a,
+        "seed"_a,
+        "first_index"_a = 0,
+        "n_threads"_a = 0,
+        R"(The clones number `first_index` to `first_index + count - 1` of the morphology,
+generated in parallel; they are the same as the ones of clone_morphology.)");
+}
+
+
+void bind_unravel(py::module& m) {
+    using namespace morphio::unravel;
+
+    py::class_<Unravelled>(
+        m,
+        "Unravelled",
+        R"(A morphology unravelled with a sliding window, and the mapping from the original one.
+
+Every segment is replaced by a segment of the same length along the principal direction of the
+`window_half_length` points on each side of it. The unravelled morphology has the same sections
+and points as the original one: original point i is moved to point i.)")
+        .def(py::init([](const morphio::Morphology& morphology,
+                         size_t window_half_length,
+                         unsigned int n_threads) {
+                 py::gil_scoped_release release;
+                 return std::make_unique<Unravelled>(morphology, window_half_length, n_threads);
+             }),
+             "morphology"_a,
+             "window_half_length"_a = DEFAULT_WINDOW_HALF_LENGTH,
+             "n_threads"_a = 0)
+        .def_property_readonly("original", &Unravelled::original, "The original morphology")
+        .def_property_readonly("morphology",
+                               &Unravelled::morphology,
+                               "The unravelled morphology")
+        .def(
+            "map",
+            [](const Unravelled& unravelled,
+               const py::array_t<morphio::floatType>& positions,
+               const std::vector<uint32_t>& sections,
+               unsigned int n_threads) {
+                const auto points = array_to_points(positions);
+                morphio::Points mapped;
+                {
+                    py::gil_scoped_release release;
+                    mapped = unravelled.map(points, sections, n_threads);
+                }
+                return points_array(mapped);
+            },
+            "positions"_a,
+            "sections"_a,
+            "n_threads"_a = 0,
+            R"(Move the (N, 3) positions, attached to the sections of the original morphology
+(synapses, markers, ...): a position keeps its location along the closest segment of its section,
+and its offset from the segment rotated with it.)");
+
+    m.def(
+        "unravel",
+        [](const morphio::Morphology& morphology,
+           size_t window_half_length,
+           unsigned int n_threads) {
+            py::gil_scoped_release release;
+            return unravel(morphology, window_half_length, n_threads);
+        },
+        "morphology"_a,
+        "window_half_length"_a = DEFAULT_WINDOW_HALF_LENGTH,
+        "n_threads"_a = 0,
+        "The unravelled morphology, see Unravelled");
+}
+
+
+/** A read-only numpy view of a mapped sidecar array, which keeps the mapping alive */
+template <typename T>
+py::array_t<T> mapped_array(std::shared_ptr<const morphio::sidecar::MappedArray> array) {
+    const auto values = array->values<T>();
+    auto* owner = new std::shared_ptr<const morphio::sidecar::MappedArray>(std::move(array));
+    py::capsule base(owner, [](void* pointer) {
+        delete static_cast<std::shared_ptr<const morphio::sidecar::MappedArray>*>(pointer);
+    });
+    py::array_t<T> result(static_cast<py::ssize_t>(values.size()), values.data(), base);
+    result.attr("setflags")("write"_a = false);
+    return result;
+}
+
+void bind_sidecar(py::module& m) {
+    using namespace morphio::sidecar;
+
+    m.def("content_hash",
+          &contentHash,
+          "morphology"_a,
+          "Hash of the points, diameters, perimeters, topology, section types and soma");
+
+    py::class_<SidecarCache>(
+        m,
+        "SidecarCache",
+        R"(Persistent cache of arrays derived from morphologies, keyed by their content hash.
+
+Every array is a `<content hash>-<name>.bin` file of the cache directory, read back with mmap:
+the returned arrays are read-only views of the files.)")
+        .def(py::init([](py::object directory) {
+                 return SidecarCache(py::str(directory));
+             }),
+             "directory"_a,
+             "The directory is created if it does not exist")
+        .def_static(
+            "next_to",
+            [](py::object source) { return SidecarCache::nextTo(py::str(source)); },
+            "source"_a,
+            R"(The cache of a container (`<path>.morphio-cache`) or a directory of morphologies
+(`<path>/.morphio-cache`))")
+        .def_property_readonly("directory", &SidecarCache::directory)
+        .def(
+            "section_lengths",
+            [](const SidecarCache& cache, const morphio::Morphology& morphology) {
+                return mapped_array<morphio::floatType>(cache.sectionLengths(morphology));
+            },
+            "morphology"_a,
+            "Length of every section")
+        .def(
+            "path_distances",
+            [](const SidecarCache& cache, const morphio::Morphology& morphology) {
+                return mapped_array<morphio::floatType>(cache.pathDistances(morphology));
+            },
+            "morphology"_a,
+            "Path distance from the first point of the root section to the end of every section")
+        .def(
+            "depth_first_order",
+            [](const SidecarCache& cache, const morphio::Morphology& morphology) {
+                return mapped_array<uint32_t>(cache.depthFirstOrder(morphology));
+            },
+            "morphology"_a,
+            "Section ids in depth first order")
+        .def(
+            "get_or_compute",
+            [](const SidecarCache& cache,
+               const morphio::Morphology& morphology,
+               const std::string& name,
+               const py::function& compute) {
+                using Array = py::array_t<double, py::array::c_style | py::array::forcecast>;
+                const auto compute_array = [&compute](const morphio::Morphology& m) {
+                    const auto values = compute(m).cast<Array>();
+                    return std::vector<double>(values.data(), values.data() + values.size());
+                };
+                return mapped_array<double>(
+                    cache.getOrCompute<double>(morphology, name, compute_array));
+            },
+            "morphology"_a,
+            "name"_a,
+            "compute"_a,
+            R"(The array `name` of the morphology, as float64; `compute(morphology)` is called
+to create it if it is not in the cache.)");
+}
+
+void bind_parallel(py::module& m) {
+    using namespace morphio::parallel;
+
+    py::enum_<Order>(m, "SectionOrder", py::arithmetic())
+        .value("unordered", Order::UNORDERED, "The sections are visited in any order")
+        .value("top_down", Order::TOP_DOWN, "A section is visited after its parent")
+        .value("bottom_up", Order::BOTTOM_UP, "A section is visited after all its children");
+
+    m.def(
+        "parallel_for_sections",
+        [](const morphio::Morphology& morphology,
+           const py::function& callback,
+           Order order,
+           unsigned int n_threads) {
+            py::gil_scoped_release release;
+            forEachSection(
+                morphology,
+                [&callback](const morphio::Section& section) {
+                    py::gil_scoped_acquire acquire;
+                    callback(section);
+                },
+                order,
+                n_threads);
+        },
+        "morphology"_a,
+        "callback"_a,
+        "order"_a = Order::UNORDERED,
+        "n_threads"_a = 0,
+        R"(Call callback(section) once for every section of the morphology, on n_threads threads
+(0: one per hardware thread).
+
+With SectionOrder.top_down a section is visited after its parent, with SectionOrder.bottom_up
+after all its children. The callbacks hold the GIL: they only run concurrently when they release
+it, for instance in numpy. The first exception raised by a callback is re-raised.)");
+}
+
+/** A read-only numpy view of a vector of `owner`, which it keeps alive */
+template <typename T>
+py::array_t<T> vector_view(const std::vector<T>& values, const py::object& owner) {
+    py::array_t<T> result(static_cast<py::ssize_t>(values.size()), values.data(), owner);
+    result.attr("setflags")("write"_a = false);
+    return result;
+}
+
+void bind_subtree(py::module& m) {
+    using morphio::subtree::Aggregates;
+
+    py::class_<Aggregates>(
+        m,
+        "SubtreeAggregates",
+        R"(Aggregates of every section and all the sections below it, indexed by section id.
+
+The arrays are read-only views of the aggregates, without copies. Only the segments of the
+sections count, not the segments between the soma and the root sections.)")
+        .def_property_readonly(
+            "length",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Aggregates&>().length, self);
+            },
+            "Total length")
+        .def_property_readonly(
+            "area",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Aggregates&>().area, self);
+            },
+            "Lateral area of the frustums of the segments")
+        .def_property_readonly(
+            "volume",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Aggregates&>().volume, self);
+            },
+            "Volume of the frustums of the segments")
+        .def_property_readonly(
+            "tips",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Aggregates&>().tips, self);
+            },
+            "Number of sections without children")
+        .def_property_readonly(
+            "bifurcations",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Aggregates&>().bifurcations, self);
+            },
+            "Number of sections with two children or more")
+        .def_property_readonly(
+            "max_path_length",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Aggregates&>().maxPathLength, self);
+            },
+            "Longest path length from the first point of the section to the end of a tip");
+
+    m.def(
+        "subtree_aggregates",
+        [](const morphio::Morphology& morphology) {
+            py::gil_scoped_release release;
+            return morphio::subtree::aggregates(morphology);
+        },
+        "morphology"_a,
+        "The SubtreeAggregates of the morphology, computed in a single postorder pass");
+}
+
+void bind_clip(py::module& m) {
+    using namespace morphio::clip;
+
+    py::class_<Box>(m, "ClipBox", "Axis aligned box, from its min to its max corner")
+        .def(py::init([](const morphio::Point& min, const morphio::Point& max) {
+                 return Box{min, max};
+             }),
+             "min"_a,
+             "max"_a)
+        .def_readwrite("min", &Box::min)
+        .def_readwrite("max", &Box::max);
+
+    py::class_<Plane>(m,
+                      "ClipPlane",
+                      "Half-space on the side of the plane through `point` that `normal` points to")
+        .def(py::init([](const morphio::Point& point, const morphio::Point& normal) {
+                 return Plane{point, normal};
+             }),
+             "point"_a,
+             "normal"_a)
+        .def_readwrite("point", &Plane::point)
+        .def_readwrite("normal", &Plane::normal);
+
+    py::class_<Slab>(
+        m,
+        "ClipSlab",
+        "The points of the ClipPlane(point, normal) at most `thickness` away from the plane")
+        .def(py::init([](const morphio::Point& point,
+                         const morphio::Point& normal,
+                         morphio::floatType thickness) {
+                 return Slab{Plane{point, normal}, thickness};
+             }),
+             "point"_a,
+             "normal"_a,
+             "thickness"_a)
+        .def_readwrite("plane", &Slab::plane)
+        .def_readwrite("thickness", &Slab::thickness);
+
+    py::class_<Clipped>(
+        m,
+        "Clipped",
+        R"(The parts of a morphology inside a region, and the mapping to the original morphology.
+
+Sections crossing the boundary are cut there, with interpolated points, diameters and perimeters.
+A part starting at the first point of its section keeps its parent if the end of the parent is
+kept, the other parts are root sections. The soma is kept if its center is inside the region;
+mitochondria, endoplasmic reticulum, annotations and markers are not kept.)")
+        .def_readonly("morphology", &Clipped::morphology, "The clipped morphology")
+        .def_property_readonly(
+            "sections",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Clipped&>().sections, self);
+            },
+            "For every clipped section, the original section it is part of")
+        .def_property_readonly(
+            "offsets",
+            [](const py::object& self) {
+                return vector_view(self.cast<const Clipped&>().offsets, self);
+            },
+            R"(For every point, its position in its original section, in points: i + t is at
+fraction t of the segment from point i to point i + 1)");
+
+    const auto clip_region = [](const morphio::Morphology& morphology,
+                                const py::object& region,
+                                unsigned int n_threads) {
+        if (py::isinstance<Box>(region)) {
+            const auto box = region.cast<Box>();
+            py::gil_scoped_release release;
+            return clip(morphology, box, n_threads);
+        }
+        if (py::isinstance<Plane>(region)) {
+            const auto plane = region.cast<Plane>();
+            py::gil_scoped_release release;
+            return clip(morphology, plane, n_threads);
+        }
+        if (py::isinstance<Slab>(region)) {
+            const auto slab = region.cast<Slab>();
+            py::gil_scoped_release release;
+            return clip(morphology, slab, n_threads);
+        }
+        throw std::invalid_argument("region must be a ClipBox, a ClipPlane or a ClipSlab");
+    };
+
+    m.def("clip",
+          clip_region,
+          "morphology"_a,
+          "region"_a,
+          "n_threads"_a = 0,
+          "The Clipped parts of the morphology inside the ClipBox, ClipPlane or ClipSlab region");
+}
+
+void bind_layout(py::module& m) {
+    m.def("access_order",
+          &morphio::layout::accessOrder,
+          "morphology_names"_a,
+          "traces"_a,
+          R"(The order in which to lay out `morphology_names`, given the access traces of jobs.
+
+The pairs of morphologies loaded one after the other most often in `traces` are made adjacent
+first; the chains they form follow each other in the order they were first accessed, then the
+morphologies absent from the traces keep their order.)");
+
+    m.def(
+        "reorder_container",
+        [](py::object input_path, py::object output_path, const py::iterable& traces) {
+            std::vector<std::vector<std::string>> names;
+            for (const auto& trace : traces) {
+                if (py::isinstance<morphio::AccessTrace>(trace)) {
+                    names.push_back(trace.cast<const morphio::AccessTrace&>().names());
+                } else {
+                    names.push_back(trace.cast<std::vector<std::string>>());
+                }
+            }
+            const std::string input = py::str(input_path);
+            const std::string output = py::str(output_path);
+            py::gil_scoped_release release;
+            morphio::layout::reorderContainer(input, output, names);
+        },
+        "input_path"_a,
+        "output_path"_a,
+        "traces"_a,
+        R"(Copy the container `input_path` to `output_path` with its morphologies in `access_order`.
+
+`traces` are AccessTrace objects or lists of names, e.g. read back with `AccessTrace.read`.)");
+}
+
+
+/** (offsets, cells, sections, segments, distances), the hits of the query i being in
+ * [offsets[i], offsets[i + 1]) */
+py::tuple circuit_hit_arrays(const std::vector<std::vector<morphio::circuit::SegmentHit>>& hits) {
+    std::vector<int64_t> offsets{0};
+    std::vector<uint64_t> cells;
+    std::vector<uint32_t> sections;
+    std::vector<uint32_t> segments;
+    std::vector<morphio::floatType> distances;
+    for (const auto& queryHits : hits) {
+        for (const auto& hit : queryHits) {
+            cells.push_back(hit.cell);
+            sections.push_back(hit.section);
+            segments.push_back(hit.segment);
+            distances.push_back(hit.distance);
+        }
+        offsets.push_back(static_cast<int64_t>(cells.size()));
+    }
+    return py::make_tuple(as_pyarray(std::move(offsets)),
+                          as_pyarray(std::move(cells)),
+                          as_pyarray(std::move(sections)),
+                          as_pyarray(std::move(segments)),
+                          as_pyarray(std::move(distances)));
+}
+
+void bind_circuit(py::module& m) {
+    using morphio::circuit::Cell;
+    using morphio::circuit::SegmentHit;
+    using morphio::circuit::SpatialIndex;
+    using FloatArray = py::array_t<morphio::floatType, py::array::c_style | py::array::forcecast>;
+
+    py::class_<SpatialIndex>(
+        m,
+        "CircuitIndex",
+        R"(Two-level spatial index over the neurite segments of the cells of a circuit.
+
+A cell is a morphology of the collection placed by a rotation and a translation. The top level
+is a bounding volume hierarchy over the boxes of the cells; the segment index of a cell is built
+when a query first reaches its box, and at most `max_resident_cells` of them are kept in memory,
+the least recently used ones being dropped first. The soma is not indexed.
+
+Queries return (offsets, cells, sections, segments, distances): the hits of the query i are in
+[offsets[i], offsets[i + 1]). Distances are to the surface of the segments, 0 inside. Queries run
+in parallel on n_threads threads (0: one per hardware thread).)")
+        .def(py::init([](const morphio::Collection& collection,
+                         const std::vector<std::string>& morphology_names,
+                         const py::object& rotations,
+                         const py::object& translations,
+                         size_t max_resident_cells,
+                         unsigned int options,
+                         unsigned int n_threads) {
+                 const auto n_cells = static_cast<py::ssize_t>(morphology_names.size());
+                 std::vector<Cell> cells(morphology_names.size());
+                 for (size_t i = 0; i < cells.size(); ++i) {
+                     cells[i].morphology = morphology_names[i];
+                 }
+                 if (!rotations.is_none()) {
+                     const auto matrices = rotations.cast<FloatArray>();
+                     if (matrices.ndim() != 3 || matrices.shape(0) != n_cells ||
+                         matrices.shape(1) != 3 || matrices.shape(2) != 3) {
+                         throw std::invalid_argument("rotations must be a (N, 3, 3) array");
+                     }
+                     for (py::ssize_t c = 0; c < n_cells; ++c) {
+                         for (py::ssize_t i = 0; i < 3; ++i) {
+                             for (py::ssize_t k = 0; k < 3; ++k) {
+                                 cells[static_cast<size_t>(c)]
+                                     .transform.rotation[static_cast<size_t>(i)]
+                                                        [static_cast<size_t>(k)] =
+                                     matrices.at(c, i, k);
+                             }
+                         }
+                     }
+                 }
+                 if (!translations.is_none()) {
+                     const auto vectors = translations.cast<FloatArray>();
+                     if (vectors.ndim() != 2 || vectors.shape(0) != n_cells ||
+                         vectors.shape(1) != 3) {
+                         throw std::invalid_argument("translations must be a (N, 3) array");
+                     }
+                     for (py::ssize_t c = 0; c < n_cells; ++c) {
+                         for (py::ssize_t k = 0; k < 3; ++k) {
+                             cells[static_cast<size_t>(c)]
+                                 .transform.translation[static_cast<size_t>(k)] =
+                                 vectors.at(c, k);
+                         }
+                     }
+                 }
+                 py::gil_scoped_release release;
+                 return std::make_unique<SpatialIndex>(
+                     collection, std::move(cells), max_resident_cells, options, n_threads);
+             }),
+             "collection"_a,
+             "morphology_names"_a,
+             "rotations"_a = py::none(),
+             "translations"_a = py::none(),
+             "max_resident_cells"_a = morphio::circuit::DEFAULT_MAX_RESIDENT_CELLS,
+             "options"_a = morphio::enums::Option::NO_MODIFIER,
+             "n_threads"_a = 0,
+             R"(Index the cells `morphology_names[i]`, placed by the (N, 3, 3) rotations and the
+(N, 3) translations. Every morphology is loaded once, only its box is kept.)")
+        .def("__len__", &SpatialIndex::size, "Number of cells")
+        .def_property_readonly("resident_cells",
+                               &SpatialIndex::residentCells,
+                               "Number of cells whose segment index is in memory")
+        .def(
+            "cell_box",
+            [](const SpatialIndex& index, size_t cell) {
+                return bounding_box_array(index.cellBox(cell));
+            },
+            "cell"_a,
+            "Bounding box of the placed segments of the cell, as a (2, 3) array: [min, max]")
+        .def(
+            "in_box",
+            [](const SpatialIndex& index, const FloatArray& boxes, unsigned int n_threads) {
+                if (boxes.ndim() != 3 || boxes.shape(1) != 2 || boxes.shape(2) != 3) {
+                    throw std::invalid_argument("boxes must be a (N, 2, 3) array");
+                }
+                std::vector<morphio::BoundingBox> queries(static_cast<size_t>(boxes.shape(0)));
+                for (py::ssize_t i = 0; i < boxes.shape(0); ++i) {
+                    for (py::ssize_t k = 0; k < 3; ++k) {
+                        queries[static_cast<size_t>(i)].min[static_cast<size_t>(k)] =
+                            boxes.at(i, 0, k);
+                        queries[static_cast<size_t>(i)].max[static_cast<size_t>(k)] =
+                            boxes.at(i, 1, k);
+                    }
+                }
+                std::vector<std::vector<SegmentHit>> hits;
+                {
+                    py::gil_scoped_release release;
+                    hits = index.inBox(queries, n_threads);
+                }
+                return circuit_hit_arrays(hits);
+            },
+            "boxes"_a,
+            "n_threads"_a = 0,
+            R"(The segments whose axis has a point in every box of a (N, 2, 3) array of
+[min, max] corners, sorted by cell, section and segment)")
+        .def(
+            "in_sphere",
+            [](const SpatialIndex& index,
+               const py::array_t<morphio::floatType>& centers,
+               morphio::floatType radius,
+               unsigned int n_threads) {
+                const auto queries = array_to_points(centers);
+                std::vector<std::vector<SegmentHit>> hits;
+                {
+                    py::gil_scoped_release release;
+                    hits = index.inSphere(queries, radius, n_threads);
+                }
+                return circuit_hit_arrays(hits);
+            },
+            "centers"_a,
+            "radius"_a,
+            "n_threads"_a = 0,
+            "The segments within radius of every point of a (N, 3) array, sorted by distance")
+        .def(
+            "nearest",
+            [](const SpatialIndex& index,
+               const py::array_t<morphio::floatType>& points,
+               size_t k,
+               unsigned int n_threads) {
+                const auto queries = array_to_points(points);
+                std::vector<std::vector<SegmentHit>> hits;
+                {
+                    py::gil_scoped_release release;
+                    hits = index.nearest(queries, k, n_threads);
+                }
+                return circuit_hit_arrays(hits);
+            },
+            "points"_a,
+            "k"_a = 1,
+            "n_threads"_a = 0,
+            "The k nearest segments of every point of a (N, 3) array, sorted by distance");
+}
+
+}  // namespace
+
+void bind_tools(py::module& m) {
+    bind_tmd(m);
+    bind_bounding_volumes(m);
+    bind_mesh(m);
+    bind_compartments(m);
+    bind_arrow(m);
+    bind_spines(m);
+    bind_delta(m);
+    bind_clones(m);
+    bind_unravel(m);
+    bind_sidecar(m);
+    bind_parallel(m);
+    bind_subtree(m);
+    bind_layout(m);
+    bind_clip(m);
+    bind_circuit(m);
+}
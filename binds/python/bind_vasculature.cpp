@@ -4,18 +4,123 @@
  */
 #include "bind_vasculature.h"
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <morphio/vasc/proximity.h>
 #include <morphio/vasc/section.h>
 #include <morphio/vasc/vasculature.h>
 
-#include <memory>  // std::make_unique
+#include <iterator>  // std::back_inserter
+#include <limits>
+#include <memory>     // std::make_unique
+#include <stdexcept>  // std::invalid_argument
 
 #include "bindings_utils.h"
 
 namespace py = pybind11;
 
+namespace {
+using morphio::vasculature::MorphologyHits;
+using morphio::vasculature::SegmentHit;
+
+/** (sections, segments, distances) of the nearest hits; -1, -1, inf for queries without any */
+py::tuple nearest_arrays(const std::vector<std::vector<SegmentHit>>& hits) {
+    const auto size = static_cast<py::ssize_t>(hits.size());
+    py::array_t<int64_t> sections(size);
+    py::array_t<int64_t> segments(size);
+    py::array_t<morphio::floatType> distances(size);
+    for (py::ssize_t i = 0; i < size; ++i) {
+        const auto& hit = hits[static_cast<size_t>(i)];
+        sections.mutable_at(i) = hit.empty() ? -1 : static_cast<int64_t>(hit[0].section);
+        segments.mutable_at(i) = hit.empty() ? -1 : static_cast<int64_t>(hit[0].segment);
+        distances.mutable_at(i) = hit.empty() ? std::numeric_limits<morphio::floatType>::infinity()
+                                              : hit[0].distance;
+    }
+    return py::make_tuple(sections, segments, distances);
+}
+
+/** (offsets, sections, segments, distances), the hits of the query i being in
+ * [offsets[i], offsets[i + 1]) */
+py::tuple within_arrays(const std::vector<std::vector<SegmentHit>>& hits) {
+    std::vector<int64_t> offsets{0};
+    std::vector<uint32_t> sections;
+    std::vector<uint32_t> segments;
+    std::vector<morphio::floatType> distances;
+    for (const auto& queryHits : hits) {
+        for (const auto& hit : queryHits) {
+            sections.push_back(hit.section);
+            segments.push_back(hit.segment);
+            distances.push_back(hit.distance);
+        }
+        offsets.push_back(static_cast<int64_t>(sections.size()));
+    }
+    return py::make_tuple(as_pyarray(std::move(offsets)),
+                          as_pyarray(std::move(sections)),
+                          as_pyarray(std::move(segments)),
+                          as_pyarray(std::move(distances)));
+}
+
+/** The placement given by an optional (3, 3) rotation and an optional translation */
+morphio::Transform make_transform(const py::object& rotation,
+                                               const py::object& translation) {
+    using FloatArray =
+        py::array_t<morphio::floatType, py::array::c_style | py::array::forcecast>;
+    morphio::Transform transform;
+    if (!rotation.is_none()) {
+        const auto matrix = rotation.cast<FloatArray>();
+        if (matrix.ndim() != 2 || matrix.shape(0) != 3 || matrix.shape(1) != 3) {
+            throw std::invalid_argument("rotation must be a (3, 3) array");
+        }
+        for (py::ssize_t i = 0; i < 3; ++i) {
+            for (py::ssize_t k = 0; k < 3; ++k) {
+                transform.rotation[static_cast<size_t>(i)][static_cast<size_t>(k)] =
+                    matrix.at(i, k);
+            }
+        }
+    }
+    if (!translation.is_none()) {
+        const auto vector = translation.cast<FloatArray>();
+        if (vector.ndim() != 1 || vector.shape(0) != 3) {
+            throw std::invalid_argument("translation must be a (3,) array");
+        }
+        for (py::ssize_t i = 0; i < 3; ++i) {
+            transform.translation[static_cast<size_t>(i)] = vector.at(i);
+        }
+    }
+    return transform;
+}
+
+/**
+ * The queried parts of a morphology, (sections, segments) with -1 for the soma, followed by their
+ * nearest or within arrays
+ */
+py::tuple morphology_arrays(const morphio::Morphology& morphology,
+                            MorphologyHits&& result,
+                            bool nearest) {
+    std::vector<std::vector<SegmentHit>> hits;
+    std::vector<int64_t> sections;
+    std::vector<int64_t> segments;
+    if (!morphology.soma().points().empty()) {
+        hits.push_back(std::move(result.soma));
+        sections.push_back(-1);
+        segments.push_back(-1);
+    }
+    std::move(result.hits.begin(), result.hits.end(), std::back_inserter(hits));
+    sections.insert(sections.end(), result.sections.begin(), result.sections.end());
+    segments.insert(segments.end(), result.segments.begin(), result.segments.end());
+    const py::tuple arrays = nearest ? nearest_arrays(hits) : within_arrays(hits);
+    py::tuple tuple(arrays.size() + 2);
+    tuple[0] = as_pyarray(std::move(sections));
+    tuple[1] = as_pyarray(std::move(segments));
+    for (size_t i = 0; i < arrays.size(); ++i) {
+        tuple[i + 2] = arrays[i];
+    }
+    return tuple;
+}
+}  // namespace
+
 void bind_vasculature(py::module& m) {
     using namespace py::literals;
 
@@ -160,4 +265,118 @@ void bind_vasculature(py::module& m) {
             },
             py::keep_alive<0, 1>() /* Essential: keep object alive while iterator exists */,
             "Section iterator\n");
+
+    using morphio::vasculature::ProximityIndex;
+    py::class_<ProximityIndex>(
+        m,
+        "ProximityIndex",
+        R"(Spatial index over the segments of a vasculature, for proximity queries.
+
+A segment is the truncated cone between two consecutive points of a section. Distances are between
+the surfaces of the query and of the segment, 0 when they overlap. Queries run in parallel on
+n_threads threads (0: one per hardware thread).)")
+        .def(py::init<const morphio::vasculature::Vasculature&>(), "vasculature"_a)
+        .def(py::init([](const py::array_t<morphio::floatType>& points,
+                         const std::vector<morphio::floatType>& diameters,
+                         const std::vector<uint64_t>& section_offsets) {
+                 return std::make_unique<ProximityIndex>(array_to_points(points),
+                                                         diameters,
+                                                         section_offsets);
+             }),
+             "points"_a,
+             "diameters"_a,
+             "section_offsets"_a,
+             R"(Index the sections given as flat arrays: the section i has the points
+[section_offsets[i], section_offsets[i + 1]), the last offset being len(points))")
+        .def("__len__", &ProximityIndex::size, "Number of indexed segments")
+        .def(
+            "nearest",
+            [](const ProximityIndex& index,
+               const morphio::Morphology& morphology,
+               const py::object& rotation,
+               const py::object& translation,
+               unsigned int n_threads) {
+                const auto transform = make_transform(rotation, translation);
+                MorphologyHits hits;
+                {
+                    py::gil_scoped_release release;
+                    hits = index.nearest(morphology, transform, n_threads);
+                }
+                return morphology_arrays(morphology, std::move(hits), true);
+            },
+            "morphology"_a,
+            "rotation"_a = py::none(),
+            "translation"_a = py::none(),
+            "n_threads"_a = 0,
+            R"(Nearest vessel segment of the soma and of every neurite segment of the morphology,
+placed by the (3, 3) rotation and the translation.
+
+Returns (query_sections, query_segments, sections, segments, distances): the soma, if it has
+points, is the first query with the section and segment -1.)")
+        .def(
+            "nearest",
+            [](const ProximityIndex& index,
+               const py::array_t<morphio::floatType>& points,
+               unsigned int n_threads) {
+                const auto queries = array_to_points(points);
+                std::vector<std::vector<SegmentHit>> hits;
+                {
+                    py::gil_scoped_release release;
+                    hits = index.nearest(queries, n_threads);
+                }
+                return nearest_arrays(hits);
+            },
+            "points"_a,
+            "n_threads"_a = 0,
+            R"(Nearest vessel segment of every point of a (N, 3) array.
+
+Returns (sections, segments, distances); -1, -1 and inf if the index is empty.)")
+        .def(
+            "within",
+            [](const ProximityIndex& index,
+               const morphio::Morphology& morphology,
+               morphio::floatType radius,
+               const py::object& rotation,
+               const py::object& translation,
+               unsigned int n_threads) {
+                const auto transform = make_transform(rotation, translation);
+                MorphologyHits hits;
+                {
+                    py::gil_scoped_release release;
+                    hits = index.within(morphology, radius, transform, n_threads);
+                }
+                return morphology_arrays(morphology, std::move(hits), false);
+            },
+            "morphology"_a,
+            "radius"_a,
+            "rotation"_a = py::none(),
+            "translation"_a = py::none(),
+            "n_threads"_a = 0,
+            R"(Vessel segments within radius of the soma and of every neurite segment of the
+morphology, placed by the (3, 3) rotation and the translation.
+
+Returns (query_sections, query_segments, offsets, sections, segments, distances): the hits of the
+query i are in [offsets[i], offsets[i + 1]), sorted by distance; the soma, if it has points, is
+the first query with the section and segment -1.)")
+        .def(
+            "within",
+            [](const ProximityIndex& index,
+               const py::array_t<morphio::floatType>& points,
+               morphio::floatType radius,
+               unsigned int n_threads) {
+                const auto queries = array_to_points(points);
+                std::vector<std::vector<SegmentHit>> hits;
+                {
+                    py::gil_scoped_release release;
+                    hits = index.within(queries, radius, n_threads);
+                }
+                return within_arrays(hits);
+            },
+            "points"_a,
+            "radius"_a,
+            "n_threads"_a = 0,
+            R"(Vessel segments within radius of every point of a (N, 3) array.
+
+Returns (offsets, sections, segments, distances): the hits of the point i are in
+[offsets[i], offsets[i + 1]), sorted by distance.)");
 }
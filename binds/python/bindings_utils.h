@@ -66,3 +66,19 @@ inline py::array_t<typename Sequence::value_type> as_pyarray(Sequence&& seq) {
                      capsule           // numpy array references this parent
     );
 }
+
+/**
+ * @brief "Casts" a vector of fixed-size arrays to a 2D python array (no memory copies)
+ *
+ * A vector of N std::array<T, M> becomes an array of shape (N, M).
+ */
+template <typename T, size_t M>
+inline py::array_t<T> as_pyarray_of_arrays(std::vector<std::array<T, M>>&& seq) {
+    using Sequence = std::vector<std::array<T, M>>;
+    Sequence* seq_ptr = new Sequence(std::move(seq));
+    auto capsule = py::capsule(seq_ptr, [](void* p) { delete reinterpret_cast<Sequence*>(p); });
+
+    return py::array_t<T>({static_cast<py::ssize_t>(seq_ptr->size()), static_cast<py::ssize_t>(M)},
+                          reinterpret_cast<const T*>(seq_ptr->data()),
+                          capsule);
+}
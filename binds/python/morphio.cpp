@@ -8,6 +8,7 @@
 #include "bind_immutable.h"
 #include "bind_misc.h"
 #include "bind_mutable.h"
+#include "bind_tools.h"
 #include "bind_vasculature.h"
 #include "bind_warnings_exceptions.h"
 
@@ -20,12 +21,20 @@ namespace py = pybind11;
 #pragma clang diagnostic ignored "-Wunsafe-buffer-usage"
 #endif
 
+// The bindings hold no global Python state, and the C++ state shared between threads (the default
+// warning handler, the HDF5 library) is guarded by mutexes: declare the module usable without the
+// GIL, so that it does not get re-enabled when imported by a free-threaded interpreter.
+#if PYBIND11_VERSION_HEX >= 0x020D0000
+PYBIND11_MODULE(_morphio, m, py::mod_gil_not_used()) {
+#else
 PYBIND11_MODULE(_morphio, m) {
+#endif
     bind_enums(m);
     bind_warnings_exceptions(m);
     bind_misc(m);
 
     bind_immutable(m);
+    bind_tools(m);
 
     py::module mut_module = m.def_submodule("mut");
     bind_mutable(mut_module);
@@ -0,0 +1,90 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <morphio/morphology.h>
+
+namespace morphio {
+/**
+ * Columnar export/import of a population of morphologies as Apache Arrow IPC data.
+ *
+ * A population is stored as three tables, usable as-is by pandas, polars, duckdb...:
+ *  - `morphologies`: one row per morphology
+ *      name (utf8), cell_family (int32), soma_type (int32), format (utf8),
+ *      version_major (int32), version_minor (int32), has_perimeters (bool),
+ *      section_offset (int64), point_offset (int64), soma_point_count (int32)
+ *  - `sections`: one row per section
+ *      morphology (int32), section (int32), parent (int32), type (int32),
+ *      point_offset (int64, first point of the section among the neurite points of its
+ *      morphology, as in Morphology::sectionOffsets())
+ *  - `points`: one row per point, the soma points of a morphology followed by its neurite points
+ *      morphology (int32), section (int32, -1 for the soma), x, y, z, diameter, perimeter
+ *      (floating point columns, float32 or float64 as morphio::floatType)
+ *
+ * `section_offset` and `point_offset` of the `morphologies` table are the first row of the
+ * morphology in the other two tables.
+ *
+ * The IPC format is implemented directly from the Arrow specification: only non-nullable,
+ * uncompressed and non-dictionary encoded int, floating point, bool and (large) utf8 columns
+ * are supported, which covers what is written here and what Arrow libraries write by default
+ * for such tables. Organelles, annotations and markers are not exported.
+ */
+namespace arrow {
+
+/** The Arrow IPC flavour */
+enum Format {
+    IPC_STREAM,  //!< the streaming format (`pyarrow.ipc.open_stream`)
+    IPC_FILE     //!< the random access file format, with its footer (`pyarrow.ipc.open_file`)
+};
+
+/** The tables of a population */
+enum Table { MORPHOLOGIES, SECTIONS, POINTS };
+
+/** Morphologies with their names, as stored in the tables */
+struct Population {
+    std::vector<std::string> names;
+    std::vector<Morphology> morphologies;
+};
+
+/** Return the name of the table: its file name, without the `.arrow` extension */
+std::string tableName(Table table);
+
+/**
+ * Serialize one table of the population.
+ *
+ * @throw MorphioError if `names` and `morphologies` do not have the same size
+ */
+std::string serialize(Table table,
+                      const std::vector<std::string>& names,
+                      const std::vector<Morphology>& morphologies,
+                      Format format = IPC_FILE);
+
+/** Write the three tables in `directory` as `morphologies.arrow`, `sections.arrow`
+ * and `points.arrow` */
+void write(const std::string& directory,
+           const std::vector<std::string>& names,
+           const std::vector<Morphology>& morphologies,
+           Format format = IPC_FILE);
+
+/**
+ * Rebuild the population from the contents of its three tables, in either format.
+ *
+ * Columns with the layout written by `serialize` (same widths) are copied straight from the IPC
+ * bodies into the morphology properties; other int and floating point widths are converted.
+ *
+ * @throw RawDataError if the data is not valid Arrow IPC or if a column is missing
+ */
+Population deserialize(const std::string& morphologies,
+                       const std::string& sections,
+                       const std::string& points);
+
+/** Read the population written by `write` in `directory` */
+Population read(const std::string& directory);
+
+}  // namespace arrow
+}  // namespace morphio
@@ -0,0 +1,109 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+
+/** Axis aligned bounding box */
+struct BoundingBox {
+    Point min{};
+    Point max{};
+};
+
+/** Bounding box aligned with the principal axes of the points it encloses */
+struct OrientedBoundingBox {
+    Point center{};
+    /** Unit principal axes, by decreasing variance of the points along them */
+    std::array<Point, 3> axes{};
+    /** Half of the size of the box along each of the axes */
+    Point halfExtents{};
+
+    floatType volume() const noexcept {
+        return 8 * halfExtents[0] * halfExtents[1] * halfExtents[2];
+    }
+};
+
+/** Convex hull of a set of points */
+struct ConvexHull {
+    /** Points of the set that are vertices of the hull */
+    Points vertices;
+    floatType volume = 0;
+    /** Surface area; a flat hull counts both of its sides */
+    floatType area = 0;
+};
+
+/** The bounding volumes of a set of points */
+struct Bounds {
+    BoundingBox boundingBox;
+    OrientedBoundingBox orientedBoundingBox;
+    ConvexHull convexHull;
+};
+
+/**
+ * Bounding volumes of the neurites of a morphology.
+ *
+ * All the volumes are computed once, at construction, from `Morphology::points()` and
+ * `Morphology::sectionTypes()`: the soma is not taken into account. Per neurite hulls are
+ * reused to get the volumes of groups of neurites, so querying them is free. Use `cached()`
+ * to compute them only once per morphology.
+ */
+class BoundingVolumes
+{
+  public:
+    /**
+     * Compute the bounding volumes of all neurites.
+     *
+     * \param nThreads number of threads used to process the neurites, 0 means one per
+     *        hardware thread
+     */
+    explicit BoundingVolumes(const Morphology& morphology, unsigned int nThreads = 0);
+
+    /**
+     * The bounding volumes of `morphology`, computed on the first call for it.
+     *
+     * Copies of a Morphology share their data, and so their volumes. The volumes are kept
+     * as long as the data of the morphology is alive. Thread safe.
+     */
+    static std::shared_ptr<const BoundingVolumes> cached(const Morphology& morphology,
+                                                         unsigned int nThreads = 0);
+
+    /** Volumes enclosing all the neurites; empty if there are none */
+    const Bounds& morphology() const noexcept {
+        return morphology_;
+    }
+
+    /** Volumes of each neurite, in root section order */
+    const std::vector<Bounds>& neurites() const noexcept {
+        return neurites_;
+    }
+
+    /** Type of each neurite, in root section order */
+    const std::vector<SectionType>& neuriteTypes() const noexcept {
+        return neuriteTypes_;
+    }
+
+    /**
+     * Volumes enclosing all the neurites of the given type
+     *
+     * Throws MorphioError if there is no neurite of this type.
+     */
+    const Bounds& neuriteType(SectionType type) const;
+
+  private:
+    std::vector<SectionType> neuriteTypes_;
+    std::vector<Bounds> neurites_;
+    std::map<SectionType, Bounds> byType_;
+    Bounds morphology_;
+};
+
+}  // namespace morphio
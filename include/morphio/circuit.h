@@ -0,0 +1,151 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t, uint64_t
+#include <list>
+#include <memory>  // std::shared_ptr
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <morphio/bounding_volumes.h>
+#include <morphio/collection.h>
+#include <morphio/types.h>
+#include <morphio/vasc/proximity.h>
+
+namespace morphio {
+/**
+ * Circuits: morphologies of a collection placed in space, queried together.
+ **/
+namespace circuit {
+
+/** A cell of a circuit: the morphology `morphology` of the collection, placed by `transform` */
+struct Cell {
+    std::string morphology;
+    Transform transform;
+};
+
+/** A neurite segment of a cell close to a query */
+struct SegmentHit {
+    /** Index of the cell */
+    uint64_t cell;
+    /** Section of the morphology of the cell */
+    uint32_t section;
+    /** Segment of the section: between its points `segment` and `segment + 1` */
+    uint32_t segment;
+    /** Distance between the query and the surface of the segment (0 if it is inside) */
+    floatType distance;
+};
+
+/** Default number of cells whose segment index is kept in memory */
+constexpr size_t DEFAULT_MAX_RESIDENT_CELLS = 1024;
+
+/**
+ * Two-level spatial index over the neurite segments of the cells of a circuit
+ *
+ * The top level is a bounding volume hierarchy over the bounding boxes of the cells, the bottom
+ * level one `vasculature::ProximityIndex` per cell over its placed segments. Building the index
+ * loads every morphology once, in parallel and in the order suggested by the collection, but
+ * only keeps its bounding box; the index of a cell is built when a query first reaches its box,
+ * loading the morphology again. At most `maxResidentCells` cell indexes are kept, the least
+ * recently used ones being dropped first, so that circuits of millions of cells are queried
+ * without all their geometry in memory. The soma is not indexed.
+ *
+ * The index can be queried from several threads. Bulk queries run in parallel; `nThreads` = 0
+ * means one thread per hardware thread.
+ */
+class SpatialIndex
+{
+  public:
+    /**
+     * Index `cells`, whose morphologies are loaded from `collection` with `options`
+     *
+     * @throw MorphioError if there are more than 2^32 cells
+     */
+    SpatialIndex(Collection collection,
+                 std::vector<Cell> cells,
+                 size_t maxResidentCells = DEFAULT_MAX_RESIDENT_CELLS,
+                 unsigned int options = NO_MODIFIER,
+                 unsigned int nThreads = 0);
+
+    /** Number of cells */
+    size_t size() const noexcept {
+        return cells_.size();
+    }
+
+    /**
+     * Bounding box of the placed segments of the cell `cell`, including their radii; inverted
+     * (min > max) if the cell has no segments
+     */
+    const BoundingBox& cellBox(size_t cell) const {
+        return boxes_.at(cell);
+    }
+
+    /** Number of cells whose segment index is in memory */
+    size_t residentCells() const;
+
+    /**
+     * The segments whose axis has a point in the box `box`, sorted by cell, section and
+     * segment; their distance is 0
+     */
+    std::vector<SegmentHit> inBox(const BoundingBox& box) const;
+
+    /** The segments within `radius` of `center`, sorted by distance */
+    std::vector<SegmentHit> inSphere(const Point& center, floatType radius) const;
+
+    /** The `k` nearest segments of `point`, sorted by distance */
+    std::vector<SegmentHit> nearest(const Point& point, size_t k) const;
+
+    std::vector<std::vector<SegmentHit>> inBox(const std::vector<BoundingBox>& boxes,
+                                               unsigned int nThreads = 0) const;
+
+    std::vector<std::vector<SegmentHit>> inSphere(const Points& centers,
+                                                  floatType radius,
+                                                  unsigned int nThreads = 0) const;
+
+    std::vector<std::vector<SegmentHit>> nearest(const Points& points,
+                                                 size_t k,
+                                                 unsigned int nThreads = 0) const;
+
+  private:
+    struct Node {
+        Point min;
+        Point max;
+        /** Leaf: first cell of `order_` and count; inner node: first child (second one follows) */
+        uint32_t first;
+        uint32_t count;
+    };
+
+    struct Resident {
+        std::shared_ptr<const vasculature::ProximityIndex> index;
+        /** Position of the cell in `recentlyUsed_` */
+        std::list<uint32_t>::iterator use;
+    };
+
+    void build();
+    /** The segment index of the cell, built if it is not in memory */
+    std::shared_ptr<const vasculature::ProximityIndex> cellIndex(uint32_t cell) const;
+    /** Call `f(cell)` for every cell whose box is at most `distance` away from [min, max] */
+    template <typename F>
+    void forEachCell(const Point& min, const Point& max, floatType distance, const F& f) const;
+
+    Collection collection_;
+    std::vector<Cell> cells_;
+    unsigned int options_;
+    std::vector<BoundingBox> boxes_;
+    std::vector<uint32_t> order_;
+    std::vector<Node> nodes_;
+
+    size_t maxResidentCells_;
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<uint32_t, Resident> resident_;
+    /** The resident cells, the most recently used first */
+    mutable std::list<uint32_t> recentlyUsed_;
+};
+
+}  // namespace circuit
+}  // namespace morphio
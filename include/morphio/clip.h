@@ -0,0 +1,71 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Clipping: keeping the parts of a morphology inside a region, as in slice experiments.
+ *
+ * Sections crossing the boundary of the region are cut where they cross it, with interpolated
+ * end points, diameters and perimeters; the parts outside are dropped. The regions are convex,
+ * so every segment is clipped against their planes independently, in one pass over the points.
+ **/
+namespace clip {
+
+/** Axis aligned box, from its `min` to its `max` corner */
+struct Box {
+    Point min;
+    Point max;
+};
+
+/** Half-space on the side of the plane through `point` that `normal` points to */
+struct Plane {
+    Point point;
+    Point normal;
+};
+
+/** The points of a `plane` half-space at most `thickness` away from the plane */
+struct Slab {
+    Plane plane;
+    floatType thickness;
+};
+
+/**
+ * A clipped morphology, with the mapping to the original one
+ *
+ * A section of the original morphology becomes one clipped section for every part of it inside
+ * the region. A part starting at the first point of its original section keeps its parent if
+ * the end of the parent is kept; the other parts become root sections. The soma is kept if its
+ * center is inside the region. Mitochondria, endoplasmic reticulum, annotations and markers are
+ * not kept.
+ */
+struct Clipped {
+    Morphology morphology;
+    /** For every clipped section, the section of the original morphology it is part of */
+    std::vector<uint32_t> sections;
+    /**
+     * For every point of the clipped morphology, its position in its original section, in
+     * points: `i + t` is at fraction `t` of the segment from point `i` to point `i + 1`
+     */
+    std::vector<floatType> offsets;
+};
+
+/**
+ * The parts of `morphology` inside `region`
+ *
+ * \param nThreads number of threads over the sections, 0 means one per hardware thread
+ */
+Clipped clip(const Morphology& morphology, const Box& region, unsigned int nThreads = 0);
+Clipped clip(const Morphology& morphology, const Plane& region, unsigned int nThreads = 0);
+Clipped clip(const Morphology& morphology, const Slab& region, unsigned int nThreads = 0);
+
+}  // namespace clip
+}  // namespace morphio
@@ -0,0 +1,70 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint64_t
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Randomized clones of an exemplar morphology, as used when building circuits: the clones are
+ * scaled, their sections stretched and bent, and their subtrees rotated around the parent
+ * sections.
+ *
+ * The random numbers are drawn from a counter-based generator keyed by (seed, clone, section),
+ * so that a clone only depends on its seed and index, not on the number of threads or the other
+ * clones generated in the same batch.
+ **/
+namespace clones {
+
+/**
+ * The random transformations; all of them default to none
+ *
+ * Scaling factors are log-normal: exp(sigma * N(0, 1)), so that they are always positive.
+ */
+struct CloneParameters {
+    /** Sigma of the scaling factor of the whole morphology, around its soma center */
+    floatType scaleSigma = 0;
+    /** Sigma of the scaling factor of the length of every section */
+    floatType lengthSigma = 0;
+    /**
+     * Standard deviation (radians) of the angle by which every section is bent, around a random
+     * axis through its first point
+     */
+    floatType angleSigma = 0;
+    /**
+     * Every subtree is rotated around the last segment of its parent section (for neurites, the
+     * direction from the soma center) by an angle uniform in [-subtreeRotation, subtreeRotation]
+     */
+    floatType subtreeRotation = 0;
+};
+
+/**
+ * Clone number `index` of the morphology, for the given `seed`
+ *
+ * Point coordinates are transformed, diameters, perimeters, topology and organelles are kept.
+ * The transformations of a section apply to the whole subtree it starts.
+ */
+Morphology clone(const Morphology& morphology,
+                 const CloneParameters& parameters,
+                 uint64_t seed,
+                 uint64_t index = 0);
+
+/**
+ * The clones number `firstIndex` to `firstIndex + count - 1`, generated with `nThreads` threads
+ * (0 means one per hardware thread)
+ */
+std::vector<Morphology> clones(const Morphology& morphology,
+                               const CloneParameters& parameters,
+                               size_t count,
+                               uint64_t seed,
+                               uint64_t firstIndex = 0,
+                               unsigned int nThreads = 0);
+
+}  // namespace clones
+}  // namespace morphio
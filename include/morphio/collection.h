@@ -4,12 +4,21 @@
  */
 #pragma once
 
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include <morphio/dendritic_spine.h>
+#include <morphio/glial_cell.h>
 #include <morphio/morphology.h>
 #include <morphio/mut/morphology.h>
 
+#ifdef MORPHIO_ENABLE_MPI
+#include <mpi.h>
+#endif
+
 namespace morphio {
 
 class CollectionImpl;
@@ -29,11 +38,122 @@ struct enable_if_immutable: public std::enable_if<std::is_same<T, Morphology>::v
 template <class T, class U = void>
 struct enable_if_mutable: public std::enable_if<std::is_same<T, mut::Morphology>::value, U> {};
 
+/**
+ * Enable if `T` is an immutable morphology of a specific kind of cell.
+ */
+template <class T, class U = void>
+struct enable_if_cell
+    : public std::enable_if<std::is_same<T, GlialCell>::value ||
+                                std::is_same<T, DendriticSpine>::value,
+                            U> {};
+
+/**
+ * The raw contents of a morphology file.
+ */
+struct MorphologyBytes {
+    /** The bytes of the file, as they would be stored on disk. */
+    std::string contents;
+
+    /** The format of `contents`: "h5", "asc" or "swc" (a leading dot is ignored). */
+    std::string extension;
+};
+
+/**
+ * A storage from which a `Collection` reads its morphologies.
+ *
+ * Implementing `get` is enough to back a collection with any storage (a local
+ * key-value store, a memory map, a cache in front of a parallel filesystem,
+ * ...) without writing temporary files. The other methods can be overridden
+ * when the storage supports batched or asynchronous reads.
+ *
+ * A `ByteSource` may be called from several threads at once.
+ */
+class ByteSource
+{
+  public:
+    virtual ~ByteSource() = default;
+
+    /**
+     * Return the morphology `morph_name`.
+     *
+     * Throws if there is no such morphology.
+     */
+    virtual MorphologyBytes get(const std::string& morph_name) const = 0;
+
+    /**
+     * Return the morphologies `morph_names`, in the same order.
+     *
+     * The default calls `get` for every name.
+     */
+    virtual std::vector<MorphologyBytes> get_batch(
+        const std::vector<std::string>& morph_names) const;
+
+    /**
+     * Start reading the morphologies `morph_names`.
+     *
+     * `Collection::load_unordered` uses it to fetch the next batch while the
+     * current one is being parsed. The default defers `get_batch` until the
+     * result is requested, i.e. there is no prefetching.
+     */
+    virtual std::future<std::vector<MorphologyBytes>> get_async(
+        std::vector<std::string> morph_names) const;
+
+    /**
+     * Returns the suggested order in which to read `morphology_names`.
+     *
+     * The default keeps the original order.
+     */
+    virtual std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const;
+};
+
+/**
+ * The names of the morphologies a `Collection` loaded, in order.
+ *
+ * Recording is thread-safe. A trace is typically saved at the end of every
+ * job; `layout::reorderContainer` then lays a container out after the traces
+ * of many jobs.
+ */
+class AccessTrace
+{
+  public:
+    /** Append `morph_name` to the trace */
+    void record(const std::string& morph_name);
+
+    /** The names recorded so far */
+    std::vector<std::string> names() const;
+
+    /** Forget the names recorded so far */
+    void clear();
+
+    /**
+     * Write the names recorded so far to `path`, one per line.
+     *
+     * Throws `WriterError` if the file can't be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * Read the names of a trace written by `save`.
+     *
+     * Throws `MorphioError` if the file can't be read.
+     */
+    static std::vector<std::string> read(const std::string& path);
+
+  private:
+    mutable std::mutex _mutex;
+    std::vector<std::string> _names;
+};
+
 class Collection
 {
   public:
     Collection(std::shared_ptr<CollectionImpl> collection);
 
+    /**
+     * Create a collection reading its morphologies from `source`.
+     */
+    Collection(std::shared_ptr<ByteSource> source);
+
     /**
      * Create a collection from the given path.
      *
@@ -49,6 +169,16 @@ class Collection
                std::vector<std::string> extensions =
                    std::vector<std::string>{".h5", ".H5", ".asc", ".ASC", ".swc", ".SWC"});
 
+#ifdef MORPHIO_ENABLE_MPI
+    /**
+     * Open the HDF5 container `collection_path` with the MPI-IO driver.
+     *
+     * Collective over `comm`: every rank must open the collection, and later
+     * close or destroy it, together.
+     */
+    Collection(const std::string& collection_path, MPI_Comm comm);
+#endif
+
     /**
      * Load the morphology as an immutable morphology.
      */
@@ -67,6 +197,17 @@ class Collection
         unsigned int options = NO_MODIFIER,
         std::shared_ptr<WarningHandler> warning_handler = nullptr) const;
 
+    /**
+     * Load the morphology as a `GlialCell` or a `DendriticSpine`.
+     *
+     * Throws `RawDataError` if the morphology is of another cell family.
+     */
+    template <class M>
+    typename enable_if_cell<M, M>::type load(
+        const std::string& morph_name,
+        unsigned int options = NO_MODIFIER,
+        std::shared_ptr<WarningHandler> warning_handler = nullptr) const;
+
     /**
      * Returns an iterable of loop index, morphology pairs.
      *
@@ -88,6 +229,42 @@ class Collection
      */
     std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const;
 
+#ifdef MORPHIO_ENABLE_MPI
+    /**
+     * Load the share of `morphology_names` of this rank, as pairs of loop index
+     * and morphology.
+     *
+     * The morphologies are sorted by their position in the container and split
+     * into contiguous shares of about the same number of bytes, one per rank.
+     * The bulk of a share (points, structure and perimeters) is fetched with
+     * collective MPI-IO reads of the coalesced byte ranges it spans, which lets
+     * MPI-IO aggregate the requests of all ranks, and then parsed from memory.
+     *
+     * Collective: every rank of the communicator of the collection must call it
+     * with the same `morphology_names`. Only collections opened with a
+     * communicator support it.
+     *
+     * Note: This API is 'experimental', meaning it might change in the future.
+     */
+    template <class M>
+    std::vector<std::pair<size_t, M>> load_share(
+        const std::vector<std::string>& morphology_names,
+        unsigned int options = NO_MODIFIER,
+        std::shared_ptr<WarningHandler> warning_handler = nullptr) const;
+#endif
+
+    /**
+     * Record the names of the morphologies loaded from now on into `trace`.
+     *
+     * Copies of the collection made afterwards, e.g. the one kept by
+     * `load_unordered`, record into the same trace. Pass `nullptr` to stop
+     * recording.
+     */
+    void record_accesses(std::shared_ptr<AccessTrace> trace);
+
+    /** The trace the collection records into, or `nullptr` */
+    std::shared_ptr<AccessTrace> access_trace() const;
+
     /**
      * Close the collection.
      *
@@ -103,6 +280,7 @@ class Collection
 
   private:
     std::shared_ptr<CollectionImpl> _collection;
+    std::shared_ptr<AccessTrace> _access_trace;
 };
 
 class LoadUnorderedImpl;
@@ -154,6 +332,9 @@ class LoadUnordered
         template <class U = M>
         typename enable_if_mutable<U, std::pair<size_t, M>>::type operator*() const;
 
+        template <class U = M>
+        typename enable_if_cell<U, std::pair<size_t, M>>::type operator*() const;
+
         Iterator& operator++();
         Iterator operator++(int);
 
@@ -177,9 +358,13 @@ class LoadUnordered
 
 extern template class LoadUnordered<Morphology>;
 extern template class LoadUnordered<mut::Morphology>;
+extern template class LoadUnordered<GlialCell>;
+extern template class LoadUnordered<DendriticSpine>;
 
 extern template class LoadUnordered<Morphology>::Iterator;
 extern template class LoadUnordered<mut::Morphology>::Iterator;
+extern template class LoadUnordered<GlialCell>::Iterator;
+extern template class LoadUnordered<DendriticSpine>::Iterator;
 
 extern template typename enable_if_immutable<Morphology, std::pair<size_t, Morphology>>::type
     LoadUnordered<Morphology>::Iterator::operator*<Morphology>() const;
@@ -188,6 +373,12 @@ extern template
     typename enable_if_mutable<mut::Morphology, std::pair<size_t, mut::Morphology>>::type
         LoadUnordered<mut::Morphology>::Iterator::operator*<mut::Morphology>() const;
 
+extern template typename enable_if_cell<GlialCell, std::pair<size_t, GlialCell>>::type
+    LoadUnordered<GlialCell>::Iterator::operator*<GlialCell>() const;
+
+extern template typename enable_if_cell<DendriticSpine, std::pair<size_t, DendriticSpine>>::type
+    LoadUnordered<DendriticSpine>::Iterator::operator*<DendriticSpine>() const;
+
 extern template typename enable_if_mutable<mut::Morphology, mut::Morphology>::type
 Collection::load<mut::Morphology>(const std::string& morph_name,
                                   unsigned int options,
@@ -198,6 +389,16 @@ Collection::load<Morphology>(const std::string& morph_name,
                              unsigned int options,
                              std::shared_ptr<WarningHandler> warning_handler) const;
 
+extern template typename enable_if_cell<GlialCell, GlialCell>::type Collection::load<GlialCell>(
+    const std::string& morph_name,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+extern template typename enable_if_cell<DendriticSpine, DendriticSpine>::type
+Collection::load<DendriticSpine>(const std::string& morph_name,
+                                 unsigned int options,
+                                 std::shared_ptr<WarningHandler> warning_handler) const;
+
 extern template LoadUnordered<Morphology> Collection::load_unordered<Morphology>(
     std::vector<std::string> morphology_names,
     unsigned int options,
@@ -208,4 +409,36 @@ extern template LoadUnordered<mut::Morphology> Collection::load_unordered<mut::M
     unsigned int options,
     std::shared_ptr<WarningHandler> warning_handler) const;
 
+extern template LoadUnordered<GlialCell> Collection::load_unordered<GlialCell>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+extern template LoadUnordered<DendriticSpine> Collection::load_unordered<DendriticSpine>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+#ifdef MORPHIO_ENABLE_MPI
+extern template std::vector<std::pair<size_t, Morphology>> Collection::load_share<Morphology>(
+    const std::vector<std::string>& morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+extern template std::vector<std::pair<size_t, mut::Morphology>>
+Collection::load_share<mut::Morphology>(const std::vector<std::string>& morphology_names,
+                                        unsigned int options,
+                                        std::shared_ptr<WarningHandler> warning_handler) const;
+
+extern template std::vector<std::pair<size_t, GlialCell>> Collection::load_share<GlialCell>(
+    const std::vector<std::string>& morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+extern template std::vector<std::pair<size_t, DendriticSpine>>
+Collection::load_share<DendriticSpine>(const std::vector<std::string>& morphology_names,
+                                       unsigned int options,
+                                       std::shared_ptr<WarningHandler> warning_handler) const;
+#endif
+
 }  // namespace morphio
@@ -0,0 +1,93 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // int32_t
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Discretisation of morphologies into compartment trees, numbered for the Hines tridiagonal
+ * solver of the cable equation.
+ **/
+namespace compartments {
+
+/** How the nodes of several cells are numbered */
+enum Ordering {
+    /** Cells one after the other, each one numbered depth first */
+    CONCATENATED,
+    /**
+     * Cells grouped by `groupSize`; in a group, the nodes are sorted by level (number of nodes
+     * to the root) and, in a level, the cells contribute their nodes in turn, as CoreNEURON's
+     * interleaved permutation: consecutive nodes of a level belong to different cells and can
+     * be processed in SIMD lanes.
+     */
+    INTERLEAVED
+};
+
+struct CompartmentOptions {
+    /** Maximum length of a compartment; 0 means one compartment per section */
+    floatType maxLength = 0;
+    /** Add the soma as the root node of each cell (if the soma has points) */
+    bool withSoma = true;
+    Ordering ordering = CONCATENATED;
+    /** Number of cells interleaved together, for INTERLEAVED */
+    unsigned int groupSize = 32;
+    /** Number of threads used to discretise the cells, 0 means one per hardware thread */
+    unsigned int nThreads = 0;
+};
+
+/**
+ * A forest of compartments, one tree per cell.
+ *
+ * Nodes are in Hines order: the parent of a node always has a smaller index, so the
+ * triangularisation can run from the last node to the first one and the back substitution in
+ * the other direction. Each node is at the center of its compartment; the compartments of a
+ * section have the same length.
+ */
+struct CompartmentTree {
+    /** Parent node of every node, -1 for the root of a cell */
+    std::vector<int32_t> parents;
+    /** Cell (index in the input morphologies) of every node */
+    std::vector<int32_t> cells;
+    /** Section of every node, -1 for the soma */
+    std::vector<int32_t> sections;
+    /** Index of every node in the depth first numbering of its own cell */
+    std::vector<int32_t> cellNodes;
+
+    /** Position of every node */
+    Points centers;
+    /** Diameter at the position of every node */
+    std::vector<floatType> diameters;
+    /** Membrane area of every compartment (lateral area of its frustums; soma: its surface) */
+    std::vector<floatType> areas;
+    /**
+     * Axial resistance factor between every node and its parent: the integral of 1 / (pi r^2)
+     * along the path between them (0 for roots). Multiplied by the axial resistivity, it gives
+     * the axial resistance. A zero diameter on the path gives an infinite factor.
+     */
+    std::vector<floatType> axialResistanceFactors;
+
+    /** Number of nodes */
+    size_t size() const noexcept {
+        return parents.size();
+    }
+};
+
+/** Discretise one morphology, numbered depth first from the soma */
+CompartmentTree compartmentalize(const Morphology& morphology,
+                                 const CompartmentOptions& options = CompartmentOptions());
+
+/**
+ * Discretise several morphologies, in parallel, into one forest ordered as `options.ordering`.
+ */
+CompartmentTree compartmentalize(const std::vector<Morphology>& morphologies,
+                                 const CompartmentOptions& options = CompartmentOptions());
+
+}  // namespace compartments
+}  // namespace morphio
@@ -0,0 +1,142 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // int32_t, uint32_t
+#include <list>
+#include <memory>  // std::shared_ptr
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>  // std::pair
+#include <vector>
+
+#include <morphio/collection.h>
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Storage of morphology variants (repaired, unravelled, scaled, cloned, ...) as deltas against a
+ * base morphology: the sections a variant shares verbatim with its base are stored as references
+ * to the base sections.
+ **/
+namespace delta {
+
+/**
+ * The difference between a variant and its base
+ *
+ * The topology of the variant (parent and type of every section) is always stored; the points
+ * of a section are stored only when no section of the base has the same points, diameters and
+ * perimeters. Organelles are not supported.
+ */
+struct MorphologyDelta {
+    /** Name of the base morphology */
+    std::string base;
+
+    CellFamily cellFamily = CellFamily::NEURON;
+    SomaType somaType = SOMA_UNDEFINED;
+    /** The version of the variant */
+    std::tuple<std::string, uint32_t, uint32_t> version;
+
+    /** Whether the soma differs from the base one; if so, the points below replace it */
+    bool somaChanged = false;
+    Points somaPoints;
+    std::vector<floatType> somaDiameters;
+
+    /** Base section copied by every section of the variant, -1 if its points are stored */
+    std::vector<int32_t> baseSections;
+    /** Parent of every section of the variant, -1 for root sections */
+    std::vector<int32_t> parents;
+    std::vector<SectionType> types;
+
+    /**
+     * Whether the variant has perimeters; the sections copied from the base take theirs from
+     * it, which must then have perimeters too
+     */
+    bool hasPerimeters = false;
+    /** Points of the stored sections, one after the other */
+    Points points;
+    std::vector<floatType> diameters;
+    /** Empty if the variant has no perimeters, one per point otherwise */
+    std::vector<floatType> perimeters;
+    /** Offset of every stored section in `points`, followed by the number of points */
+    std::vector<uint64_t> offsets;
+
+    /** Number of sections of the variant */
+    size_t size() const noexcept {
+        return parents.size();
+    }
+};
+
+/**
+ * The delta turning `base` into `variant`
+ *
+ * @throw MorphioError if the variant has mitochondria or an endoplasmic reticulum
+ */
+MorphologyDelta diff(const Morphology& base,
+                     const Morphology& variant,
+                     const std::string& baseName = "");
+
+/**
+ * Rebuild the variant from its base
+ *
+ * @throw RawDataError if the delta does not match the base
+ */
+Morphology apply(const Morphology& base, const MorphologyDelta& delta);
+
+/** Binary representation of a delta, the contents of a `.delta` file */
+std::string serialize(const MorphologyDelta& delta);
+
+/** @throw RawDataError if `contents` is not a serialized delta */
+MorphologyDelta deserialize(const std::string& contents);
+
+/** Write the delta to a `.delta` file */
+void write(const MorphologyDelta& delta, const std::string& filename);
+
+/** @throw RawDataError if the file can not be read */
+MorphologyDelta read(const std::string& filename);
+
+/**
+ * A collection of variants stored as deltas, with their bases in another collection.
+ *
+ * The deltas are read from a directory of `<name>.delta` files, or from a `ByteSource` returning
+ * their serialized contents. The most recently used bases are kept in memory, so that loading
+ * the variants of a cell one after the other parses its base once.
+ *
+ * `load` can be called from several threads at once.
+ */
+class VariantCollection
+{
+  public:
+    /** \param cacheSize number of bases kept in memory (at least 1) */
+    VariantCollection(Collection bases, const std::string& directory, size_t cacheSize = 16);
+
+    VariantCollection(Collection bases,
+                      std::shared_ptr<ByteSource> deltas,
+                      size_t cacheSize = 16);
+
+    /** Load the variant `name` */
+    Morphology load(const std::string& name) const;
+
+    /** Load the base `name`, from the cache if it is there */
+    Morphology base(const std::string& name) const;
+
+  private:
+    Collection _bases;
+    std::shared_ptr<ByteSource> _deltas;
+    size_t _cacheSize;
+
+    // least recently used bases at the back
+    mutable std::mutex _mutex;
+    mutable std::list<std::pair<std::string, Morphology>> _cache;
+    mutable std::unordered_map<std::string,
+                               std::list<std::pair<std::string, Morphology>>::iterator>
+        _cacheIndex;
+};
+
+}  // namespace delta
+}  // namespace morphio
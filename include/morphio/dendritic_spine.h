@@ -17,7 +17,20 @@ namespace morphio {
 class DendriticSpine: public Morphology
 {
   public:
-    explicit DendriticSpine(const std::string& source);
+    explicit DendriticSpine(const std::string& source,
+                            unsigned int options = NO_MODIFIER,
+                            std::shared_ptr<WarningHandler> warning_handler = nullptr);
+
+    /** Constructor from an already opened HDF5 group, e.g. in a container */
+    explicit DendriticSpine(const HighFive::Group& group,
+                            unsigned int options = NO_MODIFIER,
+                            std::shared_ptr<WarningHandler> warning_handler = nullptr);
+
+    /** Load a dendritic spine from a string */
+    explicit DendriticSpine(const std::string& contents,
+                            const std::string& extension,
+                            unsigned int options = NO_MODIFIER,
+                            std::shared_ptr<WarningHandler> warning_handler = nullptr);
 
     const std::vector<Property::DendriticSpine::PostSynapticDensity>& postSynapticDensity() const
         noexcept;
@@ -15,7 +15,20 @@ namespace morphio {
 class GlialCell: public Morphology
 {
   public:
-    explicit GlialCell(const std::string& source);
+    explicit GlialCell(const std::string& source,
+                       unsigned int options = NO_MODIFIER,
+                       std::shared_ptr<WarningHandler> warning_handler = nullptr);
+
+    /** Constructor from an already opened HDF5 group, e.g. in a container */
+    explicit GlialCell(const HighFive::Group& group,
+                       unsigned int options = NO_MODIFIER,
+                       std::shared_ptr<WarningHandler> warning_handler = nullptr);
+
+    /** Load a glial cell from a string */
+    explicit GlialCell(const std::string& contents,
+                       const std::string& extension,
+                       unsigned int options = NO_MODIFIER,
+                       std::shared_ptr<WarningHandler> warning_handler = nullptr);
 
   private:
     Soma soma() const;
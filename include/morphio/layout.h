@@ -0,0 +1,46 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace morphio {
+/**
+ * Physical layouts of containers matching the way they are read.
+ *
+ * `Collection::argsort` orders the reads of a given list of morphologies, but the place of the
+ * morphologies in a container is fixed when it is written. When jobs load the same subsets
+ * repeatedly, rewriting the container after the traces they recorded (see `AccessTrace`) puts
+ * the morphologies they load together next to each other.
+ **/
+namespace layout {
+
+/**
+ * The order in which to lay out `morphology_names`, given the access `traces` of several jobs
+ *
+ * Two morphologies loaded one after the other in a trace are co-accessed; the pairs co-accessed
+ * most often are made adjacent first, chaining the morphologies greedily (as Pettis and Hansen
+ * lay out code). The chains follow each other in the order they were first accessed, then the
+ * morphologies absent from the traces keep the order of `morphology_names`. Names of the traces
+ * missing from `morphology_names` are ignored.
+ */
+std::vector<std::string> accessOrder(const std::vector<std::string>& morphology_names,
+                                     const std::vector<std::vector<std::string>>& traces);
+
+/**
+ * Copy the HDF5 container `input_path` to `output_path`, with its morphologies laid out in
+ * their `accessOrder`
+ *
+ * The morphologies absent from the traces keep their current relative order. Only the groups of
+ * the morphologies are copied, not the attributes of the root group. Throws `WriterError` if
+ * `output_path` is `input_path` or can't be written.
+ */
+void reorderContainer(const std::string& input_path,
+                      const std::string& output_path,
+                      const std::vector<std::vector<std::string>>& traces);
+
+}  // namespace layout
+}  // namespace morphio
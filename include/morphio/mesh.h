@@ -0,0 +1,70 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>  // uint32_t
+#include <string>
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Tessellation of the neurites of a morphology into triangle meshes
+ **/
+namespace mesh {
+
+/** The primitives the neurites are made of */
+enum Style {
+    TUBES,      //!< One closed tube per section, following its polyline
+    FRUSTUMS,   //!< One closed frustum per segment
+    CAPSULES    //!< One closed frustum capped by half spheres per segment
+};
+
+struct MeshOptions {
+    Style style = TUBES;
+    /** Number of vertices around the neurite at level of detail 0 */
+    unsigned int resolution = 12;
+    /**
+     * Level of detail: each level halves the circumferential resolution (down to 3) and
+     * keeps one point out of two along the sections (the first and last points of a section
+     * are always kept)
+     */
+    unsigned int levelOfDetail = 0;
+    /** Number of threads used to mesh the sections, 0 means one per hardware thread */
+    unsigned int nThreads = 0;
+};
+
+/**
+ * Indexed triangle mesh
+ *
+ * Every primitive is a closed surface with outward facing triangles (counter-clockwise when
+ * seen from outside); primitives do not share vertices.
+ */
+struct Mesh {
+    std::vector<std::array<float, 3>> vertices;
+    std::vector<std::array<uint32_t, 3>> triangles;
+    /** Id of the section each triangle belongs to */
+    std::vector<uint32_t> triangleSections;
+};
+
+/**
+ * Mesh all the neurites of the morphology, from `points()` and `diameters()`.
+ *
+ * The soma is not meshed. Sections are meshed in parallel and written to their own slice of
+ * the buffers, so that the output does not depend on the number of threads.
+ */
+Mesh tessellate(const Morphology& morphology, const MeshOptions& options = MeshOptions());
+
+/** Write the mesh in binary PLY format; throws WriterError on failure */
+void writePLY(const Mesh& mesh, const std::string& filename);
+
+/** Write the mesh in Wavefront OBJ format; throws WriterError on failure */
+void writeOBJ(const Mesh& mesh, const std::string& filename);
+
+}  // namespace mesh
+}  // namespace morphio
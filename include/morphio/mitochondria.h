@@ -35,6 +35,26 @@ class Mitochondria
      **/
     std::vector<MitoSection> sections() const;
 
+    /** @{
+     * Return the data of all the points of all sections, in section order
+     *
+     * The points of section `i` are in the range
+     * [sectionOffsets()[i], sectionOffsets()[i+1]).
+     **/
+    const std::vector<uint32_t>& neuriteSectionIds() const noexcept;
+    const std::vector<floatType>& relativePathLengths() const noexcept;
+    const std::vector<floatType>& diameters() const noexcept;
+    /** @} */
+
+    /**
+     * Return the offset of the first point of each section, followed by the
+     * total number of points
+     **/
+    std::vector<uint64_t> sectionOffsets() const;
+
+    /// Return the parent id of each section, -1 for root sections
+    std::vector<int32_t> sectionParents() const;
+
   private:
     explicit Mitochondria(const std::shared_ptr<Property::Properties>& properties)
         : properties_(properties) {}
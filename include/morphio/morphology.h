@@ -12,6 +12,9 @@
 #include <morphio/warning_handling.h>  // WarningHandler
 
 namespace morphio {
+namespace details {
+class MorphologyAccess;
+}  // namespace details
 
 /** Morphology breadth iterator */
 using breadth_iterator = breadth_iterator_t<Section, Morphology>;
@@ -113,8 +116,10 @@ class Morphology
      *
      * Note: for convenience, the last point of this array is the points() array size
      * so that the above example works also for the last section.
+     *
+     * The offsets are 64-bit, datasets can have more than 2^32 points.
      **/
-    std::vector<uint32_t> sectionOffsets() const;
+    std::vector<uint64_t> sectionOffsets() const;
 
     /**
      * Return a vector with all diameters from all sections
@@ -165,6 +170,7 @@ class Morphology
 
   protected:
     friend class mut::Morphology;
+    friend class details::MorphologyAccess;
     Morphology(const Property::Properties& properties, unsigned int options);
 
     std::shared_ptr<Property::Properties> properties_;
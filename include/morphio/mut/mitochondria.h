@@ -4,8 +4,8 @@
  */
 #pragma once
 
-#include <map>
 #include <memory>
+#include <vector>
 
 #include <morphio/mito_section.h>
 #include <morphio/properties.h>
@@ -39,8 +39,10 @@ class Mitochondria
     **/
     const MitoSectionP& section(uint32_t id) const;
 
-    /// Returns the dictionary id -> Section for this tree
-    const std::map<uint32_t, MitoSectionP>& sections() const noexcept;
+    /**
+       Returns the sections of this tree, indexed by id
+    **/
+    const std::vector<MitoSectionP>& sections() const noexcept;
 
     /**
        Depth first iterator starting at a given section id
@@ -101,6 +103,18 @@ class Mitochondria
     MitoSectionP appendRootSection(const morphio::MitoSection&, bool recursive = false);
     MitoSectionP appendRootSection(const MitoSectionP&, bool recursive = false);
 
+    /**
+       Append all the sections of flat mitochondria data at once
+
+       `sections` holds the (offset of the first point in `points`, parent index)
+       pair of each section, as in the H5 'structure' dataset. The parent index
+       refers to `sections` and is -1 for root sections. Section ids follow the
+       order of `sections`. Returns the appended root sections.
+    **/
+    std::vector<MitoSectionP> appendSections(
+        const std::vector<Property::MitoSection::Type>& sections,
+        const Property::MitochondriaPointLevel& points);
+
     const MitoSectionP& mitoSection(uint32_t id) const;
 
     /**
@@ -111,17 +125,22 @@ class Mitochondria
   private:
     friend class MitoSection;
 
-    uint32_t _register(const MitoSectionP& section);
+    /// The id of the next registered section
+    uint32_t _nextId() const noexcept {
+        return static_cast<uint32_t>(sections_.size());
+    }
+
+    uint32_t _register(const MitoSectionP& section, int32_t parentId = -1);
+
+    // Indexed by section id, ids being given contiguously by `_register`
+    std::vector<MitoSectionP> sections_;
+    std::vector<int32_t> parent_;
+    std::vector<std::vector<MitoSectionP>> children_;
 
-    uint32_t _counter = 0;
-    std::map<uint32_t, std::vector<MitoSectionP>> children_;
-    std::map<uint32_t, uint32_t> parent_;
     std::vector<MitoSectionP> root_sections_;
-    std::map<uint32_t, MitoSectionP> sections_;
 };
 
-inline const std::map<uint32_t, Mitochondria::MitoSectionP>& Mitochondria::sections() const
-    noexcept {
+inline const std::vector<Mitochondria::MitoSectionP>& Mitochondria::sections() const noexcept {
     return sections_;
 }
 
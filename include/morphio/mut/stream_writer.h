@@ -0,0 +1,118 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t
+#include <memory>   // std::unique_ptr, std::shared_ptr
+#include <string>
+#include <vector>
+
+#include <morphio/types.h>
+#include <morphio/warning_handling.h>
+
+namespace morphio {
+namespace mut {
+namespace writer {
+
+namespace details {
+class StreamBackend;
+
+/** A section on the path from the root to the last written section */
+struct StreamSection {
+    uint32_t id;
+    int parent;
+    SectionType type;
+    size_t depth;  //!< 0 for root sections
+    size_t childCount;
+    floatType lastDiameter;
+};
+}  // namespace details
+
+/**
+ * Write a morphology section by section, without building a mut::Morphology first.
+ *
+ * Sections must be added in depth-first order: the parent of a new section is either -1 (a
+ * new neurite), the last added section, or one of its ancestors. Only the sections on the
+ * path from the root to the last section are kept, so ASC files of arbitrarily large
+ * morphologies are written with O(section) memory. SWC holds back the rows of the first child
+ * of a section until a second child shows that the section is not a unifurcation. H5 keeps the
+ * rows until `finish()`, to write contiguous datasets like writer::h5.
+ *
+ * The format is picked from the extension of the file, like mut::Morphology::write, and
+ * the output is the same as writing the equivalent mut::Morphology. Organelles and
+ * dendritic spine data are not supported.
+ *
+ * \code{.cpp}
+ * StreamWriter writer("out.swc");
+ * writer.beginSoma(SOMA_SINGLE_POINT, {{0, 0, 0}}, {10});
+ * auto root = writer.addSection(SECTION_AXON, -1, {{0, 0, 0}, {0, 5, 0}}, {2, 2});
+ * writer.addSection(SECTION_AXON, root, {{0, 5, 0}, {5, 5, 0}}, {2, 2});
+ * writer.addSection(SECTION_AXON, root, {{0, 5, 0}, {-5, 5, 0}}, {2, 2});
+ * writer.finish();
+ * \endcode
+ */
+class StreamWriter
+{
+  public:
+    /**
+     * Prepare writing to `filename`; the file is created when the first data is written, or by
+     * `finish()` for H5.
+     *
+     * \param cellFamily only used by the H5 format
+     */
+    explicit StreamWriter(const std::string& filename,
+                          std::shared_ptr<WarningHandler> warning_handler = nullptr,
+                          CellFamily cellFamily = CellFamily::NEURON);
+    ~StreamWriter();
+
+    StreamWriter(const StreamWriter&) = delete;
+    StreamWriter& operator=(const StreamWriter&) = delete;
+
+    /** Set the soma; it must be called before adding any section */
+    void beginSoma(SomaType type, const Points& points, const std::vector<floatType>& diameters);
+
+    /**
+     * Write a section and return its id
+     *
+     * Ids are given in the order sections are added, starting from 0, which is also the
+     * order of the sections when the file is read back.
+     *
+     * \param parent the id of the parent section, or -1 for a root section
+     * \param perimeters only supported by the H5 format; either all sections or none have
+     *        some
+     */
+    uint32_t addSection(SectionType type,
+                        int parent,
+                        const Points& points,
+                        const std::vector<floatType>& diameters,
+                        const std::vector<floatType>& perimeters = {});
+
+    /**
+     * Close the remaining sections and complete the file
+     *
+     * Nothing can be added afterwards. A writer destroyed before being finished leaves an
+     * incomplete file, or no H5 file.
+     */
+    void finish();
+
+  private:
+    void begin(bool hasSections);
+    void closeSectionsAbove(int parent);
+
+    std::string _filename;
+    std::shared_ptr<WarningHandler> _handler;
+    std::unique_ptr<details::StreamBackend> _backend;
+    SomaType _somaType = SOMA_UNDEFINED;
+    Points _somaPoints;
+    std::vector<floatType> _somaDiameters;
+    std::vector<details::StreamSection> _openSections;
+    uint32_t _sectionCount = 0;
+    bool _begun = false;
+    bool _finished = false;
+};
+
+}  // namespace writer
+}  // end namespace mut
+}  // end namespace morphio
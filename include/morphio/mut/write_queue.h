@@ -0,0 +1,87 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>  // size_t
+#include <deque>
+#include <memory>  // std::unique_ptr
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>  // std::pair
+#include <vector>
+
+#include <morphio/mut/morphology.h>
+
+namespace morphio {
+namespace mut {
+
+/**
+ * Write morphologies on background threads, so that writing overlaps with computing the next
+ * ones.
+ *
+ * The queue owns the morphologies it is given until they are written. At most `capacity`
+ * morphologies are queued or being written: `push` blocks until one is done, which bounds the
+ * memory. Errors do not stop the other writes; they are reported by the next `flush`.
+ *
+ * H5 files are written one at a time since the HDF5 library is not thread-safe; the text
+ * formats are written concurrently.
+ *
+ * \code{.cpp}
+ * WriteQueue queue(2);
+ * for (...) {
+ *     auto morphology = std::make_unique<Morphology>(...);
+ *     queue.push(std::move(morphology), "out.h5");
+ * }
+ * queue.flush();
+ * \endcode
+ */
+class WriteQueue
+{
+  public:
+    /**
+     * \param nThreads number of writing threads, 0 means one per hardware thread
+     * \param capacity maximum number of morphologies held by the queue (at least 1)
+     */
+    explicit WriteQueue(unsigned int nThreads = 1, size_t capacity = 16);
+
+    /** Wait for the pending writes; the errors that were not flushed are dropped */
+    ~WriteQueue();
+
+    WriteQueue(const WriteQueue&) = delete;
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    /** Queue `morphology` to be written to `filename`, blocking while the queue is full */
+    void push(std::unique_ptr<Morphology> morphology, const std::string& filename);
+
+    /**
+     * Wait until every pushed morphology is written
+     *
+     * @throw WriterError listing the files that failed since the last flush
+     */
+    void flush();
+
+    /** Number of morphologies queued or being written */
+    size_t pending() const;
+
+  private:
+    void work();
+
+    using Task = std::pair<std::unique_ptr<Morphology>, std::string>;
+
+    size_t _capacity;
+    std::deque<Task> _tasks;
+    size_t _running = 0;
+    bool _stopping = false;
+    std::vector<std::string> _errors;
+    mutable std::mutex _mutex;
+    std::condition_variable _taskAdded;
+    std::condition_variable _taskDone;
+    std::vector<std::thread> _threads;
+};
+
+}  // namespace mut
+}  // namespace morphio
@@ -0,0 +1,47 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <functional>  // std::function
+
+#include <morphio/morphology.h>
+#include <morphio/section.h>
+
+namespace morphio {
+/**
+ * Parallel traversals of the sections of a single morphology, for analyses of very large trees
+ * (full axons with 10^5 sections) that the sequential iterators can not spread over several
+ * cores.
+ **/
+namespace parallel {
+
+/** The sections a callback must wait for */
+enum Order {
+    UNORDERED,  //!< none: the sections are visited in any order
+    TOP_DOWN,   //!< its parent: a section is visited after its parent
+    BOTTOM_UP   //!< its children: a section is visited after all its children
+};
+
+/**
+ * Call `callback` once for every section of the morphology, using up to `nThreads` threads
+ *
+ * With TOP_DOWN and BOTTOM_UP, the results of the sections a callback waits for are visible to
+ * it (for instance path distances from the parent, or subtree sizes from the children), the
+ * callback does not need to synchronize. Callbacks on independent sections run concurrently:
+ * they must not write to shared state without synchronization. Every thread follows the
+ * sections of a subtree, and idle threads steal the largest subtrees left.
+ *
+ * The first exception thrown by a callback is re-thrown once all the threads have stopped, the
+ * sections that were not visited yet are skipped.
+ *
+ * \param nThreads number of threads to use, 0 means one per hardware thread
+ */
+void forEachSection(const Morphology& morphology,
+                    const std::function<void(const Section&)>& callback,
+                    Order order = UNORDERED,
+                    unsigned int nThreads = 0);
+
+}  // namespace parallel
+}  // namespace morphio
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <cstdint>  // uint32_t
+#include <cstdint>  // int64_t, uint32_t
 
 #include <array>
 #include <map>
@@ -22,12 +22,13 @@ namespace Property {
 
 struct Section {
     // (offset, parent index)
-    using Type = std::array<int, 2>;
+    // 64-bit so that the offsets of datasets with more than 2^31 points can be stored
+    using Type = std::array<int64_t, 2>;
 };
 
 struct MitoSection {
     // (offset, parent index)
-    using Type = std::array<int, 2>;
+    using Type = std::array<int64_t, 2>;
 };
 
 struct Point {
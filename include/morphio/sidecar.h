@@ -0,0 +1,151 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t, uint64_t
+#include <memory>   // std::shared_ptr
+#include <string>
+#include <vector>
+
+#include <morphio/exceptions.h>
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Persistent cache of arrays derived from morphologies (section lengths, path distances,
+ * traversal orders, ...), stored in sidecar files next to a container or a directory.
+ *
+ * Entries are keyed by a hash of the contents of the morphology, so that they are invalidated
+ * when the morphology changes, and read back with mmap.
+ **/
+namespace sidecar {
+
+/** Hash of the points, diameters, perimeters, topology, section types and soma of a morphology */
+uint64_t contentHash(const Morphology& morphology);
+
+/** Length of every section */
+std::vector<floatType> sectionLengths(const Morphology& morphology);
+
+/** Path distance from the first point of the root section to the end of every section */
+std::vector<floatType> pathDistances(const Morphology& morphology);
+
+/** Section ids in depth first order, as Morphology::depth_begin */
+std::vector<uint32_t> depthFirstOrder(const Morphology& morphology);
+
+/** A read-only array of a sidecar file, mapped in memory */
+class MappedArray
+{
+  public:
+    MappedArray(const MappedArray&) = delete;
+    MappedArray& operator=(const MappedArray&) = delete;
+    ~MappedArray();
+
+    /** Number of elements */
+    size_t size() const noexcept {
+        return count_;
+    }
+
+    size_t elementSize() const noexcept {
+        return elementSize_;
+    }
+
+    /** @throw MorphioError if `T` is not the type of the elements */
+    template <typename T>
+    range<const T> values() const {
+        if (sizeof(T) != elementSize_) {
+            throw MorphioError("Sidecar: the elements have " + std::to_string(elementSize_) +
+                               " bytes, not " + std::to_string(sizeof(T)));
+        }
+        return {reinterpret_cast<const T*>(data_), count_};
+    }
+
+  private:
+    friend class SidecarCache;
+    MappedArray() = default;
+
+    const char* data_ = nullptr;
+    size_t count_ = 0;
+    size_t elementSize_ = 0;
+    // the whole mapped file, or a copy where mmap is not available
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    std::vector<char> buffer_;
+};
+
+/**
+ * A directory of sidecar files, one per morphology and array: `<content hash>-<name>.bin`
+ *
+ * Files are written to a temporary file first and then renamed, so that several processes can
+ * share a cache. The files of morphologies that changed are left in the directory.
+ */
+class SidecarCache
+{
+  public:
+    /** The directory is created if it does not exist */
+    explicit SidecarCache(std::string directory);
+
+    /**
+     * The cache of a container (`<path>.morphio-cache`) or a directory of morphologies
+     * (`<path>/.morphio-cache`)
+     */
+    static SidecarCache nextTo(const std::string& source);
+
+    const std::string& directory() const noexcept {
+        return directory_;
+    }
+
+    /**
+     * The array `name` of the morphology with the content hash `hash`
+     *
+     * \return nullptr if it is not in the cache, or if its file is invalid (which includes an
+     *         element size of 0)
+     */
+    std::shared_ptr<const MappedArray> load(uint64_t hash,
+                                            const std::string& name,
+                                            size_t elementSize) const;
+
+    /**
+     * Write the array `name` of the morphology with the content hash `hash`, and map it
+     *
+     * @throw MorphioError if the file can not be written, or if `elementSize` is 0
+     */
+    std::shared_ptr<const MappedArray> store(uint64_t hash,
+                                             const std::string& name,
+                                             const void* data,
+                                             size_t count,
+                                             size_t elementSize) const;
+
+    /** Load the array `name` of the morphology, computing and storing it if it is missing */
+    template <typename T, typename F>
+    std::shared_ptr<const MappedArray> getOrCompute(const Morphology& morphology,
+                                                    const std::string& name,
+                                                    const F& compute) const {
+        const uint64_t hash = contentHash(morphology);
+        auto array = load(hash, name, sizeof(T));
+        if (array) {
+            return array;
+        }
+        const std::vector<T> values = compute(morphology);
+        return store(hash, name, values.data(), values.size(), sizeof(T));
+    }
+
+    /** The cached `sidecar::sectionLengths` */
+    std::shared_ptr<const MappedArray> sectionLengths(const Morphology& morphology) const;
+
+    /** The cached `sidecar::pathDistances` */
+    std::shared_ptr<const MappedArray> pathDistances(const Morphology& morphology) const;
+
+    /** The cached `sidecar::depthFirstOrder` */
+    std::shared_ptr<const MappedArray> depthFirstOrder(const Morphology& morphology) const;
+
+  private:
+    std::string path(uint64_t hash, const std::string& name) const;
+
+    std::string directory_;
+};
+
+}  // namespace sidecar
+}  // namespace morphio
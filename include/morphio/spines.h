@@ -0,0 +1,105 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t
+#include <vector>
+
+#include <morphio/dendritic_spine.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Placement of dendritic spines onto the dendrites of a morphology, as instances of a library of
+ * spine morphologies: a placed spine is a library index and a transform, its geometry is only
+ * generated on demand.
+ **/
+namespace spines {
+
+/** Where to grow a spine */
+struct SpineLocation {
+    /** Index of the spine in the library */
+    uint32_t spine;
+    /** Section of the host morphology */
+    uint32_t section;
+    /** Position along the section, as a fraction of its path length in [0, 1] */
+    floatType offset;
+    /** Angle (radians) of the spine around the dendrite, from a reference direction */
+    floatType angle = 0;
+};
+
+/** A spine of the library, placed onto the host morphology */
+struct PlacedSpine {
+    uint32_t spine;
+    uint32_t section;
+    floatType offset;
+    /** Placement of the library spine: its root is on the dendrite surface */
+    Transform transform;
+};
+
+/**
+ * The spine morphologies that are instantiated, each one with its attachment frame: the root
+ * (first point of its first root section) goes on the dendrite surface and the axis, from the
+ * root to the head, is aligned with the dendrite normal.
+ */
+class SpineLibrary
+{
+  public:
+    /** The axis goes to the first post synaptic density (else to the farthest point) */
+    explicit SpineLibrary(const std::vector<DendriticSpine>& spines);
+
+    /** Morphologies without post synaptic densities: the axis goes to the farthest point */
+    explicit SpineLibrary(const std::vector<Morphology>& spines);
+
+    size_t size() const noexcept {
+        return spines_.size();
+    }
+
+    const Morphology& spine(size_t i) const {
+        return spines_.at(i);
+    }
+
+    /** Root of every spine, in its own coordinates */
+    const Points& roots() const noexcept {
+        return roots_;
+    }
+
+    /** Unit axis of every spine, in its own coordinates */
+    const Points& axes() const noexcept {
+        return axes_;
+    }
+
+    /** The points of a placed spine (all its section points) */
+    Points points(const PlacedSpine& placed) const;
+
+    /** A placed spine as a standalone morphology, e.g. to write it */
+    mut::Morphology instantiate(const PlacedSpine& placed) const;
+
+  private:
+    void addSpine(const Morphology& spine, const Point* head);
+
+    std::vector<Morphology> spines_;
+    Points roots_;
+    Points axes_;
+};
+
+/**
+ * Place spines onto the dendrites of `morphology`, in parallel.
+ *
+ * The spine root goes on the dendrite surface at the location; the spine axis is aligned with
+ * the direction normal to the dendrite axis at `angle` from a reference direction, the
+ * normalised cross product of the dendrite axis and the world axis the least aligned with it.
+ *
+ * @throw RawDataError if a location refers to a missing section or spine
+ */
+std::vector<PlacedSpine> place(const Morphology& morphology,
+                               const SpineLibrary& library,
+                               const std::vector<SpineLocation>& locations,
+                               unsigned int nThreads = 0);
+
+}  // namespace spines
+}  // namespace morphio
@@ -0,0 +1,44 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Aggregates of the subtrees of a morphology: for every section, values summed (or maximized)
+ * over the section and all the sections below it, computed in a single postorder pass.
+ **/
+namespace subtree {
+
+/**
+ * Aggregates of every section and its descendants, indexed by section id
+ *
+ * Only the segments of the sections count: the segment between the soma and a root section, or
+ * between the last point of a parent and a child that does not start there, is not included.
+ */
+struct Aggregates {
+    /** Total length */
+    std::vector<floatType> length;
+    /** Lateral area of the frustums of the segments */
+    std::vector<floatType> area;
+    /** Volume of the frustums of the segments */
+    std::vector<floatType> volume;
+    /** Number of sections without children */
+    std::vector<uint32_t> tips;
+    /** Number of sections with two children or more */
+    std::vector<uint32_t> bifurcations;
+    /** Longest path length from the first point of the section to the end of a tip */
+    std::vector<floatType> maxPathLength;
+};
+
+Aggregates aggregates(const Morphology& morphology);
+
+}  // namespace subtree
+}  // namespace morphio
@@ -0,0 +1,79 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <morphio/collection.h>
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Topological Morphology Descriptor (TMD)
+ *
+ * Computes the persistence barcode of the neurites of a morphology, as described in:
+ * Kanari et al. (2018), "A Topological Representation of Branching Neuronal Morphologies".
+ **/
+namespace tmd {
+
+/** The function used to filter the tree: distance of every branching and tip point to the
+ * root of its neurite */
+enum Filtration {
+    RADIAL_DISTANCE,  //!< Euclidean distance to the first point of the neurite
+    PATH_DISTANCE     //!< Path length along the neurite from its first point
+};
+
+/** A (birth, death) pair */
+using Bar = std::array<floatType, 2>;
+
+/** All the bars of one or several neurites */
+using Barcode = std::vector<Bar>;
+
+/**
+ * Return the persistence barcode of all the neurites of the given type.
+ *
+ * Each neurite contributes one bar per tip: the bar is born at the filtration value of its
+ * tip and dies at the branching point where it merges with a longer-lived component. The
+ * component of the longest-lived tip dies at the root of the neurite (value 0).
+ * The bars of all matching neurites are concatenated, in root section order.
+ *
+ * \param neuriteType only consider neurites whose root section has this type. SECTION_ALL
+ *        selects every neurite.
+ */
+Barcode persistenceBarcode(const Morphology& morphology,
+                           SectionType neuriteType = SECTION_ALL,
+                           Filtration filtration = RADIAL_DISTANCE);
+
+/**
+ * Return the persistence barcodes of several morphologies, computed in parallel.
+ *
+ * \param nThreads number of threads to use, 0 means one per hardware thread
+ */
+std::vector<Barcode> persistenceBarcodes(const std::vector<Morphology>& morphologies,
+                                         SectionType neuriteType = SECTION_ALL,
+                                         Filtration filtration = RADIAL_DISTANCE,
+                                         unsigned int nThreads = 0);
+
+/**
+ * Load the given morphologies from the collection and return their persistence barcodes,
+ * in the order of `morphologyNames`.
+ *
+ * Loading and computing are done in parallel, each morphology is released as soon as its
+ * barcode has been computed.
+ *
+ * \param nThreads number of threads to use, 0 means one per hardware thread
+ */
+std::vector<Barcode> persistenceBarcodes(const Collection& collection,
+                                         const std::vector<std::string>& morphologyNames,
+                                         SectionType neuriteType = SECTION_ALL,
+                                         Filtration filtration = RADIAL_DISTANCE,
+                                         unsigned int options = NO_MODIFIER,
+                                         unsigned int nThreads = 0);
+
+}  // namespace tmd
+}  // namespace morphio
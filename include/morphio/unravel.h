@@ -0,0 +1,82 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Unravelling: straightening the tortuous neurites of in-vitro reconstructions with a sliding
+ * window, as in NeuroR.
+ *
+ * Every segment is replaced by a segment of the same length along the principal direction of the
+ * points in a window around it, pointing the same way as the original segment. Sections keep
+ * their first point attached to the end of their (unravelled) parent.
+ **/
+namespace unravel {
+
+/** Default number of points on each side of the window */
+constexpr size_t DEFAULT_WINDOW_HALF_LENGTH = 5;
+
+/**
+ * An unravelled morphology, with the mapping from the original one
+ *
+ * The unravelled morphology has the same sections and the same number of points as the original
+ * one: original point `i` is moved to point `i` of the unravelled morphology. `map` moves other
+ * positions attached to a section, such as synapses or markers.
+ */
+class Unravelled
+{
+  public:
+    /**
+     * \param windowHalfLength number of points on each side of the window
+     * \param nThreads number of threads over the sections, 0 means one per hardware thread
+     */
+    explicit Unravelled(const Morphology& morphology,
+                        size_t windowHalfLength = DEFAULT_WINDOW_HALF_LENGTH,
+                        unsigned int nThreads = 0);
+
+    const Morphology& original() const noexcept {
+        return original_;
+    }
+
+    /** The unravelled morphology */
+    const Morphology& morphology() const noexcept {
+        return morphology_;
+    }
+
+    /**
+     * Move a position attached to the section `section` of the original morphology
+     *
+     * The position keeps its location along the closest segment of the section, and its offset
+     * from the segment, rotated with it.
+     *
+     * @throw RawDataError if the section does not exist
+     */
+    Point map(const Point& position, uint32_t section) const;
+
+    /** Move `positions[i]`, attached to the section `sections[i]` */
+    Points map(const Points& positions,
+               const std::vector<uint32_t>& sections,
+               unsigned int nThreads = 0) const;
+
+  private:
+    Morphology original_;
+    Morphology morphology_;
+    /** `original_.sectionOffsets()`, looked up by every `map` */
+    std::vector<uint64_t> offsets_;
+};
+
+/** The unravelled morphology */
+Morphology unravel(const Morphology& morphology,
+                   size_t windowHalfLength = DEFAULT_WINDOW_HALF_LENGTH,
+                   unsigned int nThreads = 0);
+
+}  // namespace unravel
+}  // namespace morphio
@@ -4,6 +4,7 @@
  */
 #pragma once
 
+#include <cstdint>  // uint64_t
 #include <map>
 #include <string>  // std::string
 #include <vector>  // std::vector
@@ -16,8 +17,9 @@ namespace property {
 
 struct VascSection {
     // offset
-    // refers to the index in the points vector from which the section begins
-    using Type = unsigned int;
+    // refers to the index in the points vector from which the section begins, 64-bit so that
+    // datasets with more than 2^32 points can be loaded
+    using Type = uint64_t;
 };
 
 struct Point {
@@ -0,0 +1,142 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t, uint64_t
+#include <limits>
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/types.h>
+#include <morphio/vasc/vasculature.h>
+
+namespace morphio {
+namespace vasculature {
+
+/** A vessel segment close to a query, and the distance between their surfaces */
+struct SegmentHit {
+    /** Section of the vasculature */
+    uint32_t section;
+    /** Segment of the section: between its points `segment` and `segment + 1` */
+    uint32_t segment;
+    /**
+     * Distance between the surface of the query and the surface of the vessel, measured at the
+     * closest points of their axes (0 if they overlap)
+     */
+    floatType distance;
+};
+
+/** Hits of every part of a morphology */
+struct MorphologyHits {
+    /** Hits of the soma, as a sphere enclosing its points */
+    std::vector<SegmentHit> soma;
+    /** Section of every queried neurite segment */
+    std::vector<uint32_t> sections;
+    /** Index of every queried neurite segment in its section */
+    std::vector<uint32_t> segments;
+    /** Hits of every neurite segment */
+    std::vector<std::vector<SegmentHit>> hits;
+};
+
+/**
+ * Spatial index (bounding volume hierarchy) over the segments of a vasculature, each one a
+ * truncated cone between two consecutive points of a section.
+ *
+ * The index is immutable once built and can be queried from several threads. Batch queries
+ * run in parallel; `nThreads` = 0 means one thread per hardware thread.
+ */
+class ProximityIndex
+{
+  public:
+    explicit ProximityIndex(const Vasculature& vasculature);
+
+    /**
+     * Index the sections given as flat arrays: the section `i` has the points
+     * [sectionOffsets[i], sectionOffsets[i + 1]), the last offset being the number of points.
+     *
+     * @throw MorphioError if the arrays are inconsistent
+     */
+    ProximityIndex(const Points& points,
+                   const std::vector<floatType>& diameters,
+                   const std::vector<uint64_t>& sectionOffsets);
+
+    /** Number of indexed segments */
+    size_t size() const noexcept {
+        return segments_.size();
+    }
+
+    /** The nearest vessel segment of every point (empty results if the index is empty) */
+    std::vector<std::vector<SegmentHit>> nearest(const Points& points,
+                                                 unsigned int nThreads = 0) const;
+
+    /** All the vessel segments within `radius` of every point, sorted by distance */
+    std::vector<std::vector<SegmentHit>> within(const Points& points,
+                                                floatType radius,
+                                                unsigned int nThreads = 0) const;
+
+    /** The `k` nearest vessel segments of `point` at most `maxDistance` away, sorted by distance */
+    std::vector<SegmentHit> nearest(
+        const Point& point,
+        size_t k,
+        floatType maxDistance = std::numeric_limits<floatType>::infinity()) const;
+
+    /** All the vessel segments within `radius` of `point`, sorted by distance */
+    std::vector<SegmentHit> within(const Point& point, floatType radius) const;
+
+    /**
+     * The vessel segments whose axis has a point in the box [min, max], sorted by section and
+     * segment; their distance is 0
+     */
+    std::vector<SegmentHit> inBox(const Point& min, const Point& max) const;
+
+    /** The nearest vessel segment of the soma and of every neurite segment of `morphology` */
+    MorphologyHits nearest(const Morphology& morphology,
+                           const Transform& transform = Transform(),
+                           unsigned int nThreads = 0) const;
+
+    /**
+     * All the vessel segments within `radius` of the soma and of every neurite segment of
+     * `morphology`, sorted by distance
+     */
+    MorphologyHits within(const Morphology& morphology,
+                          floatType radius,
+                          const Transform& transform = Transform(),
+                          unsigned int nThreads = 0) const;
+
+    /** A segment (or a point if a == b), with a radius varying linearly from a to b */
+    struct Capsule {
+        Point a;
+        Point b;
+        floatType ra;
+        floatType rb;
+    };
+
+  private:
+    struct Node {
+        Point min;
+        Point max;
+        /** Leaf: first segment and count; inner node: first child (second one follows) */
+        uint32_t first;
+        uint32_t count;
+    };
+
+    void build();
+    /** The nearest segment, or false if the index is empty */
+    bool nearestSegment(const Capsule& query, SegmentHit& hit) const;
+    std::vector<SegmentHit> segmentsWithin(const Capsule& query, floatType radius) const;
+    MorphologyHits query(const Morphology& morphology,
+                         const Transform& transform,
+                         floatType radius,
+                         bool all,
+                         unsigned int nThreads) const;
+
+    std::vector<Capsule> segments_;
+    std::vector<uint32_t> sections_;
+    std::vector<uint32_t> indices_;
+    std::vector<Node> nodes_;
+};
+
+}  // namespace vasculature
+}  // namespace morphio
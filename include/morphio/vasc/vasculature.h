@@ -60,8 +60,10 @@ class Vasculature
      *
      * Note: for convenience, the last point of this array is the points() array size
      * so that the above example works also for the last section.
+     *
+     * The offsets are 64-bit, datasets can have more than 2^32 points.
      */
-    const std::vector<uint32_t> sectionOffsets() const noexcept;
+    const std::vector<uint64_t> sectionOffsets() const noexcept;
 
     /**
      * Return a vector with all points from all sections
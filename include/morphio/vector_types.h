@@ -1,7 +1,8 @@
 #pragma once
 
 #include <array>
-#include <cmath>  // M_PI
+#include <cmath>    // M_PI
+#include <cstddef>  // size_t
 #include <vector>
 
 #include <gsl/gsl-lite.hpp>
@@ -31,4 +32,21 @@ using Point = std::array<morphio::floatType, 3>;
 /** An array of points */
 using Points = std::vector<Point>;
 
+/** Rigid placement of a morphology: p' = rotation * p + translation */
+struct Transform {
+    /** Rotation matrix, row major */
+    std::array<std::array<floatType, 3>, 3> rotation{{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+    Point translation{0, 0, 0};
+
+    Point apply(const Point& point) const noexcept {
+        Point result = translation;
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t k = 0; k < 3; ++k) {
+                result[i] += rotation[i][k] * point[k];
+            }
+        }
+        return result;
+    }
+};
+
 }  // namespace morphio
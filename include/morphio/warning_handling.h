@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>  // std::ostringstream
 #include <string>
@@ -258,14 +259,20 @@ struct SomaNonCynlinderOrPoint: public WarningMessage {
     }
 };
 
+/**
+ * Base class of the warning handlers
+ *
+ * Handlers are shared between threads (the default one, returned by `getWarningHandler()`, is
+ * used by every load that does not pass its own), so their state is guarded by `mutex_`.
+ */
 class WarningHandler
 {
   public:
     WarningHandler() = default;
-    WarningHandler(WarningHandler&&) = default;
-    WarningHandler& operator=(const WarningHandler&) = default;
-    WarningHandler& operator=(WarningHandler&&) = default;
-    WarningHandler(WarningHandler&) = default;
+    WarningHandler(WarningHandler&& other);
+    WarningHandler& operator=(const WarningHandler& other);
+    WarningHandler& operator=(WarningHandler&& other);
+    WarningHandler(const WarningHandler& other);
     virtual ~WarningHandler() = default;
 
     virtual void emit(std::shared_ptr<WarningMessage>) = 0;
@@ -280,6 +287,9 @@ class WarningHandler
     virtual bool getRaiseWarnings() const = 0;
     virtual void setRaiseWarnings(bool raise) = 0;
 
+  protected:
+    mutable std::mutex mutex_;
+
   private:
     std::set<enums::Warning> ignoredWarnings_;
 };
@@ -12,47 +12,96 @@ if platform.system() == "Windows":
 
 
 from ._morphio import (
+    AccessTrace,
     Annotation,
     AnnotationType,
+    ArrowFormat,
+    ArrowTable,
+    BoundingVolumes,
+    Bounds,
+    ByteSource,
     CellFamily,
     CellLevel,
+    CircuitIndex,
+    ClipBox,
+    ClipPlane,
+    ClipSlab,
+    Clipped,
+    CloneParameters,
     Collection,
+    CompartmentOrdering,
+    CompartmentTree,
     DendriticSpine,
     EndoplasmicReticulum,
     GlialCell,
     IDSequenceError,
     IterType,
     LogLevel,
+    Mesh,
+    MeshStyle,
     MissingParentError,
     MitoSection,
     Mitochondria,
     MitochondriaPointLevel,
     MorphioError,
     Morphology,
+    MorphologyDelta,
     MultipleTrees,
     Option,
     PointLevel,
     Points,
+    PlacedSpine,
     PostSynapticDensity,
     Properties,
     RawDataError,
     Section,
     SectionBuilderError,
     SectionLevel,
+    SectionOrder,
     SectionType,
+    SidecarCache,
     Soma,
     SomaError,
     SomaType,
+    SpineLibrary,
+    SubtreeAggregates,
+    TMDFiltration,
     UnknownFileType,
+    Unravelled,
+    VariantCollection,
     VasculatureSectionType,
     Warning,
     WarningHandlerCollector,
     WriterError,
+    access_order,
+    arrow_deserialize,
+    arrow_serialize,
+    clip,
+    clone_morphologies,
+    clone_morphology,
+    compartmentalize,
+    content_hash,
+    delta_apply,
+    delta_deserialize,
+    delta_diff,
+    delta_serialize,
     mut,
     ostream_redirect,
+    parallel_for_sections,
+    persistence_barcode,
+    persistence_barcodes,
+    place_spines,
+    read_arrow,
+    read_delta,
+    reorder_container,
     set_ignored_warning,
     set_raise_warnings,
     set_maximum_warnings,
+    subtree_aggregates,
+    tessellate,
+    unravel,
     vasculature,
     version,
+    write_arrow,
+    write_delta,
 )
@@ -6,4 +6,6 @@ from .._morphio.mut import (Morphology,
                             GlialCell,
                             EndoplasmicReticulum,
                             DendriticSpine,
+                            StreamWriter,
+                            WriteQueue,
                             )
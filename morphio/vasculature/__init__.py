@@ -1 +1 @@
-from .._morphio.vasculature import Vasculature, Section
+from .._morphio.vasculature import Vasculature, Section, ProximityIndex
@@ -0,0 +1,1117 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::stable_sort
+#include <cstring>    // std::memcpy
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <type_traits>
+
+#include <morphio/arrow.h>
+#include <morphio/exceptions.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+
+#include "morphology_access.h"
+#include "shared_utils.hpp"
+
+namespace {
+
+using morphio::RawDataError;
+
+/**
+ * Minimal FlatBuffers builder, enough for the Arrow IPC metadata.
+ *
+ * Unlike the official builder, objects are appended after the object that references them, so
+ * that all the (unsigned) offsets point forward: a table is written with placeholders for its
+ * offset fields, which are patched with `link` once the referenced object has been written.
+ */
+class FlatBufferBuilder
+{
+  public:
+    /** The fields of a table to write */
+    class Table
+    {
+      public:
+        template <typename T>
+        Table& scalar(uint16_t id, T value) {
+            std::string bytes(sizeof(T), '\0');
+            std::memcpy(&bytes[0], &value, sizeof(T));
+            fields_.push_back({id, std::move(bytes), false});
+            return *this;
+        }
+
+        /** An offset to an object written later */
+        Table& offset(uint16_t id) {
+            fields_.push_back({id, std::string(sizeof(uint32_t), '\0'), true});
+            return *this;
+        }
+
+      private:
+        friend class FlatBufferBuilder;
+        struct Field {
+            uint16_t id;
+            std::string bytes;
+            bool isOffset;
+        };
+        std::vector<Field> fields_;
+    };
+
+    /** A written table, with the position of its offset fields */
+    struct Written {
+        size_t position;
+        std::map<uint16_t, size_t> slots;
+
+        size_t slot(uint16_t id) const {
+            return slots.at(id);
+        }
+    };
+
+    FlatBufferBuilder()
+        : buffer_(sizeof(uint32_t), '\0') {}  // the offset to the root table
+
+    Written table(const Table& table) {
+        uint16_t nIds = 0;
+        for (const auto& field : table.fields_) {
+            nIds = std::max(nIds, static_cast<uint16_t>(field.id + 1));
+        }
+        std::vector<uint16_t> vtable(2 + nIds, 0);
+
+        align(sizeof(uint16_t));
+        const size_t vtablePosition = buffer_.size();
+        buffer_.append(vtable.size() * sizeof(uint16_t), '\0');
+
+        Written written{align(sizeof(int32_t)), {}};
+        append(static_cast<int32_t>(written.position - vtablePosition));
+
+        // largest fields first, to limit the padding
+        auto fields = table.fields_;
+        std::stable_sort(fields.begin(), fields.end(), [](const Table::Field& a, const Table::Field& b) {
+            return a.bytes.size() > b.bytes.size();
+        });
+        for (const auto& field : fields) {
+            const size_t position = align(field.bytes.size());
+            buffer_ += field.bytes;
+            vtable[2 + field.id] = static_cast<uint16_t>(position - written.position);
+            if (field.isOffset) {
+                written.slots[field.id] = position;
+            }
+        }
+
+        vtable[0] = static_cast<uint16_t>(vtable.size() * sizeof(uint16_t));
+        vtable[1] = static_cast<uint16_t>(buffer_.size() - written.position);
+        std::memcpy(&buffer_[vtablePosition], vtable.data(), vtable.size() * sizeof(uint16_t));
+        return written;
+    }
+
+    /** Write a vector of `count` offsets, return the position of the first one */
+    size_t offsets(size_t slot, size_t count) {
+        align(sizeof(uint32_t));
+        link(slot, buffer_.size());
+        append(static_cast<uint32_t>(count));
+        const size_t first = buffer_.size();
+        buffer_.append(count * sizeof(uint32_t), '\0');
+        return first;
+    }
+
+    /** Write a vector of `count` structs of the given alignment, already serialized in `bytes` */
+    void structs(size_t slot, const std::string& bytes, size_t count, size_t alignment) {
+        align(sizeof(uint32_t));
+        while ((buffer_.size() + sizeof(uint32_t)) % alignment != 0) {
+            buffer_.append(sizeof(uint32_t), '\0');
+        }
+        link(slot, buffer_.size());
+        append(static_cast<uint32_t>(count));
+        buffer_ += bytes;
+    }
+
+    void string(size_t slot, const std::string& str) {
+        align(sizeof(uint32_t));
+        link(slot, buffer_.size());
+        append(static_cast<uint32_t>(str.size()));
+        buffer_ += str;
+        buffer_ += '\0';
+    }
+
+    /** Make the offset at `slot` point to `target` */
+    void link(size_t slot, size_t target) {
+        const auto offset = static_cast<uint32_t>(target - slot);
+        std::memcpy(&buffer_[slot], &offset, sizeof(offset));
+    }
+
+    /** Return the buffer, with `root` as root table, padded to 8 bytes */
+    std::string finish(const Written& root) {
+        link(0, root.position);
+        align(8);
+        return buffer_;
+    }
+
+  private:
+    template <typename T>
+    void append(T value) {
+        buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    size_t align(size_t alignment) {
+        buffer_.append((alignment - buffer_.size() % alignment) % alignment, '\0');
+        return buffer_.size();
+    }
+
+    std::string buffer_;
+};
+
+/** Bounds checked reads of a FlatBuffers table */
+class FlatBufferTable
+{
+  public:
+    static FlatBufferTable root(const char* data, size_t size) {
+        const FlatBufferTable buffer(data, size, 0);
+        return {data, size, buffer.read<uint32_t>(0)};
+    }
+
+    template <typename T>
+    T scalar(uint16_t id, T defaultValue) const {
+        const size_t position = field(id);
+        return position == 0 ? defaultValue : read<T>(position);
+    }
+
+    bool has(uint16_t id) const {
+        return field(id) != 0;
+    }
+
+    FlatBufferTable table(uint16_t id) const {
+        return {data_, size_, target(required(id))};
+    }
+
+    std::string string(uint16_t id) const {
+        const size_t position = target(required(id));
+        const auto length = read<uint32_t>(position);
+        check(position + sizeof(uint32_t), length);
+        return {data_ + position + sizeof(uint32_t), length};
+    }
+
+    /** Number of elements of a vector, 0 if absent */
+    size_t length(uint16_t id) const {
+        return has(id) ? read<uint32_t>(target(field(id))) : 0;
+    }
+
+    /** The `index`th table of a vector of tables */
+    FlatBufferTable element(uint16_t id, size_t index) const {
+        return {data_, size_, target(elements(id, index, sizeof(uint32_t)))};
+    }
+
+    /** The field at `offset` of the `index`th struct of a vector of structs */
+    template <typename T>
+    T structField(uint16_t id, size_t index, size_t structSize, size_t offset) const {
+        return read<T>(elements(id, index, structSize) + offset);
+    }
+
+  private:
+    FlatBufferTable(const char* data, size_t size, size_t position)
+        : data_(data)
+        , size_(size)
+        , position_(position) {}
+
+    void check(size_t position, size_t size) const {
+        if (position > size_ || size > size_ - position) {
+            throw RawDataError("Arrow: invalid flatbuffer metadata");
+        }
+    }
+
+    template <typename T>
+    T read(size_t position) const {
+        check(position, sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + position, sizeof(T));
+        return value;
+    }
+
+    /** Position of the field `id`, 0 if absent */
+    size_t field(uint16_t id) const {
+        const auto vtable = static_cast<size_t>(static_cast<int64_t>(position_) -
+                                                read<int32_t>(position_));
+        const auto vtableSize = read<uint16_t>(vtable);
+        const size_t entry = sizeof(uint16_t) * (2u + id);
+        if (entry + sizeof(uint16_t) > vtableSize) {
+            return 0;
+        }
+        const auto offset = read<uint16_t>(vtable + entry);
+        return offset == 0 ? 0 : position_ + offset;
+    }
+
+    size_t required(uint16_t id) const {
+        const size_t position = field(id);
+        if (position == 0) {
+            throw RawDataError("Arrow: missing flatbuffer field");
+        }
+        return position;
+    }
+
+    size_t target(size_t position) const {
+        return position + read<uint32_t>(position);
+    }
+
+    size_t elements(uint16_t id, size_t index, size_t elementSize) const {
+        const size_t vector = target(required(id));
+        if (index >= read<uint32_t>(vector)) {
+            throw RawDataError("Arrow: flatbuffer vector index out of range");
+        }
+        return vector + sizeof(uint32_t) + index * elementSize;
+    }
+
+    const char* data_;
+    size_t size_;
+    size_t position_;
+};
+
+// From the Arrow format specification (format/Schema.fbs, Message.fbs and File.fbs)
+constexpr int16_t METADATA_V5 = 4;
+constexpr uint8_t HEADER_SCHEMA = 1;
+constexpr uint8_t HEADER_DICTIONARY_BATCH = 2;
+constexpr uint8_t HEADER_RECORD_BATCH = 3;
+constexpr int32_t CONTINUATION = -1;
+constexpr char MAGIC[] = "ARROW1";
+constexpr size_t MAGIC_SIZE = 6;
+constexpr size_t BODY_ALIGNMENT = 8;
+
+enum TypeId : uint8_t {
+    TYPE_INT = 2,
+    TYPE_FLOATING_POINT = 3,
+    TYPE_UTF8 = 5,
+    TYPE_BOOL = 6,
+    TYPE_LARGE_UTF8 = 20
+};
+
+namespace table_id {
+// Message
+constexpr uint16_t MESSAGE_VERSION = 0, MESSAGE_HEADER_TYPE = 1, MESSAGE_HEADER = 2,
+                   MESSAGE_BODY_LENGTH = 3;
+// Schema
+constexpr uint16_t SCHEMA_FIELDS = 1;
+// Field
+constexpr uint16_t FIELD_NAME = 0, FIELD_NULLABLE = 1, FIELD_TYPE_TYPE = 2, FIELD_TYPE = 3,
+                   FIELD_DICTIONARY = 4, FIELD_CHILDREN = 5;
+// Int, FloatingPoint
+constexpr uint16_t INT_BIT_WIDTH = 0, INT_IS_SIGNED = 1, FLOATING_POINT_PRECISION = 0;
+// RecordBatch
+constexpr uint16_t BATCH_LENGTH = 0, BATCH_NODES = 1, BATCH_BUFFERS = 2, BATCH_COMPRESSION = 3;
+// Footer
+constexpr uint16_t FOOTER_VERSION = 0, FOOTER_SCHEMA = 1, FOOTER_DICTIONARIES = 2,
+                   FOOTER_RECORD_BATCHES = 3;
+}  // namespace table_id
+
+// FieldNode and Buffer structs are two int64
+constexpr size_t NODE_SIZE = 16;
+constexpr size_t BUFFER_SIZE = 16;
+
+/** A column to write: its Arrow type and its buffers, without the (empty) validity bitmap */
+struct Column {
+    std::string name;
+    TypeId type;
+    int32_t bitWidth;
+    int64_t length;
+    std::vector<std::string> buffers;
+};
+
+template <typename T>
+Column numericColumn(const std::string& name, const std::vector<T>& values) {
+    static_assert(std::is_arithmetic<T>::value, "numeric columns only");
+    return {name,
+            std::is_floating_point<T>::value ? TYPE_FLOATING_POINT : TYPE_INT,
+            static_cast<int32_t>(8 * sizeof(T)),
+            static_cast<int64_t>(values.size()),
+            {std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T))}};
+}
+
+Column boolColumn(const std::string& name, const std::vector<bool>& values) {
+    std::string bits((values.size() + 7) / 8, '\0');
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i]) {
+            bits[i / 8] = static_cast<char>(bits[i / 8] | (1 << (i % 8)));
+        }
+    }
+    return {name, TYPE_BOOL, 1, static_cast<int64_t>(values.size()), {bits}};
+}
+
+Column utf8Column(const std::string& name, const std::vector<std::string>& values) {
+    std::vector<int32_t> offsets{0};
+    std::string data;
+    for (const auto& value : values) {
+        data += value;
+        offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+    return {name,
+            TYPE_UTF8,
+            0,
+            static_cast<int64_t>(values.size()),
+            {std::string(reinterpret_cast<const char*>(offsets.data()),
+                         offsets.size() * sizeof(int32_t)),
+             data}};
+}
+
+template <typename T>
+void appendBytes(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeSchema(FlatBufferBuilder& builder, size_t slot, const std::vector<Column>& columns) {
+    using namespace table_id;
+    const auto schema = builder.table(FlatBufferBuilder::Table().offset(SCHEMA_FIELDS));
+    builder.link(slot, schema.position);
+
+    const size_t fields = builder.offsets(schema.slot(SCHEMA_FIELDS), columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const auto& column = columns[i];
+        const auto field = builder.table(FlatBufferBuilder::Table()
+                                             .offset(FIELD_NAME)
+                                             .scalar<uint8_t>(FIELD_NULLABLE, 0)
+                                             .scalar<uint8_t>(FIELD_TYPE_TYPE, column.type)
+                                             .offset(FIELD_TYPE)
+                                             .offset(FIELD_CHILDREN));
+        builder.link(fields + i * sizeof(uint32_t), field.position);
+        builder.string(field.slot(FIELD_NAME), column.name);
+
+        FlatBufferBuilder::Table type;
+        if (column.type == TYPE_INT) {
+            type.scalar<int32_t>(INT_BIT_WIDTH, column.bitWidth)
+                .scalar<uint8_t>(INT_IS_SIGNED, 1);
+        } else if (column.type == TYPE_FLOATING_POINT) {
+            type.scalar<int16_t>(FLOATING_POINT_PRECISION, column.bitWidth == 32 ? 1 : 2);
+        }
+        builder.link(field.slot(FIELD_TYPE), builder.table(type).position);
+        builder.offsets(field.slot(FIELD_CHILDREN), 0);
+    }
+}
+
+/** Return the encapsulated message: continuation, metadata size, metadata, body */
+std::string encapsulate(const std::string& metadata, const std::string& body) {
+    std::string message;
+    appendBytes(message, CONTINUATION);
+    appendBytes(message, static_cast<int32_t>(metadata.size()));
+    return message + metadata + body;
+}
+
+std::string schemaMessage(const std::vector<Column>& columns) {
+    using namespace table_id;
+    FlatBufferBuilder builder;
+    const auto message = builder.table(FlatBufferBuilder::Table()
+                                           .scalar<int16_t>(MESSAGE_VERSION, METADATA_V5)
+                                           .scalar<uint8_t>(MESSAGE_HEADER_TYPE, HEADER_SCHEMA)
+                                           .offset(MESSAGE_HEADER)
+                                           .scalar<int64_t>(MESSAGE_BODY_LENGTH, 0));
+    writeSchema(builder, message.slot(MESSAGE_HEADER), columns);
+    return encapsulate(builder.finish(message), {});
+}
+
+std::string recordBatchMessage(const std::vector<Column>& columns, int64_t length) {
+    using namespace table_id;
+    std::string body;
+    std::string nodes;
+    std::string buffers;
+    size_t nBuffers = 0;
+    for (const auto& column : columns) {
+        appendBytes(nodes, column.length);
+        appendBytes(nodes, int64_t{0});  // null count
+
+        // the validity bitmap can be omitted when there are no nulls
+        appendBytes(buffers, static_cast<int64_t>(body.size()));
+        appendBytes(buffers, int64_t{0});
+        ++nBuffers;
+
+        for (const auto& buffer : column.buffers) {
+            appendBytes(buffers, static_cast<int64_t>(body.size()));
+            appendBytes(buffers, static_cast<int64_t>(buffer.size()));
+            ++nBuffers;
+            body += buffer;
+            body.append((BODY_ALIGNMENT - body.size() % BODY_ALIGNMENT) % BODY_ALIGNMENT, '\0');
+        }
+    }
+
+    FlatBufferBuilder builder;
+    const auto message = builder.table(
+        FlatBufferBuilder::Table()
+            .scalar<int16_t>(MESSAGE_VERSION, METADATA_V5)
+            .scalar<uint8_t>(MESSAGE_HEADER_TYPE, HEADER_RECORD_BATCH)
+            .offset(MESSAGE_HEADER)
+            .scalar<int64_t>(MESSAGE_BODY_LENGTH, static_cast<int64_t>(body.size())));
+    const auto batch = builder.table(FlatBufferBuilder::Table()
+                                         .scalar<int64_t>(BATCH_LENGTH, length)
+                                         .offset(BATCH_NODES)
+                                         .offset(BATCH_BUFFERS));
+    builder.link(message.slot(MESSAGE_HEADER), batch.position);
+    builder.structs(batch.slot(BATCH_NODES), nodes, columns.size(), 8);
+    builder.structs(batch.slot(BATCH_BUFFERS), buffers, nBuffers, 8);
+    return encapsulate(builder.finish(message), body);
+}
+
+std::string serializeColumns(const std::vector<Column>& columns,
+                             int64_t length,
+                             morphio::arrow::Format format) {
+    using namespace table_id;
+    std::string out;
+    if (format == morphio::arrow::IPC_FILE) {
+        out.append(MAGIC, MAGIC_SIZE);
+        out.append(2, '\0');
+    }
+
+    out += schemaMessage(columns);
+
+    const auto batchOffset = static_cast<int64_t>(out.size());
+    const std::string batch = recordBatchMessage(columns, length);
+    int32_t metadataLength = 0;
+    std::memcpy(&metadataLength, &batch[sizeof(int32_t)], sizeof(int32_t));
+    out += batch;
+
+    // end of stream
+    appendBytes(out, CONTINUATION);
+    appendBytes(out, int32_t{0});
+
+    if (format == morphio::arrow::IPC_FILE) {
+        std::string block;
+        appendBytes(block, batchOffset);
+        appendBytes(block, metadataLength + static_cast<int32_t>(2 * sizeof(int32_t)));
+        appendBytes(block, int32_t{0});  // padding
+        appendBytes(block,
+                    static_cast<int64_t>(batch.size() - 2 * sizeof(int32_t) -
+                                         static_cast<size_t>(metadataLength)));
+
+        FlatBufferBuilder builder;
+        const auto footer = builder.table(FlatBufferBuilder::Table()
+                                              .scalar<int16_t>(FOOTER_VERSION, METADATA_V5)
+                                              .offset(FOOTER_SCHEMA)
+                                              .offset(FOOTER_DICTIONARIES)
+                                              .offset(FOOTER_RECORD_BATCHES));
+        writeSchema(builder, footer.slot(FOOTER_SCHEMA), columns);
+        builder.structs(footer.slot(FOOTER_DICTIONARIES), {}, 0, 8);
+        builder.structs(footer.slot(FOOTER_RECORD_BATCHES), block, 1, 8);
+        const std::string metadata = builder.finish(footer);
+
+        out += metadata;
+        appendBytes(out, static_cast<int32_t>(metadata.size()));
+        out.append(MAGIC, MAGIC_SIZE);
+    }
+    return out;
+}
+
+/** A column read from IPC data: the buffers of each record batch point into the input */
+class ReadColumn
+{
+  public:
+    struct Chunk {
+        int64_t length;
+        std::vector<std::pair<const char*, size_t>> buffers;  // without the validity bitmap
+    };
+
+    std::string name;
+    TypeId type;
+    int32_t bitWidth;
+    bool isSigned;
+    std::vector<Chunk> chunks;
+
+    size_t nBuffers() const {
+        return type == TYPE_UTF8 || type == TYPE_LARGE_UTF8 ? 2 : 1;
+    }
+
+    size_t length() const {
+        size_t length = 0;
+        for (const auto& chunk : chunks) {
+            length += static_cast<size_t>(chunk.length);
+        }
+        return length;
+    }
+
+    /** Copy the rows [begin, begin + count) to `out`, every `stride` elements */
+    template <typename T>
+    void copyTo(size_t begin, size_t count, T* out, size_t stride = 1) const {
+        size_t chunkBegin = 0;
+        for (const auto& chunk : chunks) {
+            const auto chunkLength = static_cast<size_t>(chunk.length);
+            if (count > 0 && begin < chunkBegin + chunkLength) {
+                const size_t first = begin - chunkBegin;
+                const size_t n = std::min(count, chunkLength - first);
+                copyChunk(chunk.buffers[0], first, n, out, stride);
+                out += n * stride;
+                begin += n;
+                count -= n;
+            }
+            chunkBegin += chunkLength;
+        }
+        if (count > 0) {
+            throw RawDataError("Arrow: rows out of range in column " + name);
+        }
+    }
+
+    template <typename T>
+    std::vector<T> values() const {
+        std::vector<T> values(length());
+        copyTo(0, values.size(), values.data());
+        return values;
+    }
+
+    std::vector<std::string> strings() const {
+        if (type != TYPE_UTF8 && type != TYPE_LARGE_UTF8) {
+            throw RawDataError("Arrow: column " + name + " is not a string column");
+        }
+        std::vector<std::string> strings;
+        for (const auto& chunk : chunks) {
+            const auto n = static_cast<size_t>(chunk.length);
+            if (n == 0) {
+                continue;
+            }
+            std::vector<int64_t> offsets(n + 1);
+            if (type == TYPE_UTF8) {
+                convert<int32_t>(chunk.buffers[0], 0, n + 1, offsets.data(), 1);
+            } else {
+                convert<int64_t>(chunk.buffers[0], 0, n + 1, offsets.data(), 1);
+            }
+            const auto& data = chunk.buffers[1];
+            for (size_t i = 0; i < n; ++i) {
+                if (offsets[i] < 0 || offsets[i] > offsets[i + 1] ||
+                    static_cast<size_t>(offsets[i + 1]) > data.second) {
+                    throw RawDataError("Arrow: invalid string offsets in column " + name);
+                }
+                strings.emplace_back(data.first + offsets[i],
+                                     static_cast<size_t>(offsets[i + 1] - offsets[i]));
+            }
+        }
+        return strings;
+    }
+
+  private:
+    template <typename Source, typename T>
+    void convert(const std::pair<const char*, size_t>& buffer,
+                 size_t first,
+                 size_t count,
+                 T* out,
+                 size_t stride) const {
+        if ((first + count) * sizeof(Source) > buffer.second) {
+            throw RawDataError("Arrow: buffer too small in column " + name);
+        }
+        const char* data = buffer.first + first * sizeof(Source);
+        if (std::is_same<Source, T>::value && stride == 1) {
+            // same layout: straight copy from the IPC body
+            std::memcpy(out, data, count * sizeof(T));
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Source value;
+            std::memcpy(&value, data + i * sizeof(Source), sizeof(Source));
+            out[i * stride] = static_cast<T>(value);
+        }
+    }
+
+    template <typename T>
+    void copyChunk(const std::pair<const char*, size_t>& buffer,
+                   size_t first,
+                   size_t count,
+                   T* out,
+                   size_t stride) const {
+        switch (type) {
+        case TYPE_BOOL:
+            if ((first + count + 7) / 8 > buffer.second) {
+                throw RawDataError("Arrow: buffer too small in column " + name);
+            }
+            for (size_t i = first; i < first + count; ++i) {
+                out[(i - first) * stride] = static_cast<T>((buffer.first[i / 8] >> (i % 8)) & 1);
+            }
+            return;
+        case TYPE_FLOATING_POINT:
+            if (bitWidth == 32) {
+                return convert<float>(buffer, first, count, out, stride);
+            }
+            return convert<double>(buffer, first, count, out, stride);
+        case TYPE_INT:
+            switch (bitWidth) {
+            case 8:
+                return isSigned ? convert<int8_t>(buffer, first, count, out, stride)
+                                : convert<uint8_t>(buffer, first, count, out, stride);
+            case 16:
+                return isSigned ? convert<int16_t>(buffer, first, count, out, stride)
+                                : convert<uint16_t>(buffer, first, count, out, stride);
+            case 32:
+                return isSigned ? convert<int32_t>(buffer, first, count, out, stride)
+                                : convert<uint32_t>(buffer, first, count, out, stride);
+            default:
+                return isSigned ? convert<int64_t>(buffer, first, count, out, stride)
+                                : convert<uint64_t>(buffer, first, count, out, stride);
+            }
+        case TYPE_UTF8:
+        case TYPE_LARGE_UTF8:
+            break;
+        }
+        throw RawDataError("Arrow: column " + name + " is not numeric");
+    }
+};
+
+ReadColumn readField(const FlatBufferTable& field) {
+    using namespace table_id;
+    ReadColumn column;
+    column.name = field.string(FIELD_NAME);
+    column.bitWidth = 0;
+    column.isSigned = false;
+
+    if (field.has(FIELD_DICTIONARY) || field.length(FIELD_CHILDREN) > 0) {
+        throw RawDataError("Arrow: dictionary encoded and nested columns are not supported: " +
+                           column.name);
+    }
+
+    const auto type = field.scalar<uint8_t>(FIELD_TYPE_TYPE, 0);
+    switch (type) {
+    case TYPE_INT: {
+        const auto details = field.table(FIELD_TYPE);
+        column.bitWidth = details.scalar<int32_t>(INT_BIT_WIDTH, 0);
+        column.isSigned = details.scalar<uint8_t>(INT_IS_SIGNED, 0) != 0;
+        if (column.bitWidth != 8 && column.bitWidth != 16 && column.bitWidth != 32 &&
+            column.bitWidth != 64) {
+            throw RawDataError("Arrow: invalid integer width for column " + column.name);
+        }
+        break;
+    }
+    case TYPE_FLOATING_POINT: {
+        const auto precision = field.table(FIELD_TYPE).scalar<int16_t>(FLOATING_POINT_PRECISION,
+                                                                        0);
+        if (precision != 1 && precision != 2) {
+            throw RawDataError("Arrow: only single and double precision are supported: " +
+                               column.name);
+        }
+        column.bitWidth = precision == 1 ? 32 : 64;
+        break;
+    }
+    case TYPE_UTF8:
+    case TYPE_LARGE_UTF8:
+    case TYPE_BOOL:
+        break;
+    default:
+        throw RawDataError("Arrow: unsupported type for column " + column.name);
+    }
+    column.type = static_cast<TypeId>(type);
+    return column;
+}
+
+/** The columns of an IPC stream or file, by name */
+class ReadTable
+{
+  public:
+    explicit ReadTable(const std::string& contents) {
+        using namespace table_id;
+        size_t position = 0;
+        if (contents.compare(0, MAGIC_SIZE, MAGIC) == 0) {
+            position = 8;  // the file format embeds the stream format after its magic
+        }
+
+        bool hasSchema = false;
+        while (position + sizeof(int32_t) <= contents.size()) {
+            int32_t metadataLength = read<int32_t>(contents, position);
+            position += sizeof(int32_t);
+            if (metadataLength == CONTINUATION) {
+                metadataLength = read<int32_t>(contents, position);
+                position += sizeof(int32_t);
+            }
+            if (metadataLength == 0) {
+                break;  // end of stream
+            }
+            if (metadataLength < 0 ||
+                static_cast<size_t>(metadataLength) > contents.size() - position) {
+                throw RawDataError("Arrow: truncated message");
+            }
+
+            const auto message = FlatBufferTable::root(contents.data() + position,
+                                                       static_cast<size_t>(metadataLength));
+            position += static_cast<size_t>(metadataLength);
+            const auto bodyLength = message.scalar<int64_t>(MESSAGE_BODY_LENGTH, 0);
+            if (bodyLength < 0 || static_cast<size_t>(bodyLength) > contents.size() - position) {
+                throw RawDataError("Arrow: truncated message body");
+            }
+
+            switch (message.scalar<uint8_t>(MESSAGE_HEADER_TYPE, 0)) {
+            case HEADER_SCHEMA: {
+                const auto schema = message.table(MESSAGE_HEADER);
+                for (size_t i = 0; i < schema.length(SCHEMA_FIELDS); ++i) {
+                    columns_.push_back(readField(schema.element(SCHEMA_FIELDS, i)));
+                }
+                hasSchema = true;
+                break;
+            }
+            case HEADER_RECORD_BATCH:
+                if (!hasSchema) {
+                    throw RawDataError("Arrow: record batch before the schema");
+                }
+                readBatch(message.table(MESSAGE_HEADER),
+                          contents.data() + position,
+                          static_cast<size_t>(bodyLength));
+                break;
+            case HEADER_DICTIONARY_BATCH:
+                throw RawDataError("Arrow: dictionary batches are not supported");
+            default:
+                throw RawDataError("Arrow: unsupported message type");
+            }
+            position += static_cast<size_t>(bodyLength);
+        }
+
+        if (!hasSchema) {
+            throw RawDataError("Arrow: no schema found");
+        }
+    }
+
+    const ReadColumn& column(const std::string& name) const {
+        for (const auto& column : columns_) {
+            if (column.name == name) {
+                return column;
+            }
+        }
+        throw RawDataError("Arrow: missing column " + name);
+    }
+
+    size_t length() const {
+        return columns_.empty() ? 0 : columns_[0].length();
+    }
+
+  private:
+    template <typename T>
+    static T read(const std::string& contents, size_t position) {
+        if (position + sizeof(T) > contents.size()) {
+            throw RawDataError("Arrow: truncated message");
+        }
+        T value;
+        std::memcpy(&value, contents.data() + position, sizeof(T));
+        return value;
+    }
+
+    void readBatch(const FlatBufferTable& batch, const char* body, size_t bodyLength) {
+        using namespace table_id;
+        if (batch.has(BATCH_COMPRESSION)) {
+            throw RawDataError("Arrow: compressed record batches are not supported");
+        }
+        if (batch.length(BATCH_NODES) != columns_.size()) {
+            throw RawDataError("Arrow: record batch does not match the schema");
+        }
+
+        size_t buffer = 0;
+        const auto nextBuffer = [&]() {
+            const auto offset = batch.structField<int64_t>(BATCH_BUFFERS, buffer, BUFFER_SIZE, 0);
+            const auto length = batch.structField<int64_t>(BATCH_BUFFERS, buffer, BUFFER_SIZE, 8);
+            ++buffer;
+            if (offset < 0 || length < 0 || static_cast<size_t>(offset) > bodyLength ||
+                static_cast<size_t>(length) > bodyLength - static_cast<size_t>(offset)) {
+                throw RawDataError("Arrow: buffer out of the message body");
+            }
+            return std::make_pair(body + offset, static_cast<size_t>(length));
+        };
+
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            auto& column = columns_[i];
+            ReadColumn::Chunk chunk;
+            chunk.length = batch.structField<int64_t>(BATCH_NODES, i, NODE_SIZE, 0);
+            if (chunk.length < 0) {
+                throw RawDataError("Arrow: invalid length for column " + column.name);
+            }
+            if (batch.structField<int64_t>(BATCH_NODES, i, NODE_SIZE, 8) != 0) {
+                throw RawDataError("Arrow: null values are not supported: " + column.name);
+            }
+            nextBuffer();  // validity bitmap, unused without nulls
+            for (size_t j = 0; j < column.nBuffers(); ++j) {
+                chunk.buffers.push_back(nextBuffer());
+            }
+            column.chunks.push_back(std::move(chunk));
+        }
+    }
+
+    std::vector<ReadColumn> columns_;
+};
+
+std::vector<Column> morphologiesColumns(const std::vector<std::string>& names,
+                                        const std::vector<morphio::Morphology>& morphologies) {
+    std::vector<int32_t> cellFamilies, somaTypes, versionMajors, versionMinors, somaPointCounts;
+    std::vector<std::string> formats;
+    std::vector<bool> hasPerimeters;
+    std::vector<int64_t> sectionOffsets, pointOffsets;
+
+    int64_t sectionOffset = 0;
+    int64_t pointOffset = 0;
+    for (const auto& morphology : morphologies) {
+        cellFamilies.push_back(morphology.cellFamily());
+        somaTypes.push_back(morphology.somaType());
+        formats.push_back(std::get<0>(morphology.version()));
+        versionMajors.push_back(static_cast<int32_t>(std::get<1>(morphology.version())));
+        versionMinors.push_back(static_cast<int32_t>(std::get<2>(morphology.version())));
+        hasPerimeters.push_back(!morphology.perimeters().empty());
+        sectionOffsets.push_back(sectionOffset);
+        pointOffsets.push_back(pointOffset);
+
+        const auto somaPoints = morphology.soma().points().size();
+        somaPointCounts.push_back(static_cast<int32_t>(somaPoints));
+        sectionOffset += static_cast<int64_t>(morphology.sectionTypes().size());
+        pointOffset += static_cast<int64_t>(somaPoints + morphology.points().size());
+    }
+
+    return {utf8Column("name", names),
+            numericColumn("cell_family", cellFamilies),
+            numericColumn("soma_type", somaTypes),
+            utf8Column("format", formats),
+            numericColumn("version_major", versionMajors),
+            numericColumn("version_minor", versionMinors),
+            boolColumn("has_perimeters", hasPerimeters),
+            numericColumn("section_offset", sectionOffsets),
+            numericColumn("point_offset", pointOffsets),
+            numericColumn("soma_point_count", somaPointCounts)};
+}
+
+std::vector<Column> sectionsColumns(const std::vector<morphio::Morphology>& morphologies) {
+    std::vector<int32_t> morphologyIds, sectionIds, parents, types;
+    std::vector<int64_t> pointOffsets;
+    for (size_t i = 0; i < morphologies.size(); ++i) {
+        const auto& morphology = morphologies[i];
+        const auto offsets = morphology.sectionOffsets();
+        for (const auto& section : morphology.sections()) {
+            morphologyIds.push_back(static_cast<int32_t>(i));
+            sectionIds.push_back(static_cast<int32_t>(section.id()));
+            parents.push_back(section.isRoot() ? -1 : static_cast<int32_t>(section.parent().id()));
+            types.push_back(section.type());
+            pointOffsets.push_back(static_cast<int64_t>(offsets[section.id()]));
+        }
+    }
+    return {numericColumn("morphology", morphologyIds),
+            numericColumn("section", sectionIds),
+            numericColumn("parent", parents),
+            numericColumn("type", types),
+            numericColumn("point_offset", pointOffsets)};
+}
+
+std::vector<Column> pointsColumns(const std::vector<morphio::Morphology>& morphologies) {
+    std::vector<int32_t> morphologyIds, sectionIds;
+    std::vector<morphio::floatType> x, y, z, diameters, perimeters;
+
+    const auto append = [&](const auto& points) {
+        for (const auto& point : points) {
+            x.push_back(point[0]);
+            y.push_back(point[1]);
+            z.push_back(point[2]);
+        }
+    };
+
+    for (size_t i = 0; i < morphologies.size(); ++i) {
+        const auto& morphology = morphologies[i];
+        const auto soma = morphology.soma();
+        append(soma.points());
+        diameters.insert(diameters.end(), soma.diameters().begin(), soma.diameters().end());
+        sectionIds.insert(sectionIds.end(), soma.points().size(), -1);
+        perimeters.resize(diameters.size(), 0);  // the soma has no perimeters
+
+        append(morphology.points());
+        diameters.insert(diameters.end(),
+                         morphology.diameters().begin(),
+                         morphology.diameters().end());
+        const auto offsets = morphology.sectionOffsets();
+        for (size_t section = 0; section + 1 < offsets.size(); ++section) {
+            sectionIds.insert(sectionIds.end(),
+                              offsets[section + 1] - offsets[section],
+                              static_cast<int32_t>(section));
+        }
+
+        if (morphology.perimeters().empty()) {
+            perimeters.resize(diameters.size(), 0);
+        } else {
+            perimeters.insert(perimeters.end(),
+                              morphology.perimeters().begin(),
+                              morphology.perimeters().end());
+        }
+        morphologyIds.resize(diameters.size(), static_cast<int32_t>(i));
+    }
+
+    return {numericColumn("morphology", morphologyIds),
+            numericColumn("section", sectionIds),
+            numericColumn("x", x),
+            numericColumn("y", y),
+            numericColumn("z", z),
+            numericColumn("diameter", diameters),
+            numericColumn("perimeter", perimeters)};
+}
+
+/** Row range [offsets[i], offsets[i + 1]) of the `i`th morphology, checked against `total` */
+std::pair<size_t, size_t> rowRange(const std::vector<int64_t>& offsets,
+                                   size_t i,
+                                   size_t total,
+                                   const std::string& table) {
+    const auto begin = offsets[i];
+    const auto end = i + 1 < offsets.size() ? offsets[i + 1] : static_cast<int64_t>(total);
+    if (begin < 0 || begin > end || static_cast<size_t>(end) > total) {
+        throw RawDataError("Arrow: invalid " + table + " offset for morphology " +
+                           std::to_string(i));
+    }
+    return {static_cast<size_t>(begin), static_cast<size_t>(end)};
+}
+
+void copyPoints(const ReadTable& points, size_t begin, size_t count, morphio::Points& out) {
+    out.resize(count);
+    if (count == 0) {
+        return;
+    }
+    points.column("x").copyTo(begin, count, &out[0][0], 3);
+    points.column("y").copyTo(begin, count, &out[0][1], 3);
+    points.column("z").copyTo(begin, count, &out[0][2], 3);
+}
+
+void copyValues(const ReadColumn& column,
+                size_t begin,
+                size_t count,
+                std::vector<morphio::floatType>& out) {
+    out.resize(count);
+    column.copyTo(begin, count, out.data());
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw RawDataError("File: " + path + " does not exist.");
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+}  // namespace
+
+namespace morphio {
+namespace arrow {
+
+std::string tableName(Table table) {
+    switch (table) {
+    case MORPHOLOGIES:
+        return "morphologies";
+    case SECTIONS:
+        return "sections";
+    case POINTS:
+        return "points";
+    }
+    throw MorphioError("Unknown Arrow table");
+}
+
+std::string serialize(Table table,
+                      const std::vector<std::string>& names,
+                      const std::vector<Morphology>& morphologies,
+                      Format format) {
+    if (names.size() != morphologies.size()) {
+        throw MorphioError("Arrow: there must be one name per morphology");
+    }
+
+    std::vector<Column> columns;
+    switch (table) {
+    case MORPHOLOGIES:
+        columns = morphologiesColumns(names, morphologies);
+        break;
+    case SECTIONS:
+        columns = sectionsColumns(morphologies);
+        break;
+    case POINTS:
+        columns = pointsColumns(morphologies);
+        break;
+    }
+    return serializeColumns(columns, columns[0].length, format);
+}
+
+void write(const std::string& directory,
+           const std::vector<std::string>& names,
+           const std::vector<Morphology>& morphologies,
+           Format format) {
+    if (!is_directory(directory)) {
+        throw MorphioError("Arrow: " + directory + " is not a directory");
+    }
+    for (const auto table : {MORPHOLOGIES, SECTIONS, POINTS}) {
+        const std::string path = join_path(directory, tableName(table) + ".arrow");
+        std::ofstream file(path, std::ios::binary);
+        file << serialize(table, names, morphologies, format);
+        if (!file) {
+            throw MorphioError("Arrow: could not write " + path);
+        }
+    }
+}
+
+Population deserialize(const std::string& morphologiesContents,
+                       const std::string& sectionsContents,
+                       const std::string& pointsContents) {
+    const ReadTable morphologies(morphologiesContents);
+    const ReadTable sections(sectionsContents);
+    const ReadTable points(pointsContents);
+
+    Population population;
+    population.names = morphologies.column("name").strings();
+    const auto cellFamilies = morphologies.column("cell_family").values<int32_t>();
+    const auto somaTypes = morphologies.column("soma_type").values<int32_t>();
+    const auto formats = morphologies.column("format").strings();
+    const auto versionMajors = morphologies.column("version_major").values<uint32_t>();
+    const auto versionMinors = morphologies.column("version_minor").values<uint32_t>();
+    const auto hasPerimeters = morphologies.column("has_perimeters").values<uint8_t>();
+    const auto sectionOffsets = morphologies.column("section_offset").values<int64_t>();
+    const auto pointOffsets = morphologies.column("point_offset").values<int64_t>();
+    const auto somaPointCounts = morphologies.column("soma_point_count").values<int32_t>();
+
+    const auto parents = sections.column("parent").values<int32_t>();
+    const auto types = sections.column("type").values<int32_t>();
+    const auto sectionPointOffsets = sections.column("point_offset").values<int64_t>();
+
+    population.morphologies.reserve(population.names.size());
+    for (size_t i = 0; i < population.names.size(); ++i) {
+        Property::Properties properties;
+        properties._cellLevel._cellFamily = static_cast<CellFamily>(cellFamilies[i]);
+        properties._cellLevel._somaType = static_cast<SomaType>(somaTypes[i]);
+        properties._cellLevel._version = {formats[i], versionMajors[i], versionMinors[i]};
+
+        const auto pointRange = rowRange(pointOffsets, i, points.length(), "point");
+        const auto somaCount = static_cast<size_t>(somaPointCounts[i]);
+        if (somaPointCounts[i] < 0 || somaCount > pointRange.second - pointRange.first) {
+            throw RawDataError("Arrow: invalid soma point count for morphology " +
+                               population.names[i]);
+        }
+        const size_t neuriteBegin = pointRange.first + somaCount;
+        const size_t neuriteCount = pointRange.second - neuriteBegin;
+
+        copyPoints(points, pointRange.first, somaCount, properties._somaLevel._points);
+        copyValues(points.column("diameter"),
+                   pointRange.first,
+                   somaCount,
+                   properties._somaLevel._diameters);
+        copyPoints(points, neuriteBegin, neuriteCount, properties._pointLevel._points);
+        copyValues(points.column("diameter"),
+                   neuriteBegin,
+                   neuriteCount,
+                   properties._pointLevel._diameters);
+        if (hasPerimeters[i] != 0) {
+            copyValues(points.column("perimeter"),
+                       neuriteBegin,
+                       neuriteCount,
+                       properties._pointLevel._perimeters);
+        }
+
+        const auto sectionRange = rowRange(sectionOffsets, i, parents.size(), "section");
+        const auto nSections = static_cast<int64_t>(sectionRange.second - sectionRange.first);
+        auto& structure = properties._sectionLevel._sections;
+        auto& sectionTypes = properties._sectionLevel._sectionTypes;
+        structure.reserve(static_cast<size_t>(nSections));
+        sectionTypes.reserve(static_cast<size_t>(nSections));
+        for (size_t section = sectionRange.first; section < sectionRange.second; ++section) {
+            if (parents[section] < -1 || parents[section] >= nSections ||
+                sectionPointOffsets[section] < 0 ||
+                static_cast<size_t>(sectionPointOffsets[section]) > neuriteCount) {
+                throw RawDataError("Arrow: invalid section " +
+                                   std::to_string(section - sectionRange.first) +
+                                   " in morphology " + population.names[i]);
+            }
+            structure.push_back({sectionPointOffsets[section], parents[section]});
+            sectionTypes.push_back(static_cast<SectionType>(types[section]));
+        }
+
+        population.morphologies.push_back(details::MorphologyAccess::fromProperties(properties));
+    }
+    return population;
+}
+
+Population read(const std::string& directory) {
+    return deserialize(readFile(join_path(directory, tableName(MORPHOLOGIES) + ".arrow")),
+                       readFile(join_path(directory, tableName(SECTIONS) + ".arrow")),
+                       readFile(join_path(directory, tableName(POINTS) + ".arrow")));
+}
+
+}  // namespace arrow
+}  // namespace morphio
@@ -0,0 +1,224 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::min, std::max
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>  // std::move
+
+#include <morphio/bounding_volumes.h>
+
+#include "convex_hull.h"
+#include "morphology_access.h"
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::Bounds;
+using morphio::Point;
+using morphio::Points;
+using morphio::details::PointMoments;
+
+struct CacheEntry {
+    std::weak_ptr<const morphio::Property::Properties> properties;
+    std::shared_ptr<const morphio::BoundingVolumes> volumes;
+};
+
+/** Volumes by morphology data; an expired entry may be for a freed address reused since */
+struct VolumesCache {
+    std::mutex mutex;
+    std::map<const morphio::Property::Properties*, CacheEntry> entries;
+    /// Where the next sweep starts
+    const morphio::Property::Properties* sweepFrom = nullptr;
+
+    /**
+     * Drop the expired entries among the next few ones, on every call: they are all visited
+     * while the cache is used, lookups included, without ever scanning all of it at once
+     */
+    void sweep() {
+        constexpr size_t length = 2;
+        auto it = entries.lower_bound(sweepFrom);
+        for (size_t i = 0; i < length && !entries.empty(); ++i) {
+            if (it == entries.end()) {
+                it = entries.begin();
+            }
+            if (it->second.properties.expired()) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        sweepFrom = it == entries.end() ? nullptr : it->first;
+    }
+};
+
+VolumesCache& volumesCache() {
+    static VolumesCache cache;
+    return cache;
+}
+
+/** The bounds of a set of points, and what is needed to merge them with other bounds */
+struct PartialBounds {
+    Bounds bounds;
+    PointMoments moments;
+};
+
+Bounds makeBounds(const Points& points, const PointMoments& moments) {
+    Bounds bounds;
+    if (points.empty()) {
+        return bounds;
+    }
+
+    const auto hull = morphio::details::convexHull(points);
+    bounds.convexHull.vertices = hull.vertices;
+    bounds.convexHull.volume = static_cast<morphio::floatType>(hull.volume);
+    bounds.convexHull.area = static_cast<morphio::floatType>(hull.area);
+
+    // Extrema of any linear function of the points are reached at vertices of their hull
+    auto& box = bounds.boundingBox;
+    box.min = box.max = hull.vertices.front();
+    for (const auto& vertex : hull.vertices) {
+        for (size_t i = 0; i < 3; ++i) {
+            box.min[i] = std::min(box.min[i], vertex[i]);
+            box.max[i] = std::max(box.max[i], vertex[i]);
+        }
+    }
+
+    auto& oriented = bounds.orientedBoundingBox;
+    oriented.axes = moments.principalAxes();
+    Point lowest, highest;
+    lowest.fill(std::numeric_limits<morphio::floatType>::max());
+    highest.fill(std::numeric_limits<morphio::floatType>::lowest());
+    for (const auto& vertex : hull.vertices) {
+        for (size_t i = 0; i < 3; ++i) {
+            const auto& axis = oriented.axes[i];
+            const auto projection = vertex[0] * axis[0] + vertex[1] * axis[1] + vertex[2] * axis[2];
+            lowest[i] = std::min(lowest[i], projection);
+            highest[i] = std::max(highest[i], projection);
+        }
+    }
+    oriented.center = {0, 0, 0};
+    for (size_t i = 0; i < 3; ++i) {
+        const auto middle = (lowest[i] + highest[i]) / 2;
+        oriented.halfExtents[i] = (highest[i] - lowest[i]) / 2;
+        for (size_t j = 0; j < 3; ++j) {
+            oriented.center[j] += middle * oriented.axes[i][j];
+        }
+    }
+
+    return bounds;
+}
+
+PartialBounds neuriteBounds(const morphio::Morphology& morphology,
+                            uint32_t root,
+                            const std::vector<uint64_t>& offsets) {
+    const auto& points = morphology.points();
+    const auto& children = morphology.connectivity();
+
+    PartialBounds result;
+    Points neuritePoints;
+    std::vector<uint32_t> stack{root};
+    while (!stack.empty()) {
+        const uint32_t id = stack.back();
+        stack.pop_back();
+        for (uint64_t i = offsets[id]; i < offsets[id + 1]; ++i) {
+            neuritePoints.push_back(points[i]);
+            result.moments.add(points[i]);
+        }
+        const auto it = children.find(static_cast<int>(id));
+        if (it != children.end()) {
+            stack.insert(stack.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    result.bounds = makeBounds(neuritePoints, result.moments);
+    return result;
+}
+
+Bounds mergeBounds(const std::vector<const PartialBounds*>& parts) {
+    Points vertices;
+    PointMoments moments;
+    for (const auto* part : parts) {
+        const auto& partVertices = part->bounds.convexHull.vertices;
+        vertices.insert(vertices.end(), partVertices.begin(), partVertices.end());
+        moments.merge(part->moments);
+    }
+    return makeBounds(vertices, moments);
+}
+
+}  // namespace
+
+namespace morphio {
+
+BoundingVolumes::BoundingVolumes(const Morphology& morphology, unsigned int nThreads) {
+    const auto& connectivity = morphology.connectivity();
+    const auto roots = connectivity.find(-1);
+    if (roots == connectivity.end()) {
+        return;
+    }
+    const auto& rootIds = roots->second;
+    const auto& types = morphology.sectionTypes();
+    const std::vector<uint64_t> offsets = morphology.sectionOffsets();
+
+    std::vector<PartialBounds> parts(rootIds.size());
+    details::parallelFor(
+        rootIds.size(),
+        [&](size_t i) { parts[i] = neuriteBounds(morphology, rootIds[i], offsets); },
+        nThreads);
+
+    std::vector<const PartialBounds*> all;
+    std::map<SectionType, std::vector<const PartialBounds*>> byType;
+    for (size_t i = 0; i < rootIds.size(); ++i) {
+        neuriteTypes_.push_back(types[rootIds[i]]);
+        neurites_.push_back(parts[i].bounds);
+        all.push_back(&parts[i]);
+        byType[types[rootIds[i]]].push_back(&parts[i]);
+    }
+
+    for (const auto& type : byType) {
+        byType_[type.first] = mergeBounds(type.second);
+    }
+    morphology_ = mergeBounds(all);
+}
+
+std::shared_ptr<const BoundingVolumes> BoundingVolumes::cached(const Morphology& morphology,
+                                                              unsigned int nThreads) {
+    const auto properties = details::MorphologyAccess::sharedProperties(morphology);
+    auto& cache = volumesCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.sweep();
+        const auto it = cache.entries.find(properties.get());
+        if (it != cache.entries.end()) {
+            if (!it->second.properties.expired()) {
+                return it->second.volumes;
+            }
+            cache.entries.erase(it);
+        }
+    }
+
+    // Computed without the lock: other morphologies can be looked up meanwhile
+    auto volumes = std::make_shared<const BoundingVolumes>(morphology, nThreads);
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.sweep();
+    auto& entry = cache.entries[properties.get()];
+    // Another thread may have computed them first, they are the same
+    if (entry.properties.expired()) {
+        entry = CacheEntry{properties, std::move(volumes)};
+    }
+    return entry.volumes;
+}
+
+const Bounds& BoundingVolumes::neuriteType(SectionType type) const {
+    const auto it = byType_.find(type);
+    if (it == byType_.end()) {
+        throw MorphioError("No neurite of type " + std::to_string(static_cast<int>(type)));
+    }
+    return it->second;
+}
+
+}  // namespace morphio
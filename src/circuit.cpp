@@ -0,0 +1,369 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::nth_element, std::push_heap, std::sort
+#include <limits>
+#include <utility>  // std::move, std::pair
+
+#include <morphio/circuit.h>
+#include <morphio/exceptions.h>
+#include <morphio/morphology.h>
+
+#include "point_utils.h"  // boxDistance
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::floatType;
+using morphio::Point;
+using morphio::circuit::SegmentHit;
+
+constexpr uint32_t LEAF_SIZE = 4;
+
+/** The points of the morphology placed by the transform */
+morphio::Points placedPoints(const morphio::Morphology& morphology,
+                             const morphio::Transform& transform) {
+    const auto points = morphology.points();
+    morphio::Points placed(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        placed[i] = transform.apply(points[i]);
+    }
+    return placed;
+}
+
+/**
+ * Bounding box of the placed segments of the morphology, including their radii; inverted
+ * (min > max) if it has no segments
+ */
+morphio::BoundingBox segmentsBox(const morphio::Morphology& morphology,
+                                 const morphio::Transform& transform) {
+    constexpr floatType infinity = std::numeric_limits<floatType>::infinity();
+    morphio::BoundingBox box{{infinity, infinity, infinity}, {-infinity, -infinity, -infinity}};
+    const auto points = morphology.points();
+    const auto diameters = morphology.diameters();
+    const auto offsets = morphology.sectionOffsets();
+    for (size_t s = 0; s + 1 < offsets.size(); ++s) {
+        if (offsets[s + 1] - offsets[s] < 2) {
+            continue;
+        }
+        for (uint64_t i = offsets[s]; i < offsets[s + 1]; ++i) {
+            const Point placed = transform.apply(points[i]);
+            const floatType radius = diameters[i] / 2;
+            for (size_t k = 0; k < 3; ++k) {
+                box.min[k] = std::min(box.min[k], placed[k] - radius);
+                box.max[k] = std::max(box.max[k], placed[k] + radius);
+            }
+        }
+    }
+    return box;
+}
+
+bool isEmpty(const morphio::BoundingBox& box) {
+    return box.min[0] > box.max[0];
+}
+
+bool closer(const SegmentHit& left, const SegmentHit& right) {
+    if (left.distance != right.distance) {
+        return left.distance < right.distance;
+    }
+    if (left.cell != right.cell) {
+        return left.cell < right.cell;
+    }
+    return left.section != right.section ? left.section < right.section
+                                         : left.segment < right.segment;
+}
+
+}  // namespace
+
+namespace morphio {
+namespace circuit {
+
+SpatialIndex::SpatialIndex(Collection collection,
+                           std::vector<Cell> cells,
+                           size_t maxResidentCells,
+                           unsigned int options,
+                           unsigned int nThreads)
+    : collection_(std::move(collection))
+    , cells_(std::move(cells))
+    , options_(options)
+    , maxResidentCells_(maxResidentCells) {
+    if (cells_.size() > std::numeric_limits<uint32_t>::max()) {
+        throw MorphioError("Circuit index: more than 2^32 cells are not supported");
+    }
+
+    // every morphology is loaded once, for all the cells placing it
+    std::vector<std::string> names;
+    std::vector<std::vector<uint32_t>> cellsOf;
+    {
+        std::unordered_map<std::string, size_t> nameIndex;
+        for (size_t i = 0; i < cells_.size(); ++i) {
+            const auto inserted = nameIndex.emplace(cells_[i].morphology, names.size());
+            if (inserted.second) {
+                names.push_back(cells_[i].morphology);
+                cellsOf.emplace_back();
+            }
+            cellsOf[inserted.first->second].push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // only the boxes are kept; visit the morphologies in the order suggested by the collection
+    boxes_.resize(cells_.size());
+    const std::vector<size_t> loopIndices = collection_.argsort(names);
+    details::parallelFor(
+        loopIndices.size(),
+        [&](size_t k) {
+            const size_t i = loopIndices[k];
+            const auto morphology = collection_.load<Morphology>(names[i], options_);
+            for (const uint32_t cell : cellsOf[i]) {
+                boxes_[cell] = segmentsBox(morphology, cells_[cell].transform);
+            }
+        },
+        nThreads);
+
+    build();
+}
+
+void SpatialIndex::build() {
+    for (uint32_t cell = 0; cell < cells_.size(); ++cell) {
+        if (!isEmpty(boxes_[cell])) {
+            order_.push_back(cell);
+        }
+    }
+    const auto count = static_cast<uint32_t>(order_.size());
+    if (count == 0) {
+        return;
+    }
+
+    nodes_.reserve(2 * (count / LEAF_SIZE + 1));
+    nodes_.push_back({{}, {}, 0, count});
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const uint32_t n = stack.back();
+        stack.pop_back();
+        const uint32_t first = nodes_[n].first;
+        const uint32_t size = nodes_[n].count;
+
+        Point min = boxes_[order_[first]].min;
+        Point max = boxes_[order_[first]].max;
+        for (uint32_t i = first + 1; i < first + size; ++i) {
+            const auto& box = boxes_[order_[i]];
+            for (size_t k = 0; k < 3; ++k) {
+                min[k] = std::min(min[k], box.min[k]);
+                max[k] = std::max(max[k], box.max[k]);
+            }
+        }
+        nodes_[n].min = min;
+        nodes_[n].max = max;
+        if (size <= LEAF_SIZE) {
+            continue;
+        }
+
+        // split at the median of the box centers, along the longest axis
+        size_t axis = 0;
+        for (size_t k = 1; k < 3; ++k) {
+            if (max[k] - min[k] > max[axis] - min[axis]) {
+                axis = k;
+            }
+        }
+        const uint32_t half = size / 2;
+        std::nth_element(order_.begin() + first,
+                         order_.begin() + first + half,
+                         order_.begin() + first + size,
+                         [&](uint32_t left, uint32_t right) {
+                             return boxes_[left].min[axis] + boxes_[left].max[axis] <
+                                    boxes_[right].min[axis] + boxes_[right].max[axis];
+                         });
+        const auto child = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back({{}, {}, first, half});
+        nodes_.push_back({{}, {}, first + half, size - half});
+        nodes_[n].first = child;
+        nodes_[n].count = 0;
+        stack.push_back(child + 1);
+        stack.push_back(child);
+    }
+}
+
+size_t SpatialIndex::residentCells() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return resident_.size();
+}
+
+std::shared_ptr<const vasculature::ProximityIndex> SpatialIndex::cellIndex(uint32_t cell) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = resident_.find(cell);
+        if (it != resident_.end()) {
+            recentlyUsed_.splice(recentlyUsed_.begin(), recentlyUsed_, it->second.use);
+            return it->second.index;
+        }
+    }
+
+    // built outside of the lock: the other cells can be queried meanwhile
+    const auto morphology = collection_.load<Morphology>(cells_[cell].morphology, options_);
+    const auto diameters = morphology.diameters();
+    auto index = std::make_shared<const vasculature::ProximityIndex>(
+        placedPoints(morphology, cells_[cell].transform),
+        std::vector<floatType>(diameters.begin(), diameters.end()),
+        morphology.sectionOffsets());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = resident_.find(cell);
+    if (it != resident_.end()) {
+        // built concurrently by another query
+        recentlyUsed_.splice(recentlyUsed_.begin(), recentlyUsed_, it->second.use);
+        return it->second.index;
+    }
+    if (maxResidentCells_ > 0) {
+        recentlyUsed_.push_front(cell);
+        resident_[cell] = {index, recentlyUsed_.begin()};
+        while (resident_.size() > maxResidentCells_) {
+            resident_.erase(recentlyUsed_.back());
+            recentlyUsed_.pop_back();
+        }
+    }
+    return index;
+}
+
+template <typename F>
+void SpatialIndex::forEachCell(const Point& min,
+                               const Point& max,
+                               floatType distance,
+                               const F& f) const {
+    if (nodes_.empty()) {
+        return;
+    }
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (boxDistance(min, max, node.min, node.max) > distance) {
+            continue;
+        }
+        if (node.count == 0) {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            const auto& box = boxes_[order_[i]];
+            if (boxDistance(min, max, box.min, box.max) <= distance) {
+                f(order_[i]);
+            }
+        }
+    }
+}
+
+std::vector<SegmentHit> SpatialIndex::inBox(const BoundingBox& box) const {
+    std::vector<SegmentHit> hits;
+    forEachCell(box.min, box.max, 0, [&](uint32_t cell) {
+        for (const auto& hit : cellIndex(cell)->inBox(box.min, box.max)) {
+            hits.push_back({cell, hit.section, hit.segment, 0});
+        }
+    });
+    std::sort(hits.begin(), hits.end(), closer);
+    return hits;
+}
+
+std::vector<SegmentHit> SpatialIndex::inSphere(const Point& center, floatType radius) const {
+    std::vector<SegmentHit> hits;
+    forEachCell(center, center, radius, [&](uint32_t cell) {
+        for (const auto& hit : cellIndex(cell)->within(center, radius)) {
+            hits.push_back({cell, hit.section, hit.segment, hit.distance});
+        }
+    });
+    std::sort(hits.begin(), hits.end(), closer);
+    return hits;
+}
+
+std::vector<SegmentHit> SpatialIndex::nearest(const Point& point, size_t k) const {
+    // a max-heap of the k closest hits found so far
+    std::vector<SegmentHit> hits;
+    if (nodes_.empty() || k == 0) {
+        return hits;
+    }
+    const auto bound = [&]() {
+        return hits.size() < k ? std::numeric_limits<floatType>::infinity()
+                               : hits.front().distance;
+    };
+
+    std::vector<std::pair<floatType, uint32_t>> stack{{0, 0}};
+    while (!stack.empty()) {
+        const auto top = stack.back();
+        stack.pop_back();
+        if (top.first > bound()) {
+            continue;
+        }
+        const Node& node = nodes_[top.second];
+        if (node.count > 0) {
+            // the closest cells first: loading the others may then be avoided
+            std::vector<std::pair<floatType, uint32_t>> cells;
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const auto& box = boxes_[order_[i]];
+                cells.emplace_back(boxDistance(point, point, box.min, box.max), order_[i]);
+            }
+            std::sort(cells.begin(), cells.end());
+            for (const auto& distanceAndCell : cells) {
+                if (distanceAndCell.first > bound()) {
+                    break;
+                }
+                const uint32_t cell = distanceAndCell.second;
+                for (const auto& hit : cellIndex(cell)->nearest(point, k, bound())) {
+                    const SegmentHit candidate{cell, hit.section, hit.segment, hit.distance};
+                    if (hits.size() < k) {
+                        hits.push_back(candidate);
+                        std::push_heap(hits.begin(), hits.end(), closer);
+                    } else if (closer(candidate, hits.front())) {
+                        std::pop_heap(hits.begin(), hits.end(), closer);
+                        hits.back() = candidate;
+                        std::push_heap(hits.begin(), hits.end(), closer);
+                    }
+                }
+            }
+            continue;
+        }
+        // visit the closest child first
+        const Node& left = nodes_[node.first];
+        const Node& right = nodes_[node.first + 1];
+        const floatType leftDistance = boxDistance(point, point, left.min, left.max);
+        const floatType rightDistance = boxDistance(point, point, right.min, right.max);
+        if (leftDistance <= rightDistance) {
+            stack.emplace_back(rightDistance, node.first + 1);
+            stack.emplace_back(leftDistance, node.first);
+        } else {
+            stack.emplace_back(leftDistance, node.first);
+            stack.emplace_back(rightDistance, node.first + 1);
+        }
+    }
+    std::sort_heap(hits.begin(), hits.end(), closer);
+    return hits;
+}
+
+std::vector<std::vector<SegmentHit>> SpatialIndex::inBox(const std::vector<BoundingBox>& boxes,
+                                                         unsigned int nThreads) const {
+    std::vector<std::vector<SegmentHit>> hits(boxes.size());
+    details::parallelFor(
+        boxes.size(), [&](size_t i) { hits[i] = inBox(boxes[i]); }, nThreads);
+    return hits;
+}
+
+std::vector<std::vector<SegmentHit>> SpatialIndex::inSphere(const Points& centers,
+                                                            floatType radius,
+                                                            unsigned int nThreads) const {
+    std::vector<std::vector<SegmentHit>> hits(centers.size());
+    details::parallelFor(
+        centers.size(), [&](size_t i) { hits[i] = inSphere(centers[i], radius); }, nThreads);
+    return hits;
+}
+
+std::vector<std::vector<SegmentHit>> SpatialIndex::nearest(const Points& points,
+                                                           size_t k,
+                                                           unsigned int nThreads) const {
+    std::vector<std::vector<SegmentHit>> hits(points.size());
+    details::parallelFor(
+        points.size(), [&](size_t i) { hits[i] = nearest(points[i], k); }, nThreads);
+    return hits;
+}
+
+}  // namespace circuit
+}  // namespace morphio
@@ -0,0 +1,297 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::min, std::max
+#include <array>
+#include <cmath>      // std::sqrt
+#include <vector>
+
+#include <morphio/clip.h>
+#include <morphio/exceptions.h>
+#include <morphio/properties.h>
+
+#include "morphology_access.h"
+#include "point_utils.h"  // centerOfGravity
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::floatType;
+using morphio::Point;
+
+/** The points `p` such that `normal . p >= offset` */
+struct HalfSpace {
+    std::array<double, 3> normal;
+    double offset;
+
+    double value(const Point& point) const {
+        double result = -offset;
+        for (size_t k = 0; k < 3; ++k) {
+            result += normal[k] * static_cast<double>(point[k]);
+        }
+        return result;
+    }
+};
+
+using Region = std::vector<HalfSpace>;
+
+bool inside(const Region& region, const Point& point) {
+    for (const auto& halfSpace : region) {
+        if (halfSpace.value(point) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+HalfSpace unitHalfSpace(const morphio::clip::Plane& plane) {
+    const std::array<double, 3> normal{static_cast<double>(plane.normal[0]),
+                                       static_cast<double>(plane.normal[1]),
+                                       static_cast<double>(plane.normal[2])};
+    const double norm =
+        std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    if (norm == 0) {
+        throw morphio::MorphioError("Clip: the normal of the plane is null");
+    }
+    HalfSpace halfSpace{{normal[0] / norm, normal[1] / norm, normal[2] / norm}, 0};
+    halfSpace.offset = halfSpace.value(plane.point);
+    return halfSpace;
+}
+
+/**
+ * The parts of a section inside the region, as positions in the section: `i + t` is at fraction
+ * `t` of segment `i`
+ *
+ * Every segment is clipped against the half-spaces, as Liang and Barsky do; consecutive clipped
+ * segments ending and starting at the same point of the section are parts of the same piece.
+ */
+struct Pieces {
+    std::vector<double> offsets;
+    /** Index in `offsets` of the first position of every piece */
+    std::vector<size_t> starts;
+
+    size_t size() const noexcept {
+        return starts.size();
+    }
+    size_t pointCount(size_t piece) const noexcept {
+        return (piece + 1 < starts.size() ? starts[piece + 1] : offsets.size()) - starts[piece];
+    }
+};
+
+void clipSection(const Point* points, size_t count, const Region& region, Pieces& pieces) {
+    if (count == 1) {
+        if (inside(region, points[0])) {
+            pieces.starts.push_back(0);
+            pieces.offsets.push_back(0);
+        }
+        return;
+    }
+
+    bool open = false;
+    for (size_t i = 0; i + 1 < count; ++i) {
+        double enter = 0;
+        double exit = 1;
+        for (const auto& halfSpace : region) {
+            const double first = halfSpace.value(points[i]);
+            const double second = halfSpace.value(points[i + 1]);
+            if (first < 0 && second < 0) {
+                exit = 0;
+                break;
+            }
+            if (first < 0) {
+                enter = std::max(enter, first / (first - second));
+            } else if (second < 0) {
+                exit = std::min(exit, first / (first - second));
+            }
+        }
+        // segments touching the region at a single point are outside
+        if (enter >= exit) {
+            open = false;
+            continue;
+        }
+        if (enter > 0 || !open) {
+            pieces.starts.push_back(pieces.offsets.size());
+            pieces.offsets.push_back(static_cast<double>(i) + enter);
+        }
+        pieces.offsets.push_back(static_cast<double>(i) + exit);
+        open = exit == 1;
+    }
+}
+
+template <typename T>
+T interpolate(const std::vector<T>& values, size_t begin, double offset) {
+    const auto i = static_cast<size_t>(offset);
+    const double t = offset - static_cast<double>(i);
+    if (t == 0) {
+        return values[begin + i];
+    }
+    const auto from = static_cast<double>(values[begin + i]);
+    const auto to = static_cast<double>(values[begin + i + 1]);
+    return static_cast<T>(from + t * (to - from));
+}
+
+Point interpolate(const std::vector<Point>& points, size_t begin, double offset) {
+    const auto i = static_cast<size_t>(offset);
+    const double t = offset - static_cast<double>(i);
+    if (t == 0) {
+        return points[begin + i];
+    }
+    Point result;
+    for (size_t k = 0; k < 3; ++k) {
+        const auto from = static_cast<double>(points[begin + i][k]);
+        const auto to = static_cast<double>(points[begin + i + 1][k]);
+        result[k] = static_cast<floatType>(from + t * (to - from));
+    }
+    return result;
+}
+
+morphio::clip::Clipped clipRegion(const morphio::Morphology& morphology,
+                                  const Region& region,
+                                  unsigned int nThreads) {
+    using morphio::Property::Properties;
+
+    const Properties& original = morphio::details::MorphologyAccess::properties(morphology);
+    const auto& sections = original._sectionLevel._sections;
+    const auto& points = original._pointLevel._points;
+    const auto& diameters = original._pointLevel._diameters;
+    const auto& perimeters = original._pointLevel._perimeters;
+    const bool hasPerimeters = !perimeters.empty();
+    const size_t nSections = sections.size();
+    const auto sectionBegin = [&](size_t section) {
+        return static_cast<size_t>(sections[section][0]);
+    };
+    const auto sectionEnd = [&](size_t section) {
+        return section + 1 < nSections ? sectionBegin(section + 1) : points.size();
+    };
+
+    std::vector<Pieces> pieces(nSections);
+    morphio::details::parallelFor(
+        nSections,
+        [&](size_t section) {
+            const size_t begin = sectionBegin(section);
+            const size_t end = sectionEnd(section);
+            if (end > begin) {
+                clipSection(&points[begin], end - begin, region, pieces[section]);
+            }
+        },
+        nThreads);
+
+    // the first clipped section and point of every original section
+    std::vector<size_t> firstSection(nSections + 1, 0);
+    std::vector<size_t> firstPoint(nSections + 1, 0);
+    for (size_t section = 0; section < nSections; ++section) {
+        firstSection[section + 1] = firstSection[section] + pieces[section].size();
+        firstPoint[section + 1] = firstPoint[section] + pieces[section].offsets.size();
+    }
+
+    Properties properties;
+    properties._cellLevel._version = original._cellLevel._version;
+    properties._cellLevel._cellFamily = original._cellLevel._cellFamily;
+    if (!original._somaLevel._points.empty() &&
+        inside(region, morphio::centerOfGravity(original._somaLevel._points))) {
+        properties._cellLevel._somaType = original._cellLevel._somaType;
+        properties._somaLevel = original._somaLevel;
+    }
+
+    const size_t nClipped = firstSection[nSections];
+    const size_t nPoints = firstPoint[nSections];
+    auto& clippedSections = properties._sectionLevel._sections;
+    auto& clippedTypes = properties._sectionLevel._sectionTypes;
+    auto& clippedPoints = properties._pointLevel._points;
+    auto& clippedDiameters = properties._pointLevel._diameters;
+    auto& clippedPerimeters = properties._pointLevel._perimeters;
+    clippedSections.resize(nClipped);
+    clippedTypes.resize(nClipped);
+    clippedPoints.resize(nPoints);
+    clippedDiameters.resize(nPoints);
+    clippedPerimeters.resize(hasPerimeters ? nPoints : 0);
+
+    std::vector<uint32_t> originalSections(nClipped);
+    std::vector<floatType> offsets(nPoints);
+
+    morphio::details::parallelFor(
+        nSections,
+        [&](size_t section) {
+            const Pieces& sectionPieces = pieces[section];
+            if (sectionPieces.size() == 0) {
+                return;
+            }
+
+            // the first piece stays attached to the parent if both ends are kept
+            int64_t parent = -1;
+            const auto originalParent = sections[section][1];
+            if (originalParent != -1 && sectionPieces.offsets.front() == 0) {
+                const auto parentId = static_cast<size_t>(originalParent);
+                const Pieces& parentPieces = pieces[parentId];
+                const size_t parentCount = sectionEnd(parentId) - sectionBegin(parentId);
+                if (parentPieces.size() > 0 &&
+                    parentPieces.offsets.back() == static_cast<double>(parentCount - 1)) {
+                    parent = static_cast<int64_t>(firstSection[parentId + 1] - 1);
+                }
+            }
+
+            const size_t begin = sectionBegin(section);
+            size_t point = firstPoint[section];
+            for (size_t piece = 0; piece < sectionPieces.size(); ++piece) {
+                const size_t id = firstSection[section] + piece;
+                clippedSections[id] = {static_cast<int64_t>(point), parent};
+                clippedTypes[id] = original._sectionLevel._sectionTypes[section];
+                originalSections[id] = static_cast<uint32_t>(section);
+                parent = -1;
+
+                const size_t start = sectionPieces.starts[piece];
+                for (size_t k = 0; k < sectionPieces.pointCount(piece); ++k, ++point) {
+                    const double offset = sectionPieces.offsets[start + k];
+                    clippedPoints[point] = interpolate(points, begin, offset);
+                    clippedDiameters[point] = interpolate(diameters, begin, offset);
+                    if (hasPerimeters) {
+                        clippedPerimeters[point] = interpolate(perimeters, begin, offset);
+                    }
+                    offsets[point] = static_cast<floatType>(offset);
+                }
+            }
+        },
+        nThreads);
+
+    return {morphio::details::MorphologyAccess::fromProperties(properties),
+            std::move(originalSections), std::move(offsets)};
+}
+
+}  // namespace
+
+namespace morphio {
+namespace clip {
+
+Clipped clip(const Morphology& morphology, const Box& region, unsigned int nThreads) {
+    Region halfSpaces;
+    for (size_t k = 0; k < 3; ++k) {
+        if (region.min[k] > region.max[k]) {
+            throw MorphioError("Clip: the min corner of the box is above its max corner");
+        }
+        HalfSpace lower{{0, 0, 0}, static_cast<double>(region.min[k])};
+        lower.normal[k] = 1;
+        HalfSpace upper{{0, 0, 0}, -static_cast<double>(region.max[k])};
+        upper.normal[k] = -1;
+        halfSpaces.push_back(lower);
+        halfSpaces.push_back(upper);
+    }
+    return clipRegion(morphology, halfSpaces, nThreads);
+}
+
+Clipped clip(const Morphology& morphology, const Plane& region, unsigned int nThreads) {
+    return clipRegion(morphology, {unitHalfSpace(region)}, nThreads);
+}
+
+Clipped clip(const Morphology& morphology, const Slab& region, unsigned int nThreads) {
+    if (region.thickness < 0) {
+        throw MorphioError("Clip: the thickness of the slab is negative");
+    }
+    const HalfSpace lower = unitHalfSpace(region.plane);
+    const HalfSpace upper{{-lower.normal[0], -lower.normal[1], -lower.normal[2]},
+                          -lower.offset - static_cast<double>(region.thickness)};
+    return clipRegion(morphology, {lower, upper}, nThreads);
+}
+
+}  // namespace clip
+}  // namespace morphio
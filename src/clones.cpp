@@ -0,0 +1,271 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <array>
+#include <cmath>  // std::exp, std::log, std::sqrt
+
+#include <morphio/clones.h>
+#include <morphio/properties.h>
+
+#include "morphology_access.h"
+#include "point_utils.h"  // centerOfGravity
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::floatType;
+using morphio::Point;
+using morphio::details::MorphologyAccess;
+using Matrix = std::array<std::array<floatType, 3>, 3>;
+
+const Matrix kIdentity{{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+// stream of the draws that are not specific to a section
+const uint64_t kMorphologyStream = ~uint64_t(0);
+
+/** SplitMix64 finalizer */
+uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Counter-based generator: the n-th draw of the stream (seed, clone, section) is a hash of
+ * those values and n, it does not depend on any other draw
+ */
+class CounterRng
+{
+  public:
+    CounterRng(uint64_t seed, uint64_t clone, uint64_t stream)
+        : key_(mix(mix(mix(seed) + clone) + stream)) {}
+
+    /** Uniform in [0, 1) */
+    double uniform() {
+        const uint64_t bits = mix(key_ + (++counter_) * 0x9E3779B97F4A7C15ULL);
+        return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /** Standard normal, with the Box-Muller transform */
+    double normal() {
+        const double radius = std::sqrt(-2 * std::log(1 - uniform()));
+        return radius * std::cos(2 * M_PI * uniform());
+    }
+
+    Point direction() {
+        const double z = 2 * uniform() - 1;
+        const double angle = 2 * M_PI * uniform();
+        const double r = std::sqrt(1 - z * z);
+        return {static_cast<floatType>(r * std::cos(angle)),
+                static_cast<floatType>(r * std::sin(angle)),
+                static_cast<floatType>(z)};
+    }
+
+  private:
+    uint64_t key_;
+    uint64_t counter_ = 0;
+};
+
+/** Rotation of `angle` radians around the unit vector `axis` (Rodrigues) */
+Matrix rotation(const Point& axis, double angle) {
+    if (angle == 0) {
+        return kIdentity;
+    }
+    const auto c = static_cast<floatType>(std::cos(angle));
+    const auto s = static_cast<floatType>(std::sin(angle));
+    const floatType t = 1 - c;
+    const floatType x = axis[0], y = axis[1], z = axis[2];
+    return {{{t * x * x + c, t * x * y - s * z, t * x * z + s * y},
+             {t * x * y + s * z, t * y * y + c, t * y * z - s * x},
+             {t * x * z - s * y, t * y * z + s * x, t * z * z + c}}};
+}
+
+Matrix multiply(const Matrix& a, const Matrix& b) {
+    Matrix result{};
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t k = 0; k < 3; ++k) {
+                result[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+    return result;
+}
+
+/** anchor + factor * matrix * (point - origin) */
+Point transform(const Matrix& matrix,
+                const Point& point,
+                const Point& origin,
+                const Point& anchor,
+                floatType factor) {
+    const Point relative = morphio::subtract(point, origin);
+    Point result = anchor;
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t k = 0; k < 3; ++k) {
+            result[i] += factor * matrix[i][k] * relative[k];
+        }
+    }
+    return result;
+}
+
+/** Unit vector from `from` to `to`, or the null vector if they are the same */
+Point direction(const Point& from, const Point& to) {
+    const Point delta = morphio::subtract(to, from);
+    const floatType norm = std::sqrt(delta[0] * delta[0] + delta[1] * delta[1] +
+                                     delta[2] * delta[2]);
+    if (norm == 0) {
+        return {0, 0, 0};
+    }
+    return {delta[0] / norm, delta[1] / norm, delta[2] / norm};
+}
+
+/** The sections of the exemplar, shared by all its clones */
+struct Layout {
+    /** Section ids, parents before their children */
+    std::vector<uint32_t> order;
+    /** Point range of every section */
+    std::vector<size_t> begin;
+    std::vector<size_t> end;
+    std::vector<int32_t> parent;
+    Point center{0, 0, 0};
+
+    explicit Layout(const morphio::Property::Properties& properties) {
+        const auto& sections = properties._sectionLevel._sections;
+        const size_t nPoints = properties._pointLevel._points.size();
+        const size_t nSections = sections.size();
+
+        begin.resize(nSections);
+        end.resize(nSections);
+        parent.resize(nSections);
+        std::vector<std::vector<uint32_t>> children(nSections);
+        std::vector<uint32_t> stack;
+        for (size_t i = 0; i < nSections; ++i) {
+            begin[i] = static_cast<size_t>(sections[i][0]);
+            end[i] = i + 1 < nSections ? static_cast<size_t>(sections[i + 1][0]) : nPoints;
+            parent[i] = static_cast<int32_t>(sections[i][1]);
+            if (parent[i] == -1) {
+                stack.push_back(static_cast<uint32_t>(i));
+            } else {
+                children[static_cast<size_t>(parent[i])].push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        order.reserve(nSections);
+        while (!stack.empty()) {
+            const uint32_t section = stack.back();
+            stack.pop_back();
+            order.push_back(section);
+            stack.insert(stack.end(), children[section].begin(), children[section].end());
+        }
+
+        const auto& somaPoints = properties._somaLevel._points;
+        if (!somaPoints.empty()) {
+            center = morphio::centerOfGravity(somaPoints);
+        }
+    }
+};
+
+morphio::Morphology generate(const morphio::Property::Properties& exemplar,
+                             const Layout& layout,
+                             const morphio::clones::CloneParameters& parameters,
+                             uint64_t seed,
+                             uint64_t index) {
+    morphio::Property::Properties properties = exemplar;
+    // rebuilt by the Morphology constructor
+    properties._sectionLevel._children.clear();
+    properties._mitochondriaSectionLevel._children.clear();
+    const auto& points = exemplar._pointLevel._points;
+    auto& cloned = properties._pointLevel._points;
+
+    CounterRng morphologyRng(seed, index, kMorphologyStream);
+    const auto scale = static_cast<floatType>(
+        std::exp(static_cast<double>(parameters.scaleSigma) * morphologyRng.normal()));
+
+    for (auto& point : properties._somaLevel._points) {
+        point = transform(kIdentity, point, layout.center, layout.center, scale);
+    }
+
+    std::vector<Matrix> rotations(layout.begin.size(), kIdentity);
+    for (const uint32_t section : layout.order) {
+        const size_t begin = layout.begin[section];
+        const size_t end = layout.end[section];
+        if (begin == end) {
+            continue;
+        }
+        const int32_t parent = layout.parent[section];
+
+        // the first point of the section follows the end of its parent
+        Point axis{0, 0, 0};
+        Point anchor = transform(kIdentity, points[begin], layout.center, layout.center, scale);
+        Matrix parentRotation = kIdentity;
+        if (parent == -1) {
+            axis = direction(layout.center, points[begin]);
+        } else if (layout.end[static_cast<size_t>(parent)] >
+                   layout.begin[static_cast<size_t>(parent)]) {
+            const auto parentId = static_cast<size_t>(parent);
+            const size_t last = layout.end[parentId] - 1;
+            parentRotation = rotations[parentId];
+            if (last > layout.begin[parentId]) {
+                axis = direction(points[last - 1], points[last]);
+            }
+            anchor = transform(parentRotation, points[begin], points[last], cloned[last], scale);
+        }
+
+        CounterRng rng(seed, index, section);
+        Matrix jitter = kIdentity;
+        if (parameters.subtreeRotation != 0 && axis != Point{0, 0, 0}) {
+            const double angle = static_cast<double>(parameters.subtreeRotation) *
+                                 (2 * rng.uniform() - 1);
+            jitter = rotation(axis, angle);
+        }
+        if (parameters.angleSigma != 0) {
+            const Point bendAxis = rng.direction();
+            const double angle = static_cast<double>(parameters.angleSigma) * rng.normal();
+            jitter = multiply(jitter, rotation(bendAxis, angle));
+        }
+        rotations[section] = multiply(parentRotation, jitter);
+
+        const auto length = static_cast<floatType>(
+            std::exp(static_cast<double>(parameters.lengthSigma) * rng.normal()));
+        for (size_t i = begin; i < end; ++i) {
+            cloned[i] = transform(rotations[section], points[i], points[begin], anchor,
+                                  scale * length);
+        }
+    }
+
+    return MorphologyAccess::fromProperties(properties);
+}
+
+}  // namespace
+
+namespace morphio {
+namespace clones {
+
+Morphology clone(const Morphology& morphology,
+                 const CloneParameters& parameters,
+                 uint64_t seed,
+                 uint64_t index) {
+    const auto& exemplar = MorphologyAccess::properties(morphology);
+    return generate(exemplar, Layout(exemplar), parameters, seed, index);
+}
+
+std::vector<Morphology> clones(const Morphology& morphology,
+                               const CloneParameters& parameters,
+                               size_t count,
+                               uint64_t seed,
+                               uint64_t firstIndex,
+                               unsigned int nThreads) {
+    const auto& exemplar = MorphologyAccess::properties(morphology);
+    const Layout layout(exemplar);
+    std::vector<Morphology> result(count, morphology);
+    details::parallelFor(
+        count,
+        [&](size_t i) {
+            result[i] = generate(exemplar, layout, parameters, seed, firstIndex + i);
+        },
+        nThreads);
+    return result;
+}
+
+}  // namespace clones
+}  // namespace morphio
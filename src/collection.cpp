@@ -4,6 +4,21 @@
  */
 #include <morphio/collection.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <numeric>  // std::iota
+
+#if defined(WIN32) || defined(__WIN32__) || defined(_WIN32) || defined(_MSC_VER) || defined(__MINGW32__)
+#include <process.h>  // _getpid
+#define MORPHIO_GETPID _getpid
+#else
+#include <unistd.h>  // getpid
+#define MORPHIO_GETPID getpid
+#endif
+
 #include "shared_utils.hpp"
 #include <highfive/H5File.hpp>
 
@@ -18,6 +33,8 @@ class LoadUnorderedImpl
 
     virtual Morphology load(size_t k) const = 0;
     virtual mut::Morphology load_mut(size_t k) const = 0;
+    virtual GlialCell load_glial_cell(size_t k) const = 0;
+    virtual DendriticSpine load_dendritic_spine(size_t k) const = 0;
 
     virtual size_t size() const = 0;
 };
@@ -59,6 +76,14 @@ class LoadUnorderedFromLoopIndices: public LoadUnorderedImpl
         return load_impl<mut::Morphology>(k);
     }
 
+    GlialCell load_glial_cell(size_t k) const override {
+        return load_impl<GlialCell>(k);
+    }
+
+    DendriticSpine load_dendritic_spine(size_t k) const override {
+        return load_impl<DendriticSpine>(k);
+    }
+
   protected:
     template <class M>
     M load_impl(size_t k) const {
@@ -74,6 +99,192 @@ class LoadUnorderedFromLoopIndices: public LoadUnorderedImpl
     std::shared_ptr<WarningHandler> _warning_handler;
 };
 
+/**
+ *  Parse the morphology stored in `bytes`.
+ */
+template <class M>
+M load_from_bytes(const MorphologyBytes& bytes,
+                  unsigned int options,
+                  std::shared_ptr<WarningHandler> warning_handler) {
+    const auto& extension = bytes.extension;
+    const bool has_dot = !extension.empty() && extension[0] == '.';
+    return M(bytes.contents,
+             has_dot ? extension.substr(1) : extension,
+             options,
+             std::move(warning_handler));
+}
+
+template <>
+mut::Morphology load_from_bytes<mut::Morphology>(const MorphologyBytes& bytes,
+                                                 unsigned int options,
+                                                 std::shared_ptr<WarningHandler> warning_handler) {
+    return mut::Morphology(
+        load_from_bytes<Morphology>(bytes, options, std::move(warning_handler)));
+}
+
+/**
+ *  Load morphologies from a `ByteSource` in batches.
+ *
+ *  The morphologies are read in the order suggested by the source, one batch
+ *  at a time. While a batch is being parsed the next one is requested with
+ *  `ByteSource::get_async`, which lets sources overlap reading and parsing.
+ */
+class LoadUnorderedFromByteSource: public LoadUnorderedImpl
+{
+  public:
+    LoadUnorderedFromByteSource(std::shared_ptr<ByteSource> source,
+                                std::vector<size_t> loop_indices,
+                                std::vector<std::string> morphology_names,
+                                unsigned int options,
+                                std::shared_ptr<WarningHandler> warning_handler,
+                                std::shared_ptr<AccessTrace> access_trace)
+        : _source(std::move(source))
+        , _loop_indices(std::move(loop_indices))
+        , _morphology_names(std::move(morphology_names))
+        , _options(options)
+        , _warning_handler(std::move(warning_handler))
+        , _access_trace(std::move(access_trace)) {}
+
+    size_t size() const override {
+        return _morphology_names.size();
+    }
+
+    Morphology load(size_t k) const override {
+        return load_from_bytes<Morphology>(fetch(k), _options, _warning_handler);
+    }
+
+    mut::Morphology load_mut(size_t k) const override {
+        return load_from_bytes<mut::Morphology>(fetch(k), _options, _warning_handler);
+    }
+
+    GlialCell load_glial_cell(size_t k) const override {
+        return load_from_bytes<GlialCell>(fetch(k), _options, _warning_handler);
+    }
+
+    DendriticSpine load_dendritic_spine(size_t k) const override {
+        return load_from_bytes<DendriticSpine>(fetch(k), _options, _warning_handler);
+    }
+
+  private:
+    static constexpr size_t batch_size = 16;
+
+    MorphologyBytes fetch(size_t k) const {
+        if (_access_trace != nullptr) {
+            _access_trace->record(_morphology_names[_loop_indices[k]]);
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const size_t batch = k / batch_size;
+        if (_batch != batch) {
+            if (_next.valid() && _next_batch == batch) {
+                _bytes = _next.get();
+            } else {
+                _bytes = _source->get_batch(batch_names(batch));
+            }
+            _batch = batch;
+
+            if ((batch + 1) * batch_size < size()) {
+                _next = _source->get_async(batch_names(batch + 1));
+                _next_batch = batch + 1;
+            }
+        }
+
+        return _bytes[k - batch * batch_size];
+    }
+
+    std::vector<std::string> batch_names(size_t batch) const {
+        const size_t begin = batch * batch_size;
+        const size_t end = std::min(begin + batch_size, size());
+
+        std::vector<std::string> names;
+        names.reserve(end - begin);
+        for (size_t k = begin; k < end; ++k) {
+            names.push_back(_morphology_names[_loop_indices[k]]);
+        }
+        return names;
+    }
+
+    std::shared_ptr<ByteSource> _source;
+    std::vector<size_t> _loop_indices;
+    std::vector<std::string> _morphology_names;
+    unsigned int _options;
+    std::shared_ptr<WarningHandler> _warning_handler;
+    std::shared_ptr<AccessTrace> _access_trace;
+
+    mutable std::mutex _mutex;
+    mutable size_t _batch = size_t(-1);
+    mutable std::vector<MorphologyBytes> _bytes;
+    mutable size_t _next_batch = size_t(-1);
+    mutable std::future<std::vector<MorphologyBytes>> _next;
+};
+
+#ifdef MORPHIO_ENABLE_MPI
+/**
+ *  Load the share of a rank of the morphologies loaded collectively.
+ *
+ *  The bulk of the share was read ahead of time: every morphology is loaded
+ *  from the collection while the readers use those bytes.
+ */
+class LoadShare: public LoadUnorderedImpl
+{
+  public:
+    LoadShare(Collection collection,
+              std::shared_ptr<const readers::h5::PrefetchedBytes> bytes,
+              std::vector<size_t> loop_indices,
+              std::vector<std::string> morphology_names,
+              unsigned int options,
+              std::shared_ptr<WarningHandler> warning_handler)
+        : _collection(std::move(collection))
+        , _bytes(std::move(bytes))
+        , _loop_indices(std::move(loop_indices))
+        , _morphology_names(std::move(morphology_names))
+        , _options(options)
+        , _warning_handler(std::move(warning_handler)) {}
+
+    size_t size() const override {
+        return _loop_indices.size();
+    }
+
+    /** The index in the names passed to `Collection::load_share` of the `k`-th morphology */
+    size_t loop_index(size_t k) const {
+        return _loop_indices[k];
+    }
+
+    Morphology load(size_t k) const override {
+        return load_impl<Morphology>(k);
+    }
+
+    mut::Morphology load_mut(size_t k) const override {
+        return load_impl<mut::Morphology>(k);
+    }
+
+    GlialCell load_glial_cell(size_t k) const override {
+        return load_impl<GlialCell>(k);
+    }
+
+    DendriticSpine load_dendritic_spine(size_t k) const override {
+        return load_impl<DendriticSpine>(k);
+    }
+
+  private:
+    template <class M>
+    M load_impl(size_t k) const {
+        readers::h5::PrefetchedBytes::Scope scope(*_bytes);
+        return _collection.template load<M>(_morphology_names[_loop_indices[k]],
+                                            _options,
+                                            _warning_handler);
+    }
+
+    Collection _collection;
+    std::shared_ptr<const readers::h5::PrefetchedBytes> _bytes;
+    std::vector<size_t> _loop_indices;
+    std::vector<std::string> _morphology_names;
+    unsigned int _options;
+    std::shared_ptr<WarningHandler> _warning_handler;
+};
+#endif
+
 }  // namespace detail
 
 
@@ -90,6 +301,15 @@ class CollectionImpl
                                      unsigned int options,
                                      std::shared_ptr<WarningHandler> warning_handler) const = 0;
 
+    virtual GlialCell load_glial_cell(const std::string& morph_name,
+                                      unsigned int options,
+                                      std::shared_ptr<WarningHandler> warning_handler) const = 0;
+
+    virtual DendriticSpine load_dendritic_spine(
+        const std::string& morph_name,
+        unsigned int options,
+        std::shared_ptr<WarningHandler> warning_handler) const = 0;
+
     virtual std::shared_ptr<LoadUnorderedImpl> load_unordered(
         Collection collection,
         std::vector<std::string> morph_name,
@@ -97,13 +317,23 @@ class CollectionImpl
         std::shared_ptr<WarningHandler> warning_handler) const = 0;
 
     virtual std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const = 0;
+
+#ifdef MORPHIO_ENABLE_MPI
+    virtual std::shared_ptr<detail::LoadShare> load_share(
+        Collection /* collection */,
+        const std::vector<std::string>& /* morphology_names */,
+        unsigned int /* options */,
+        std::shared_ptr<WarningHandler> /* warning_handler */) const {
+        throw MorphioError("Only collections opened with an MPI communicator can load shares.");
+    }
+#endif
 };
 
 namespace detail {
 template <class Derived>
 class CollectionImpl: public morphio::CollectionImpl
 {
-    // The purpose of this class is to implement the two separate
+    // The purpose of this class is to implement the separate `load*`
     // functions in terms of a single templated method `load_impl`.
   public:
     morphio::Morphology load(const std::string& morph_name,
@@ -121,6 +351,21 @@ class CollectionImpl: public morphio::CollectionImpl
         return derived.template load_impl<mut::Morphology>(morph_name, options, warning_handler);
     }
 
+    GlialCell load_glial_cell(const std::string& morph_name,
+                              unsigned int options,
+                              std::shared_ptr<WarningHandler> warning_handler) const override {
+        const auto& derived = static_cast<const Derived&>(*this);
+        return derived.template load_impl<GlialCell>(morph_name, options, warning_handler);
+    }
+
+    DendriticSpine load_dendritic_spine(
+        const std::string& morph_name,
+        unsigned int options,
+        std::shared_ptr<WarningHandler> warning_handler) const override {
+        const auto& derived = static_cast<const Derived&>(*this);
+        return derived.template load_impl<DendriticSpine>(morph_name, options, warning_handler);
+    }
+
     std::shared_ptr<LoadUnorderedImpl> load_unordered(
         Collection collection,
         std::vector<std::string> morphology_names,
@@ -134,6 +379,40 @@ class CollectionImpl: public morphio::CollectionImpl
                                                                       warning_handler);
     }
 };
+
+/**
+ *  Pick the `load*` method matching the cell type `M`.
+ */
+template <class M>
+struct CellLoader;
+
+template <>
+struct CellLoader<GlialCell> {
+    static GlialCell load(const morphio::CollectionImpl& collection,
+                          const std::string& morph_name,
+                          unsigned int options,
+                          std::shared_ptr<WarningHandler> warning_handler) {
+        return collection.load_glial_cell(morph_name, options, std::move(warning_handler));
+    }
+
+    static GlialCell load(const LoadUnorderedImpl& load_unordered, size_t k) {
+        return load_unordered.load_glial_cell(k);
+    }
+};
+
+template <>
+struct CellLoader<DendriticSpine> {
+    static DendriticSpine load(const morphio::CollectionImpl& collection,
+                               const std::string& morph_name,
+                               unsigned int options,
+                               std::shared_ptr<WarningHandler> warning_handler) {
+        return collection.load_dendritic_spine(morph_name, options, std::move(warning_handler));
+    }
+
+    static DendriticSpine load(const LoadUnorderedImpl& load_unordered, size_t k) {
+        return load_unordered.load_dendritic_spine(k);
+    }
+};
 }  // namespace detail
 
 class DirectoryCollection: public morphio::detail::CollectionImpl<DirectoryCollection>
@@ -189,7 +468,10 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
      * to open the container.
      */
     HDF5ContainerCollection(HighFive::File file)
-        : _file(std::move(file)) {}
+        : _file(new HighFive::File(std::move(file)))
+        , _access(_file->getAccessPropertyList())
+        , _path(_file->getName())
+        , _pid(MORPHIO_GETPID()) {}
 
     /**
      * Create the collection from a path.
@@ -208,12 +490,13 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
         std::vector<hsize_t> offsets(n_morphologies);
         std::vector<size_t> loop_indices(n_morphologies);
 
+        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
         for (size_t i = 0; i < n_morphologies; ++i) {
             loop_indices[i] = i;
 
             const auto& morph_name = morphology_names[i];
 
-            auto morph = _file.getGroup(morph_name.data());
+            auto morph = file().getGroup(morph_name.data());
             auto points = morph.getDataSet("points");
 
             auto dcpl = points.getCreatePropertyList();
@@ -236,7 +519,7 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
                 unsigned int options,
                 std::shared_ptr<WarningHandler> warning_handler) const {
         std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
-        return M(_file.getGroup(morph_name), options, warning_handler);
+        return M(file().getGroup(morph_name), options, warning_handler);
     }
 
   protected:
@@ -245,8 +528,382 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
         return HighFive::File(container_path, HighFive::File::ReadOnly);
     }
 
+    /**
+     * The file handle of the current process; must be called with the HDF5 lock held.
+     *
+     * After a fork, the handle inherited from the parent shares its file descriptor, and the
+     * state of the HDF5 library it refers to is a stale copy: the child reopens the file the first
+     * time it uses it, with the access properties it was opened with. The inherited handle is
+     * closed first, otherwise HDF5 would find the file already open and share that stale state
+     * with the new handle. The rest of the collection is inherited as is.
+     */
+    const HighFive::File& file() const {
+        const auto pid = MORPHIO_GETPID();
+        if (pid != _pid) {
+            _file.reset();
+            _file.reset(new HighFive::File(_path, HighFive::File::ReadOnly, _access));
+            _pid = pid;
+        }
+        return *_file;
+    }
+
+  private:
+    mutable std::unique_ptr<HighFive::File> _file;
+    // the file access properties of `_file`, to reopen it the same way
+    HighFive::FileAccessProps _access;
+    std::string _path;
+    // the process that opened `_file`
+    mutable decltype(MORPHIO_GETPID()) _pid;
+};
+
+#ifdef MORPHIO_ENABLE_MPI
+namespace detail {
+/** Open a file with the MPI-IO driver of HDF5, collectively over `comm` */
+class MPIIOAccess
+{
+  public:
+    explicit MPIIOAccess(MPI_Comm comm)
+        : _comm(comm) {}
+
+    void apply(hid_t list) const {
+        if (H5Pset_fapl_mpio(list, _comm, MPI_INFO_NULL) < 0) {
+            throw MorphioError("Could not select the MPI-IO driver of HDF5");
+        }
+    }
+
+  private:
+    MPI_Comm _comm;
+};
+
+/** `size` bytes at `offset` in a file */
+struct ByteRange {
+    uint64_t offset;
+    uint64_t size;
+};
+
+static void check_mpi(int status, const std::string& function) {
+    if (status != MPI_SUCCESS) {
+        throw MorphioError("MPI-IO error in " + function);
+    }
+}
+
+/**
+ *  Read the `ranges` of the file at `path`, sorted by offset, collectively over `comm`.
+ *
+ *  Every rank describes its ranges with a file view and reads them with a
+ *  single `MPI_File_read_all`, in rounds of at most 1 GiB so that the counts
+ *  fit in an `int`. All ranks take part in as many rounds as the busiest one.
+ */
+static std::vector<std::string> collective_read(const std::string& path,
+                                                MPI_Comm comm,
+                                                const std::vector<ByteRange>& ranges) {
+    constexpr uint64_t max_round_bytes = uint64_t(1) << 30;
+
+    struct Piece {
+        size_t range;
+        uint64_t begin;
+        uint64_t size;
+    };
+
+    std::vector<std::vector<Piece>> rounds(1);
+    uint64_t round_bytes = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        for (uint64_t begin = 0; begin < ranges[i].size;) {
+            if (round_bytes == max_round_bytes) {
+                rounds.emplace_back();
+                round_bytes = 0;
+            }
+            const uint64_t size = std::min(ranges[i].size - begin, max_round_bytes - round_bytes);
+            rounds.back().push_back({i, begin, size});
+            round_bytes += size;
+            begin += size;
+        }
+    }
+
+    uint64_t n_rounds = rounds.size();
+    check_mpi(MPI_Allreduce(MPI_IN_PLACE, &n_rounds, 1, MPI_UINT64_T, MPI_MAX, comm),
+              "MPI_Allreduce");
+    rounds.resize(n_rounds);
+
+    std::vector<std::string> bytes(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        bytes[i].resize(ranges[i].size);
+    }
+
+    MPI_File file;
+    check_mpi(MPI_File_open(comm, path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file),
+              "MPI_File_open");
+
+    std::vector<char> buffer;
+    for (const auto& round : rounds) {
+        std::vector<int> lengths;
+        std::vector<MPI_Aint> displacements;
+        int count = 0;
+        for (const auto& piece : round) {
+            lengths.push_back(static_cast<int>(piece.size));
+            displacements.push_back(
+                static_cast<MPI_Aint>(ranges[piece.range].offset + piece.begin));
+            count += static_cast<int>(piece.size);
+        }
+
+        // MPI-IO implementations choke on empty file views: idle ranks read nothing from a
+        // plain one
+        MPI_Datatype view = MPI_BYTE;
+        if (!round.empty()) {
+            check_mpi(MPI_Type_create_hindexed(static_cast<int>(round.size()),
+                                               lengths.data(),
+                                               displacements.data(),
+                                               MPI_BYTE,
+                                               &view),
+                      "MPI_Type_create_hindexed");
+            check_mpi(MPI_Type_commit(&view), "MPI_Type_commit");
+        }
+        check_mpi(MPI_File_set_view(file, 0, MPI_BYTE, view, "native", MPI_INFO_NULL),
+                  "MPI_File_set_view");
+
+        buffer.resize(static_cast<size_t>(count));
+        MPI_Status status;
+        check_mpi(MPI_File_read_all(file, buffer.data(), count, MPI_BYTE, &status),
+                  "MPI_File_read_all");
+        if (!round.empty()) {
+            MPI_Type_free(&view);
+        }
+
+        size_t position = 0;
+        for (const auto& piece : round) {
+            std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(position),
+                      buffer.begin() + static_cast<std::ptrdiff_t>(position + piece.size),
+                      bytes[piece.range].begin() + static_cast<std::ptrdiff_t>(piece.begin));
+            position += piece.size;
+        }
+    }
+
+    check_mpi(MPI_File_close(&file), "MPI_File_close");
+    return bytes;
+}
+}  // namespace detail
+
+/**
+ *  An HDF5 container opened with the MPI-IO driver, whose ranks load their
+ *  share of the morphologies collectively.
+ */
+class MPIContainerCollection: public HDF5ContainerCollection
+{
+  public:
+    MPIContainerCollection(const std::string& collection_path, MPI_Comm comm)
+        : HDF5ContainerCollection(open_file(collection_path, comm))
+        , _comm(comm) {}
+
+    std::shared_ptr<detail::LoadShare> load_share(
+        Collection collection,
+        const std::vector<std::string>& morphology_names,
+        unsigned int options,
+        std::shared_ptr<WarningHandler> warning_handler) const override {
+        int rank = 0;
+        int n_ranks = 1;
+        detail::check_mpi(MPI_Comm_rank(_comm, &rank), "MPI_Comm_rank");
+        detail::check_mpi(MPI_Comm_size(_comm, &n_ranks), "MPI_Comm_size");
+
+        // every rank locates a block of the morphologies, then they share what they found
+        const size_t n_morphologies = morphology_names.size();
+        const auto block_begin = [&](int r) {
+            return n_morphologies * static_cast<size_t>(r) / static_cast<size_t>(n_ranks);
+        };
+
+        std::vector<uint64_t> records(record_size * n_morphologies);
+        std::string path;
+        {
+            std::lock_guard<std::recursive_mutex> lock(
+                morphio::readers::h5::global_hdf5_mutex());
+            path = file().getName();
+            for (size_t i = block_begin(rank); i < block_begin(rank + 1); ++i) {
+                locate(file().getGroup(morphology_names[i]), &records[record_size * i]);
+            }
+        }
+
+        std::vector<int> counts(static_cast<size_t>(n_ranks));
+        std::vector<int> displacements(static_cast<size_t>(n_ranks));
+        for (int r = 0; r < n_ranks; ++r) {
+            counts[static_cast<size_t>(r)] = static_cast<int>(
+                record_size * (block_begin(r + 1) - block_begin(r)));
+            displacements[static_cast<size_t>(r)] = static_cast<int>(record_size *
+                                                                     block_begin(r));
+        }
+        detail::check_mpi(MPI_Allgatherv(MPI_IN_PLACE,
+                                         0,
+                                         MPI_DATATYPE_NULL,
+                                         records.data(),
+                                         counts.data(),
+                                         displacements.data(),
+                                         MPI_UINT64_T,
+                                         _comm),
+                          "MPI_Allgatherv");
+
+        // sorted by position in the file, then split in contiguous shares of about the same
+        // number of bytes; every morphology weighs one more byte, so that empty ones count too
+        const auto first_offset = [&records](size_t i) {
+            uint64_t offset = uint64_t(-1);
+            for (size_t j = 0; j < n_datasets; ++j) {
+                if (records[record_size * i + 2 + 2 * j] > 0) {
+                    offset = std::min(offset, records[record_size * i + 1 + 2 * j]);
+                }
+            }
+            return offset;
+        };
+
+        std::vector<size_t> order(n_morphologies);
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::vector<uint64_t> offsets(n_morphologies);
+        for (size_t i = 0; i < n_morphologies; ++i) {
+            offsets[i] = first_offset(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [&offsets](size_t i, size_t j) {
+            return offsets[i] < offsets[j];
+        });
+
+        uint64_t total_bytes = 0;
+        for (size_t i = 0; i < n_morphologies; ++i) {
+            total_bytes += records[record_size * i] + 1;
+        }
+
+        std::vector<size_t> loop_indices;
+        std::vector<detail::ByteRange> ranges;
+        uint64_t bytes_before = 0;
+        for (const size_t i : order) {
+            const uint64_t bytes = records[record_size * i] + 1;
+            // the rank in whose share the middle of the morphology falls
+            const auto owner = std::min(
+                n_ranks - 1,
+                static_cast<int>(static_cast<double>(bytes_before + bytes / 2) /
+                                 static_cast<double>(total_bytes) * n_ranks));
+            bytes_before += bytes;
+
+            if (owner == rank) {
+                loop_indices.push_back(i);
+                for (size_t j = 0; j < n_datasets; ++j) {
+                    const uint64_t size = records[record_size * i + 2 + 2 * j];
+                    if (size > 0) {
+                        ranges.push_back({records[record_size * i + 1 + 2 * j], size});
+                    }
+                }
+            }
+        }
+
+        const auto coalesced = coalesce(std::move(ranges));
+        auto bytes = detail::collective_read(path, _comm, coalesced);
+
+        auto prefetched = std::make_shared<readers::h5::PrefetchedBytes>();
+        for (size_t i = 0; i < coalesced.size(); ++i) {
+            prefetched->insert(coalesced[i].offset, std::move(bytes[i]));
+        }
+
+        return std::make_shared<detail::LoadShare>(std::move(collection),
+                                                   std::move(prefetched),
+                                                   std::move(loop_indices),
+                                                   morphology_names,
+                                                   options,
+                                                   std::move(warning_handler));
+    }
+
+  private:
+    /// The datasets read ahead: points, structure and perimeters
+    static constexpr size_t n_datasets = 3;
+    /// The bytes of the datasets, then the offset and size of those stored contiguously
+    static constexpr size_t record_size = 1 + 2 * n_datasets;
+    /// Holes smaller than that between two ranges are read rather than skipped
+    static constexpr uint64_t max_gap = uint64_t(1) << 16;
+
+    static HighFive::File open_file(const std::string& collection_path, MPI_Comm comm) {
+        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
+        HighFive::FileAccessProps fapl;
+        fapl.add(detail::MPIIOAccess(comm));
+        return HighFive::File(collection_path, HighFive::File::ReadOnly, fapl);
+    }
+
+    /// Fill the record of the morphology `group`; must be called with the HDF5 lock held
+    static void locate(const HighFive::Group& group, uint64_t* record) {
+        static const std::array<std::string, n_datasets> names{"points",
+                                                               "structure",
+                                                               "perimeters"};
+        std::fill(record, record + record_size, 0);
+        for (size_t j = 0; j < n_datasets; ++j) {
+            if (!group.exist(names[j])) {
+                continue;
+            }
+            const auto dataset = group.getDataSet(names[j]);
+            const uint64_t size = dataset.getStorageSize();
+            record[0] += size;
+
+            const auto dcpl = dataset.getCreatePropertyList();
+            if (size > 0 && H5Pget_layout(dcpl.getId()) == H5D_CONTIGUOUS) {
+                record[1 + 2 * j] = dataset.getOffset();
+                record[2 + 2 * j] = size;
+            }
+        }
+    }
+
+    /// Merge the ranges that overlap or are separated by less than `max_gap`
+    static std::vector<detail::ByteRange> coalesce(std::vector<detail::ByteRange> ranges) {
+        std::sort(ranges.begin(),
+                  ranges.end(),
+                  [](const detail::ByteRange& a, const detail::ByteRange& b) {
+                      return a.offset < b.offset;
+                  });
+
+        std::vector<detail::ByteRange> coalesced;
+        for (const auto& range : ranges) {
+            if (!coalesced.empty() &&
+                range.offset <= coalesced.back().offset + coalesced.back().size + max_gap) {
+                auto& last = coalesced.back();
+                last.size = std::max(last.offset + last.size, range.offset + range.size) -
+                            last.offset;
+            } else {
+                coalesced.push_back(range);
+            }
+        }
+        return coalesced;
+    }
+
+    MPI_Comm _comm;
+};
+#endif
+
+class ByteSourceCollection: public morphio::detail::CollectionImpl<ByteSourceCollection>
+{
+  public:
+    ByteSourceCollection(std::shared_ptr<ByteSource> source)
+        : _source(std::move(source)) {}
+
+    std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const override {
+        return _source->argsort(morphology_names);
+    }
+
+    std::shared_ptr<LoadUnorderedImpl> load_unordered(
+        Collection collection,
+        std::vector<std::string> morphology_names,
+        unsigned int options,
+        std::shared_ptr<WarningHandler> warning_handler) const override {
+        auto loop_indices = argsort(morphology_names);
+        return std::make_shared<detail::LoadUnorderedFromByteSource>(_source,
+                                                                     std::move(loop_indices),
+                                                                     std::move(morphology_names),
+                                                                     options,
+                                                                     warning_handler,
+                                                                     collection.access_trace());
+    }
+
+  protected:
+    friend morphio::detail::CollectionImpl<ByteSourceCollection>;
+
+    template <class M>
+    M load_impl(const std::string& morph_name,
+                unsigned int options,
+                std::shared_ptr<WarningHandler> warning_handler) const {
+        return detail::load_from_bytes<M>(_source->get(morph_name), options, warning_handler);
+    }
+
   private:
-    HighFive::File _file;
+    std::shared_ptr<ByteSource> _source;
 };
 
 namespace detail {
@@ -267,8 +924,83 @@ static std::shared_ptr<morphio::CollectionImpl> open_collection(
     throw std::invalid_argument("Invalid path: " + collection_path);
 }
 
+static std::shared_ptr<morphio::CollectionImpl> open_byte_source(
+    std::shared_ptr<ByteSource> source) {
+    if (source == nullptr) {
+        throw std::invalid_argument("Can't construct a collection from a nullptr.");
+    }
+
+    return std::make_shared<ByteSourceCollection>(std::move(source));
+}
+
 }  // namespace detail
 
+std::vector<MorphologyBytes> ByteSource::get_batch(
+    const std::vector<std::string>& morph_names) const {
+    std::vector<MorphologyBytes> batch;
+    batch.reserve(morph_names.size());
+    for (const auto& morph_name : morph_names) {
+        batch.push_back(get(morph_name));
+    }
+    return batch;
+}
+
+std::future<std::vector<MorphologyBytes>> ByteSource::get_async(
+    std::vector<std::string> morph_names) const {
+    return std::async(std::launch::deferred, [this, morph_names]() {
+        return get_batch(morph_names);
+    });
+}
+
+std::vector<size_t> ByteSource::argsort(const std::vector<std::string>& morphology_names) const {
+    std::vector<size_t> loop_indices(morphology_names.size());
+    for (size_t i = 0; i < loop_indices.size(); ++i) {
+        loop_indices[i] = i;
+    }
+    return loop_indices;
+}
+
+void AccessTrace::record(const std::string& morph_name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _names.push_back(morph_name);
+}
+
+std::vector<std::string> AccessTrace::names() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _names;
+}
+
+void AccessTrace::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _names.clear();
+}
+
+void AccessTrace::save(const std::string& path) const {
+    std::ofstream file(path);
+    for (const auto& name : names()) {
+        file << name << '\n';
+    }
+    if (!file) {
+        throw WriterError("Could not write the access trace " + path);
+    }
+}
+
+std::vector<std::string> AccessTrace::read(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw MorphioError("Could not read the access trace " + path);
+    }
+
+    std::vector<std::string> names;
+    std::string name;
+    while (std::getline(file, name)) {
+        if (!name.empty()) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
 Collection::Collection(std::shared_ptr<CollectionImpl> collection)
     : _collection(std::move(collection)) {
     if (_collection == nullptr) {
@@ -279,6 +1011,14 @@ Collection::Collection(std::shared_ptr<CollectionImpl> collection)
 Collection::Collection(std::string collection_path, std::vector<std::string> extensions)
     : Collection(detail::open_collection(std::move(collection_path), std::move(extensions))) {}
 
+Collection::Collection(std::shared_ptr<ByteSource> source)
+    : Collection(detail::open_byte_source(std::move(source))) {}
+
+#ifdef MORPHIO_ENABLE_MPI
+Collection::Collection(const std::string& collection_path, MPI_Comm comm)
+    : Collection(std::make_shared<MPIContainerCollection>(collection_path, comm)) {}
+#endif
+
 
 template <class M>
 typename enable_if_immutable<M, M>::type Collection::load(
@@ -286,6 +1026,9 @@ typename enable_if_immutable<M, M>::type Collection::load(
     unsigned int options,
     std::shared_ptr<WarningHandler> warning_handler) const {
     if (_collection != nullptr) {
+        if (_access_trace != nullptr) {
+            _access_trace->record(morph_name);
+        }
         return _collection->load(morph_name, options, warning_handler);
     }
 
@@ -298,12 +1041,30 @@ typename enable_if_mutable<M, M>::type Collection::load(
     unsigned int options,
     std::shared_ptr<WarningHandler> warning_handler) const {
     if (_collection != nullptr) {
+        if (_access_trace != nullptr) {
+            _access_trace->record(morph_name);
+        }
         return _collection->load_mut(morph_name, options, warning_handler);
     }
 
     throw std::runtime_error("The collection has been closed.");
 }
 
+template <class M>
+typename enable_if_cell<M, M>::type Collection::load(
+    const std::string& morph_name,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const {
+    if (_collection != nullptr) {
+        if (_access_trace != nullptr) {
+            _access_trace->record(morph_name);
+        }
+        return detail::CellLoader<M>::load(*_collection, morph_name, options, warning_handler);
+    }
+
+    throw std::runtime_error("The collection has been closed.");
+}
+
 std::vector<size_t> Collection::argsort(const std::vector<std::string>& morphology_names) const {
     if (_collection != nullptr) {
         return _collection->argsort(morphology_names);
@@ -322,6 +1083,16 @@ template Morphology Collection::load<Morphology>(
     unsigned int options,
     std::shared_ptr<WarningHandler> warning_handler = nullptr) const;
 
+template GlialCell Collection::load<GlialCell>(
+    const std::string& morph_name,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler = nullptr) const;
+
+template DendriticSpine Collection::load<DendriticSpine>(
+    const std::string& morph_name,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler = nullptr) const;
+
 
 template <class M>
 LoadUnordered<M> Collection::load_unordered(std::vector<std::string> morphology_names,
@@ -341,6 +1112,64 @@ template LoadUnordered<Morphology> Collection::load_unordered<Morphology>(
     unsigned int options,
     std::shared_ptr<WarningHandler> warning_handler) const;
 
+template LoadUnordered<GlialCell> Collection::load_unordered<GlialCell>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+template LoadUnordered<DendriticSpine> Collection::load_unordered<DendriticSpine>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+#ifdef MORPHIO_ENABLE_MPI
+template <class M>
+std::vector<std::pair<size_t, M>> Collection::load_share(
+    const std::vector<std::string>& morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const {
+    if (_collection == nullptr) {
+        throw std::runtime_error("The collection has been closed.");
+    }
+
+    auto share = _collection->load_share(*this, morphology_names, options, warning_handler);
+    std::vector<std::pair<size_t, M>> morphologies;
+    morphologies.reserve(share->size());
+    for (auto loaded : LoadUnordered<M>(share)) {
+        morphologies.emplace_back(share->loop_index(loaded.first), std::move(loaded.second));
+    }
+    return morphologies;
+}
+
+template std::vector<std::pair<size_t, Morphology>> Collection::load_share<Morphology>(
+    const std::vector<std::string>& morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+template std::vector<std::pair<size_t, mut::Morphology>> Collection::load_share<mut::Morphology>(
+    const std::vector<std::string>& morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+template std::vector<std::pair<size_t, GlialCell>> Collection::load_share<GlialCell>(
+    const std::vector<std::string>& morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+template std::vector<std::pair<size_t, DendriticSpine>> Collection::load_share<DendriticSpine>(
+    const std::vector<std::string>& morphology_names,
+    unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+#endif
+
+
+void Collection::record_accesses(std::shared_ptr<AccessTrace> trace) {
+    _access_trace = std::move(trace);
+}
+
+std::shared_ptr<AccessTrace> Collection::access_trace() const {
+    return _access_trace;
+}
 
 void Collection::close() {
     _collection = nullptr;
@@ -402,6 +1231,13 @@ typename enable_if_immutable<U, std::pair<size_t, M>>::type LoadUnordered<M>::It
     return {_k, std::move(_load_unordered_impl->load(_k))};
 }
 
+template <class M>
+template <class U>
+typename enable_if_cell<U, std::pair<size_t, M>>::type LoadUnordered<M>::Iterator::operator*()
+    const {
+    return {_k, detail::CellLoader<M>::load(*_load_unordered_impl, _k)};
+}
+
 
 template LoadUnordered<Morphology>::Iterator::Iterator(
     std::shared_ptr<LoadUnorderedImpl> load_unordered_impl, size_t k);
@@ -409,23 +1245,45 @@ template LoadUnordered<Morphology>::Iterator::Iterator(
 template LoadUnordered<mut::Morphology>::Iterator::Iterator(
     std::shared_ptr<LoadUnorderedImpl> load_unordered_impl, size_t k);
 
+template LoadUnordered<GlialCell>::Iterator::Iterator(
+    std::shared_ptr<LoadUnorderedImpl> load_unordered_impl, size_t k);
+
+template LoadUnordered<DendriticSpine>::Iterator::Iterator(
+    std::shared_ptr<LoadUnorderedImpl> load_unordered_impl, size_t k);
+
 
 template typename LoadUnordered<Morphology>::Iterator LoadUnordered<Morphology>::begin() const;
 
 template typename LoadUnordered<mut::Morphology>::Iterator LoadUnordered<mut::Morphology>::begin()
     const;
 
+template typename LoadUnordered<GlialCell>::Iterator LoadUnordered<GlialCell>::begin() const;
+
+template typename LoadUnordered<DendriticSpine>::Iterator LoadUnordered<DendriticSpine>::begin()
+    const;
+
 template typename LoadUnordered<Morphology>::Iterator LoadUnordered<Morphology>::end() const;
 
 template typename LoadUnordered<mut::Morphology>::Iterator LoadUnordered<mut::Morphology>::end()
     const;
 
+template typename LoadUnordered<GlialCell>::Iterator LoadUnordered<GlialCell>::end() const;
+
+template typename LoadUnordered<DendriticSpine>::Iterator LoadUnordered<DendriticSpine>::end()
+    const;
+
 template LoadUnordered<Morphology>::LoadUnordered(
     std::shared_ptr<LoadUnorderedImpl> load_unordered_impl);
 
 template LoadUnordered<mut::Morphology>::LoadUnordered(
     std::shared_ptr<LoadUnorderedImpl> load_unordered_impl);
 
+template LoadUnordered<GlialCell>::LoadUnordered(
+    std::shared_ptr<LoadUnorderedImpl> load_unordered_impl);
+
+template LoadUnordered<DendriticSpine>::LoadUnordered(
+    std::shared_ptr<LoadUnorderedImpl> load_unordered_impl);
+
 
 template bool LoadUnordered<Morphology>::Iterator::operator==(
     const LoadUnordered::Iterator& other) const;
@@ -433,6 +1291,12 @@ template bool LoadUnordered<Morphology>::Iterator::operator==(
 template bool LoadUnordered<mut::Morphology>::Iterator::operator==(
     const LoadUnordered::Iterator& other) const;
 
+template bool LoadUnordered<GlialCell>::Iterator::operator==(
+    const LoadUnordered::Iterator& other) const;
+
+template bool LoadUnordered<DendriticSpine>::Iterator::operator==(
+    const LoadUnordered::Iterator& other) const;
+
 
 template bool LoadUnordered<Morphology>::Iterator::operator!=(
     const LoadUnordered::Iterator& other) const;
@@ -440,23 +1304,47 @@ template bool LoadUnordered<Morphology>::Iterator::operator!=(
 template bool LoadUnordered<mut::Morphology>::Iterator::operator!=(
     const LoadUnordered::Iterator& other) const;
 
+template bool LoadUnordered<GlialCell>::Iterator::operator!=(
+    const LoadUnordered::Iterator& other) const;
+
+template bool LoadUnordered<DendriticSpine>::Iterator::operator!=(
+    const LoadUnordered::Iterator& other) const;
+
 template typename LoadUnordered<Morphology>::Iterator&
 LoadUnordered<Morphology>::Iterator::operator++();
 
 template typename LoadUnordered<mut::Morphology>::Iterator&
 LoadUnordered<mut::Morphology>::Iterator::operator++();
 
+template typename LoadUnordered<GlialCell>::Iterator&
+LoadUnordered<GlialCell>::Iterator::operator++();
+
+template typename LoadUnordered<DendriticSpine>::Iterator&
+LoadUnordered<DendriticSpine>::Iterator::operator++();
+
 template typename LoadUnordered<Morphology>::Iterator
 LoadUnordered<Morphology>::Iterator::operator++(int);
 
 template typename LoadUnordered<mut::Morphology>::Iterator
 LoadUnordered<mut::Morphology>::Iterator::operator++(int);
 
+template typename LoadUnordered<GlialCell>::Iterator
+LoadUnordered<GlialCell>::Iterator::operator++(int);
+
+template typename LoadUnordered<DendriticSpine>::Iterator
+LoadUnordered<DendriticSpine>::Iterator::operator++(int);
+
 template typename enable_if_mutable<mut::Morphology, std::pair<size_t, mut::Morphology>>::type
     LoadUnordered<mut::Morphology>::Iterator::operator*<mut::Morphology>() const;
 
 template typename enable_if_immutable<Morphology, std::pair<size_t, Morphology>>::type
     LoadUnordered<Morphology>::Iterator::operator*<Morphology>() const;
 
+template typename enable_if_cell<GlialCell, std::pair<size_t, GlialCell>>::type
+    LoadUnordered<GlialCell>::Iterator::operator*<GlialCell>() const;
+
+template typename enable_if_cell<DendriticSpine, std::pair<size_t, DendriticSpine>>::type
+    LoadUnordered<DendriticSpine>::Iterator::operator*<DendriticSpine>() const;
+
 
 }  // namespace morphio
@@ -0,0 +1,335 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::upper_bound
+#include <cmath>      // std::ceil, std::sqrt
+#include <limits>
+
+#include <morphio/compartments.h>
+#include <morphio/exceptions.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+
+#include "point_utils.h"
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::floatType;
+using morphio::Point;
+using morphio::compartments::CompartmentTree;
+
+/** Membrane area and axial resistance factor of a piece of a section */
+struct Cable {
+    floatType area = 0;
+    floatType resistance = 0;
+};
+
+/** A section polyline, parametrised by the path length from its first point */
+class SectionPath
+{
+  public:
+    explicit SectionPath(const morphio::Section& section)
+        : points_(section.points())
+        , diameters_(section.diameters())
+        , cumulative_(points_.size(), 0) {
+        for (size_t i = 1; i < points_.size(); ++i) {
+            cumulative_[i] = cumulative_[i - 1] +
+                             morphio::euclidean_distance(points_[i - 1], points_[i]);
+        }
+    }
+
+    floatType length() const {
+        return cumulative_.empty() ? 0 : cumulative_.back();
+    }
+
+    Point pointAt(floatType s) const {
+        if (points_.size() < 2) {
+            return points_.empty() ? Point{} : points_[0];
+        }
+        const size_t i = segment(s);
+        const floatType t = fraction(i, s);
+        Point point;
+        for (size_t k = 0; k < 3; ++k) {
+            point[k] = points_[i][k] + t * (points_[i + 1][k] - points_[i][k]);
+        }
+        return point;
+    }
+
+    floatType diameterAt(floatType s) const {
+        if (diameters_.size() < 2) {
+            return diameters_.empty() ? 0 : diameters_[0];
+        }
+        const size_t i = segment(s);
+        return diameters_[i] + fraction(i, s) * (diameters_[i + 1] - diameters_[i]);
+    }
+
+    /** Integrate the frustums of the part [a, b] of the section */
+    Cable integrate(floatType a, floatType b) const {
+        Cable cable;
+        for (size_t i = 0; i + 1 < points_.size(); ++i) {
+            const floatType begin = std::max(a, cumulative_[i]);
+            const floatType end = std::min(b, cumulative_[i + 1]);
+            const floatType h = end - begin;
+            if (h <= 0) {
+                continue;
+            }
+            const floatType r0 = radiusAt(i, begin);
+            const floatType r1 = radiusAt(i, end);
+            cable.area += morphio::PI * (r0 + r1) * std::sqrt(h * h + (r1 - r0) * (r1 - r0));
+            cable.resistance += r0 > 0 && r1 > 0 ? h / (morphio::PI * r0 * r1)
+                                                 : std::numeric_limits<floatType>::infinity();
+        }
+        return cable;
+    }
+
+  private:
+    /** The segment containing `s`, for sections with at least 2 points */
+    size_t segment(floatType s) const {
+        const auto it = std::upper_bound(cumulative_.begin(), cumulative_.end(), s);
+        const auto i = static_cast<size_t>(std::distance(cumulative_.begin(), it));
+        return std::min(std::max<size_t>(i, 1), points_.size() - 1) - 1;
+    }
+
+    floatType fraction(size_t i, floatType s) const {
+        const floatType h = cumulative_[i + 1] - cumulative_[i];
+        return h > 0 ? std::min<floatType>(std::max<floatType>((s - cumulative_[i]) / h, 0), 1)
+                     : 0;
+    }
+
+    floatType radiusAt(size_t i, floatType s) const {
+        return (diameters_[i] + fraction(i, s) * (diameters_[i + 1] - diameters_[i])) / 2;
+    }
+
+    morphio::range<const Point> points_;
+    morphio::range<const floatType> diameters_;
+    std::vector<floatType> cumulative_;
+};
+
+/** Surface of the soma, with an equivalent sphere for the types Soma::surface() lacks */
+floatType somaArea(const morphio::Soma& soma) {
+    if (soma.type() == morphio::SOMA_SINGLE_POINT ||
+        soma.type() == morphio::SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS ||
+        soma.type() == morphio::SOMA_CYLINDERS) {
+        return soma.surface();
+    }
+    const Point center = soma.center();
+    floatType radius = 0;
+    for (const auto& point : soma.points()) {
+        radius += morphio::euclidean_distance(center, point);
+    }
+    radius /= static_cast<floatType>(soma.points().size());
+    return 4 * morphio::PI * radius * radius;
+}
+
+void pushNode(CompartmentTree& tree,
+              int32_t parent,
+              int32_t section,
+              const Point& center,
+              floatType diameter,
+              floatType area,
+              floatType resistance) {
+    tree.cellNodes.push_back(static_cast<int32_t>(tree.parents.size()));
+    tree.parents.push_back(parent);
+    tree.cells.push_back(0);
+    tree.sections.push_back(section);
+    tree.centers.push_back(center);
+    tree.diameters.push_back(diameter);
+    tree.areas.push_back(area);
+    tree.axialResistanceFactors.push_back(parent < 0 ? 0 : resistance);
+}
+
+/** Append the `node`th node of `from` to `to`, with the given parent and cell */
+void copyNode(const CompartmentTree& from,
+              size_t node,
+              int32_t parent,
+              int32_t cell,
+              CompartmentTree& to) {
+    to.parents.push_back(parent);
+    to.cells.push_back(cell);
+    to.sections.push_back(from.sections[node]);
+    to.cellNodes.push_back(from.cellNodes[node]);
+    to.centers.push_back(from.centers[node]);
+    to.diameters.push_back(from.diameters[node]);
+    to.areas.push_back(from.areas[node]);
+    to.axialResistanceFactors.push_back(from.axialResistanceFactors[node]);
+}
+
+void reserve(CompartmentTree& tree, size_t size) {
+    tree.parents.reserve(size);
+    tree.cells.reserve(size);
+    tree.sections.reserve(size);
+    tree.cellNodes.reserve(size);
+    tree.centers.reserve(size);
+    tree.diameters.reserve(size);
+    tree.areas.reserve(size);
+    tree.axialResistanceFactors.reserve(size);
+}
+
+/** Append the nodes of the cells [first, last), sorted by level */
+void interleave(const std::vector<CompartmentTree>& cells,
+                size_t first,
+                size_t last,
+                CompartmentTree& forest) {
+    // levels[c][l]: nodes of the cell `first + c` at level `l`, in depth first order
+    std::vector<std::vector<std::vector<size_t>>> levels(last - first);
+    size_t maxLevels = 0;
+    for (size_t c = first; c < last; ++c) {
+        const auto& parents = cells[c].parents;
+        std::vector<size_t> level(parents.size(), 0);
+        auto& byLevel = levels[c - first];
+        for (size_t node = 0; node < parents.size(); ++node) {
+            if (parents[node] >= 0) {
+                level[node] = level[static_cast<size_t>(parents[node])] + 1;
+            }
+            if (level[node] >= byLevel.size()) {
+                byLevel.resize(level[node] + 1);
+            }
+            byLevel[level[node]].push_back(node);
+        }
+        maxLevels = std::max(maxLevels, byLevel.size());
+    }
+
+    std::vector<std::vector<int32_t>> newIndex(last - first);
+    for (size_t c = first; c < last; ++c) {
+        newIndex[c - first].resize(cells[c].size());
+    }
+    // in a level, the cells contribute their nodes in turn, so that consecutive nodes belong to
+    // different cells
+    for (size_t l = 0; l < maxLevels; ++l) {
+        size_t width = 0;
+        for (const auto& byLevel : levels) {
+            width = std::max(width, l < byLevel.size() ? byLevel[l].size() : 0);
+        }
+        for (size_t rank = 0; rank < width; ++rank) {
+            for (size_t c = first; c < last; ++c) {
+                const auto& byLevel = levels[c - first];
+                if (l >= byLevel.size() || rank >= byLevel[l].size()) {
+                    continue;
+                }
+                auto& index = newIndex[c - first];
+                const size_t node = byLevel[l][rank];
+                const int32_t parent = cells[c].parents[node];
+                index[node] = static_cast<int32_t>(forest.size());
+                copyNode(cells[c],
+                         node,
+                         parent < 0 ? -1 : index[static_cast<size_t>(parent)],
+                         static_cast<int32_t>(c),
+                         forest);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+namespace morphio {
+namespace compartments {
+
+CompartmentTree compartmentalize(const Morphology& morphology, const CompartmentOptions& options) {
+    if (options.maxLength < 0) {
+        throw MorphioError("The maximum length of a compartment must be positive");
+    }
+
+    CompartmentTree tree;
+    reserve(tree, morphology.sectionTypes().size() + 1);
+
+    int32_t somaNode = -1;
+    const Soma soma = morphology.soma();
+    if (options.withSoma && !soma.points().empty()) {
+        const floatType area = somaArea(soma);
+        somaNode = 0;
+        pushNode(tree, -1, -1, soma.center(), std::sqrt(area / PI), area, 0);
+    }
+
+    const size_t nSections = morphology.sectionTypes().size();
+    std::vector<int32_t> lastNode(nSections, -1);
+    // resistance factor from the last node of a section to its end
+    std::vector<floatType> tailResistance(nSections, 0);
+
+    for (auto it = morphology.depth_begin(); it != morphology.depth_end(); ++it) {
+        const Section& section = *it;
+        const SectionPath path(section);
+        const floatType length = path.length();
+        const auto nCompartments =
+            options.maxLength > 0 && length > options.maxLength
+                ? static_cast<unsigned int>(std::ceil(length / options.maxLength))
+                : 1u;
+        const floatType compartmentLength = length / static_cast<floatType>(nCompartments);
+
+        int32_t parent = somaNode;
+        floatType carried = 0;
+        if (!section.isRoot()) {
+            const uint32_t parentSection = section.parent().id();
+            parent = lastNode[parentSection];
+            carried = tailResistance[parentSection];
+        }
+
+        floatType previousCenter = 0;
+        for (unsigned int k = 0; k < nCompartments; ++k) {
+            const floatType center = (static_cast<floatType>(k) + floatType(0.5)) *
+                                     compartmentLength;
+            const floatType area =
+                path.integrate(static_cast<floatType>(k) * compartmentLength,
+                               static_cast<floatType>(k + 1) * compartmentLength)
+                    .area;
+            const floatType resistance = carried +
+                                         path.integrate(previousCenter, center).resistance;
+            const auto node = static_cast<int32_t>(tree.size());
+            pushNode(tree,
+                     parent,
+                     static_cast<int32_t>(section.id()),
+                     path.pointAt(center),
+                     path.diameterAt(center),
+                     area,
+                     resistance);
+            parent = node;
+            carried = 0;
+            previousCenter = center;
+        }
+        lastNode[section.id()] = parent;
+        tailResistance[section.id()] = path.integrate(previousCenter, length).resistance;
+    }
+    return tree;
+}
+
+CompartmentTree compartmentalize(const std::vector<Morphology>& morphologies,
+                                 const CompartmentOptions& options) {
+    std::vector<CompartmentTree> cells(morphologies.size());
+    details::parallelFor(
+        morphologies.size(),
+        [&](size_t i) { cells[i] = compartmentalize(morphologies[i], options); },
+        options.nThreads);
+
+    size_t size = 0;
+    for (const auto& cell : cells) {
+        size += cell.size();
+    }
+
+    CompartmentTree forest;
+    reserve(forest, size);
+    if (options.ordering == INTERLEAVED) {
+        const size_t groupSize = std::max(1u, options.groupSize);
+        for (size_t first = 0; first < cells.size(); first += groupSize) {
+            interleave(cells, first, std::min(first + groupSize, cells.size()), forest);
+        }
+        return forest;
+    }
+
+    for (size_t c = 0; c < cells.size(); ++c) {
+        const auto offset = static_cast<int32_t>(forest.size());
+        const auto& parents = cells[c].parents;
+        for (size_t node = 0; node < parents.size(); ++node) {
+            copyNode(cells[c],
+                     node,
+                     parents[node] < 0 ? -1 : parents[node] + offset,
+                     static_cast<int32_t>(c),
+                     forest);
+        }
+    }
+    return forest;
+}
+
+}  // namespace compartments
+}  // namespace morphio
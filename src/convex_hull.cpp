@@ -0,0 +1,407 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::max_element, std::sort
+#include <cmath>      // std::sqrt, std::fabs
+#include <unordered_map>
+
+#include "convex_hull.h"
+#include "point_utils.h"  // cross, dot
+
+namespace morphio {
+namespace details {
+
+namespace {
+
+using Vec = std::array<double, 3>;
+
+Vec sub(const Vec& a, const Vec& b) {
+    return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+double norm(const Vec& a) {
+    return std::sqrt(dot(a, a));
+}
+
+Point toPoint(const Vec& v) {
+    return {static_cast<floatType>(v[0]),
+            static_cast<floatType>(v[1]),
+            static_cast<floatType>(v[2])};
+}
+
+struct Face {
+    std::array<uint32_t, 3> vertices;
+    Vec normal;  // not normalized, |normal| is twice the area of the face
+    bool alive;
+    /** Points above the face that are above none of the faces it was checked against before */
+    std::vector<uint32_t> outside;
+};
+
+Face makeFace(const std::vector<Vec>& points, uint32_t a, uint32_t b, uint32_t c) {
+    return {{a, b, c}, cross(sub(points[b], points[a]), sub(points[c], points[a])), true, {}};
+}
+
+uint64_t edgeKey(uint32_t from, uint32_t to) {
+    return (static_cast<uint64_t>(from) << 32) | to;
+}
+
+/** Index of the point maximizing `f` */
+template <typename F>
+uint32_t argmax(const std::vector<Vec>& points, const F& f) {
+    uint32_t best = 0;
+    double bestValue = f(points[0]);
+    for (uint32_t i = 1; i < points.size(); ++i) {
+        const double value = f(points[i]);
+        if (value > bestValue) {
+            best = i;
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+/** Hull of points lying in the plane of (origin, u, v), u and v being orthonormal */
+ConvexHull3D planarHull(const std::vector<Vec>& points,
+                        const Vec& origin,
+                        const Vec& u,
+                        const Vec& v) {
+    std::vector<std::array<double, 2>> projected;
+    projected.reserve(points.size());
+    for (const auto& point : points) {
+        const Vec d = sub(point, origin);
+        projected.push_back({dot(d, u), dot(d, v)});
+    }
+
+    std::vector<uint32_t> order(points.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&projected](uint32_t a, uint32_t b) {
+        return projected[a] < projected[b];
+    });
+
+    // Andrew's monotone chain
+    auto turn = [&projected](uint32_t o, uint32_t a, uint32_t b) {
+        return (projected[a][0] - projected[o][0]) * (projected[b][1] - projected[o][1]) -
+               (projected[a][1] - projected[o][1]) * (projected[b][0] - projected[o][0]);
+    };
+    std::vector<uint32_t> polygon(2 * order.size());
+    size_t k = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        while (k >= 2 && turn(polygon[k - 2], polygon[k - 1], order[i]) <= 0) {
+            --k;
+        }
+        polygon[k++] = order[i];
+    }
+    for (size_t i = order.size() - 1, lower = k + 1; i > 0; --i) {
+        while (k >= lower && turn(polygon[k - 2], polygon[k - 1], order[i - 1]) <= 0) {
+            --k;
+        }
+        polygon[k++] = order[i - 1];
+    }
+    polygon.resize(k - 1);
+
+    ConvexHull3D hull;
+    double area = 0;
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        hull.vertices.push_back(toPoint(points[polygon[i]]));
+        area += turn(polygon[0], polygon[i], polygon[(i + 1) % polygon.size()]);
+    }
+    // Twice the polygon area: the flat hull has two sides
+    hull.area = std::fabs(area);
+    return hull;
+}
+
+}  // namespace
+
+ConvexHull3D convexHull(const Points& input) {
+    ConvexHull3D hull;
+    if (input.empty()) {
+        return hull;
+    }
+
+    std::vector<Vec> points;
+    points.reserve(input.size());
+    for (const auto& point : input) {
+        points.push_back({point[0], point[1], point[2]});
+    }
+
+    // Initial simplex: extremities along the widest axis, then the farthest point from
+    // their line, then the farthest point from the plane of the three
+    size_t axis = 0;
+    double extent = -1;
+    for (size_t i = 0; i < 3; ++i) {
+        const uint32_t lo = argmax(points, [i](const Vec& p) { return -p[i]; });
+        const uint32_t hi = argmax(points, [i](const Vec& p) { return p[i]; });
+        if (points[hi][i] - points[lo][i] > extent) {
+            extent = points[hi][i] - points[lo][i];
+            axis = i;
+        }
+    }
+    const double epsilon = 1e-10 * extent;
+    const uint32_t i0 = argmax(points, [axis](const Vec& p) { return -p[axis]; });
+    const uint32_t i1 = argmax(points, [axis](const Vec& p) { return p[axis]; });
+    if (extent <= 0) {
+        hull.vertices.push_back(input[i0]);
+        return hull;
+    }
+
+    const Vec lineDirection = sub(points[i1], points[i0]);
+    const uint32_t i2 = argmax(points, [&](const Vec& p) {
+        return norm(cross(lineDirection, sub(p, points[i0])));
+    });
+    const Vec planeNormal = cross(lineDirection, sub(points[i2], points[i0]));
+    if (norm(planeNormal) <= epsilon * norm(lineDirection)) {
+        hull.vertices = {input[i0], input[i1]};
+        return hull;
+    }
+
+    const uint32_t i3 = argmax(points, [&](const Vec& p) {
+        return std::fabs(dot(planeNormal, sub(p, points[i0])));
+    });
+    const double height = dot(planeNormal, sub(points[i3], points[i0]));
+    if (std::fabs(height) <= epsilon * norm(planeNormal)) {
+        const double length = norm(lineDirection);
+        const Vec u{lineDirection[0] / length,
+                    lineDirection[1] / length,
+                    lineDirection[2] / length};
+        Vec v = cross(planeNormal, u);
+        const double vLength = norm(v);
+        v = {v[0] / vLength, v[1] / vLength, v[2] / vLength};
+        return planarHull(points, points[i0], u, v);
+    }
+
+    // Quickhull: every point outside the hull is in the conflict list of one face it is above.
+    // The farthest point above a face is added to the hull by replacing the faces it sees,
+    // found by walking the neighbours of the face, and only the points of their conflict lists
+    // need to be assigned to the new faces.
+    std::vector<Face> faces;
+    // Directed edge -> index of the alive face having it
+    std::unordered_map<uint64_t, uint32_t> edgeFaces;
+    const auto addFace = [&](uint32_t a, uint32_t b, uint32_t c) {
+        const auto id = static_cast<uint32_t>(faces.size());
+        faces.push_back(makeFace(points, a, b, c));
+        edgeFaces[edgeKey(a, b)] = id;
+        edgeFaces[edgeKey(b, c)] = id;
+        edgeFaces[edgeKey(c, a)] = id;
+    };
+    const auto distance = [&](const Face& face, uint32_t point) {
+        return dot(face.normal, sub(points[point], points[face.vertices[0]]));
+    };
+    const auto isAbove = [&](const Face& face, uint32_t point) {
+        return distance(face, point) > epsilon * norm(face.normal);
+    };
+    // Put `point` in the conflict list of the first face of `candidates` it is above
+    const auto assign = [&](uint32_t point, size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            if (isAbove(faces[f], point)) {
+                faces[f].outside.push_back(point);
+                return;
+            }
+        }
+    };
+
+    if (height < 0) {
+        addFace(i0, i1, i2);
+        addFace(i0, i3, i1);
+        addFace(i1, i3, i2);
+        addFace(i2, i3, i0);
+    } else {
+        addFace(i0, i2, i1);
+        addFace(i0, i1, i3);
+        addFace(i1, i2, i3);
+        addFace(i2, i0, i3);
+    }
+    for (uint32_t i = 0; i < points.size(); ++i) {
+        if (i != i0 && i != i1 && i != i2 && i != i3) {
+            assign(i, 0, faces.size());
+        }
+    }
+
+    std::vector<uint32_t> visible;
+    std::vector<std::array<uint32_t, 2>> horizon;
+    std::vector<uint32_t> orphans;
+    // New faces are appended, so a single pass processes them all
+    for (uint32_t current = 0; current < faces.size(); ++current) {
+        if (!faces[current].alive || faces[current].outside.empty()) {
+            continue;
+        }
+        const auto& candidates = faces[current].outside;
+        const uint32_t eye = *std::max_element(candidates.begin(),
+                                               candidates.end(),
+                                               [&](uint32_t a, uint32_t b) {
+                                                   return distance(faces[current], a) <
+                                                          distance(faces[current], b);
+                                               });
+
+        // The faces seen from the eye are connected, they are marked as dead while walked
+        visible.assign(1, current);
+        faces[current].alive = false;
+        for (size_t v = 0; v < visible.size(); ++v) {
+            const auto vertices = faces[visible[v]].vertices;
+            for (size_t e = 0; e < 3; ++e) {
+                const uint32_t neighbour =
+                    edgeFaces.at(edgeKey(vertices[(e + 1) % 3], vertices[e]));
+                if (faces[neighbour].alive && isAbove(faces[neighbour], eye)) {
+                    faces[neighbour].alive = false;
+                    visible.push_back(neighbour);
+                }
+            }
+        }
+
+        // The horizon is made of the edges of visible faces shared with hidden faces
+        horizon.clear();
+        orphans.clear();
+        for (const uint32_t id : visible) {
+            auto& face = faces[id];
+            for (size_t e = 0; e < 3; ++e) {
+                const uint32_t from = face.vertices[e];
+                const uint32_t to = face.vertices[(e + 1) % 3];
+                if (faces[edgeFaces.at(edgeKey(to, from))].alive) {
+                    horizon.push_back({from, to});
+                }
+            }
+            orphans.insert(orphans.end(), face.outside.begin(), face.outside.end());
+            face.outside = {};
+        }
+        for (const uint32_t id : visible) {
+            const auto& vertices = faces[id].vertices;
+            for (size_t e = 0; e < 3; ++e) {
+                edgeFaces.erase(edgeKey(vertices[e], vertices[(e + 1) % 3]));
+            }
+        }
+
+        const size_t firstNewFace = faces.size();
+        for (const auto& edge : horizon) {
+            addFace(edge[0], edge[1], eye);
+        }
+        for (const uint32_t orphan : orphans) {
+            if (orphan != eye) {
+                assign(orphan, firstNewFace, faces.size());
+            }
+        }
+    }
+
+    // Renumber the vertices that are used by the surviving faces
+    std::vector<uint32_t> remap(points.size(), UINT32_MAX);
+    const Vec& reference = points[i0];
+    for (const auto& face : faces) {
+        if (!face.alive) {
+            continue;
+        }
+        std::array<uint32_t, 3> triangle{};
+        for (size_t k = 0; k < 3; ++k) {
+            const uint32_t id = face.vertices[k];
+            if (remap[id] == UINT32_MAX) {
+                remap[id] = static_cast<uint32_t>(hull.vertices.size());
+                hull.vertices.push_back(input[id]);
+            }
+            triangle[k] = remap[id];
+        }
+        hull.faces.push_back(triangle);
+        hull.area += norm(face.normal) / 2;
+        hull.volume += dot(sub(points[face.vertices[0]], reference), face.normal) / 6;
+    }
+
+    return hull;
+}
+
+void PointMoments::add(const Point& point) {
+    const double x = point[0], y = point[1], z = point[2];
+    count += 1;
+    sum[0] += x;
+    sum[1] += y;
+    sum[2] += z;
+    sumOfProducts[0] += x * x;
+    sumOfProducts[1] += y * y;
+    sumOfProducts[2] += z * z;
+    sumOfProducts[3] += x * y;
+    sumOfProducts[4] += x * z;
+    sumOfProducts[5] += y * z;
+}
+
+void PointMoments::merge(const PointMoments& other) {
+    count += other.count;
+    for (size_t i = 0; i < 3; ++i) {
+        sum[i] += other.sum[i];
+    }
+    for (size_t i = 0; i < 6; ++i) {
+        sumOfProducts[i] += other.sumOfProducts[i];
+    }
+}
+
+Point PointMoments::mean() const {
+    if (count == 0) {
+        return {0, 0, 0};
+    }
+    return toPoint({sum[0] / count, sum[1] / count, sum[2] / count});
+}
+
+std::array<Point, 3> PointMoments::principalAxes() const {
+    // Covariance matrix, diagonalized with cyclic Jacobi rotations
+    double a[3][3] = {};
+    double eigenvectors[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    if (count > 0) {
+        const double m[3] = {sum[0] / count, sum[1] / count, sum[2] / count};
+        a[0][0] = sumOfProducts[0] / count - m[0] * m[0];
+        a[1][1] = sumOfProducts[1] / count - m[1] * m[1];
+        a[2][2] = sumOfProducts[2] / count - m[2] * m[2];
+        a[0][1] = a[1][0] = sumOfProducts[3] / count - m[0] * m[1];
+        a[0][2] = a[2][0] = sumOfProducts[4] / count - m[0] * m[2];
+        a[1][2] = a[2][1] = sumOfProducts[5] / count - m[1] * m[2];
+    }
+
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        const double offDiagonal = std::fabs(a[0][1]) + std::fabs(a[0][2]) + std::fabs(a[1][2]);
+        const double diagonal = std::fabs(a[0][0]) + std::fabs(a[1][1]) + std::fabs(a[2][2]);
+        if (offDiagonal <= 1e-15 * diagonal || offDiagonal == 0) {
+            break;
+        }
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (a[p][q] == 0) {
+                    continue;
+                }
+                const double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                const double t = (theta >= 0 ? 1. : -1.) /
+                                 (std::fabs(theta) + std::sqrt(theta * theta + 1));
+                const double c = 1 / std::sqrt(t * t + 1);
+                const double s = t * c;
+                for (int k = 0; k < 3; ++k) {
+                    const double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double vkp = eigenvectors[k][p], vkq = eigenvectors[k][q];
+                    eigenvectors[k][p] = c * vkp - s * vkq;
+                    eigenvectors[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    std::array<int, 3> order{0, 1, 2};
+    std::sort(order.begin(), order.end(), [&a](int i, int j) { return a[i][i] > a[j][j]; });
+
+    std::array<Point, 3> axes;
+    for (size_t i = 0; i < 3; ++i) {
+        const int column = order[i];
+        axes[i] = toPoint(
+            {eigenvectors[0][column], eigenvectors[1][column], eigenvectors[2][column]});
+    }
+    // Keep a right-handed frame
+    const Vec x{axes[0][0], axes[0][1], axes[0][2]};
+    const Vec y{axes[1][0], axes[1][1], axes[1][2]};
+    axes[2] = toPoint(cross(x, y));
+    return axes;
+}
+
+}  // namespace details
+}  // namespace morphio
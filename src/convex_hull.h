@@ -0,0 +1,52 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>  // uint32_t
+#include <vector>
+
+#include <morphio/types.h>
+
+namespace morphio {
+namespace details {
+
+/** The convex hull of a set of 3D points */
+struct ConvexHull3D {
+    /** The points of the input set that are vertices of the hull */
+    Points vertices;
+    /** Triangles of the hull surface, indexing `vertices`, counter-clockwise seen from outside */
+    std::vector<std::array<uint32_t, 3>> faces;
+    double volume = 0;
+    double area = 0;
+};
+
+/**
+ * Compute the convex hull of `points` with the Quickhull algorithm.
+ *
+ * Degenerate inputs are handled: for coplanar points, `vertices` is the 2D hull polygon,
+ * `faces` is empty, the volume is 0 and the area is twice the area of the polygon (both
+ * sides of a flat hull); for collinear points `vertices` are the two extremities and the
+ * area is 0.
+ */
+ConvexHull3D convexHull(const Points& points);
+
+/** First and second order moments of a point set, they can be merged without the points */
+struct PointMoments {
+    double count = 0;
+    std::array<double, 3> sum{};
+    /** xx, yy, zz, xy, xz, yz */
+    std::array<double, 6> sumOfProducts{};
+
+    void add(const Point& point);
+    void merge(const PointMoments& other);
+
+    Point mean() const;
+    /** Principal axes, sorted by decreasing variance */
+    std::array<Point, 3> principalAxes() const;
+};
+
+}  // namespace details
+}  // namespace morphio
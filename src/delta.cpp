@@ -0,0 +1,505 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::equal, std::max
+#include <cstring>    // std::memcpy
+#include <fstream>
+#include <sstream>
+
+#include <morphio/delta.h>
+#include <morphio/endoplasmic_reticulum.h>
+#include <morphio/exceptions.h>
+#include <morphio/mitochondria.h>
+#include <morphio/properties.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+
+#include "morphology_access.h"
+#include "shared_utils.hpp"
+
+namespace {
+
+using morphio::floatType;
+using morphio::RawDataError;
+
+const char kMagic[] = "MORPHIODELTA";
+const size_t kMagicSize = sizeof(kMagic) - 1;
+const uint32_t kFormatVersion = 1;
+
+/** The points, diameters and perimeters of a section */
+struct SectionData {
+    morphio::range<const morphio::Point> points;
+    morphio::range<const floatType> diameters;
+    morphio::range<const floatType> perimeters;
+
+    explicit SectionData(const morphio::Section& section)
+        : points(section.points())
+        , diameters(section.diameters())
+        , perimeters(section.perimeters()) {}
+
+    bool operator==(const SectionData& other) const {
+        return points.size() == other.points.size() &&
+               perimeters.size() == other.perimeters.size() &&
+               std::equal(points.begin(), points.end(), other.points.begin()) &&
+               std::equal(diameters.begin(), diameters.end(), other.diameters.begin()) &&
+               std::equal(perimeters.begin(), perimeters.end(), other.perimeters.begin());
+    }
+
+    /** FNV-1a over the bytes of the values */
+    uint64_t hash() const {
+        uint64_t hash = 14695981039346656037ULL;
+        const auto add = [&hash](const void* data, size_t size) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ULL;
+            }
+        };
+        add(points.data(), points.size() * sizeof(morphio::Point));
+        add(diameters.data(), diameters.size() * sizeof(floatType));
+        add(perimeters.data(), perimeters.size() * sizeof(floatType));
+        return hash;
+    }
+};
+
+class Writer
+{
+  public:
+    template <typename T>
+    void scalar(T value) {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        buffer_.append(bytes, sizeof(T));
+    }
+
+    void string(const std::string& str) {
+        scalar<uint64_t>(str.size());
+        buffer_ += str;
+    }
+
+    template <typename T>
+    void vector(const std::vector<T>& values) {
+        scalar<uint64_t>(values.size());
+        buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    std::string release() {
+        return std::move(buffer_);
+    }
+
+  private:
+    std::string buffer_;
+};
+
+class Reader
+{
+  public:
+    explicit Reader(const std::string& contents)
+        : contents_(contents) {}
+
+    void magic() {
+        if (contents_.compare(0, kMagicSize, kMagic) != 0) {
+            throw RawDataError("Delta: not a morphology delta");
+        }
+        position_ = kMagicSize;
+        const auto version = scalar<uint32_t>();
+        if (version != kFormatVersion) {
+            throw RawDataError("Delta: unsupported format version " + std::to_string(version));
+        }
+        floatSize_ = scalar<uint8_t>();
+        if (floatSize_ != sizeof(float) && floatSize_ != sizeof(double)) {
+            throw RawDataError("Delta: invalid float size " + std::to_string(floatSize_));
+        }
+    }
+
+    template <typename T>
+    T scalar() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string string() {
+        const auto size = count(1);
+        return {take(size), size};
+    }
+
+    template <typename T>
+    std::vector<T> vector() {
+        const auto size = count(sizeof(T));
+        std::vector<T> values(size);
+        std::memcpy(values.data(), take(size * sizeof(T)), size * sizeof(T));
+        return values;
+    }
+
+    /** Floating point values, converted to `floatType` if written with another precision */
+    std::vector<floatType> floats(size_t width = 1) {
+        const auto size = count(floatSize_ * width) * width;
+        if (floatSize_ == sizeof(float)) {
+            return convert<float>(size);
+        }
+        return convert<double>(size);
+    }
+
+    morphio::Points points() {
+        const auto values = floats(3);
+        morphio::Points points(values.size() / 3);
+        for (size_t i = 0; i < points.size(); ++i) {
+            points[i] = {values[3 * i], values[3 * i + 1], values[3 * i + 2]};
+        }
+        return points;
+    }
+
+    void end() const {
+        if (position_ != contents_.size()) {
+            throw RawDataError("Delta: trailing bytes");
+        }
+    }
+
+  private:
+    template <typename T>
+    std::vector<floatType> convert(size_t size) {
+        std::vector<T> values(size);
+        std::memcpy(values.data(), take(size * sizeof(T)), size * sizeof(T));
+        return {values.begin(), values.end()};
+    }
+
+    /** Read a vector length, checking that `size * itemSize` bytes remain */
+    size_t count(size_t itemSize) {
+        const auto size = scalar<uint64_t>();
+        if (size > (contents_.size() - position_) / itemSize) {
+            throw RawDataError("Delta: truncated contents");
+        }
+        return static_cast<size_t>(size);
+    }
+
+    const char* take(size_t size) {
+        if (size > contents_.size() - position_) {
+            throw RawDataError("Delta: truncated contents");
+        }
+        const char* data = contents_.data() + position_;
+        position_ += size;
+        return data;
+    }
+
+    const std::string& contents_;
+    size_t position_ = 0;
+    size_t floatSize_ = sizeof(floatType);
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw RawDataError("File: " + path + " does not exist.");
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+/** The `.delta` files of a directory */
+class DirectorySource: public morphio::ByteSource
+{
+  public:
+    explicit DirectorySource(std::string directory)
+        : directory_(std::move(directory)) {}
+
+    morphio::MorphologyBytes get(const std::string& morph_name) const override {
+        return {readFile(morphio::join_path(directory_, morph_name + ".delta")), "delta"};
+    }
+
+  private:
+    std::string directory_;
+};
+
+}  // namespace
+
+namespace morphio {
+namespace delta {
+
+MorphologyDelta diff(const Morphology& base,
+                     const Morphology& variant,
+                     const std::string& baseName) {
+    if (!variant.mitochondria().rootSections().empty() ||
+        !variant.endoplasmicReticulum().sectionIndices().empty()) {
+        throw MorphioError("Delta: morphologies with organelles are not supported");
+    }
+
+    MorphologyDelta delta;
+    delta.base = baseName;
+    delta.cellFamily = variant.cellFamily();
+    delta.somaType = variant.somaType();
+    delta.version = variant.version();
+
+    const auto baseSoma = base.soma();
+    const auto variantSoma = variant.soma();
+    const auto somaPoints = variantSoma.points();
+    const auto somaDiameters = variantSoma.diameters();
+    if (baseSoma.points().size() != somaPoints.size() ||
+        !std::equal(somaPoints.begin(), somaPoints.end(), baseSoma.points().begin()) ||
+        !std::equal(somaDiameters.begin(), somaDiameters.end(), baseSoma.diameters().begin())) {
+        delta.somaChanged = true;
+        delta.somaPoints.assign(somaPoints.begin(), somaPoints.end());
+        delta.somaDiameters.assign(somaDiameters.begin(), somaDiameters.end());
+    }
+
+    const auto baseSections = base.sections();
+    std::unordered_multimap<uint64_t, uint32_t> baseIndex;
+    baseIndex.reserve(baseSections.size());
+    for (const auto& section : baseSections) {
+        baseIndex.emplace(SectionData(section).hash(), section.id());
+    }
+
+    const auto findBase = [&](const SectionData& data) -> int32_t {
+        const auto candidates = baseIndex.equal_range(data.hash());
+        for (auto it = candidates.first; it != candidates.second; ++it) {
+            if (SectionData(baseSections[it->second]) == data) {
+                return static_cast<int32_t>(it->second);
+            }
+        }
+        return -1;
+    };
+
+    const auto sections = variant.sections();
+    delta.hasPerimeters = !variant.perimeters().empty();
+    delta.baseSections.reserve(sections.size());
+    delta.parents.reserve(sections.size());
+    delta.types.reserve(sections.size());
+    for (const auto& section : sections) {
+        delta.parents.push_back(section.isRoot() ? -1
+                                                 : static_cast<int32_t>(section.parent().id()));
+        delta.types.push_back(section.type());
+
+        const SectionData data(section);
+        const int32_t baseSection = findBase(data);
+        delta.baseSections.push_back(baseSection);
+        if (baseSection != -1) {
+            continue;
+        }
+        delta.offsets.push_back(delta.points.size());
+        delta.points.insert(delta.points.end(), data.points.begin(), data.points.end());
+        delta.diameters.insert(delta.diameters.end(), data.diameters.begin(), data.diameters.end());
+        if (delta.hasPerimeters) {
+            delta.perimeters.insert(delta.perimeters.end(),
+                                    data.perimeters.begin(),
+                                    data.perimeters.end());
+        }
+    }
+    delta.offsets.push_back(delta.points.size());
+    return delta;
+}
+
+Morphology apply(const Morphology& base, const MorphologyDelta& delta) {
+    const size_t nSections = delta.size();
+    const size_t nStored = delta.offsets.empty() ? 0 : delta.offsets.size() - 1;
+    if (delta.baseSections.size() != nSections || delta.types.size() != nSections ||
+        delta.offsets.empty() || delta.offsets.back() != delta.points.size() ||
+        delta.diameters.size() != delta.points.size() ||
+        delta.perimeters.size() != (delta.hasPerimeters ? delta.points.size() : 0) ||
+        delta.somaDiameters.size() != delta.somaPoints.size()) {
+        throw RawDataError("Delta: inconsistent delta");
+    }
+
+    Property::Properties properties;
+    properties._cellLevel._cellFamily = delta.cellFamily;
+    properties._cellLevel._somaType = delta.somaType;
+    properties._cellLevel._version = delta.version;
+
+    if (delta.somaChanged) {
+        properties._somaLevel._points = delta.somaPoints;
+        properties._somaLevel._diameters = delta.somaDiameters;
+    } else {
+        const auto soma = base.soma();
+        properties._somaLevel._points.assign(soma.points().begin(), soma.points().end());
+        properties._somaLevel._diameters.assign(soma.diameters().begin(), soma.diameters().end());
+    }
+
+    const auto baseSections = base.sections();
+    if (delta.hasPerimeters && nStored < nSections && base.perimeters().empty()) {
+        throw RawDataError("Delta: the base " + delta.base + " has no perimeters");
+    }
+
+    auto& points = properties._pointLevel._points;
+    auto& diameters = properties._pointLevel._diameters;
+    auto& perimeters = properties._pointLevel._perimeters;
+    auto& structure = properties._sectionLevel._sections;
+    auto& sectionTypes = properties._sectionLevel._sectionTypes;
+    structure.reserve(nSections);
+    sectionTypes.reserve(nSections);
+
+    size_t stored = 0;
+    for (size_t i = 0; i < nSections; ++i) {
+        const int32_t parent = delta.parents[i];
+        const int32_t baseSection = delta.baseSections[i];
+        if (parent < -1 || parent >= static_cast<int32_t>(nSections) || baseSection < -1 ||
+            baseSection >= static_cast<int32_t>(baseSections.size())) {
+            throw RawDataError("Delta: invalid section " + std::to_string(i) +
+                               " for the base " + delta.base);
+        }
+        structure.push_back({static_cast<int64_t>(points.size()), parent});
+        sectionTypes.push_back(delta.types[i]);
+
+        if (baseSection != -1) {
+            const auto& section = baseSections[static_cast<size_t>(baseSection)];
+            const auto sectionPoints = section.points();
+            const auto sectionDiameters = section.diameters();
+            points.insert(points.end(), sectionPoints.begin(), sectionPoints.end());
+            diameters.insert(diameters.end(), sectionDiameters.begin(), sectionDiameters.end());
+            if (delta.hasPerimeters) {
+                const auto sectionPerimeters = section.perimeters();
+                perimeters.insert(perimeters.end(),
+                                  sectionPerimeters.begin(),
+                                  sectionPerimeters.end());
+            }
+            continue;
+        }
+
+        if (stored >= nStored || delta.offsets[stored] > delta.offsets[stored + 1]) {
+            throw RawDataError("Delta: invalid offsets");
+        }
+        const auto begin = static_cast<std::ptrdiff_t>(delta.offsets[stored]);
+        const auto end = static_cast<std::ptrdiff_t>(delta.offsets[stored + 1]);
+        points.insert(points.end(), delta.points.begin() + begin, delta.points.begin() + end);
+        diameters.insert(diameters.end(),
+                         delta.diameters.begin() + begin,
+                         delta.diameters.begin() + end);
+        if (delta.hasPerimeters) {
+            perimeters.insert(perimeters.end(),
+                              delta.perimeters.begin() + begin,
+                              delta.perimeters.begin() + end);
+        }
+        ++stored;
+    }
+    if (stored != nStored) {
+        throw RawDataError("Delta: invalid offsets");
+    }
+
+    return details::MorphologyAccess::fromProperties(properties);
+}
+
+std::string serialize(const MorphologyDelta& delta) {
+    Writer writer;
+    for (size_t i = 0; i < kMagicSize; ++i) {
+        writer.scalar(kMagic[i]);
+    }
+    writer.scalar(kFormatVersion);
+    writer.scalar(static_cast<uint8_t>(sizeof(floatType)));
+    writer.scalar(static_cast<uint8_t>(delta.hasPerimeters));
+
+    writer.string(delta.base);
+    writer.scalar(static_cast<int32_t>(delta.cellFamily));
+    writer.scalar(static_cast<int32_t>(delta.somaType));
+    writer.string(std::get<0>(delta.version));
+    writer.scalar(std::get<1>(delta.version));
+    writer.scalar(std::get<2>(delta.version));
+
+    writer.scalar(static_cast<uint8_t>(delta.somaChanged));
+    writer.vector(delta.somaPoints);
+    writer.vector(delta.somaDiameters);
+
+    writer.vector(delta.baseSections);
+    writer.vector(delta.parents);
+    std::vector<int32_t> types(delta.types.begin(), delta.types.end());
+    writer.vector(types);
+
+    writer.vector(delta.points);
+    writer.vector(delta.diameters);
+    writer.vector(delta.perimeters);
+    writer.vector(delta.offsets);
+    return writer.release();
+}
+
+MorphologyDelta deserialize(const std::string& contents) {
+    Reader reader(contents);
+    reader.magic();
+
+    MorphologyDelta delta;
+    delta.hasPerimeters = reader.scalar<uint8_t>() != 0;
+    delta.base = reader.string();
+    delta.cellFamily = static_cast<CellFamily>(reader.scalar<int32_t>());
+    delta.somaType = static_cast<SomaType>(reader.scalar<int32_t>());
+    std::get<0>(delta.version) = reader.string();
+    std::get<1>(delta.version) = reader.scalar<uint32_t>();
+    std::get<2>(delta.version) = reader.scalar<uint32_t>();
+
+    delta.somaChanged = reader.scalar<uint8_t>() != 0;
+    delta.somaPoints = reader.points();
+    delta.somaDiameters = reader.floats();
+
+    delta.baseSections = reader.vector<int32_t>();
+    delta.parents = reader.vector<int32_t>();
+    for (const auto type : reader.vector<int32_t>()) {
+        delta.types.push_back(static_cast<SectionType>(type));
+    }
+
+    delta.points = reader.points();
+    delta.diameters = reader.floats();
+    delta.perimeters = reader.floats();
+    delta.offsets = reader.vector<uint64_t>();
+    reader.end();
+    return delta;
+}
+
+void write(const MorphologyDelta& delta, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw WriterError("Delta: cannot open " + filename);
+    }
+    file << serialize(delta);
+    if (!file) {
+        throw WriterError("Delta: cannot write " + filename);
+    }
+}
+
+MorphologyDelta read(const std::string& filename) {
+    return deserialize(readFile(filename));
+}
+
+VariantCollection::VariantCollection(Collection bases,
+                                     const std::string& directory,
+                                     size_t cacheSize)
+    : VariantCollection(std::move(bases), std::make_shared<DirectorySource>(directory), cacheSize) {
+}
+
+VariantCollection::VariantCollection(Collection bases,
+                                     std::shared_ptr<ByteSource> deltas,
+                                     size_t cacheSize)
+    : _bases(std::move(bases))
+    , _deltas(std::move(deltas))
+    , _cacheSize(std::max<size_t>(cacheSize, 1)) {}
+
+Morphology VariantCollection::load(const std::string& name) const {
+    const auto delta = deserialize(_deltas->get(name).contents);
+    try {
+        return apply(base(delta.base), delta);
+    } catch (const RawDataError& e) {
+        throw RawDataError("Delta: cannot load " + name + ": " + e.what());
+    }
+}
+
+Morphology VariantCollection::base(const std::string& name) const {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = _cacheIndex.find(name);
+        if (it != _cacheIndex.end()) {
+            _cache.splice(_cache.begin(), _cache, it->second);
+            return it->second->second;
+        }
+    }
+
+    // parse outside of the lock, another thread may be doing the same
+    auto morphology = _bases.load<Morphology>(name);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_cacheIndex.find(name) == _cacheIndex.end()) {
+        _cache.emplace_front(name, morphology);
+        _cacheIndex[name] = _cache.begin();
+        if (_cache.size() > _cacheSize) {
+            _cacheIndex.erase(_cache.back().first);
+            _cache.pop_back();
+        }
+    }
+    return morphology;
+}
+
+}  // namespace delta
+}  // namespace morphio
@@ -7,14 +7,37 @@
 
 #include <morphio/dendritic_spine.h>
 
+namespace {
+void checkCellFamily(morphio::CellFamily cellFamily, const std::string& source) {
+    if (cellFamily != morphio::CellFamily::SPINE) {
+        throw(morphio::RawDataError(
+            source + " is not a DendriticSpine file. It should be a H5 file of type SPINE."));
+    }
+}
+}  // namespace
+
 namespace morphio {
 
-DendriticSpine::DendriticSpine(const std::string& source)
-    : Morphology(source) {
-    if (properties_->_cellLevel._cellFamily != CellFamily::SPINE) {
-        throw(RawDataError("File: " + source +
-                           " is not a DendriticSpine file. It should be a H5 file of type SPINE."));
-    }
+DendriticSpine::DendriticSpine(const std::string& source,
+                               unsigned int options,
+                               std::shared_ptr<WarningHandler> warning_handler)
+    : Morphology(source, options, std::move(warning_handler)) {
+    checkCellFamily(properties_->_cellLevel._cellFamily, "File: " + source);
+}
+
+DendriticSpine::DendriticSpine(const HighFive::Group& group,
+                               unsigned int options,
+                               std::shared_ptr<WarningHandler> warning_handler)
+    : Morphology(group, options, std::move(warning_handler)) {
+    checkCellFamily(properties_->_cellLevel._cellFamily, "Group: " + group.getPath());
+}
+
+DendriticSpine::DendriticSpine(const std::string& contents,
+                               const std::string& extension,
+                               unsigned int options,
+                               std::shared_ptr<WarningHandler> warning_handler)
+    : Morphology(contents, extension, options, std::move(warning_handler)) {
+    checkCellFamily(properties_->_cellLevel._cellFamily, "String");
 }
 
 const std::vector<Property::DendriticSpine::PostSynapticDensity>&
@@ -204,6 +204,20 @@ std::string ErrorMessages::ERROR_SOMA_INVALID_CONTOUR() const {
     return "Contour soma must have at least 3 points.";
 }
 
+std::string ErrorMessages::ERROR_STREAM_WRITER_ORDER(int parentId) const {
+    return "Cannot add a child to section " + std::to_string(parentId) +
+           ": sections must be added in depth-first order, the parent must be the last added "
+           "section or one of its ancestors.";
+}
+
+std::string ErrorMessages::ERROR_STREAM_WRITER_SOMA_AFTER_SECTIONS() const {
+    return "The soma must be set before adding sections.";
+}
+
+std::string ErrorMessages::ERROR_STREAM_WRITER_FINISHED() const {
+    return "The morphology has already been finished.";
+}
+
 // LCOV_EXCL_STOP }
 
 }  // namespace details
@@ -136,6 +136,15 @@ class ErrorMessages
 
     /** Contour soma must have at least 3 points. */
     std::string ERROR_SOMA_INVALID_CONTOUR() const;
+
+    /** Stream writer sections must be added in depth-first order */
+    std::string ERROR_STREAM_WRITER_ORDER(int parentId) const;
+
+    /** Stream writer soma must be set before the sections */
+    std::string ERROR_STREAM_WRITER_SOMA_AFTER_SECTIONS() const;
+
+    /** Stream writer can't be used after finish() */
+    std::string ERROR_STREAM_WRITER_FINISHED() const;
   private:
     std::string _uri;
 };
@@ -5,14 +5,37 @@
 #include <morphio/exceptions.h>  // for RawDataError
 #include <morphio/glial_cell.h>
 
+namespace {
+void checkCellFamily(morphio::CellFamily cellFamily, const std::string& source) {
+    if (cellFamily != morphio::CellFamily::GLIA) {
+        throw(morphio::RawDataError(
+            source + " is not a GlialCell file. It should be a H5 file the cell type GLIA."));
+    }
+}
+}  // namespace
+
 namespace morphio {
 
-GlialCell::GlialCell(const std::string& source)
-    : Morphology(source) {
-    if (properties_->_cellLevel._cellFamily != CellFamily::GLIA) {
-        throw(RawDataError("File: " + source +
-                           " is not a GlialCell file. It should be a H5 file the cell type GLIA."));
-    }
+GlialCell::GlialCell(const std::string& source,
+                     unsigned int options,
+                     std::shared_ptr<WarningHandler> warning_handler)
+    : Morphology(source, options, std::move(warning_handler)) {
+    checkCellFamily(properties_->_cellLevel._cellFamily, "File: " + source);
+}
+
+GlialCell::GlialCell(const HighFive::Group& group,
+                     unsigned int options,
+                     std::shared_ptr<WarningHandler> warning_handler)
+    : Morphology(group, options, std::move(warning_handler)) {
+    checkCellFamily(properties_->_cellLevel._cellFamily, "Group: " + group.getPath());
+}
+
+GlialCell::GlialCell(const std::string& contents,
+                     const std::string& extension,
+                     unsigned int options,
+                     std::shared_ptr<WarningHandler> warning_handler)
+    : Morphology(contents, extension, options, std::move(warning_handler)) {
+    checkCellFamily(properties_->_cellLevel._cellFamily, "String");
 }
 
 }  // namespace morphio
@@ -0,0 +1,208 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::sort
+#include <deque>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <utility>  // std::pair
+
+#include <morphio/collection.h>
+#include <morphio/exceptions.h>
+#include <morphio/layout.h>
+
+#include <highfive/H5File.hpp>
+
+#include "readers/morphologyHDF5.h"  // global_hdf5_mutex
+
+namespace morphio {
+namespace layout {
+
+std::vector<std::string> accessOrder(const std::vector<std::string>& morphology_names,
+                                     const std::vector<std::vector<std::string>>& traces) {
+    const size_t n = morphology_names.size();
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < n; ++i) {
+        index.emplace(morphology_names[i], i);
+    }
+
+    // when every morphology was first accessed, and how often pairs were accessed in a row
+    constexpr size_t never = size_t(-1);
+    std::vector<size_t> firstAccess(n, never);
+    std::map<std::pair<size_t, size_t>, size_t> coAccesses;
+    size_t time = 0;
+    for (const auto& trace : traces) {
+        size_t previous = never;
+        for (const auto& name : trace) {
+            const auto it = index.find(name);
+            if (it == index.end()) {
+                continue;
+            }
+            const size_t current = it->second;
+            firstAccess[current] = std::min(firstAccess[current], time++);
+            if (previous != never && previous != current) {
+                ++coAccesses[std::minmax(previous, current)];
+            }
+            previous = current;
+        }
+    }
+
+    // the most frequent pairs first, ties broken by first access
+    struct Pair {
+        size_t count;
+        size_t firstAccess;
+        size_t first;
+        size_t second;
+    };
+    std::vector<Pair> pairs;
+    pairs.reserve(coAccesses.size());
+    for (const auto& coAccess : coAccesses) {
+        const size_t first = coAccess.first.first;
+        const size_t second = coAccess.first.second;
+        pairs.push_back(
+            {coAccess.second, std::min(firstAccess[first], firstAccess[second]), first, second});
+    }
+    std::stable_sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) {
+        return std::make_tuple(b.count, a.firstAccess) < std::make_tuple(a.count, b.firstAccess);
+    });
+
+    // every accessed morphology starts in its own chain; a pair joins two chains when both
+    // morphologies are at an end of theirs, the smaller chain moving into the larger one
+    std::vector<std::deque<size_t>> chains(n);
+    std::vector<size_t> chainOf(n);
+    for (size_t i = 0; i < n; ++i) {
+        chainOf[i] = i;
+        if (firstAccess[i] != never) {
+            chains[i].push_back(i);
+        }
+    }
+
+    const auto atEnd = [&](size_t i) {
+        const auto& chain = chains[chainOf[i]];
+        return chain.front() == i || chain.back() == i;
+    };
+
+    for (const auto& pair : pairs) {
+        size_t first = pair.first;
+        size_t second = pair.second;
+        if (chainOf[first] == chainOf[second] || !atEnd(first) || !atEnd(second)) {
+            continue;
+        }
+        if (chains[chainOf[first]].size() < chains[chainOf[second]].size()) {
+            std::swap(first, second);
+        }
+
+        const size_t largeId = chainOf[first];
+        auto& large = chains[largeId];
+        auto& small = chains[chainOf[second]];
+        const bool smallForward = small.front() == second;
+        if (large.back() == first) {
+            // append `small`, starting from `second`
+            if (smallForward) {
+                for (auto it = small.begin(); it != small.end(); ++it) {
+                    large.push_back(*it);
+                    chainOf[*it] = largeId;
+                }
+            } else {
+                for (auto it = small.rbegin(); it != small.rend(); ++it) {
+                    large.push_back(*it);
+                    chainOf[*it] = largeId;
+                }
+            }
+        } else {
+            // prepend `small`, ending with `second`
+            if (smallForward) {
+                for (auto it = small.begin(); it != small.end(); ++it) {
+                    large.push_front(*it);
+                    chainOf[*it] = largeId;
+                }
+            } else {
+                for (auto it = small.rbegin(); it != small.rend(); ++it) {
+                    large.push_front(*it);
+                    chainOf[*it] = largeId;
+                }
+            }
+        }
+        small.clear();
+    }
+
+    // chains in the order they were first accessed, each read from its earlier end
+    std::vector<std::pair<size_t, size_t>> starts;  // (first access, chain)
+    for (size_t c = 0; c < n; ++c) {
+        if (chains[c].empty()) {
+            continue;
+        }
+        size_t first = never;
+        for (const size_t i : chains[c]) {
+            first = std::min(first, firstAccess[i]);
+        }
+        starts.emplace_back(first, c);
+    }
+    std::sort(starts.begin(), starts.end());
+
+    std::vector<std::string> order;
+    order.reserve(n);
+    for (const auto& start : starts) {
+        const auto& chain = chains[start.second];
+        if (firstAccess[chain.front()] <= firstAccess[chain.back()]) {
+            for (auto it = chain.begin(); it != chain.end(); ++it) {
+                order.push_back(morphology_names[*it]);
+            }
+        } else {
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                order.push_back(morphology_names[*it]);
+            }
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (firstAccess[i] == never) {
+            order.push_back(morphology_names[i]);
+        }
+    }
+    return order;
+}
+
+void reorderContainer(const std::string& input_path,
+                      const std::string& output_path,
+                      const std::vector<std::vector<std::string>>& traces) {
+    if (input_path == output_path) {
+        throw WriterError("Can not reorder the container " + input_path + " in place");
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(readers::h5::global_hdf5_mutex());
+    const HighFive::File input(input_path, HighFive::File::ReadOnly);
+    const auto names = input.listObjectNames();
+
+    // the morphologies absent from the traces keep their current relative order
+    std::vector<std::string> current;
+    {
+        const Collection collection(input_path);
+        const auto loop_indices = collection.argsort(names);
+        current.reserve(names.size());
+        for (const size_t i : loop_indices) {
+            current.push_back(names[i]);
+        }
+    }
+
+    // HDF5 allocates the datasets of a group when it is copied: the copies are laid out in the
+    // order they are made
+    HighFive::File output(output_path,
+                          HighFive::File::ReadWrite | HighFive::File::Create |
+                              HighFive::File::Truncate);
+    for (const auto& name : accessOrder(current, traces)) {
+        if (H5Ocopy(input.getId(),
+                    name.c_str(),
+                    output.getId(),
+                    name.c_str(),
+                    H5P_DEFAULT,
+                    H5P_DEFAULT) < 0) {
+            throw WriterError("Could not copy the morphology " + name + " to " + output_path);
+        }
+    }
+    output.flush();
+}
+
+}  // namespace layout
+}  // namespace morphio
@@ -0,0 +1,402 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::max
+#include <cmath>      // std::sqrt, std::cos, std::sin
+#include <cstring>    // std::memcpy
+#include <fstream>
+#include <limits>
+
+#include <morphio/mesh.h>
+
+#include "point_utils.h"  // cross, dot, normalized
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::cross;
+using morphio::dot;
+using morphio::normalized;
+using morphio::mesh::Mesh;
+using morphio::mesh::MeshOptions;
+
+using Vec = std::array<double, 3>;
+
+constexpr double PI = 3.14159265358979323846;
+
+Vec sub(const Vec& a, const Vec& b) {
+    return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+Vec add(const Vec& a, const Vec& b) {
+    return {a[0] + b[0], a[1] + b[1], a[2] + b[2]};
+}
+
+Vec scale(const Vec& a, double s) {
+    return {a[0] * s, a[1] * s, a[2] * s};
+}
+
+Vec toVec(const morphio::Point& point) {
+    return {point[0], point[1], point[2]};
+}
+
+/** A unit vector orthogonal to the unit vector `t` */
+Vec perpendicular(const Vec& t) {
+    Vec axis{0, 0, 0};
+    size_t smallest = 0;
+    for (size_t i = 1; i < 3; ++i) {
+        if (std::fabs(t[i]) < std::fabs(t[smallest])) {
+            smallest = i;
+        }
+    }
+    axis[smallest] = 1;
+    return normalized(cross(t, axis), Vec{0, 0, 0});
+}
+
+/** A circle of `resolution` vertices around `center`, in the plane spanned by `u` and `v` */
+struct Ring {
+    Vec center;
+    Vec u;
+    Vec v;
+    double radius;
+};
+
+/** Sizes of the mesh of one section, and where it goes in the output buffers */
+struct SectionMesh {
+    std::vector<size_t> points;
+    size_t nPrimitives = 0;
+    size_t ringsPerPrimitive = 0;
+    size_t firstVertex = 0;
+    size_t firstTriangle = 0;
+};
+
+size_t verticesPerPrimitive(const SectionMesh& section, unsigned int resolution) {
+    return section.ringsPerPrimitive * resolution + 2;
+}
+
+size_t trianglesPerPrimitive(const SectionMesh& section, unsigned int resolution) {
+    return 2 * section.ringsPerPrimitive * resolution;
+}
+
+/** Points of the section kept at the given stride, without consecutive duplicates */
+std::vector<size_t> selectPoints(const morphio::Points& points,
+                                 size_t begin,
+                                 size_t end,
+                                 uint32_t stride) {
+    std::vector<size_t> selected;
+    if (begin == end) {
+        return selected;
+    }
+    for (size_t i = begin;; i += stride) {
+        const size_t id = std::min(i, end - 1);
+        if (selected.empty() || points[selected.back()] != points[id]) {
+            selected.push_back(id);
+        }
+        if (id == end - 1) {
+            break;
+        }
+    }
+    return selected;
+}
+
+/**
+ * Write a closed primitive made of `rings`, closed by fans around `startCap` and `endCap`
+ *
+ * Rings must be ordered along the primitive, with u x v pointing towards the end cap.
+ */
+void emitPrimitive(const std::vector<Ring>& rings,
+                   const Vec& startCap,
+                   const Vec& endCap,
+                   unsigned int resolution,
+                   uint32_t sectionId,
+                   size_t firstVertex,
+                   size_t firstTriangle,
+                   Mesh& mesh) {
+    auto setVertex = [&mesh](size_t index, const Vec& position) {
+        mesh.vertices[index] = {static_cast<float>(position[0]),
+                                static_cast<float>(position[1]),
+                                static_cast<float>(position[2])};
+    };
+    size_t triangle = firstTriangle;
+    auto addTriangle = [&](size_t a, size_t b, size_t c) {
+        mesh.triangles[triangle] = {static_cast<uint32_t>(a),
+                                    static_cast<uint32_t>(b),
+                                    static_cast<uint32_t>(c)};
+        mesh.triangleSections[triangle] = sectionId;
+        ++triangle;
+    };
+
+    const size_t start = firstVertex;
+    const size_t end = firstVertex + 1 + rings.size() * resolution;
+    setVertex(start, startCap);
+    setVertex(end, endCap);
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+        const Ring& ring = rings[i];
+        for (unsigned int k = 0; k < resolution; ++k) {
+            const double angle = 2 * PI * k / resolution;
+            const Vec offset = add(scale(ring.u, ring.radius * std::cos(angle)),
+                                   scale(ring.v, ring.radius * std::sin(angle)));
+            setVertex(firstVertex + 1 + i * resolution + k, add(ring.center, offset));
+        }
+    }
+
+    auto vertex = [&](size_t ring, unsigned int k) {
+        return firstVertex + 1 + ring * resolution + k % resolution;
+    };
+    const size_t last = rings.size() - 1;
+    for (unsigned int k = 0; k < resolution; ++k) {
+        addTriangle(start, vertex(0, k + 1), vertex(0, k));
+        for (size_t i = 0; i < last; ++i) {
+            addTriangle(vertex(i, k), vertex(i, k + 1), vertex(i + 1, k + 1));
+            addTriangle(vertex(i, k), vertex(i + 1, k + 1), vertex(i + 1, k));
+        }
+        addTriangle(end, vertex(last, k), vertex(last, k + 1));
+    }
+}
+
+void emitTube(const morphio::Morphology& morphology,
+              const SectionMesh& section,
+              uint32_t sectionId,
+              unsigned int resolution,
+              Mesh& mesh) {
+    const auto& points = morphology.points();
+    const auto& diameters = morphology.diameters();
+    const auto& ids = section.points;
+
+    // Frames are transported along the section to avoid twisting the tube
+    std::vector<Ring> rings(ids.size());
+    const Vec zero{0, 0, 0};
+    Vec u = zero;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const Vec incoming =
+            i > 0 ? normalized(sub(toVec(points[ids[i]]), toVec(points[ids[i - 1]])), zero)
+                  : zero;
+        const Vec outgoing = i + 1 < ids.size()
+                                 ? normalized(sub(toVec(points[ids[i + 1]]), toVec(points[ids[i]])),
+                                              zero)
+                                 : zero;
+        Vec tangent = normalized(add(incoming, outgoing), zero);
+        if (dot(tangent, tangent) == 0) {  // the section folds back on itself
+            tangent = outgoing[0] != 0 || outgoing[1] != 0 || outgoing[2] != 0 ? outgoing
+                                                                                 : incoming;
+        }
+
+        u = normalized(sub(u, scale(tangent, dot(u, tangent))), zero);
+        if (dot(u, u) < 0.5) {
+            u = perpendicular(tangent);
+        }
+        rings[i] = {toVec(points[ids[i]]),
+                    u,
+                    cross(tangent, u),
+                    static_cast<double>(diameters[ids[i]]) / 2};
+    }
+
+    emitPrimitive(rings,
+                  rings.front().center,
+                  rings.back().center,
+                  resolution,
+                  sectionId,
+                  section.firstVertex,
+                  section.firstTriangle,
+                  mesh);
+}
+
+void emitSegments(const morphio::Morphology& morphology,
+                  const SectionMesh& section,
+                  uint32_t sectionId,
+                  unsigned int resolution,
+                  bool capsules,
+                  Mesh& mesh) {
+    const auto& points = morphology.points();
+    const auto& diameters = morphology.diameters();
+    const auto& ids = section.points;
+    const size_t nLatitudes = section.ringsPerPrimitive / 2;
+
+    std::vector<Ring> rings(section.ringsPerPrimitive);
+    for (size_t segment = 0; segment + 1 < ids.size(); ++segment) {
+        const Vec a = toVec(points[ids[segment]]);
+        const Vec b = toVec(points[ids[segment + 1]]);
+        const double radiusA = static_cast<double>(diameters[ids[segment]]) / 2;
+        const double radiusB = static_cast<double>(diameters[ids[segment + 1]]) / 2;
+        const Vec t = normalized(sub(b, a), Vec{0, 0, 0});
+        const Vec u = perpendicular(t);
+        const Vec v = cross(t, u);
+
+        Vec startCap = a;
+        Vec endCap = b;
+        if (capsules) {
+            // Half spheres: latitude rings from the pole of `a` to its equator, then from
+            // the equator of `b` to its pole
+            for (size_t j = 0; j < nLatitudes; ++j) {
+                const double angle = PI / 2 * static_cast<double>(j + 1) /
+                                     static_cast<double>(nLatitudes);
+                rings[j] = {sub(a, scale(t, radiusA * std::cos(angle))),
+                            u,
+                            v,
+                            radiusA * std::sin(angle)};
+                rings[2 * nLatitudes - 1 - j] = {add(b, scale(t, radiusB * std::cos(angle))),
+                                                 u,
+                                                 v,
+                                                 radiusB * std::sin(angle)};
+            }
+            startCap = sub(a, scale(t, radiusA));
+            endCap = add(b, scale(t, radiusB));
+        } else {
+            rings[0] = {a, u, v, radiusA};
+            rings[1] = {b, u, v, radiusB};
+        }
+
+        emitPrimitive(rings,
+                      startCap,
+                      endCap,
+                      resolution,
+                      sectionId,
+                      section.firstVertex + segment * verticesPerPrimitive(section, resolution),
+                      section.firstTriangle +
+                          segment * trianglesPerPrimitive(section, resolution),
+                      mesh);
+    }
+}
+
+std::ofstream openOutput(const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw morphio::WriterError("Cannot open mesh file for writing: " + filename);
+    }
+    return file;
+}
+
+void checkWritten(const std::ofstream& file, const std::string& filename) {
+    if (!file) {
+        throw morphio::WriterError("Failed to write mesh file: " + filename);
+    }
+}
+
+}  // namespace
+
+namespace morphio {
+namespace mesh {
+
+Mesh tessellate(const Morphology& morphology, const MeshOptions& options) {
+    const unsigned int level = std::min(options.levelOfDetail, 31U);
+    const unsigned int resolution = std::max(3U, options.resolution >> level);
+    const uint32_t stride = 1U << level;
+    const size_t nLatitudes = std::max(1U, resolution / 4);
+
+    const auto& points = morphology.points();
+    const std::vector<uint64_t> offsets = morphology.sectionOffsets();
+    const size_t nSections = morphology.sectionTypes().size();
+
+    // First pass: sizes of every section mesh, so that they can be written concurrently
+    std::vector<SectionMesh> sections(nSections);
+    size_t nVertices = 0;
+    size_t nTriangles = 0;
+    for (size_t id = 0; id < nSections; ++id) {
+        auto& section = sections[id];
+        section.points = selectPoints(points, offsets[id], offsets[id + 1], stride);
+        if (section.points.size() >= 2) {
+            switch (options.style) {
+            case TUBES:
+                section.nPrimitives = 1;
+                section.ringsPerPrimitive = section.points.size();
+                break;
+            case FRUSTUMS:
+                section.nPrimitives = section.points.size() - 1;
+                section.ringsPerPrimitive = 2;
+                break;
+            case CAPSULES:
+                section.nPrimitives = section.points.size() - 1;
+                section.ringsPerPrimitive = 2 * nLatitudes;
+                break;
+            }
+        }
+        section.firstVertex = nVertices;
+        section.firstTriangle = nTriangles;
+        nVertices += section.nPrimitives * verticesPerPrimitive(section, resolution);
+        nTriangles += section.nPrimitives * trianglesPerPrimitive(section, resolution);
+    }
+
+    Mesh mesh;
+    mesh.vertices.resize(nVertices);
+    mesh.triangles.resize(nTriangles);
+    mesh.triangleSections.resize(nTriangles);
+
+    details::parallelFor(
+        nSections,
+        [&](size_t id) {
+            const auto& section = sections[id];
+            if (section.nPrimitives == 0) {
+                return;
+            }
+            const auto sectionId = static_cast<uint32_t>(id);
+            if (options.style == TUBES) {
+                emitTube(morphology, section, sectionId, resolution, mesh);
+            } else {
+                emitSegments(morphology,
+                             section,
+                             sectionId,
+                             resolution,
+                             options.style == CAPSULES,
+                             mesh);
+            }
+        },
+        options.nThreads);
+
+    return mesh;
+}
+
+void writePLY(const Mesh& mesh, const std::string& filename) {
+    std::ofstream file = openOutput(filename);
+
+    const uint16_t endianness = 1;
+    unsigned char firstByte = 0;
+    std::memcpy(&firstByte, &endianness, 1);
+
+    file << "ply\n"
+         << "format " << (firstByte == 1 ? "binary_little_endian" : "binary_big_endian")
+         << " 1.0\n"
+         << "comment Generated by MorphIO\n"
+         << "element vertex " << mesh.vertices.size() << '\n'
+         << "property float x\n"
+         << "property float y\n"
+         << "property float z\n"
+         << "element face " << mesh.triangles.size() << '\n'
+         << "property list uchar uint vertex_indices\n"
+         << "end_header\n";
+
+    file.write(reinterpret_cast<const char*>(mesh.vertices.data()),
+               static_cast<std::streamsize>(mesh.vertices.size() * sizeof(mesh.vertices[0])));
+
+    // Each face is a one byte vertex count followed by the indices
+    constexpr size_t faceSize = 1 + 3 * sizeof(uint32_t);
+    std::vector<char> faces(mesh.triangles.size() * faceSize);
+    for (size_t i = 0; i < mesh.triangles.size(); ++i) {
+        faces[i * faceSize] = 3;
+        std::memcpy(&faces[i * faceSize + 1], mesh.triangles[i].data(), 3 * sizeof(uint32_t));
+    }
+    file.write(faces.data(), static_cast<std::streamsize>(faces.size()));
+
+    checkWritten(file, filename);
+}
+
+void writeOBJ(const Mesh& mesh, const std::string& filename) {
+    std::ofstream file = openOutput(filename);
+
+    file.precision(std::numeric_limits<float>::max_digits10);
+    file << "# Generated by MorphIO\n";
+    for (const auto& vertex : mesh.vertices) {
+        file << "v " << vertex[0] << ' ' << vertex[1] << ' ' << vertex[2] << '\n';
+    }
+    // OBJ indices start at 1
+    for (const auto& triangle : mesh.triangles) {
+        file << "f " << triangle[0] + 1 << ' ' << triangle[1] + 1 << ' ' << triangle[2] + 1
+             << '\n';
+    }
+
+    checkWritten(file, filename);
+}
+
+}  // namespace mesh
+}  // namespace morphio
@@ -33,4 +33,35 @@ std::vector<MitoSection> Mitochondria::rootSections() const {
     return result;
 }
 
+const std::vector<uint32_t>& Mitochondria::neuriteSectionIds() const noexcept {
+    return properties_->get<Property::MitoNeuriteSectionId>();
+}
+
+const std::vector<floatType>& Mitochondria::relativePathLengths() const noexcept {
+    return properties_->get<Property::MitoPathLength>();
+}
+
+const std::vector<floatType>& Mitochondria::diameters() const noexcept {
+    return properties_->get<Property::MitoDiameter>();
+}
+
+std::vector<uint64_t> Mitochondria::sectionOffsets() const {
+    const auto& sections = properties_->get<Property::MitoSection>();
+    std::vector<uint64_t> offsets(sections.size() + 1);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        offsets[i] = static_cast<uint64_t>(sections[i][0]);
+    }
+    offsets.back() = diameters().size();
+    return offsets;
+}
+
+std::vector<int32_t> Mitochondria::sectionParents() const {
+    const auto& sections = properties_->get<Property::MitoSection>();
+    std::vector<int32_t> parents(sections.size());
+    for (size_t i = 0; i < sections.size(); ++i) {
+        parents[i] = static_cast<int32_t>(sections[i][1]);
+    }
+    return parents;
+}
+
 }  // namespace morphio
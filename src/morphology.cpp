@@ -41,7 +41,7 @@ void buildChildren(const std::shared_ptr<morphio::Property::Properties>& propert
         auto& children = properties->_sectionLevel._children;
 
         for (unsigned int i = 0; i < sections.size(); ++i) {
-            const int32_t parent = sections[i][1];
+            const auto parent = static_cast<int32_t>(sections[i][1]);
             children[parent].push_back(i);
         }
     }
@@ -51,7 +51,7 @@ void buildChildren(const std::shared_ptr<morphio::Property::Properties>& propert
         auto& children = properties->_mitochondriaSectionLevel._children;
 
         for (unsigned int i = 0; i < sections.size(); ++i) {
-            const int32_t parent = sections[i][1];
+            const auto parent = static_cast<int32_t>(sections[i][1]);
             children[parent].push_back(i);
         }
     }
@@ -104,7 +104,9 @@ morphio::Property::Properties loadString(const std::string& contents,
         warning_handler = morphio::getWarningHandler();
     }
 
-    if (lower_extension == "asc") {
+    if (lower_extension == "h5") {
+        return morphio::readers::h5::loadFileImage(contents, warning_handler.get());
+    } else if (lower_extension == "asc") {
         return morphio::readers::asc::load("$STRING$", contents, options, warning_handler.get());
     } else if (lower_extension == "swc") {
         return morphio::readers::swc::load("$STRING$", contents, options, warning_handler);
@@ -215,15 +217,17 @@ const Points& Morphology::points() const noexcept {
     return get<Property::Point>();
 }
 
-std::vector<uint32_t> Morphology::sectionOffsets() const {
+std::vector<uint64_t> Morphology::sectionOffsets() const {
     const std::vector<Property::Section::Type>& indices_and_parents = get<Property::Section>();
     auto size = indices_and_parents.size();
-    std::vector<uint32_t> indices(size + 1);
+    std::vector<uint64_t> indices(size + 1);
     std::transform(indices_and_parents.begin(),
                    indices_and_parents.end(),
                    indices.begin(),
-                   [](const Property::Section::Type& pair) { return pair[0]; });
-    indices[size] = static_cast<uint32_t>(points().size());
+                   [](const Property::Section::Type& pair) {
+                       return static_cast<uint64_t>(pair[0]);
+                   });
+    indices[size] = points().size();
     return indices;
 }
 
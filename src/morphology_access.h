@@ -0,0 +1,40 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <memory>  // std::shared_ptr
+
+#include <morphio/enums.h>
+#include <morphio/morphology.h>
+#include <morphio/properties.h>
+
+namespace morphio {
+namespace details {
+
+/**
+ * Access to the data of a Morphology, for the algorithms building a morphology from another one
+ * without going through a mut::Morphology
+ */
+class MorphologyAccess
+{
+  public:
+    static const Property::Properties& properties(const Morphology& morphology) noexcept {
+        return *morphology.properties_;
+    }
+
+    /** The data of `morphology`, shared by all its copies: its address identifies it */
+    static const std::shared_ptr<Property::Properties>& sharedProperties(
+        const Morphology& morphology) noexcept {
+        return morphology.properties_;
+    }
+
+    /** A morphology with a copy of `properties`, with no modifier applied */
+    static Morphology fromProperties(const Property::Properties& properties) {
+        return Morphology(properties, NO_MODIFIER);
+    }
+};
+
+}  // namespace details
+}  // namespace morphio
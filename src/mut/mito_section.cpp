@@ -31,27 +31,18 @@ MitoSection::MitoSection(Mitochondria* mitochondria,
 
 std::shared_ptr<MitoSection> MitoSection::appendSection(
     const Property::MitochondriaPointLevel& points) {
-    unsigned int parentId = id();
-
     std::shared_ptr<MitoSection> ptr(
-        new MitoSection(mitochondria_, mitochondria_->_counter, points));
-
-    uint32_t childId = mitochondria_->_register(ptr);
+        new MitoSection(mitochondria_, mitochondria_->_nextId(), points));
 
-    mitochondria_->parent_[childId] = parentId;
-    mitochondria_->children_[parentId].push_back(ptr);
+    mitochondria_->_register(ptr, static_cast<int32_t>(id()));
     return ptr;
 }
 
 std::shared_ptr<MitoSection> MitoSection::appendSection(
     const std::shared_ptr<MitoSection>& original_section, bool recursive) {
     std::shared_ptr<MitoSection> ptr(
-        new MitoSection(mitochondria_, mitochondria_->_counter, *original_section));
-    unsigned int parentId = id();
-    uint32_t section_id = mitochondria_->_register(ptr);
-
-    mitochondria_->parent_[section_id] = parentId;
-    mitochondria_->children_[parentId].push_back(ptr);
+        new MitoSection(mitochondria_, mitochondria_->_nextId(), *original_section));
+    mitochondria_->_register(ptr, static_cast<int32_t>(id()));
 
     if (recursive) {
         for (const auto& child : original_section->children()) {
@@ -65,12 +56,8 @@ std::shared_ptr<MitoSection> MitoSection::appendSection(
 std::shared_ptr<MitoSection> MitoSection::appendSection(const morphio::MitoSection& section,
                                                         bool recursive) {
     std::shared_ptr<MitoSection> ptr(
-        new MitoSection(mitochondria_, mitochondria_->_counter, section));
-    unsigned int parentId = id();
-    uint32_t childId = mitochondria_->_register(ptr);
-
-    mitochondria_->parent_[childId] = parentId;
-    mitochondria_->children_[parentId].push_back(ptr);
+        new MitoSection(mitochondria_, mitochondria_->_nextId(), section));
+    mitochondria_->_register(ptr, static_cast<int32_t>(id()));
 
     if (recursive) {
         for (const auto& child : section.children()) {
@@ -82,11 +69,13 @@ std::shared_ptr<MitoSection> MitoSection::appendSection(const morphio::MitoSecti
 }
 
 std::shared_ptr<MitoSection> MitoSection::parent() const {
-    return mitochondria_->sections_.at(mitochondria_->parent_.at(id()));
+    // the parent of a root section is -1: out of range
+    return mitochondria_->sections_.at(static_cast<uint32_t>(mitochondria_->parent_.at(id())));
 }
 
 bool MitoSection::isRoot() const {
-    return mitochondria_->parent_.count(id()) == 0;
+    const auto& parents = mitochondria_->parent_;
+    return id() >= parents.size() || parents[id()] < 0;
 }
 
 bool MitoSection::hasSameShape(const MitoSection& other) const noexcept {
@@ -96,12 +85,11 @@ bool MitoSection::hasSameShape(const MitoSection& other) const noexcept {
 
 const std::vector<std::shared_ptr<MitoSection>>& MitoSection::children() const {
     const auto& children = mitochondria_->children_;
-    const auto it = children.find(id());
-    if (it == children.end()) {
+    if (id() >= children.size()) {
         static std::vector<std::shared_ptr<MitoSection>> empty;
         return empty;
     }
-    return it->second;
+    return children[id()];
 }
 
 }  // namespace mut
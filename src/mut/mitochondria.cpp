@@ -2,8 +2,6 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include <queue>  // std::queue
-
 #include <morphio/mut/mitochondria.h>
 
 
@@ -14,9 +12,8 @@ namespace mut {
 
 Mitochondria::MitoSectionP Mitochondria::appendRootSection(const morphio::MitoSection& section_,
                                                            bool recursive) {
-    auto ptr = std::make_shared<MitoSection>(this, _counter, section_);
+    auto ptr = std::make_shared<MitoSection>(this, _nextId(), section_);
     _register(ptr);
-    root_sections_.push_back(ptr);
 
     if (recursive) {
         for (const auto& child : section_.children()) {
@@ -29,9 +26,8 @@ Mitochondria::MitoSectionP Mitochondria::appendRootSection(const morphio::MitoSe
 
 Mitochondria::MitoSectionP Mitochondria::appendRootSection(const MitoSectionP& section_,
                                                            bool recursive) {
-    auto section_copy = std::make_shared<MitoSection>(this, _counter, *section_);
+    auto section_copy = std::make_shared<MitoSection>(this, _nextId(), *section_);
     _register(section_copy);
-    root_sections_.push_back(section_copy);
 
     if (recursive) {
         for (const auto& child : section_->children()) {
@@ -44,37 +40,97 @@ Mitochondria::MitoSectionP Mitochondria::appendRootSection(const MitoSectionP& s
 
 Mitochondria::MitoSectionP Mitochondria::appendRootSection(
     const Property::MitochondriaPointLevel& pointProperties) {
-    auto ptr = std::make_shared<MitoSection>(this, _counter, pointProperties);
+    auto ptr = std::make_shared<MitoSection>(this, _nextId(), pointProperties);
     _register(ptr);
-    root_sections_.push_back(ptr);
 
     return ptr;
 }
 
-static void _appendMitoProperties(Property::MitochondriaPointLevel& to,
-                                  const Property::MitochondriaPointLevel& from,
-                                  int offset = 0) {
-    _appendVector(to._sectionIds, from._sectionIds, offset);
-    _appendVector(to._relativePathLengths, from._relativePathLengths, offset);
-    _appendVector(to._diameters, from._diameters, offset);
+std::vector<Mitochondria::MitoSectionP> Mitochondria::appendSections(
+    const std::vector<Property::MitoSection::Type>& sections,
+    const Property::MitochondriaPointLevel& points) {
+    const size_t firstId = sections_.size();
+    const size_t nPoints = points._diameters.size();
+    const auto nSections = static_cast<int64_t>(sections.size());
+
+    // Everything is checked before the first section is appended, so that a failure leaves
+    // the mitochondria as they were
+    std::vector<std::vector<size_t>> children(sections.size());
+    std::vector<size_t> reached;
+    reached.reserve(sections.size());
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const size_t end = i + 1 < sections.size() ? static_cast<size_t>(sections[i + 1][0])
+                                                   : nPoints;
+        if (sections[i][0] < 0 || end < static_cast<size_t>(sections[i][0]) || end > nPoints) {
+            throw SectionBuilderError("Invalid offset for mitochondrial section " +
+                                      std::to_string(i));
+        }
+
+        const int64_t parent = sections[i][1];
+        if (parent < -1 || parent >= nSections || parent == static_cast<int64_t>(i)) {
+            throw SectionBuilderError("Invalid parent for mitochondrial section " +
+                                      std::to_string(i));
+        }
+        if (parent == -1) {
+            reached.push_back(i);
+        } else {
+            children[static_cast<size_t>(parent)].push_back(i);
+        }
+    }
+    // The sections of a parent cycle cannot be reached from any root
+    for (size_t head = 0; head < reached.size(); ++head) {
+        const auto& next = children[reached[head]];
+        reached.insert(reached.end(), next.begin(), next.end());
+    }
+    if (reached.size() != sections.size()) {
+        throw SectionBuilderError("Mitochondrial sections with a cycle of parents");
+    }
+
+    sections_.reserve(firstId + sections.size());
+    parent_.reserve(firstId + sections.size());
+    children_.resize(firstId + sections.size());
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const auto start = static_cast<size_t>(sections[i][0]);
+        const size_t end = i + 1 < sections.size() ? static_cast<size_t>(sections[i + 1][0])
+                                                   : nPoints;
+        const auto parent = static_cast<int32_t>(sections[i][1]);
+
+        sections_.push_back(std::make_shared<MitoSection>(
+            this, _nextId(), Property::MitochondriaPointLevel(points, {start, end})));
+        parent_.push_back(parent < 0 ? -1 : static_cast<int32_t>(firstId) + parent);
+    }
+
+    // Linked once all sections exist, so that children may come before their parent
+    std::vector<MitoSectionP> roots;
+    for (size_t id = firstId; id < sections_.size(); ++id) {
+        if (parent_[id] < 0) {
+            roots.push_back(sections_[id]);
+        } else {
+            children_[static_cast<size_t>(parent_[id])].push_back(sections_[id]);
+        }
+    }
+    root_sections_.insert(root_sections_.end(), roots.begin(), roots.end());
+
+    return roots;
 }
 
 const std::vector<Mitochondria::MitoSectionP>& Mitochondria::children(
     const MitoSectionP& section_) const {
-    const auto it = children_.find(section_->id());
-    if (it == children_.end()) {
+    if (section_->id() >= children_.size()) {
         static std::vector<Mitochondria::MitoSectionP> empty;
         return empty;
     }
-    return it->second;
+    return children_[section_->id()];
 }
 
 const Mitochondria::MitoSectionP& Mitochondria::parent(const MitoSectionP& parent) const {
-    return section(parent_.at(parent->id()));
+    // the parent of a root section is -1: out of range
+    return section(static_cast<uint32_t>(parent_.at(parent->id())));
 }
 
 bool Mitochondria::isRoot(const MitoSectionP& section_) const {
-    return parent_.count(section_->id()) == 0;
+    return section_->id() >= parent_.size() || parent_[section_->id()] < 0;
 }
 
 const Mitochondria::MitoSectionP& Mitochondria::section(uint32_t id) const {
@@ -82,26 +138,42 @@ const Mitochondria::MitoSectionP& Mitochondria::section(uint32_t id) const {
 }
 
 void Mitochondria::_buildMitochondria(Property::Properties& properties) const {
+    auto& sectionLevel = properties._mitochondriaSectionLevel._sections;
+    auto& pointLevel = properties._mitochondriaPointLevel;
+
+    size_t nPoints = pointLevel._diameters.size();
+    for (const auto& section_ : sections_) {
+        nPoints += section_->diameters().size();
+    }
+    sectionLevel.reserve(sectionLevel.size() + sections_.size());
+    pointLevel._sectionIds.reserve(nPoints);
+    pointLevel._relativePathLengths.reserve(nPoints);
+    pointLevel._diameters.reserve(nPoints);
+
+    // Sections are written breadth first, one mitochondrion after the other
     int32_t counter = 0;
-    std::map<uint32_t, int32_t> newIds;
+    std::vector<int32_t> newIds(sections_.size(), -1);
+    std::vector<uint32_t> queue;
+    queue.reserve(sections_.size());
 
     for (const std::shared_ptr<MitoSection>& mitoStart : root_sections_) {
-        std::queue<std::shared_ptr<MitoSection>> q;
-        q.push(mitoStart);
-        while (!q.empty()) {
-            std::shared_ptr<MitoSection> section_ = q.front();
-            q.pop();
-            int32_t parentOnDisk = isRoot(section_) ? -1 : newIds[parent(section_)->id()];
-
-            properties._mitochondriaSectionLevel._sections.push_back(
-                {static_cast<int>(properties._mitochondriaPointLevel._diameters.size()),
-                 parentOnDisk});
-            _appendMitoProperties(properties._mitochondriaPointLevel, section_->_mitoPoints);
-
-            newIds[section_->id()] = counter++;
-
-            for (const auto& child : children(section_)) {
-                q.push(child);
+        queue.clear();
+        queue.push_back(mitoStart->id());
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const uint32_t id = queue[head];
+            const auto& points = sections_[id]->_mitoPoints;
+            const int32_t parentOnDisk = parent_[id] < 0 ? -1 : newIds[static_cast<size_t>(parent_[id])];
+
+            sectionLevel.push_back(
+                {static_cast<int64_t>(pointLevel._diameters.size()), parentOnDisk});
+            _appendVector(pointLevel._sectionIds, points._sectionIds, 0);
+            _appendVector(pointLevel._relativePathLengths, points._relativePathLengths, 0);
+            _appendVector(pointLevel._diameters, points._diameters, 0);
+
+            newIds[id] = counter++;
+
+            for (const auto& child : children_[id]) {
+                queue.push_back(child->id());
             }
         }
     }
@@ -135,13 +207,21 @@ mito_upstream_iterator Mitochondria::upstream_end() const {
     return mito_upstream_iterator();
 }
 
-uint32_t Mitochondria::_register(const MitoSectionP& section) {
-    if (sections_.count(section->id()) > 0) {
+uint32_t Mitochondria::_register(const MitoSectionP& section, int32_t parentId) {
+    if (section->id() != _nextId()) {
         throw SectionBuilderError("Section already exists");
     }
-    _counter = std::max(_counter, section->id()) + 1;
 
-    sections_[section->id()] = section;
+    sections_.push_back(section);
+    parent_.push_back(parentId);
+    children_.emplace_back();
+
+    if (parentId < 0) {
+        root_sections_.push_back(section);
+    } else {
+        children_[static_cast<size_t>(parentId)].push_back(section);
+    }
+
     return section->id();
 }
 
@@ -3,7 +3,6 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <algorithm>  // std::find_if
-#include <cctype>     // std::tolower
 #include <memory>
 #include <string>
 
@@ -17,6 +16,7 @@
 
 #include "../error_message_generation.h"
 #include "../shared_utils.hpp"
+#include "writer_utils.h"
 
 namespace {
 using SectionP = std::shared_ptr<morphio::mut::Section>;
@@ -91,9 +91,9 @@ Morphology::Morphology(const morphio::Morphology& morphology,
         appendRootSection(root, true);
     }
 
-    for (const morphio::MitoSection& root : morphology.mitochondria().rootSections()) {
-        mitochondria().appendRootSection(root, true);
-    }
+    const auto& properties = *morphology.properties_;
+    mitochondria().appendSections(properties._mitochondriaSectionLevel._sections,
+                                  properties._mitochondriaPointLevel);
 
     applyModifiers(options);
 }
@@ -312,7 +312,7 @@ Property::Properties Morphology::buildReadOnly() const {
         unsigned int sectionId = section->id();
         int parentOnDisk = (section->isRoot() ? -1 : newIds[section->parent()->id()]);
 
-        auto start = static_cast<int>(properties._pointLevel._points.size());
+        auto start = static_cast<int64_t>(properties._pointLevel._points.size());
         properties._sectionLevel._sections.push_back({start, parentOnDisk});
         properties._sectionLevel._sectionTypes.push_back(section->type());
         newIds[sectionId] = sectionIdOnDisk++;
@@ -395,16 +395,7 @@ void Morphology::write(const std::string& filename) const {
         }
     }
 
-    const size_t pos = filename.find_last_of('.');
-    if (pos == std::string::npos) {
-        throw UnknownFileType("Missing file extension.");
-    }
-
-    std::string extension;
-    for (char c : filename.substr(pos)) {
-        extension += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-    }
-
+    const std::string extension = writer::details::fileExtension(filename);
     if (extension == ".h5") {
         writer::h5(*this, filename, _handler);
     } else if (extension == ".asc") {
@@ -0,0 +1,137 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <morphio/mut/soma.h>
+#include <morphio/mut/stream_writer.h>
+
+#include "../error_message_generation.h"
+#include "writer_utils.h"
+
+namespace morphio {
+namespace mut {
+namespace writer {
+
+using morphio::details::ErrorMessages;
+
+StreamWriter::StreamWriter(const std::string& filename,
+                           std::shared_ptr<WarningHandler> warning_handler,
+                           CellFamily cellFamily)
+    : _filename(filename)
+    , _handler(warning_handler ? warning_handler : morphio::getWarningHandler()) {
+    const std::string extension = details::fileExtension(filename);
+    if (extension == ".h5") {
+        _backend = details::h5Stream(filename, _handler, cellFamily);
+    } else if (extension == ".asc") {
+        _backend = details::ascStream(filename, _handler);
+    } else if (extension == ".swc") {
+        _backend = details::swcStream(filename, _handler);
+    } else {
+        throw UnknownFileType(ErrorMessages().ERROR_WRONG_EXTENSION(filename));
+    }
+}
+
+StreamWriter::~StreamWriter() = default;
+
+void StreamWriter::beginSoma(SomaType type,
+                             const Points& points,
+                             const std::vector<floatType>& diameters) {
+    if (_finished) {
+        throw WriterError(ErrorMessages().ERROR_STREAM_WRITER_FINISHED());
+    }
+    if (_begun) {
+        throw WriterError(ErrorMessages().ERROR_STREAM_WRITER_SOMA_AFTER_SECTIONS());
+    }
+    _somaType = type;
+    _somaPoints = points;
+    _somaDiameters = diameters;
+}
+
+uint32_t StreamWriter::addSection(SectionType type,
+                                  int parent,
+                                  const Points& points,
+                                  const std::vector<floatType>& diameters,
+                                  const std::vector<floatType>& perimeters) {
+    if (_finished) {
+        throw WriterError(ErrorMessages().ERROR_STREAM_WRITER_FINISHED());
+    }
+    if (points.size() != diameters.size()) {
+        throw WriterError(ErrorMessages().ERROR_VECTOR_LENGTH_MISMATCH(
+            "points", points.size(), "diameters", diameters.size()));
+    }
+    if (parent < 0 && points.size() < 2) {
+        throw morphio::SectionBuilderError("Root sections must have at least 2 points");
+    }
+    if (points.empty()) {
+        throw morphio::SectionBuilderError("Sections must have at least 1 point");
+    }
+
+    if (parent >= 0) {
+        bool isOpen = false;
+        for (const auto& section : _openSections) {
+            isOpen = isOpen || static_cast<int>(section.id) == parent;
+        }
+        if (!isOpen) {
+            throw WriterError(ErrorMessages().ERROR_STREAM_WRITER_ORDER(parent));
+        }
+    }
+    closeSectionsAbove(parent);
+
+    if (!_begun) {
+        begin(true);
+    }
+
+    const details::StreamSection* parentSection = _openSections.empty() ? nullptr
+                                                                        : &_openSections.back();
+    const details::StreamSection section{_sectionCount,
+                                         parent < 0 ? -1 : parent,
+                                         type,
+                                         parentSection ? parentSection->depth + 1 : 0,
+                                         0,
+                                         diameters.back()};
+    _backend->openSection(section, parentSection, points, diameters, perimeters);
+
+    if (parentSection) {
+        ++_openSections.back().childCount;
+    }
+    _openSections.push_back(section);
+    return _sectionCount++;
+}
+
+void StreamWriter::finish() {
+    if (_finished) {
+        throw WriterError(ErrorMessages().ERROR_STREAM_WRITER_FINISHED());
+    }
+    closeSectionsAbove(-1);
+    _finished = true;
+
+    if (!_begun) {
+        if (_somaPoints.empty()) {
+            _handler->emit(std::make_shared<morphio::WriteEmptyMorphology>());
+            return;
+        }
+        begin(false);
+    }
+    _backend->finish();
+}
+
+void StreamWriter::begin(bool hasSections) {
+    Soma soma;
+    soma.type() = _somaType;
+    soma.points() = std::move(_somaPoints);
+    soma.diameters() = std::move(_somaDiameters);
+
+    _begun = true;
+    _backend->begin(soma, hasSections);
+}
+
+void StreamWriter::closeSectionsAbove(int parent) {
+    while (!_openSections.empty() && static_cast<int>(_openSections.back().id) != parent) {
+        _backend->closeSection(_openSections.back());
+        _openSections.pop_back();
+    }
+}
+
+}  // namespace writer
+}  // end namespace mut
+}  // end namespace morphio
@@ -0,0 +1,111 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::max
+
+#include <morphio/exceptions.h>
+#include <morphio/mut/write_queue.h>
+
+#include "../readers/morphologyHDF5.h"  // global_hdf5_mutex
+#include "../thread_utils.hpp"
+#include "writer_utils.h"
+
+namespace morphio {
+namespace mut {
+
+WriteQueue::WriteQueue(unsigned int nThreads, size_t capacity)
+    : _capacity(std::max<size_t>(capacity, 1)) {
+    const unsigned int count = details::threadCount(nThreads, _capacity);
+    _threads.reserve(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        _threads.emplace_back([this]() { work(); });
+    }
+}
+
+WriteQueue::~WriteQueue() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _taskAdded.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void WriteQueue::push(std::unique_ptr<Morphology> morphology, const std::string& filename) {
+    if (!morphology) {
+        throw WriterError("Cannot write a null morphology to " + filename);
+    }
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _taskDone.wait(lock, [this]() { return _tasks.size() + _running < _capacity; });
+        _tasks.emplace_back(std::move(morphology), filename);
+    }
+    _taskAdded.notify_one();
+}
+
+void WriteQueue::flush() {
+    std::vector<std::string> errors;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _taskDone.wait(lock, [this]() { return _tasks.empty() && _running == 0; });
+        errors.swap(_errors);
+    }
+    if (errors.empty()) {
+        return;
+    }
+    std::string message = std::to_string(errors.size()) + " morphologies could not be written:";
+    for (const auto& error : errors) {
+        message += "\n" + error;
+    }
+    throw WriterError(message);
+}
+
+size_t WriteQueue::pending() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _tasks.size() + _running;
+}
+
+void WriteQueue::work() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _taskAdded.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+            if (_tasks.empty()) {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+            ++_running;
+        }
+
+        std::string error;
+        try {
+            if (writer::details::fileExtension(task.second) == ".h5") {
+                std::lock_guard<std::recursive_mutex> lock(readers::h5::global_hdf5_mutex());
+                task.first->write(task.second);
+            } else {
+                task.first->write(task.second);
+            }
+        } catch (const std::exception& e) {
+            error = task.second + ": " + e.what();
+        }
+        // free the morphology before making room for another one
+        task.first.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_running;
+            if (!error.empty()) {
+                _errors.push_back(error);
+            }
+        }
+        _taskDone.notify_all();
+    }
+}
+
+}  // namespace mut
+}  // namespace morphio
@@ -44,12 +44,100 @@ void write_asc_section(std::ofstream& myfile,
         myfile << indent << ")\n";
     }
 }
+
+void write_asc_soma(std::ofstream& myfile, const morphio::mut::Soma& soma) {
+    if (!soma.points().empty()) {
+        myfile << "(\"CellBody\"\n  (Color Red)\n  (CellBody)\n";
+        write_asc_points(myfile, soma.points(), soma.diameters(), 2);
+        myfile << ")\n\n";
+    }
+}
+
+void write_asc_neurite_header(std::ofstream& myfile, morphio::SectionType type) {
+    using namespace morphio::enums;
+    if (type == SECTION_AXON) {
+        myfile << "( (Color Cyan)\n  (Axon)\n";
+    } else if (type == SECTION_DENDRITE) {
+        myfile << "( (Color Red)\n  (Dendrite)\n";
+    } else if (type == SECTION_APICAL_DENDRITE) {
+        myfile << "( (Color Red)\n  (Apical)\n";
+    } else {
+        throw morphio::WriterError(
+            morphio::details::ErrorMessages().ERROR_UNSUPPORTED_SECTION_TYPE(type));
+    }
+}
+
+/** ASC part of the StreamWriter, it follows the same rules as writer::asc */
+class ASCStreamBackend: public morphio::mut::writer::details::StreamBackend
+{
+  public:
+    ASCStreamBackend(const std::string& filename, std::shared_ptr<morphio::WarningHandler> handler)
+        : _filename(filename)
+        , _handler(std::move(handler)) {}
+
+    void begin(const morphio::mut::Soma& soma, bool /*hasSections*/) override {
+        morphio::mut::writer::details::validateContourSoma(soma, _handler);
+        morphio::mut::writer::details::checkSomaHasSameNumberPointsDiameters(soma);
+
+        _file.open(_filename);
+        write_asc_soma(_file, soma);
+    }
+
+    void openSection(const morphio::mut::writer::details::StreamSection& section,
+                     const morphio::mut::writer::details::StreamSection* parent,
+                     const morphio::Points& points,
+                     const std::vector<morphio::floatType>& diameters,
+                     const std::vector<morphio::floatType>& perimeters) override {
+        if (!perimeters.empty()) {
+            throw morphio::WriterError(
+                morphio::details::ErrorMessages().ERROR_PERIMETER_DATA_NOT_WRITABLE());
+        }
+
+        if (parent == nullptr) {
+            write_asc_neurite_header(_file, section.type);
+        } else {
+            _file << indent(*parent) << (parent->childCount == 0 ? "(\n" : "|\n");
+        }
+        write_asc_points(_file, points, diameters, indent(section).size());
+    }
+
+    void closeSection(const morphio::mut::writer::details::StreamSection& section) override {
+        if (section.childCount > 0) {
+            _file << indent(section) << ")\n";
+        }
+        if (section.depth == 0) {
+            _file << ")\n\n";
+        }
+    }
+
+    void finish() override {
+        _file << "; " << morphio::mut::writer::details::version_string() << '\n';
+        _file.close();
+    }
+
+  private:
+    static std::string indent(const morphio::mut::writer::details::StreamSection& section) {
+        return std::string(2 * (section.depth + 1), ' ');
+    }
+
+    std::string _filename;
+    std::shared_ptr<morphio::WarningHandler> _handler;
+    std::ofstream _file;
+};
+
 }  // namespace
 
 namespace morphio {
 namespace mut {
 namespace writer {
 
+namespace details {
+std::unique_ptr<StreamBackend> ascStream(const std::string& filename,
+                                         std::shared_ptr<morphio::WarningHandler> handler) {
+    return std::unique_ptr<StreamBackend>(new ASCStreamBackend(filename, std::move(handler)));
+}
+}  // namespace details
+
 void asc(const Morphology& morph,
          const std::string& filename,
          std::shared_ptr<morphio::WarningHandler> handler) {
@@ -64,24 +152,10 @@ void asc(const Morphology& morph,
 
     std::ofstream myfile(filename);
 
-    const std::shared_ptr<Soma>& soma = morph.soma();
-    if (!soma->points().empty()) {
-        myfile << "(\"CellBody\"\n  (Color Red)\n  (CellBody)\n";
-        write_asc_points(myfile, soma->points(), soma->diameters(), 2);
-        myfile << ")\n\n";
-    }
+    write_asc_soma(myfile, *morph.soma());
 
     for (const std::shared_ptr<Section>& section : morph.rootSections()) {
-        const auto type = section->type();
-        if (type == SECTION_AXON) {
-            myfile << "( (Color Cyan)\n  (Axon)\n";
-        } else if (type == SECTION_DENDRITE) {
-            myfile << "( (Color Red)\n  (Dendrite)\n";
-        } else if (type == SECTION_APICAL_DENDRITE) {
-            myfile << "( (Color Red)\n  (Apical)\n";
-        } else {
-            throw WriterError(morphio::details::ErrorMessages().ERROR_UNSUPPORTED_SECTION_TYPE(type));
-        }
+        write_asc_neurite_header(myfile, section->type());
         write_asc_section(myfile, section, 2);
         myfile << ")\n\n";
     }
@@ -2,6 +2,12 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>  // std::all_of
+#include <array>
+#include <limits>
+#include <memory>  // std::unique_ptr
+#include <string>
+
 #include <morphio/mut/mitochondria.h>
 #include <morphio/mut/morphology.h>
 #include <morphio/mut/section.h>
@@ -67,6 +73,45 @@ void write_dataset(HighFive::Group& file, const std::string& name, const T& raw)
     dpoints.write(raw);
 }
 
+/** Write a (N, M) dataset from contiguous rows */
+template <typename Node, typename T, size_t M>
+void write_rows(Node& node, const std::string& name, const std::vector<std::array<T, M>>& rows) {
+    HighFive::DataSet dataset = node.template createDataSet<T>(name,
+                                                               HighFive::DataSpace({rows.size(), M}));
+
+    if (!rows.empty()) {
+        dataset.write_raw(rows.front().data());
+    }
+}
+
+/**
+   Write rows of offsets and section indices on 32 bits when they fit, which is the case of
+   all but the largest datasets, and on 64 bits otherwise. The readers accept both.
+ **/
+template <typename Node, size_t M>
+void write_structure(Node& node,
+                     const std::string& name,
+                     const std::vector<std::array<int64_t, M>>& rows) {
+    const bool compact = std::all_of(rows.begin(), rows.end(), [](const std::array<int64_t, M>& row) {
+        return std::all_of(row.begin(), row.end(), [](int64_t value) {
+            return value >= std::numeric_limits<int32_t>::min() &&
+                   value <= std::numeric_limits<int32_t>::max();
+        });
+    });
+    if (!compact) {
+        write_rows(node, name, rows);
+        return;
+    }
+
+    std::vector<std::array<int32_t, M>> compactRows(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (size_t j = 0; j < M; ++j) {
+            compactRows[i][j] = static_cast<int32_t>(rows[i][j]);
+        }
+    }
+    write_rows(node, name, compactRows);
+}
+
 
 }  // anonymous namespace
 
@@ -85,26 +130,21 @@ void mitochondriaH5(HighFive::File& h5_file, const Mitochondria& mitochondria) {
     auto& p = properties._mitochondriaPointLevel;
     size_t size = p._diameters.size();
 
-    std::vector<std::vector<morphio::floatType>> points;
-    std::vector<std::vector<int32_t>> structure;
-    points.reserve(size);
+    // Rows are written from contiguous buffers, with one write per dataset
+    std::vector<std::array<morphio::floatType, 3>> points(size);
     for (unsigned int i = 0; i < size; ++i) {
-        points.push_back({static_cast<morphio::floatType>(p._sectionIds[i]),
-                          p._relativePathLengths[i],
-                          p._diameters[i]});
+        points[i] = {static_cast<morphio::floatType>(p._sectionIds[i]),
+                     p._relativePathLengths[i],
+                     p._diameters[i]};
     }
 
-    auto& s = properties._mitochondriaSectionLevel;
-    structure.reserve(s._sections.size());
-    for (const auto& section : s._sections) {
-        structure.push_back({section[0], section[1]});
-    }
+    const auto& structure = properties._mitochondriaSectionLevel._sections;
 
     HighFive::Group g_organelles = h5_file.createGroup("organelles");
     HighFive::Group g_mitochondria = g_organelles.createGroup("mitochondria");
 
-    write_dataset(g_mitochondria, "points", points);
-    write_dataset(g_mitochondria, "structure", structure);
+    write_rows(g_mitochondria, "points", points);
+    write_structure(g_mitochondria, "structure", structure);
 }
 
 
@@ -145,8 +185,114 @@ void dendriticSpinePostSynapticDensityH5(HighFive::File& h5_file,
     write_dataset(g_postsynaptic_density, "segment_id", segmentIds);
     write_dataset(g_postsynaptic_density, "offset", offsets);
 }
+
+void writeMetadata(HighFive::File& h5_file, CellFamily cellFamily) {
+    HighFive::Group g_metadata = h5_file.createGroup("metadata");
+
+    write_attribute(g_metadata, "version", std::array<uint32_t, 2>{1, 3});
+    write_attribute(g_metadata,
+                    "cell_family",
+                    std::vector<uint32_t>{static_cast<uint32_t>(cellFamily)});
+    write_attribute(h5_file, "comment", std::vector<std::string>{details::version_string()});
+}
+
+/**
+ * H5 part of the StreamWriter, it follows the same rules as writer::h5
+ *
+ * The rows are buffered and the file is written when the writer is finished, with contiguous
+ * datasets like writer::h5: the readers of containers locate datasets by their offset in the
+ * file, which chunked datasets do not have.
+ */
+class H5StreamBackend: public details::StreamBackend
+{
+  public:
+    H5StreamBackend(const std::string& filename,
+                    std::shared_ptr<morphio::WarningHandler> handler,
+                    CellFamily cellFamily)
+        : _filename(filename)
+        , _handler(std::move(handler))
+        , _cellFamily(cellFamily) {}
+
+    void begin(const Soma& soma, bool /*hasSections*/) override {
+        details::validateContourSoma(soma, _handler);
+        details::checkSomaHasSameNumberPointsDiameters(soma);
+
+        const auto& somaPoints = soma.points();
+        const auto& somaDiameters = soma.diameters();
+        for (size_t i = 0; i < somaPoints.size(); ++i) {
+            const auto& point = somaPoints[i];
+            _points.push_back({point[0], point[1], point[2], somaDiameters[i]});
+        }
+        _structure.push_back({0, SECTION_SOMA, -1});
+    }
+
+    void openSection(const details::StreamSection& section,
+                     const details::StreamSection* parent,
+                     const Points& points,
+                     const std::vector<morphio::floatType>& diameters,
+                     const std::vector<morphio::floatType>& perimeters) override {
+        // Like writer::h5, the first section decides whether there are perimeters; the soma
+        // gets dummy ones to keep the length matching
+        if (section.id == 0 && !perimeters.empty()) {
+            _hasPerimeters = true;
+            _perimeters.assign(_points.size(), 0);
+        }
+        if (_hasPerimeters && perimeters.size() != points.size()) {
+            throw WriterError(morphio::details::ErrorMessages().ERROR_VECTOR_LENGTH_MISMATCH(
+                "points", points.size(), "perimeters", perimeters.size()));
+        }
+        if (!_hasPerimeters && !perimeters.empty()) {
+            throw WriterError("Section " + std::to_string(section.id) + " has " +
+                              std::to_string(perimeters.size()) +
+                              " perimeters, expected 0: the first section streamed to '" +
+                              _filename + "' has none");
+        }
+
+        // Sections are written in the order they are streamed, after the soma
+        const int64_t parentOnDisk = parent == nullptr ? 0 : static_cast<int64_t>(parent->id) + 1;
+        _structure.push_back({static_cast<int64_t>(_points.size()), section.type, parentOnDisk});
+        for (size_t i = 0; i < points.size(); ++i) {
+            _points.push_back({points[i][0], points[i][1], points[i][2], diameters[i]});
+        }
+        _perimeters.insert(_perimeters.end(), perimeters.begin(), perimeters.end());
+    }
+
+    void closeSection(const details::StreamSection& /*section*/) override {}
+
+    void finish() override {
+        HighFive::File file(_filename,
+                            HighFive::File::ReadWrite | HighFive::File::Create |
+                                HighFive::File::Truncate);
+        write_rows(file, "/points", _points);
+        write_structure(file, "/structure", _structure);
+        writeMetadata(file, _cellFamily);
+        if (_hasPerimeters) {
+            write_dataset(file, "/perimeters", _perimeters);
+        }
+        file.flush();
+    }
+
+  private:
+    std::string _filename;
+    std::shared_ptr<morphio::WarningHandler> _handler;
+    CellFamily _cellFamily;
+    std::vector<std::array<morphio::floatType, 4>> _points;
+    std::vector<std::array<int64_t, 3>> _structure;
+    bool _hasPerimeters = false;
+    std::vector<morphio::floatType> _perimeters;
+};
+
 }  // anonymous namespace
 
+namespace details {
+std::unique_ptr<StreamBackend> h5Stream(const std::string& filename,
+                                        std::shared_ptr<morphio::WarningHandler> handler,
+                                        CellFamily cellFamily) {
+    return std::unique_ptr<StreamBackend>(
+        new H5StreamBackend(filename, std::move(handler), cellFamily));
+}
+}  // namespace details
+
 void h5(const Morphology& morph,
         const std::string& filename,
         std::shared_ptr<morphio::WarningHandler> handler) {
@@ -164,7 +310,7 @@ void h5(const Morphology& morph,
     std::unordered_map<uint32_t, int32_t> newIds;
 
     std::vector<std::vector<morphio::floatType>> raw_points;
-    std::vector<std::vector<int32_t>> raw_structure;
+    std::vector<std::array<int64_t, 3>> raw_structure;
     std::vector<morphio::floatType> raw_perimeters;
 
     const std::vector<Point>& somaPoints = morph.soma()->points();
@@ -194,7 +340,7 @@ void h5(const Morphology& morph,
         const auto& perimeters = section->perimeters();
 
         int parentOnDisk = (section->isRoot() ? 0 : newIds[section->parent()->id()]);
-        raw_structure.push_back({static_cast<int>(offset), section->type(), parentOnDisk});
+        raw_structure.push_back({static_cast<int64_t>(offset), section->type(), parentOnDisk});
 
         const auto numberOfPoints = points.size();
         for (unsigned int i = 0; i < numberOfPoints; ++i) {
@@ -218,15 +364,9 @@ void h5(const Morphology& morph,
     }
 
     write_dataset(h5_file, "/points", raw_points);
-    write_dataset(h5_file, "/structure", raw_structure);
+    write_structure(h5_file, "/structure", raw_structure);
 
-    HighFive::Group g_metadata = h5_file.createGroup("metadata");
-
-    write_attribute(g_metadata, "version", std::array<uint32_t, 2>{1, 3});
-    write_attribute(g_metadata,
-                    "cell_family",
-                    std::vector<uint32_t>{static_cast<uint32_t>(morph.cellFamily())});
-    write_attribute(h5_file, "comment", std::vector<std::string>{details::version_string()});
+    writeMetadata(h5_file, morph.cellFamily());
 
     if (details::hasPerimeterData(morph)) {
         write_dataset(h5_file, "/perimeters", raw_perimeters);
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iomanip>  // std::fixed, std::setw, std::setprecision
 #include <memory>
+#include <sstream>
 #include <unordered_map>
 
 #include <morphio/mut/mitochondria.h>
@@ -25,7 +26,7 @@
 #include "writer_utils.h"
 
 namespace {
-void writeLine(std::ofstream& myfile,
+void writeLine(std::ostream& myfile,
                int id,
                int parentId,
                morphio::SectionType type,
@@ -53,15 +54,15 @@ void writeHeader(std::ofstream& myfile) {
 }
 
 int writeSoma(std::ofstream& myfile,
-              const std::shared_ptr<morphio::mut::Soma>& soma,
+              const morphio::mut::Soma& soma,
               std::shared_ptr<morphio::WarningHandler> handler) {
     using morphio::enums::SectionType;
 
-    const auto& soma_points = soma->points();
-    const auto& soma_diameters = soma->diameters();
+    const auto& soma_points = soma.points();
+    const auto& soma_diameters = soma.diameters();
 
     int startIdOnDisk = 1;
-    if (soma->type() == morphio::SomaType::SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS) {
+    if (soma.type() == morphio::SomaType::SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS) {
         const std::array<morphio::Point, 3> points = {
             soma_points[0],
             soma_points[1],
@@ -101,36 +102,122 @@ bool _skipDuplicate(const std::shared_ptr<morphio::mut::Section>& section) {
            morphio::epsilon;
 }
 
-void validateSWCSoma(const morphio::mut::Morphology& morph,
+void validateSWCSoma(const morphio::mut::Soma& soma,
+                     bool hasSections,
                      std::shared_ptr<morphio::WarningHandler> handler) {
     using morphio::SomaType;
     using morphio::Warning;
     using morphio::WriterError;
     using morphio::details::ErrorMessages;
 
-    const auto& soma = morph.soma();
-    const auto& soma_points = soma->points();
+    const auto& soma_points = soma.points();
     if (soma_points.empty()) {
-        if (morph.rootSections().empty()) {
+        if (!hasSections) {
             handler->emit(std::make_shared<morphio::WriteEmptyMorphology>());
             return;
         }
         handler->emit(std::make_shared<morphio::WriteNoSoma>());
 
-    } else if (soma->type() == morphio::SOMA_UNDEFINED) {
+    } else if (soma.type() == morphio::SOMA_UNDEFINED) {
         handler->emit(std::make_shared<morphio::WriteUndefinedSoma>());
-    } else if (!(soma->type() == SomaType::SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS ||
-                 soma->type() == SomaType::SOMA_CYLINDERS ||
-                 soma->type() == SomaType::SOMA_SINGLE_POINT)) {
+    } else if (!(soma.type() == SomaType::SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS ||
+                 soma.type() == SomaType::SOMA_CYLINDERS ||
+                 soma.type() == SomaType::SOMA_SINGLE_POINT)) {
         handler->emit(std::make_shared<morphio::SomaNonCynlinderOrPoint>());
-    } else if (soma->type() == SomaType::SOMA_SINGLE_POINT && soma_points.size() != 1) {
+    } else if (soma.type() == SomaType::SOMA_SINGLE_POINT && soma_points.size() != 1) {
         throw WriterError(ErrorMessages().ERROR_SOMA_INVALID_SINGLE_POINT());
-    } else if (soma->type() == SomaType::SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS &&
+    } else if (soma.type() == SomaType::SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS &&
                soma_points.size() != 3) {
         throw WriterError(ErrorMessages().ERROR_SOMA_INVALID_THREE_POINT_CYLINDER());
     }
 }
 
+/** SWC part of the StreamWriter, it follows the same rules as writer::swc */
+class SWCStreamBackend: public morphio::mut::writer::details::StreamBackend
+{
+  public:
+    SWCStreamBackend(const std::string& filename, std::shared_ptr<morphio::WarningHandler> handler)
+        : _filename(filename)
+        , _handler(std::move(handler)) {}
+
+    void begin(const morphio::mut::Soma& soma, bool hasSections) override {
+        validateSWCSoma(soma, hasSections, _handler);
+        morphio::mut::writer::details::checkSomaHasSameNumberPointsDiameters(soma);
+
+        _file.open(_filename);
+        writeHeader(_file);
+        _hasSoma = !soma.points().empty();
+        _segmentIdOnDisk = writeSoma(_file, soma, _handler);
+    }
+
+    void openSection(const morphio::mut::writer::details::StreamSection& section,
+                     const morphio::mut::writer::details::StreamSection* parent,
+                     const morphio::Points& points,
+                     const std::vector<morphio::floatType>& diameters,
+                     const std::vector<morphio::floatType>& perimeters) override {
+        if (!perimeters.empty()) {
+            throw morphio::WriterError(
+                morphio::details::ErrorMessages().ERROR_PERIMETER_DATA_NOT_WRITABLE());
+        }
+
+        if (parent != nullptr && parent->childCount == 0) {
+            _heldBack[parent->id] = static_cast<size_t>(_pending.tellp());
+        } else if (parent != nullptr && parent->childCount == 1) {
+            _heldBack.erase(parent->id);
+            if (_heldBack.empty()) {
+                _file << _pending.str();
+                _pending.str({});
+            }
+        }
+        std::ostream& out = _heldBack.empty() ? static_cast<std::ostream&>(_file) : _pending;
+
+        // skips duplicate point for non-root sections, if it has the same diameter
+        const bool skipDuplicate = parent != nullptr &&
+                                   std::fabs(diameters.front() - parent->lastDiameter) <
+                                       morphio::epsilon;
+        const unsigned int firstPoint = skipDuplicate ? 1 : 0;
+        for (unsigned int i = firstPoint; i < points.size(); ++i) {
+            int parentIdOnDisk = (i > firstPoint)
+                                     ? _segmentIdOnDisk - 1
+                                     : (parent == nullptr ? (_hasSoma ? 1 : -1)
+                                                          : _lastIdOnDisk[parent->id]);
+
+            writeLine(
+                out, _segmentIdOnDisk, parentIdOnDisk, section.type, points[i], diameters[i]);
+
+            ++_segmentIdOnDisk;
+        }
+        _lastIdOnDisk[section.id] = _segmentIdOnDisk - 1;
+    }
+
+    void closeSection(const morphio::mut::writer::details::StreamSection& section) override {
+        if (section.childCount == 1) {
+            // what comes before the only child is written, like writer::swc does
+            _file << _pending.str().substr(0, _heldBack.at(section.id));
+            throw morphio::WriterError(
+                morphio::details::ErrorMessages().ERROR_ONLY_CHILD_SWC_WRITER(section.id));
+        }
+        _lastIdOnDisk.erase(section.id);
+    }
+
+    void finish() override {
+        _file.close();
+    }
+
+  private:
+    std::string _filename;
+    std::shared_ptr<morphio::WarningHandler> _handler;
+    std::ofstream _file;
+    bool _hasSoma = false;
+    int _segmentIdOnDisk = 1;
+    // Id on disk of the last point of the sections on the current path
+    std::unordered_map<uint32_t, int> _lastIdOnDisk;
+    // The rows of the first child of a section are held back until a second child shows that
+    // the section is not a unifurcation, which is an error. By section with a single child so
+    // far, where the rows of that child start in `_pending`.
+    std::unordered_map<uint32_t, size_t> _heldBack;
+    std::ostringstream _pending;
+};
 
 }  // namespace
 
@@ -138,6 +225,13 @@ namespace morphio {
 namespace mut {
 namespace writer {
 
+namespace details {
+std::unique_ptr<StreamBackend> swcStream(const std::string& filename,
+                                         std::shared_ptr<morphio::WarningHandler> handler) {
+    return std::unique_ptr<StreamBackend>(new SWCStreamBackend(filename, std::move(handler)));
+}
+}  // namespace details
+
 void swc(const Morphology& morph,
          const std::string& filename,
          std::shared_ptr<morphio::WarningHandler> handler) {
@@ -146,14 +240,14 @@ void swc(const Morphology& morph,
     }
 
     const std::shared_ptr<Soma>& soma = morph.soma();
-    validateSWCSoma(morph, handler);
+    validateSWCSoma(*soma, !morph.rootSections().empty(), handler);
     details::checkSomaHasSameNumberPointsDiameters(*soma);
     details::validateHasNoMitochondria(morph, handler);
     details::validateHasNoPerimeterData(morph);
 
     std::ofstream myfile(filename);
     writeHeader(myfile);
-    int segmentIdOnDisk = writeSoma(myfile, soma, handler);
+    int segmentIdOnDisk = writeSoma(myfile, *soma, handler);
 
     std::unordered_map<uint32_t, int32_t> newIds;
     for (auto it = morph.depth_begin(); it != morph.depth_end(); ++it) {
@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <cctype>  // std::tolower
+
 #include <morphio/errorMessages.h>
 
 #include "../error_message_generation.h"
@@ -44,14 +46,18 @@ bool emptyMorphology(const morphio::mut::Morphology& morph,
 
 void validateContourSoma(const morphio::mut::Morphology& morph,
                          std::shared_ptr<morphio::WarningHandler> handler) {
-    const std::shared_ptr<Soma>& soma = morph.soma();
-    const std::vector<Point>& somaPoints = soma->points();
+    validateContourSoma(*morph.soma(), handler);
+}
+
+void validateContourSoma(const morphio::mut::Soma& soma,
+                         std::shared_ptr<morphio::WarningHandler> handler) {
+    const std::vector<Point>& somaPoints = soma.points();
 
     if (somaPoints.empty()) {
         handler->emit(std::make_shared<morphio::WriteNoSoma>());
-    } else if (soma->type() == SOMA_UNDEFINED) {
+    } else if (soma.type() == SOMA_UNDEFINED) {
         handler->emit(std::make_shared<morphio::WriteUndefinedSoma>());
-    } else if (soma->type() != SomaType::SOMA_SIMPLE_CONTOUR) {
+    } else if (soma.type() != SomaType::SOMA_SIMPLE_CONTOUR) {
         handler->emit(std::make_shared<morphio::SomaNonContour>());
     } else if (somaPoints.size() < 3) {
         throw WriterError(ErrorMessages().ERROR_SOMA_INVALID_CONTOUR());
@@ -71,6 +77,19 @@ void validateHasNoMitochondria(const morphio::mut::Morphology& morph,
     }
 }
 
+std::string fileExtension(const std::string& filename) {
+    const size_t pos = filename.find_last_of('.');
+    if (pos == std::string::npos) {
+        throw UnknownFileType("Missing file extension.");
+    }
+
+    std::string extension;
+    for (char c : filename.substr(pos)) {
+        extension += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return extension;
+}
+
 }  // namespace details
 }  // namespace writer
 }  // namespace mut
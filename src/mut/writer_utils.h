@@ -3,8 +3,11 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <memory>  // std::unique_ptr
+
 #include <morphio/mut/morphology.h>
 #include <morphio/mut/soma.h>
+#include <morphio/mut/stream_writer.h>
 #include <morphio/warning_handling.h>
 
 namespace morphio {
@@ -19,10 +22,51 @@ bool emptyMorphology(const morphio::mut::Morphology&,
                      std::shared_ptr<morphio::WarningHandler> handler);
 void validateContourSoma(const morphio::mut::Morphology&,
                          std::shared_ptr<morphio::WarningHandler> handler);
+void validateContourSoma(const morphio::mut::Soma&,
+                         std::shared_ptr<morphio::WarningHandler> handler);
 void validateHasNoPerimeterData(const morphio::mut::Morphology&);
 void validateHasNoMitochondria(const morphio::mut::Morphology&,
                                std::shared_ptr<morphio::WarningHandler> handler);
 
+
+/** Lower case extension of `filename`, dot included; throws UnknownFileType if missing */
+std::string fileExtension(const std::string& filename);
+
+/**
+ * Format specific part of the StreamWriter
+ *
+ * The StreamWriter validates the order of the sections and calls, in this order: `begin`
+ * once, then `openSection` for each section, `closeSection` once all the children of a
+ * section have been written, and `finish`.
+ */
+class StreamBackend
+{
+  public:
+    virtual ~StreamBackend() = default;
+
+    /** Create the file and write the soma; `hasSections` is false for a soma only file */
+    virtual void begin(const Soma& soma, bool hasSections) = 0;
+
+    /** Write a section, `parent` is nullptr for root sections */
+    virtual void openSection(const StreamSection& section,
+                             const StreamSection* parent,
+                             const Points& points,
+                             const std::vector<floatType>& diameters,
+                             const std::vector<floatType>& perimeters) = 0;
+
+    virtual void closeSection(const StreamSection& section) = 0;
+
+    virtual void finish() = 0;
+};
+
+std::unique_ptr<StreamBackend> swcStream(const std::string& filename,
+                                         std::shared_ptr<morphio::WarningHandler> handler);
+std::unique_ptr<StreamBackend> ascStream(const std::string& filename,
+                                         std::shared_ptr<morphio::WarningHandler> handler);
+std::unique_ptr<StreamBackend> h5Stream(const std::string& filename,
+                                        std::shared_ptr<morphio::WarningHandler> handler,
+                                        CellFamily cellFamily);
+
 }  // namespace details
 }  // namespace writer
 }  // namespace mut
@@ -0,0 +1,45 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <morphio/parallel.h>
+
+#include "thread_utils.hpp"
+
+namespace morphio {
+namespace parallel {
+
+void forEachSection(const Morphology& morphology,
+                    const std::function<void(const Section&)>& callback,
+                    Order order,
+                    unsigned int nThreads) {
+    // built once, so that the threads do not share the reference count of the properties
+    const std::vector<Section> sections = morphology.sections();
+    const size_t nSections = sections.size();
+
+    std::vector<std::vector<uint32_t>> dependents(nSections);
+    std::vector<uint32_t> nDependencies(nSections, 0);
+    if (order != UNORDERED) {
+        for (const auto& entry : morphology.connectivity()) {
+            if (entry.first == -1) {
+                continue;
+            }
+            const auto parent = static_cast<uint32_t>(entry.first);
+            for (const uint32_t child : entry.second) {
+                if (order == TOP_DOWN) {
+                    dependents[parent].push_back(child);
+                    ++nDependencies[child];
+                } else {
+                    dependents[child].push_back(parent);
+                    ++nDependencies[parent];
+                }
+            }
+        }
+    }
+
+    details::parallelForGraph(
+        dependents, nDependencies, [&](uint32_t id) { callback(sections[id]); }, nThreads);
+}
+
+}  // namespace parallel
+}  // namespace morphio
@@ -3,7 +3,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <algorithm>  // std::max
-#include <cmath>      // std::sqrt
+#include <cmath>      // std::abs, std::sqrt
 #include <numeric>    // std::accumulate
 #include <sstream>    // ostringstream
 #include <string>     // std::string
@@ -27,6 +27,48 @@ floatType euclidean_distance(const Point& left, const Point& right) {
                      (left[2] - right[2]) * (left[2] - right[2]));
 }
 
+floatType boxDistance(const Point& min0, const Point& max0, const Point& min1, const Point& max1) {
+    floatType squared = 0;
+    for (size_t k = 0; k < 3; ++k) {
+        const floatType gap = std::max<floatType>(
+            0, std::max(min0[k] - max1[k], min1[k] - max0[k]));
+        squared += gap * gap;
+    }
+    return std::sqrt(squared);
+}
+
+std::array<std::array<floatType, 3>, 3> alignment(const Point& from, const Point& to) {
+    std::array<std::array<floatType, 3>, 3> rotation{{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+    const floatType c = dot(from, to);
+    if (c < -1 + epsilon) {
+        // half turn around an axis orthogonal to `from`: 2 k k^T - I
+        const Point k = normalized(cross(from, std::abs(from[0]) < floatType(0.9)
+                                                   ? Point{1, 0, 0}
+                                                   : Point{0, 1, 0}),
+                                   Point{0, 0, 1});
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                rotation[i][j] = 2 * k[i] * k[j] - (i == j ? 1 : 0);
+            }
+        }
+        return rotation;
+    }
+    // Rodrigues: I + [v]x + [v]x^2 / (1 + c), with v = from x to
+    const Point v = cross(from, to);
+    const std::array<std::array<floatType, 3>, 3> vx{
+        {{0, -v[2], v[1]}, {v[2], 0, -v[0]}, {-v[1], v[0], 0}}};
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            floatType square = 0;
+            for (size_t k = 0; k < 3; ++k) {
+                square += vx[i][k] * vx[k][j];
+            }
+            rotation[i][j] += vx[i][j] + square / (1 + c);
+        }
+    }
+    return rotation;
+}
+
 std::string dumpPoint(const Point& point) {
     std::ostringstream oss;
     oss << point[0] << " " << point[1] << " " << point[2];
@@ -4,6 +4,8 @@
  */
 #include <morphio/types.h>
 
+#include <array>
+#include <cmath>   // std::sqrt
 #include <iosfwd>  // std::ostream
 #include <string>  // std::string
 
@@ -12,6 +14,29 @@
 namespace morphio {
 Point subtract(const Point& left, const Point& right);
 
+/** Dot product, in the precision of the vectors; they are points or double vectors */
+template <typename T>
+T dot(const std::array<T, 3>& left, const std::array<T, 3>& right) {
+    return left[0] * right[0] + left[1] * right[1] + left[2] * right[2];
+}
+
+template <typename T>
+std::array<T, 3> cross(const std::array<T, 3>& left, const std::array<T, 3>& right) {
+    return {left[1] * right[2] - left[2] * right[1],
+            left[2] * right[0] - left[0] * right[2],
+            left[0] * right[1] - left[1] * right[0]};
+}
+
+/** `vector` scaled to a unit vector, or `fallback` if it is (almost) null */
+template <typename T>
+std::array<T, 3> normalized(const std::array<T, 3>& vector, const std::array<T, 3>& fallback) {
+    const T norm = std::sqrt(dot(vector, vector));
+    if (norm < static_cast<T>(epsilon)) {
+        return fallback;
+    }
+    return {vector[0] / norm, vector[1] / norm, vector[2] / norm};
+}
+
 Point centerOfGravity(const range<const Point>& points);
 
 floatType maxDistanceToCenterOfGravity(const Points& points);
@@ -21,6 +46,12 @@ std::string dumpPoints(const range<const Point>& points);
 
 floatType euclidean_distance(const Point& left, const Point& right);
 
+/** Distance between two boxes; a lower bound of the distance between what they enclose */
+floatType boxDistance(const Point& min0, const Point& max0, const Point& min1, const Point& max1);
+
+/** The rotation (row major) taking the unit vector `from` to the unit vector `to` */
+std::array<std::array<floatType, 3>, 3> alignment(const Point& from, const Point& to);
+
 }  // namespace morphio
 
 std::ostream& operator<<(std::ostream& os, const morphio::Point& point);
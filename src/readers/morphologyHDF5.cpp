@@ -3,7 +3,9 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>  // std::max
 #include <cassert>
+#include <cstring>  // std::memcpy
 
 #include "morphologyHDF5.h"
 
@@ -59,12 +61,110 @@ const std::string _d_dendritic_spine_offset("offset");
 const std::string _g_v2root("neuron1");
 //} v2
 
+/** Open the file from a copy of `contents` held by the HDF5 core driver */
+class FileImage
+{
+  public:
+    explicit FileImage(const std::string& contents)
+        : _contents(contents) {}
+
+    void apply(hid_t list) const {
+        if (H5Pset_fapl_core(list, _contents.size(), false) < 0 ||
+            H5Pset_file_image(list,
+                              const_cast<char*>(_contents.data()),
+                              _contents.size()) < 0) {
+            throw morphio::RawDataError("Could not create an HDF5 file image");
+        }
+    }
+
+  private:
+    const std::string& _contents;
+};
+
+thread_local const morphio::readers::h5::PrefetchedBytes* currentPrefetchedBytes = nullptr;
+
+/**
+ * Copy the `count` elements of `dataset` into `data` from the bytes read ahead of time.
+ *
+ * Returns false when they don't hold the dataset, which must then be read from the file.
+ */
+template <typename T>
+bool readPrefetched(const HighFive::DataSet& dataset, T* data, size_t count) {
+    const auto* prefetched = morphio::readers::h5::PrefetchedBytes::current();
+    if (prefetched == nullptr || count == 0) {
+        return false;
+    }
+
+    const auto dcpl = dataset.getCreatePropertyList();
+    if (H5Pget_layout(dcpl.getId()) != H5D_CONTIGUOUS) {
+        return false;
+    }
+
+    const uint64_t size = dataset.getStorageSize();
+    const char* bytes = prefetched->find(dataset.getOffset(), size);
+    if (bytes == nullptr) {
+        return false;
+    }
+
+    const HighFive::AtomicType<T> memoryType;
+    const hid_t fileType = H5Dget_type(dataset.getId());
+    const size_t fileTypeSize = H5Tget_size(fileType);
+    if (fileTypeSize * count != size) {
+        H5Tclose(fileType);
+        return false;
+    }
+
+    // converted in place, the buffer fits both representations
+    std::vector<char> buffer(std::max(fileTypeSize, sizeof(T)) * count);
+    std::memcpy(buffer.data(), bytes, size);
+    const herr_t status =
+        H5Tconvert(fileType, memoryType.getId(), count, buffer.data(), nullptr, H5P_DEFAULT);
+    H5Tclose(fileType);
+    if (status < 0) {
+        throw morphio::RawDataError("Could not convert the prefetched dataset " +
+                                    dataset.getPath());
+    }
+    std::memcpy(data, buffer.data(), count * sizeof(T));
+    return true;
+}
+
 }  // namespace
 
 namespace morphio {
 namespace readers {
 namespace h5 {
 
+void PrefetchedBytes::insert(uint64_t offset, std::string bytes) {
+    _ranges[offset] = std::move(bytes);
+}
+
+const char* PrefetchedBytes::find(uint64_t offset, uint64_t size) const {
+    // the last range starting at or before `offset`
+    auto it = _ranges.upper_bound(offset);
+    if (it == _ranges.begin()) {
+        return nullptr;
+    }
+    --it;
+    const uint64_t begin = offset - it->first;
+    if (begin + size > it->second.size()) {
+        return nullptr;
+    }
+    return it->second.data() + begin;
+}
+
+const PrefetchedBytes* PrefetchedBytes::current() {
+    return currentPrefetchedBytes;
+}
+
+PrefetchedBytes::Scope::Scope(const PrefetchedBytes& bytes)
+    : _previous(currentPrefetchedBytes) {
+    currentPrefetchedBytes = &bytes;
+}
+
+PrefetchedBytes::Scope::~Scope() {
+    currentPrefetchedBytes = _previous;
+}
+
 MorphologyHDF5::MorphologyHDF5(const HighFive::Group& group, const std::string& uri)
     : _group(group)
     , _uri(uri) {}
@@ -81,6 +181,21 @@ Property::Properties load(const std::string& uri, WarningHandler* warning_handle
     }
 }
 
+Property::Properties loadFileImage(const std::string& contents, WarningHandler* warning_handler) {
+    const std::string uri = "$STRING$";
+    try {
+        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
+        HighFive::SilenceHDF5 silence;
+        HighFive::FileAccessProps fapl;
+        fapl.add(FileImage(contents));
+        auto file = HighFive::File(uri, HighFive::File::ReadOnly, fapl);
+        return MorphologyHDF5(file.getGroup("/"), uri).load(warning_handler);
+
+    } catch (const HighFive::FileException& exc) {
+        throw RawDataError("Could not open morphology from memory: " + std::string(exc.what()));
+    }
+}
+
 Property::Properties load(const HighFive::Group& group, WarningHandler* warning_handler) {
     std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
     if (warning_handler == nullptr) {
@@ -92,7 +207,7 @@ Property::Properties load(const HighFive::Group& group, WarningHandler* warning_
 Property::Properties MorphologyHDF5::load(WarningHandler* warning_handler) {
     _readMetadata();
 
-    int firstSectionOffset = _readSections();
+    const int64_t firstSectionOffset = _readSections();
 
     _readPoints(firstSectionOffset);
 
@@ -179,7 +294,7 @@ void MorphologyHDF5::_readMetadata() {
     _properties._cellLevel._version = {"h5", majorVersion, minorVersion};
 }
 
-void MorphologyHDF5::_readPoints(int firstSectionOffset) {
+void MorphologyHDF5::_readPoints(int64_t firstSectionOffset) {
     constexpr size_t pointColumns = 4;
 
     const auto pointsDataSet = _group.getDataSet(_d_points);
@@ -196,7 +311,8 @@ void MorphologyHDF5::_readPoints(int firstSectionOffset) {
 
     std::vector<std::array<floatType, pointColumns>> hdf5Data(numberPoints);
 
-    if (!hdf5Data.empty()) {
+    if (!hdf5Data.empty() &&
+        !readPrefetched(pointsDataSet, hdf5Data.front().data(), numberPoints * pointColumns)) {
         pointsDataSet.read(hdf5Data.front().data());
     }
 
@@ -235,7 +351,7 @@ void MorphologyHDF5::_readPoints(int firstSectionOffset) {
     }
 }
 
-int MorphologyHDF5::_readSections() {
+int64_t MorphologyHDF5::_readSections() {
     // Important: The code used to split the reading of the sections and types
     //            into two separate fine-grained H5 selections. This does not
     //            reduce the number of I/O operations, but increases them by
@@ -252,8 +368,10 @@ int MorphologyHDF5::_readSections() {
                            " bad number of dimensions in 'structure' dataspace"));
     }
 
-    std::vector<std::array<int, structureV1Columns>> vec(dims[0]);
-    if (dims[0] > 0) {
+    // HDF5 converts the rows to 64-bit, whether they are stored on 32 or 64 bits
+    std::vector<std::array<int64_t, structureV1Columns>> vec(dims[0]);
+    if (dims[0] > 0 &&
+        !readPrefetched(structure, vec.front().data(), dims[0] * structureV1Columns)) {
         structure.read(vec.front().data());
     }
 
@@ -267,7 +385,7 @@ int MorphologyHDF5::_readSections() {
     }
 
     const size_t firstSection = hasSoma ? 1 : 0;
-    const int firstSectionOffset = vec[firstSection][SECTION_START_OFFSET];
+    const int64_t firstSectionOffset = vec[firstSection][SECTION_START_OFFSET];
 
     auto& sections = _properties.get_mut<Property::Section>();
     sections.reserve(vec.size() - firstSection);
@@ -300,7 +418,7 @@ int MorphologyHDF5::_readSections() {
     return firstSectionOffset;
 }
 
-void MorphologyHDF5::_readPerimeters(int firstSectionOffset) {
+void MorphologyHDF5::_readPerimeters(int64_t firstSectionOffset) {
     if (!(_properties._cellLevel.majorVersion() == 1 &&
           _properties._cellLevel.minorVersion() > 0)) {
         throw RawDataError("Perimeter information is available starting at v1.1");
@@ -348,7 +466,9 @@ void MorphologyHDF5::_read(const std::string& groupName,
     }
 
     data.resize(dims[0]);
-    dataset.read(data);
+    if (!readPrefetched(dataset, data.data(), data.size())) {
+        dataset.read(data);
+    }
 }
 
 void MorphologyHDF5::_readDendriticSpinePostSynapticDensity() {
@@ -405,8 +525,10 @@ void MorphologyHDF5::_readMitochondria() {
         return;
     }
 
-    std::vector<std::vector<floatType>> points;
-    _read(_g_mitochondria, _d_points, 2, points);
+    // Read both datasets with a single contiguous read each, and split the
+    // point columns in memory
+    std::vector<std::array<floatType, 3>> points;
+    _readRows(_g_mitochondria, _d_points, points);
 
     auto& mitoSectionId = _properties.get_mut<Property::MitoNeuriteSectionId>();
     auto& pathlength = _properties.get_mut<Property::MitoPathLength>();
@@ -420,13 +542,38 @@ void MorphologyHDF5::_readMitochondria() {
         diameters.push_back(p[2]);
     }
 
-    std::vector<std::vector<int32_t>> structure;
-    _read(_g_mitochondria, _d_structure, 2, structure);
+    _readRows(_g_mitochondria, _d_structure, _properties.get_mut<Property::MitoSection>());
+}
+
+template <typename T, size_t N>
+void MorphologyHDF5::_readRows(const std::string& groupName,
+                               const std::string& datasetName,
+                               std::vector<std::array<T, N>>& data) {
+    if (!_group.exist(groupName)) {
+        throw(
+            RawDataError("Reading morphology '" + _uri + "': Missing required group " + groupName));
+    }
+    const auto group = _group.getGroup(groupName);
+
+    if (!group.exist(datasetName)) {
+        throw(RawDataError("Reading morphology '" + _uri + "': Missing required dataset " +
+                           datasetName));
+    }
+    const HighFive::DataSet dataset = group.getDataSet(datasetName);
 
-    auto& mitoSection = _properties.get_mut<Property::MitoSection>();
-    mitoSection.reserve(mitoSection.size() + structure.size());
-    for (auto& s : structure)
-        mitoSection.emplace_back(Property::MitoSection::Type{s[0], s[1]});
+    const auto dims = dataset.getSpace().getDimensions();
+    if (dims.size() != 2) {
+        throw(RawDataError("Reading morphology '" + _uri + "': bad number of dimensions in " +
+                           datasetName));
+    } else if (dims[1] != N) {
+        throw(RawDataError("Reading morphology '" + _uri + "': incorrect number of columns in " +
+                           datasetName));
+    }
+
+    data.resize(dims[0]);
+    if (!data.empty()) {
+        dataset.read(data.front().data());
+    }
 }
 
 }  // namespace h5
@@ -4,6 +4,9 @@
  */
 
 #pragma once
+#include <array>
+#include <cstdint>  // uint64_t
+#include <map>
 #include <mutex>
 #include <string>  // std::string
 
@@ -17,6 +20,45 @@ namespace readers {
 namespace h5 {
 Property::Properties load(const std::string& uri, WarningHandler*);
 Property::Properties load(const HighFive::Group& group, WarningHandler*);
+/** Load a morphology from the bytes of an HDF5 file, without touching the filesystem */
+Property::Properties loadFileImage(const std::string& contents, WarningHandler*);
+
+/**
+ * Bytes of an HDF5 file read ahead of time, e.g. collectively with MPI-IO, keyed by their offset.
+ *
+ * While a `Scope` is alive, the readers of the current thread copy the contiguous datasets holding
+ * the bulk of a morphology (points, structure and perimeters) from here instead of reading them
+ * from the file.
+ */
+class PrefetchedBytes
+{
+  public:
+    /** Add the `bytes` found at `offset` in the file */
+    void insert(uint64_t offset, std::string bytes);
+
+    /** The `size` bytes at `offset` in the file, or nullptr if they were not read ahead */
+    const char* find(uint64_t offset, uint64_t size) const;
+
+    /** The bytes used by the readers of the current thread, or nullptr */
+    static const PrefetchedBytes* current();
+
+    /** Make the readers of the current thread use `bytes` until destroyed */
+    class Scope
+    {
+      public:
+        explicit Scope(const PrefetchedBytes& bytes);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        const PrefetchedBytes* _previous;
+    };
+
+  private:
+    std::map<uint64_t, std::string> _ranges;
+};
 
 class MorphologyHDF5
 {
@@ -28,9 +70,9 @@ class MorphologyHDF5
   private:
     void _checkVersion();
     void _readMetadata();
-    void _readPoints(int);
-    int _readSections();
-    void _readPerimeters(int);
+    void _readPoints(int64_t);
+    int64_t _readSections();
+    void _readPerimeters(int64_t);
     void _readMitochondria();
     void _readEndoplasmicReticulum();
     void _readDendriticSpinePostSynapticDensity();
@@ -41,6 +83,12 @@ class MorphologyHDF5
                unsigned int expectedDimension,
                T& data);
 
+    /// Read a 2D dataset of `N` columns at once
+    template <typename T, size_t N>
+    void _readRows(const std::string& group,
+                   const std::string& dataset,
+                   std::vector<std::array<T, N>>& data);
+
     HighFive::Group _group;
     Property::Properties _properties;
     std::string _uri;
@@ -81,13 +81,9 @@ void VasculatureHDF5::_readSections() {
     auto& sections = _properties.get_mut<vasculature::property::VascSection>();
     auto selection = _sections->select({0, 0}, {_sectionsDims[0], 1});
 
-    std::vector<unsigned int> vec;
-    vec.resize(_sectionsDims[0]);
-    selection.read(vec);
-
-    for (auto p : vec) {
-        sections.push_back(p);
-    }
+    // HDF5 converts the offsets to 64-bit, whether they are stored on 32 or 64 bits
+    sections.resize(_sectionsDims[0]);
+    selection.read(sections);
 }
 
 void VasculatureHDF5::_readSectionTypes() {
@@ -70,6 +70,11 @@ bool is_regular_file(const std::string& path) {
 std::string join_path(const std::string& dirname, const std::string& filename) {
     return (ghc::filesystem::path(dirname) / filename).string();
 }
+
+void create_directories(const std::string& path) {
+    ghc::filesystem::create_directories(path);
+}
+
 namespace details {
 ThreePointSomaStatus checkNeuroMorphoSoma(const std::array<Point, 3>& points, floatType radius) {
     //  NeuroMorpho is the main provider of morphologies, but they
@@ -54,6 +54,9 @@ bool is_regular_file(const std::string& path);
  */
 std::string join_path(const std::string& dirname, const std::string& filename);
 
+/** Create the directory `path` and its missing parents, if they do not exist. */
+void create_directories(const std::string& path);
+
 namespace property {
 
 template <typename T>
@@ -0,0 +1,298 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <atomic>
+#include <cstdio>   // std::rename, std::remove
+#include <cstring>  // std::memcpy
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#if defined(WIN32) || defined(__WIN32__) || defined(_WIN32) || defined(_MSC_VER) || defined(__MINGW32__)
+#define MORPHIO_SIDECAR_NO_MMAP
+#else
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+#endif
+
+#include <morphio/section.h>
+#include <morphio/sidecar.h>
+#include <morphio/soma.h>
+
+#include "point_utils.h"  // euclidean_distance
+#include "shared_utils.hpp"
+
+namespace {
+
+const char kMagic[8] = {'M', 'O', 'R', 'P', 'H', 'I', 'O', 'C'};
+const uint32_t kFormatVersion = 1;
+
+/** The header of a sidecar file, followed by the values */
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t elementSize;
+    uint64_t hash;
+    uint64_t count;
+};
+static_assert(sizeof(Header) == 32, "the values must be aligned");
+
+/** FNV-1a */
+class Hasher
+{
+  public:
+    void add(const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash_ = (hash_ ^ bytes[i]) * 1099511628211ULL;
+        }
+    }
+
+    template <typename T>
+    void add(const std::vector<T>& values) {
+        const auto size = static_cast<uint64_t>(values.size());
+        add(&size, sizeof(size));
+        add(values.data(), values.size() * sizeof(T));
+    }
+
+    uint64_t hash() const noexcept {
+        return hash_;
+    }
+
+  private:
+    uint64_t hash_ = 14695981039346656037ULL;
+};
+
+bool validName(const std::string& name) {
+    if (name.empty()) {
+        return false;
+    }
+    for (const char c : name) {
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+              c == '_' || c == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** A name for a temporary file, unique among the threads and processes writing the cache */
+std::string temporarySuffix() {
+    static std::atomic<uint64_t> counter(0);
+    static const uint64_t processKey = std::random_device()();
+    std::ostringstream suffix;
+    suffix << ".tmp-" << std::hex << processKey << '-' << counter++;
+    return suffix.str();
+}
+
+}  // namespace
+
+namespace morphio {
+namespace sidecar {
+
+uint64_t contentHash(const Morphology& morphology) {
+    Hasher hasher;
+    hasher.add(morphology.points());
+    hasher.add(morphology.diameters());
+    hasher.add(morphology.perimeters());
+    hasher.add(morphology.sectionTypes());
+    hasher.add(morphology.sectionOffsets());
+
+    std::vector<int32_t> parents;
+    parents.reserve(morphology.sectionTypes().size());
+    for (const auto& section : morphology.sections()) {
+        parents.push_back(section.isRoot() ? -1 : static_cast<int32_t>(section.parent().id()));
+    }
+    hasher.add(parents);
+
+    const auto soma = morphology.soma();
+    const auto somaType = static_cast<int32_t>(morphology.somaType());
+    hasher.add(&somaType, sizeof(somaType));
+    hasher.add(soma.points().data(), soma.points().size() * sizeof(Point));
+    hasher.add(soma.diameters().data(), soma.diameters().size() * sizeof(floatType));
+    return hasher.hash();
+}
+
+std::vector<floatType> sectionLengths(const Morphology& morphology) {
+    const auto sections = morphology.sections();
+    std::vector<floatType> lengths(sections.size(), 0);
+    for (const auto& section : sections) {
+        const auto points = section.points();
+        floatType length = 0;
+        for (size_t i = 1; i < points.size(); ++i) {
+            length += euclidean_distance(points[i - 1], points[i]);
+        }
+        lengths[section.id()] = length;
+    }
+    return lengths;
+}
+
+std::vector<floatType> pathDistances(const Morphology& morphology) {
+    const auto lengths = sectionLengths(morphology);
+    std::vector<floatType> distances(lengths.size(), 0);
+    const auto sections = morphology.sections();
+    for (const auto id : depthFirstOrder(morphology)) {
+        const auto& section = sections[id];
+        const floatType start = section.isRoot() ? 0 : distances[section.parent().id()];
+        distances[id] = start + lengths[id];
+    }
+    return distances;
+}
+
+std::vector<uint32_t> depthFirstOrder(const Morphology& morphology) {
+    std::vector<uint32_t> order;
+    order.reserve(morphology.sectionTypes().size());
+    for (auto it = morphology.depth_begin(); it != morphology.depth_end(); ++it) {
+        order.push_back((*it).id());
+    }
+    return order;
+}
+
+MappedArray::~MappedArray() {
+#ifndef MORPHIO_SIDECAR_NO_MMAP
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappingSize_);
+    }
+#endif
+}
+
+SidecarCache::SidecarCache(std::string directory)
+    : directory_(std::move(directory)) {
+    create_directories(directory_);
+}
+
+SidecarCache SidecarCache::nextTo(const std::string& source) {
+    if (is_directory(source)) {
+        return SidecarCache(join_path(source, ".morphio-cache"));
+    }
+    return SidecarCache(source + ".morphio-cache");
+}
+
+std::string SidecarCache::path(uint64_t hash, const std::string& name) const {
+    if (!validName(name)) {
+        throw MorphioError("Sidecar: invalid array name '" + name +
+                           "', only letters, digits, '_' and '-' are allowed");
+    }
+    std::ostringstream filename;
+    filename << std::hex;
+    filename.width(16);
+    filename.fill('0');
+    filename << hash << '-' << name << ".bin";
+    return join_path(directory_, filename.str());
+}
+
+std::shared_ptr<const MappedArray> SidecarCache::load(uint64_t hash,
+                                                      const std::string& name,
+                                                      size_t elementSize) const {
+    const std::string filename = path(hash, name);
+    std::shared_ptr<MappedArray> array(new MappedArray());
+
+#ifdef MORPHIO_SIDECAR_NO_MMAP
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string bytes = contents.str();
+    array->buffer_.assign(bytes.begin(), bytes.end());
+    const char* data = array->buffer_.data();
+    const size_t size = array->buffer_.size();
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        return nullptr;
+    }
+    const auto size = static_cast<size_t>(status.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    array->mapping_ = mapping;
+    array->mappingSize_ = size;
+    const char* data = static_cast<const char*>(mapping);
+#endif
+
+    if (size < sizeof(Header)) {
+        return nullptr;
+    }
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kFormatVersion || header.elementSize == 0 ||
+        header.elementSize != elementSize ||
+        header.hash != hash || header.count != (size - sizeof(Header)) / elementSize ||
+        (size - sizeof(Header)) % elementSize != 0) {
+        return nullptr;
+    }
+    array->data_ = data + sizeof(Header);
+    array->count_ = header.count;
+    array->elementSize_ = elementSize;
+    return array;
+}
+
+std::shared_ptr<const MappedArray> SidecarCache::store(uint64_t hash,
+                                                       const std::string& name,
+                                                       const void* data,
+                                                       size_t count,
+                                                       size_t elementSize) const {
+    if (elementSize == 0) {
+        throw MorphioError("Sidecar: the elements of " + name + " have no size");
+    }
+    const std::string filename = path(hash, name);
+    const std::string temporary = filename + temporarySuffix();
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.elementSize = static_cast<uint32_t>(elementSize);
+    header.hash = hash;
+    header.count = count;
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(static_cast<const char*>(data),
+                   static_cast<std::streamsize>(count * elementSize));
+        if (!file) {
+            std::remove(temporary.c_str());
+            throw MorphioError("Sidecar: cannot write " + temporary);
+        }
+    }
+    // another process may have written the same entry in the meantime, both are the same
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+    }
+
+    auto array = load(hash, name, elementSize);
+    if (!array) {
+        throw MorphioError("Sidecar: cannot read back " + filename);
+    }
+    return array;
+}
+
+std::shared_ptr<const MappedArray> SidecarCache::sectionLengths(
+    const Morphology& morphology) const {
+    return getOrCompute<floatType>(morphology, "section_lengths", sidecar::sectionLengths);
+}
+
+std::shared_ptr<const MappedArray> SidecarCache::pathDistances(
+    const Morphology& morphology) const {
+    return getOrCompute<floatType>(morphology, "path_distances", sidecar::pathDistances);
+}
+
+std::shared_ptr<const MappedArray> SidecarCache::depthFirstOrder(
+    const Morphology& morphology) const {
+    return getOrCompute<uint32_t>(morphology, "depth_first_order", sidecar::depthFirstOrder);
+}
+
+}  // namespace sidecar
+}  // namespace morphio
@@ -0,0 +1,228 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::min, std::max
+#include <cmath>      // std::cos, std::sin, std::sqrt
+
+#include <morphio/exceptions.h>
+#include <morphio/mut/section.h>
+#include <morphio/mut/soma.h>
+#include <morphio/section.h>
+#include <morphio/spines.h>
+
+#include "point_utils.h"  // cross, dot, normalized
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::cross;
+using morphio::dot;
+using morphio::floatType;
+using morphio::normalized;
+using morphio::Point;
+
+/** Position, unit tangent and radius of a section at a fraction of its path length */
+struct Frame {
+    Point position;
+    Point tangent;
+    floatType radius;
+};
+
+Frame frameAt(const morphio::Section& section, floatType offset) {
+    const auto points = section.points();
+    const auto diameters = section.diameters();
+    if (points.size() < 2) {
+        return {points.empty() ? Point{} : points[0],
+                Point{0, 0, 1},
+                diameters.empty() ? 0 : diameters[0] / 2};
+    }
+
+    floatType length = 0;
+    for (size_t i = 1; i < points.size(); ++i) {
+        length += morphio::euclidean_distance(points[i - 1], points[i]);
+    }
+    const floatType target = std::min<floatType>(std::max<floatType>(offset, 0), 1) * length;
+
+    const auto frameOf = [&](size_t i, floatType start, floatType h) {
+        const floatType t = std::min<floatType>(std::max<floatType>((target - start) / h, 0), 1);
+        Frame frame;
+        for (size_t k = 0; k < 3; ++k) {
+            frame.position[k] = points[i][k] + t * (points[i + 1][k] - points[i][k]);
+            frame.tangent[k] = (points[i + 1][k] - points[i][k]) / h;
+        }
+        frame.radius = (diameters[i] + t * (diameters[i + 1] - diameters[i])) / 2;
+        return frame;
+    };
+
+    // the non null segment containing the target
+    floatType start = 0;
+    size_t last = points.size();
+    floatType lastStart = 0;
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        const floatType h = morphio::euclidean_distance(points[i], points[i + 1]);
+        if (h <= 0) {
+            continue;
+        }
+        if (start + h >= target) {
+            return frameOf(i, start, h);
+        }
+        last = i;
+        lastStart = start;
+        start += h;
+    }
+    if (last < points.size()) {
+        return frameOf(last, lastStart, start - lastStart);
+    }
+    // all the points are at the same place
+    return {points[0], Point{0, 0, 1}, diameters[0] / 2};
+}
+
+/** Direction normal to `tangent`, at `angle` from the reference direction */
+Point normalAt(const Point& tangent, floatType angle) {
+    // the world axis the least aligned with the tangent
+    size_t axis = 0;
+    for (size_t k = 1; k < 3; ++k) {
+        if (std::abs(tangent[k]) < std::abs(tangent[axis])) {
+            axis = k;
+        }
+    }
+    Point world{0, 0, 0};
+    world[axis] = 1;
+    const Point reference = normalized(cross(tangent, world), Point{1, 0, 0});
+    const Point binormal = cross(tangent, reference);
+    const floatType c = std::cos(angle);
+    const floatType s = std::sin(angle);
+    return {c * reference[0] + s * binormal[0],
+            c * reference[1] + s * binormal[1],
+            c * reference[2] + s * binormal[2]};
+}
+
+}  // namespace
+
+namespace morphio {
+namespace spines {
+
+SpineLibrary::SpineLibrary(const std::vector<DendriticSpine>& spines) {
+    for (const auto& spine : spines) {
+        const auto& densities = spine.postSynapticDensity();
+        if (densities.empty()) {
+            addSpine(spine, nullptr);
+            continue;
+        }
+        // the density is at `offset` (fraction) of the segment `segmentId` of its section
+        const auto& density = densities.front();
+        const auto points = spine.section(static_cast<uint32_t>(density.sectionId)).points();
+        const auto segment = static_cast<size_t>(density.segmentId);
+        if (segment >= points.size()) {
+            throw RawDataError("Post synaptic density out of its section");
+        }
+        Point head = points[segment];
+        if (segment + 1 < points.size()) {
+            const floatType t = std::min<floatType>(std::max<floatType>(density.offset, 0), 1);
+            for (size_t k = 0; k < 3; ++k) {
+                head[k] += t * (points[segment + 1][k] - points[segment][k]);
+            }
+        }
+        addSpine(spine, &head);
+    }
+}
+
+SpineLibrary::SpineLibrary(const std::vector<Morphology>& spines) {
+    for (const auto& spine : spines) {
+        addSpine(spine, nullptr);
+    }
+}
+
+void SpineLibrary::addSpine(const Morphology& spine, const Point* head) {
+    const auto roots = spine.rootSections();
+    if (roots.empty() || roots.front().points().empty()) {
+        throw RawDataError("A spine must have at least one point");
+    }
+    const Point root = roots.front().points()[0];
+
+    Point axis{0, 0, 0};
+    if (head != nullptr) {
+        axis = subtract(*head, root);
+    }
+    if (dot(axis, axis) < epsilon * epsilon) {
+        floatType farthest = 0;
+        for (const auto& point : spine.points()) {
+            const Point delta = subtract(point, root);
+            if (dot(delta, delta) > farthest) {
+                farthest = dot(delta, delta);
+                axis = delta;
+            }
+        }
+    }
+
+    spines_.push_back(spine);
+    roots_.push_back(root);
+    axes_.push_back(normalized(axis, Point{0, 1, 0}));
+}
+
+Points SpineLibrary::points(const PlacedSpine& placed) const {
+    const auto& source = spine(placed.spine).points();
+    Points points;
+    points.reserve(source.size());
+    for (const auto& point : source) {
+        points.push_back(placed.transform.apply(point));
+    }
+    return points;
+}
+
+mut::Morphology SpineLibrary::instantiate(const PlacedSpine& placed) const {
+    mut::Morphology morphology(spine(placed.spine));
+    for (const auto& section : morphology.sections()) {
+        for (auto& point : section.second->points()) {
+            point = placed.transform.apply(point);
+        }
+    }
+    for (auto& point : morphology.soma()->points()) {
+        point = placed.transform.apply(point);
+    }
+    return morphology;
+}
+
+std::vector<PlacedSpine> place(const Morphology& morphology,
+                               const SpineLibrary& library,
+                               const std::vector<SpineLocation>& locations,
+                               unsigned int nThreads) {
+    const size_t nSections = morphology.sectionTypes().size();
+    for (const auto& location : locations) {
+        if (location.spine >= library.size()) {
+            throw RawDataError("Spine " + std::to_string(location.spine) +
+                               " is not in the library");
+        }
+        if (location.section >= nSections) {
+            throw RawDataError("Section " + std::to_string(location.section) +
+                               " is not in the morphology");
+        }
+    }
+
+    std::vector<PlacedSpine> placed(locations.size());
+    details::parallelFor(
+        locations.size(),
+        [&](size_t i) {
+            const SpineLocation& location = locations[i];
+            const Frame frame = frameAt(morphology.section(location.section), location.offset);
+            const Point normal = normalAt(frame.tangent, location.angle);
+
+            PlacedSpine& spine = placed[i];
+            spine.spine = location.spine;
+            spine.section = location.section;
+            spine.offset = location.offset;
+            spine.transform.rotation = morphio::alignment(library.axes()[location.spine], normal);
+            spine.transform.translation = {0, 0, 0};
+            const Point root = spine.transform.apply(library.roots()[location.spine]);
+            for (size_t k = 0; k < 3; ++k) {
+                spine.transform.translation[k] = frame.position[k] + frame.radius * normal[k] -
+                                                 root[k];
+            }
+        },
+        nThreads);
+    return placed;
+}
+
+}  // namespace spines
+}  // namespace morphio
@@ -0,0 +1,88 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::max
+#include <cmath>      // std::sqrt
+
+#include <morphio/subtree.h>
+
+#include "point_utils.h"  // euclidean_distance
+
+namespace morphio {
+namespace subtree {
+
+Aggregates aggregates(const Morphology& morphology) {
+    const auto& points = morphology.points();
+    const auto& diameters = morphology.diameters();
+    const auto& connectivity = morphology.connectivity();
+    const std::vector<uint64_t> offsets = morphology.sectionOffsets();
+    const size_t nSections = offsets.size() - 1;
+
+    Aggregates result;
+    result.length.assign(nSections, 0);
+    result.area.assign(nSections, 0);
+    result.volume.assign(nSections, 0);
+    result.tips.assign(nSections, 0);
+    result.bifurcations.assign(nSections, 0);
+    result.maxPathLength.assign(nSections, 0);
+
+    // parents before their children
+    std::vector<int32_t> parents(nSections, -1);
+    std::vector<uint32_t> order;
+    order.reserve(nSections);
+    const auto roots = connectivity.find(-1);
+    if (roots != connectivity.end()) {
+        order.assign(roots->second.begin(), roots->second.end());
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto children = connectivity.find(static_cast<int>(order[i]));
+        if (children == connectivity.end()) {
+            continue;
+        }
+        for (const uint32_t child : children->second) {
+            parents[child] = static_cast<int32_t>(order[i]);
+            order.push_back(child);
+        }
+    }
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        const uint32_t id = *it;
+        floatType length = 0;
+        floatType area = 0;
+        floatType volume = 0;
+        for (uint64_t i = offsets[id]; i + 1 < offsets[id + 1]; ++i) {
+            const floatType h = euclidean_distance(points[i], points[i + 1]);
+            const floatType r0 = diameters[i] / 2;
+            const floatType r1 = diameters[i + 1] / 2;
+            length += h;
+            area += PI * (r0 + r1) * std::sqrt(h * h + (r1 - r0) * (r1 - r0));
+            volume += PI * h * (r0 * r0 + r0 * r1 + r1 * r1) / 3;
+        }
+
+        const auto children = connectivity.find(static_cast<int>(id));
+        const size_t nChildren = children == connectivity.end() ? 0 : children->second.size();
+        // the children were visited already
+        result.length[id] += length;
+        result.area[id] += area;
+        result.volume[id] += volume;
+        result.tips[id] += nChildren == 0 ? 1 : 0;
+        result.bifurcations[id] += nChildren >= 2 ? 1 : 0;
+        result.maxPathLength[id] += length;
+
+        if (parents[id] != -1) {
+            const auto parent = static_cast<size_t>(parents[id]);
+            result.length[parent] += result.length[id];
+            result.area[parent] += result.area[id];
+            result.volume[parent] += result.volume[id];
+            result.tips[parent] += result.tips[id];
+            result.bifurcations[parent] += result.bifurcations[id];
+            result.maxPathLength[parent] = std::max(result.maxPathLength[parent],
+                                                    result.maxPathLength[id]);
+        }
+    }
+    return result;
+}
+
+}  // namespace subtree
+}  // namespace morphio
@@ -0,0 +1,230 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <algorithm>  // std::min
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>    // size_t
+#include <cstdint>    // uint32_t
+#include <deque>
+#include <exception>  // std::exception_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace morphio {
+namespace details {
+
+/**
+ * Number of worker threads to use for `nTasks` independent tasks.
+ *
+ * A value of 0 for `nThreads` means: use as many threads as there are hardware threads.
+ */
+inline unsigned int threadCount(unsigned int nThreads, size_t nTasks) {
+    if (nThreads == 0) {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    return static_cast<unsigned int>(std::min<size_t>(nThreads, std::max<size_t>(nTasks, 1)));
+}
+
+/**
+ * Call `f(i)` for every `i` in [0, n) using up to `nThreads` threads.
+ *
+ * Indices are handed out dynamically, one at a time, so that tasks of uneven cost
+ * (morphologies of very different sizes) are balanced across workers. The first
+ * exception raised by a task is re-thrown in the calling thread once all workers have
+ * stopped; remaining tasks are skipped.
+ */
+template <typename F>
+void parallelFor(size_t n, const F& f, unsigned int nThreads = 0) {
+    const unsigned int nWorkers = threadCount(nThreads, n);
+    if (nWorkers <= 1) {
+        for (size_t i = 0; i < n; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < n && !failed; i = next++) {
+            try {
+                f(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.exchange(true)) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nWorkers - 1);
+    for (unsigned int i = 1; i < nWorkers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Call `f(i)` for every node `i` in [0, n) using up to `nThreads` threads, only once `f` returned
+ * for all the nodes `i` depends on.
+ *
+ * `dependents[i]` are the nodes waiting for `i`, and `nDependencies[i]` the number of nodes `i`
+ * waits for; the dependencies must not have cycles. Every worker has its own queue of ready
+ * nodes: it runs the nodes it made ready last first, so that it stays in the same subtree, and
+ * when it runs out it steals the oldest ready node of another worker, the root of the largest
+ * subtree left; if there is none, it sleeps until other nodes are ready. Exceptions are handled
+ * as in `parallelFor`.
+ */
+template <typename F>
+void parallelForGraph(const std::vector<std::vector<uint32_t>>& dependents,
+                      const std::vector<uint32_t>& nDependencies,
+                      const F& f,
+                      unsigned int nThreads = 0) {
+    const size_t n = nDependencies.size();
+    std::vector<uint32_t> ready;
+    for (size_t i = 0; i < n; ++i) {
+        if (nDependencies[i] == 0) {
+            ready.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    const unsigned int nWorkers = threadCount(nThreads, n);
+    if (nWorkers <= 1) {
+        std::vector<uint32_t> remaining(nDependencies);
+        std::vector<uint32_t> stack(ready.rbegin(), ready.rend());
+        while (!stack.empty()) {
+            const uint32_t i = stack.back();
+            stack.pop_back();
+            f(i);
+            for (const uint32_t dependent : dependents[i]) {
+                if (--remaining[dependent] == 0) {
+                    stack.push_back(dependent);
+                }
+            }
+        }
+        return;
+    }
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<uint32_t> nodes;
+    };
+    std::vector<Queue> queues(nWorkers);
+    // consecutive ready nodes (siblings, leaves of the same subtree) go to the same worker
+    for (size_t k = 0; k < ready.size(); ++k) {
+        queues[k * nWorkers / ready.size()].nodes.push_back(ready[k]);
+    }
+
+    std::vector<std::atomic<uint32_t>> remaining(n);
+    for (size_t i = 0; i < n; ++i) {
+        remaining[i] = nDependencies[i];
+    }
+    std::atomic<size_t> done(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    // Idle workers sleep until `generation` changes: it is incremented, under `idleMutex`, when
+    // nodes are made ready for other workers, when all nodes are done and when a task fails
+    std::mutex idleMutex;
+    std::condition_variable wakeUp;
+    std::atomic<uint64_t> generation(0);
+    const auto wakeAll = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            ++generation;
+        }
+        wakeUp.notify_all();
+    };
+
+    auto next = [&](unsigned int worker, uint32_t& node) {
+        {
+            std::lock_guard<std::mutex> lock(queues[worker].mutex);
+            auto& own = queues[worker].nodes;
+            if (!own.empty()) {
+                node = own.back();
+                own.pop_back();
+                return true;
+            }
+        }
+        for (unsigned int k = 1; k < nWorkers; ++k) {
+            auto& victim = queues[(worker + k) % nWorkers];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.nodes.empty()) {
+                node = victim.nodes.front();
+                victim.nodes.pop_front();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto worker = [&](unsigned int id) {
+        while (done < n && !failed) {
+            // read before looking for a node, so that nodes made ready meanwhile are not missed
+            const uint64_t seen = generation;
+            uint32_t node = 0;
+            if (!next(id, node)) {
+                std::unique_lock<std::mutex> lock(idleMutex);
+                wakeUp.wait(lock, [&]() { return generation != seen || done == n || failed; });
+                continue;
+            }
+            bool taskFailed = false;
+            try {
+                f(node);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.exchange(true)) {
+                    error = std::current_exception();
+                }
+                taskFailed = true;
+            }
+            size_t madeReady = 0;
+            for (const uint32_t dependent : dependents[node]) {
+                if (--remaining[dependent] == 0) {
+                    std::lock_guard<std::mutex> lock(queues[id].mutex);
+                    queues[id].nodes.push_back(dependent);
+                    ++madeReady;
+                }
+            }
+            // this worker runs one of the nodes it made ready itself
+            if (++done == n || taskFailed || madeReady > 1) {
+                wakeAll();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nWorkers - 1);
+    for (unsigned int i = 1; i < nWorkers; ++i) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace details
+}  // namespace morphio
@@ -0,0 +1,168 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cmath>  // std::fabs
+
+#include <morphio/tmd.h>
+
+#include "point_utils.h"
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::floatType;
+using morphio::tmd::Bar;
+using morphio::tmd::Barcode;
+
+/**
+ * Return the ids of the sections of the neurite starting at `root`, parents before children.
+ *
+ * The parent of each visited section is stored in `parents`.
+ */
+std::vector<uint32_t> preorder(uint32_t root,
+                               const std::map<int, std::vector<unsigned int>>& children,
+                               std::vector<uint32_t>& parents) {
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> stack{root};
+    while (!stack.empty()) {
+        const uint32_t id = stack.back();
+        stack.pop_back();
+        order.push_back(id);
+
+        const auto it = children.find(static_cast<int>(id));
+        if (it != children.end()) {
+            for (const unsigned int child : it->second) {
+                parents[child] = id;
+            }
+            stack.insert(stack.end(), it->second.rbegin(), it->second.rend());
+        }
+    }
+    return order;
+}
+
+void neuriteBarcode(uint32_t root,
+                    const morphio::Morphology& morphology,
+                    const std::vector<uint64_t>& offsets,
+                    morphio::tmd::Filtration filtration,
+                    std::vector<uint32_t>& parents,
+                    std::vector<floatType>& distance,
+                    std::vector<floatType>& value,
+                    Barcode& barcode) {
+    const auto& points = morphology.points();
+    const auto& sections = morphology.connectivity();
+    const std::vector<uint32_t> order = preorder(root, sections, parents);
+    const morphio::Point& origin = points[offsets[root]];
+
+    // Filtration value at the last point of each section; parents are visited first so their
+    // path distance is already cached
+    for (const uint32_t id : order) {
+        const uint64_t last = offsets[id + 1] - 1;
+        if (filtration == morphio::tmd::RADIAL_DISTANCE) {
+            distance[id] = morphio::euclidean_distance(points[last], origin);
+        } else {
+            floatType length = 0;
+            for (uint64_t i = offsets[id]; i < last; ++i) {
+                length += morphio::euclidean_distance(points[i], points[i + 1]);
+            }
+            distance[id] = length + (id == root ? 0 : distance[parents[id]]);
+        }
+    }
+
+    // Postorder reduction: each branching point keeps the component of its longest-lived
+    // child alive, all the other children die at the branching point
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        const uint32_t id = *it;
+        const auto children = sections.find(static_cast<int>(id));
+        if (children == sections.end() || children->second.empty()) {
+            value[id] = distance[id];
+            continue;
+        }
+
+        const auto& ids = children->second;
+        unsigned int survivor = ids.front();
+        for (const unsigned int child : ids) {
+            if (std::fabs(value[child]) > std::fabs(value[survivor])) {
+                survivor = child;
+            }
+        }
+        for (const unsigned int child : ids) {
+            if (child != survivor) {
+                barcode.push_back(Bar{value[child], distance[id]});
+            }
+        }
+        value[id] = value[survivor];
+    }
+
+    barcode.push_back(Bar{value[root], 0});
+}
+
+}  // namespace
+
+namespace morphio {
+namespace tmd {
+
+Barcode persistenceBarcode(const Morphology& morphology,
+                           SectionType neuriteType,
+                           Filtration filtration) {
+    Barcode barcode;
+    const auto& types = morphology.sectionTypes();
+    const auto& connectivity = morphology.connectivity();
+    const auto roots = connectivity.find(-1);
+    if (roots == connectivity.end()) {
+        return barcode;
+    }
+
+    const std::vector<uint64_t> offsets = morphology.sectionOffsets();
+    std::vector<uint32_t> parents(types.size());
+    std::vector<floatType> distance(types.size());
+    std::vector<floatType> value(types.size());
+
+    for (const unsigned int root : roots->second) {
+        if (neuriteType == SECTION_ALL || types[root] == neuriteType) {
+            neuriteBarcode(
+                root, morphology, offsets, filtration, parents, distance, value, barcode);
+        }
+    }
+
+    return barcode;
+}
+
+std::vector<Barcode> persistenceBarcodes(const std::vector<Morphology>& morphologies,
+                                         SectionType neuriteType,
+                                         Filtration filtration,
+                                         unsigned int nThreads) {
+    std::vector<Barcode> barcodes(morphologies.size());
+    details::parallelFor(
+        morphologies.size(),
+        [&](size_t i) {
+            barcodes[i] = persistenceBarcode(morphologies[i], neuriteType, filtration);
+        },
+        nThreads);
+    return barcodes;
+}
+
+std::vector<Barcode> persistenceBarcodes(const Collection& collection,
+                                         const std::vector<std::string>& morphologyNames,
+                                         SectionType neuriteType,
+                                         Filtration filtration,
+                                         unsigned int options,
+                                         unsigned int nThreads) {
+    // Visit the morphologies in the order suggested by the collection, so that concurrent
+    // reads from containers stay close to each other in the file
+    const std::vector<size_t> order = collection.argsort(morphologyNames);
+
+    std::vector<Barcode> barcodes(morphologyNames.size());
+    details::parallelFor(
+        order.size(),
+        [&](size_t k) {
+            const size_t i = order[k];
+            const auto morphology = collection.load<Morphology>(morphologyNames[i], options);
+            barcodes[i] = persistenceBarcode(morphology, neuriteType, filtration);
+        },
+        nThreads);
+    return barcodes;
+}
+
+}  // namespace tmd
+}  // namespace morphio
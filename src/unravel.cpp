@@ -0,0 +1,308 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::min, std::max
+#include <cmath>      // std::abs, std::sqrt
+#include <limits>
+#include <string>     // std::to_string
+
+#include <morphio/exceptions.h>
+#include <morphio/properties.h>
+#include <morphio/unravel.h>
+
+#include "morphology_access.h"
+#include "point_utils.h"  // alignment, dot, subtract
+#include "thread_utils.hpp"
+
+namespace {
+
+using morphio::dot;
+using morphio::floatType;
+using morphio::Point;
+
+/**
+ * Unit eigenvector of the largest eigenvalue of the covariance of the points, with Jacobi
+ * rotations; the null vector if the points are all the same
+ */
+Point principalDirection(const Point* points, size_t count) {
+    std::array<double, 3> mean{0, 0, 0};
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t k = 0; k < 3; ++k) {
+            mean[k] += static_cast<double>(points[i][k]);
+        }
+    }
+    for (auto& value : mean) {
+        value /= static_cast<double>(count);
+    }
+
+    std::array<std::array<double, 3>, 3> a{};
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t k = 0; k < 3; ++k) {
+                a[j][k] += (static_cast<double>(points[i][j]) - mean[j]) *
+                           (static_cast<double>(points[i][k]) - mean[k]);
+            }
+        }
+    }
+    std::array<std::array<double, 3>, 3> v{{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        const double offDiagonal = std::abs(a[0][1]) + std::abs(a[0][2]) + std::abs(a[1][2]);
+        if (offDiagonal <= 1e-12 * (std::abs(a[0][0]) + std::abs(a[1][1]) + std::abs(a[2][2]))) {
+            break;
+        }
+        for (size_t p = 0; p < 2; ++p) {
+            for (size_t q = p + 1; q < 3; ++q) {
+                if (a[p][q] == 0) {
+                    continue;
+                }
+                const double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                const double t = (theta >= 0 ? 1 : -1) /
+                                 (std::abs(theta) + std::sqrt(theta * theta + 1));
+                const double c = 1 / std::sqrt(t * t + 1);
+                const double s = t * c;
+                for (size_t k = 0; k < 3; ++k) {
+                    const double akp = a[k][p];
+                    const double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < 3; ++k) {
+                    const double apk = a[p][k];
+                    const double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < 3; ++k) {
+                    const double vkp = v[k][p];
+                    const double vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    size_t largest = 0;
+    for (size_t k = 1; k < 3; ++k) {
+        if (a[k][k] > a[largest][largest]) {
+            largest = k;
+        }
+    }
+    if (a[largest][largest] <= 0) {
+        return {0, 0, 0};
+    }
+    return {static_cast<floatType>(v[0][largest]),
+            static_cast<floatType>(v[1][largest]),
+            static_cast<floatType>(v[2][largest])};
+}
+
+/**
+ * The unravelled segments of a section, as positions relative to its first point
+ *
+ * The window around segment (i - 1, i) is made of the points [i - h - 1, i + h] of the section.
+ */
+void unravelSection(const Point* points, size_t count, size_t halfLength, Point* relative) {
+    relative[0] = {0, 0, 0};
+    for (size_t i = 1; i < count; ++i) {
+        const size_t begin = i > halfLength + 1 ? i - halfLength - 1 : 0;
+        const size_t end = std::min(count, i + halfLength + 1);
+        const Point segment = morphio::subtract(points[i], points[i - 1]);
+        const floatType length = std::sqrt(dot(segment, segment));
+
+        Point direction = principalDirection(points + begin, end - begin);
+        const auto projection = static_cast<double>(dot(segment, direction));
+        if (projection == 0 || length == 0) {
+            // keep segments orthogonal to the window (or null) as they are
+            direction = length == 0 ? Point{0, 0, 0}
+                                    : Point{segment[0] / length,
+                                            segment[1] / length,
+                                            segment[2] / length};
+        } else if (projection < 0) {
+            direction = {-direction[0], -direction[1], -direction[2]};
+        }
+        for (size_t k = 0; k < 3; ++k) {
+            relative[i][k] = relative[i - 1][k] + length * direction[k];
+        }
+    }
+}
+
+}  // namespace
+
+namespace morphio {
+namespace unravel {
+
+Unravelled::Unravelled(const Morphology& morphology,
+                       size_t windowHalfLength,
+                       unsigned int nThreads)
+    : original_(morphology)
+    , morphology_(morphology)
+    , offsets_(morphology.sectionOffsets()) {
+    const auto& source = details::MorphologyAccess::properties(morphology);
+    morphio::Property::Properties properties = source;
+    // rebuilt by the Morphology constructor
+    properties._sectionLevel._children.clear();
+    properties._mitochondriaSectionLevel._children.clear();
+
+    const auto& sections = properties._sectionLevel._sections;
+    const auto& points = source._pointLevel._points;
+    auto& unravelled = properties._pointLevel._points;
+    const size_t nSections = sections.size();
+    const auto sectionBegin = [&](size_t section) {
+        return static_cast<size_t>(sections[section][0]);
+    };
+    const auto sectionEnd = [&](size_t section) {
+        return section + 1 < nSections ? sectionBegin(section + 1) : points.size();
+    };
+
+    details::parallelFor(
+        nSections,
+        [&](size_t section) {
+            const size_t begin = sectionBegin(section);
+            const size_t end = sectionEnd(section);
+            if (end > begin) {
+                unravelSection(&points[begin], end - begin, windowHalfLength, &unravelled[begin]);
+            }
+        },
+        nThreads);
+
+    // attach the sections to the end of their parents, parents first
+    std::vector<std::vector<uint32_t>> children(nSections);
+    std::vector<uint32_t> stack;
+    for (size_t section = 0; section < nSections; ++section) {
+        const auto parent = static_cast<int32_t>(sections[section][1]);
+        if (parent == -1) {
+            stack.push_back(static_cast<uint32_t>(section));
+        } else {
+            children[static_cast<size_t>(parent)].push_back(static_cast<uint32_t>(section));
+        }
+    }
+    while (!stack.empty()) {
+        const uint32_t section = stack.back();
+        stack.pop_back();
+        stack.insert(stack.end(), children[section].begin(), children[section].end());
+
+        const size_t begin = sectionBegin(section);
+        const size_t end = sectionEnd(section);
+        if (end == begin) {
+            continue;
+        }
+        Point anchor = points[begin];
+        const auto parent = static_cast<int32_t>(sections[section][1]);
+        if (parent != -1) {
+            const auto parentId = static_cast<size_t>(parent);
+            if (sectionEnd(parentId) > sectionBegin(parentId)) {
+                // keep the gap between the parent and the section, if any
+                const size_t last = sectionEnd(parentId) - 1;
+                for (size_t k = 0; k < 3; ++k) {
+                    anchor[k] = unravelled[last][k] + points[begin][k] - points[last][k];
+                }
+            }
+        }
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t k = 0; k < 3; ++k) {
+                unravelled[i][k] += anchor[k];
+            }
+        }
+    }
+
+    morphology_ = details::MorphologyAccess::fromProperties(properties);
+}
+
+Point Unravelled::map(const Point& position, uint32_t section) const {
+    if (static_cast<size_t>(section) + 1 >= offsets_.size()) {
+        throw RawDataError("Unravel: section " + std::to_string(section) + " does not exist");
+    }
+    const auto& points = original_.points();
+    const auto& unravelled = morphology_.points();
+    const auto begin = static_cast<size_t>(offsets_[section]);
+    const auto end = static_cast<size_t>(offsets_[section + 1]);
+    if (end == begin) {
+        return position;
+    }
+    if (end - begin == 1) {
+        Point result;
+        for (size_t k = 0; k < 3; ++k) {
+            result[k] = position[k] + unravelled[begin][k] - points[begin][k];
+        }
+        return result;
+    }
+
+    // closest segment, and the position of the projection along it
+    size_t closest = begin;
+    double closestT = 0;
+    double closestDistance = std::numeric_limits<double>::max();
+    for (size_t i = begin; i + 1 < end; ++i) {
+        const Point segment = subtract(points[i + 1], points[i]);
+        const Point relative = subtract(position, points[i]);
+        const auto squaredLength = static_cast<double>(dot(segment, segment));
+        double t = 0;
+        if (squaredLength > 0) {
+            t = static_cast<double>(dot(relative, segment)) / squaredLength;
+            t = std::min(1.0, std::max(0.0, t));
+        }
+        double distance = 0;
+        for (size_t k = 0; k < 3; ++k) {
+            const double delta = static_cast<double>(relative[k]) -
+                                 t * static_cast<double>(segment[k]);
+            distance += delta * delta;
+        }
+        if (distance < closestDistance) {
+            closest = i;
+            closestT = t;
+            closestDistance = distance;
+        }
+    }
+
+    const Point segment = subtract(points[closest + 1], points[closest]);
+    const Point newSegment = subtract(unravelled[closest + 1], unravelled[closest]);
+    const floatType length = std::sqrt(dot(segment, segment));
+    const auto t = static_cast<floatType>(closestT);
+    Point offset;
+    for (size_t k = 0; k < 3; ++k) {
+        offset[k] = position[k] - (points[closest][k] + t * segment[k]);
+    }
+
+    Point result;
+    for (size_t k = 0; k < 3; ++k) {
+        result[k] = unravelled[closest][k] + t * newSegment[k];
+    }
+    if (length > 0) {
+        // unravelled segments have the same length
+        const Point from{segment[0] / length, segment[1] / length, segment[2] / length};
+        const Point to{newSegment[0] / length, newSegment[1] / length, newSegment[2] / length};
+        const auto rotation = alignment(from, to);
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t k = 0; k < 3; ++k) {
+                result[i] += rotation[i][k] * offset[k];
+            }
+        }
+    } else {
+        for (size_t k = 0; k < 3; ++k) {
+            result[k] += offset[k];
+        }
+    }
+    return result;
+}
+
+Points Unravelled::map(const Points& positions,
+                       const std::vector<uint32_t>& sections,
+                       unsigned int nThreads) const {
+    if (positions.size() != sections.size()) {
+        throw RawDataError("Unravel: there must be one section per position");
+    }
+    Points result(positions.size());
+    details::parallelFor(
+        positions.size(),
+        [&](size_t i) { result[i] = map(positions[i], sections[i]); },
+        nThreads);
+    return result;
+}
+
+Morphology unravel(const Morphology& morphology, size_t windowHalfLength, unsigned int nThreads) {
+    return Unravelled(morphology, windowHalfLength, nThreads).morphology();
+}
+
+}  // namespace unravel
+}  // namespace morphio
@@ -0,0 +1,503 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::nth_element, std::push_heap, std::sort
+#include <cmath>      // std::sqrt
+#include <limits>
+#include <utility>    // std::swap
+
+#include <morphio/exceptions.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+#include <morphio/vasc/proximity.h>
+
+#include "../point_utils.h"  // boxDistance, euclidean_distance
+#include "../thread_utils.hpp"
+
+namespace {
+
+using morphio::floatType;
+using morphio::Point;
+using morphio::vasculature::ProximityIndex;
+using morphio::vasculature::SegmentHit;
+using Capsule = ProximityIndex::Capsule;
+
+constexpr uint32_t LEAF_SIZE = 4;
+
+void boxOf(const Capsule& capsule, Point& min, Point& max) {
+    for (size_t k = 0; k < 3; ++k) {
+        min[k] = std::min(capsule.a[k] - capsule.ra, capsule.b[k] - capsule.rb);
+        max[k] = std::max(capsule.a[k] + capsule.ra, capsule.b[k] + capsule.rb);
+    }
+}
+
+/**
+ * Distance between the surfaces of two capsules, from the closest points of their axes
+ * (Ericson, Real-Time Collision Detection, 5.1.9), computed in double precision
+ */
+floatType capsuleDistance(const Capsule& p, const Capsule& q) {
+    double d1[3], d2[3], r[3];
+    for (size_t k = 0; k < 3; ++k) {
+        d1[k] = double(p.b[k]) - double(p.a[k]);
+        d2[k] = double(q.b[k]) - double(q.a[k]);
+        r[k] = double(p.a[k]) - double(q.a[k]);
+    }
+    const auto dot = [](const double* u, const double* v) {
+        return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+    };
+    const auto clamp = [](double x) { return std::min(1., std::max(0., x)); };
+
+    const double a = dot(d1, d1);
+    const double e = dot(d2, d2);
+    const double f = dot(d2, r);
+    const double epsilon = 1e-12;
+    double s = 0;
+    double t = 0;
+    if (a <= epsilon && e <= epsilon) {
+        s = t = 0;
+    } else if (a <= epsilon) {
+        t = clamp(f / e);
+    } else {
+        const double c = dot(d1, r);
+        if (e <= epsilon) {
+            s = clamp(-c / a);
+        } else {
+            const double b = dot(d1, d2);
+            const double denominator = a * e - b * b;
+            s = denominator > 0 ? clamp((b * f - c * e) / denominator) : 0;
+            t = (b * s + f) / e;
+            if (t < 0) {
+                t = 0;
+                s = clamp(-c / a);
+            } else if (t > 1) {
+                t = 1;
+                s = clamp((b - c) / a);
+            }
+        }
+    }
+
+    double squared = 0;
+    for (size_t k = 0; k < 3; ++k) {
+        const double delta = r[k] + d1[k] * s - d2[k] * t;
+        squared += delta * delta;
+    }
+    const double radii = double(p.ra) + (double(p.rb) - double(p.ra)) * s + double(q.ra) +
+                         (double(q.rb) - double(q.ra)) * t;
+    return static_cast<floatType>(std::max(0., std::sqrt(squared) - radii));
+}
+
+/** Whether a point of the axis of the capsule is in the box, clipping it against the slabs */
+bool axisInBox(const Capsule& capsule, const Point& min, const Point& max) {
+    double enter = 0;
+    double exit = 1;
+    for (size_t k = 0; k < 3; ++k) {
+        const auto a = static_cast<double>(capsule.a[k]);
+        const double delta = static_cast<double>(capsule.b[k]) - a;
+        const auto lower = static_cast<double>(min[k]);
+        const auto upper = static_cast<double>(max[k]);
+        if (delta == 0) {
+            if (a < lower || a > upper) {
+                return false;
+            }
+            continue;
+        }
+        double t0 = (lower - a) / delta;
+        double t1 = (upper - a) / delta;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+        if (enter > exit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool closer(const SegmentHit& left, const SegmentHit& right) {
+    if (left.distance != right.distance) {
+        return left.distance < right.distance;
+    }
+    return left.section != right.section ? left.section < right.section
+                                         : left.segment < right.segment;
+}
+
+}  // namespace
+
+namespace morphio {
+namespace vasculature {
+
+ProximityIndex::ProximityIndex(const Vasculature& vasculature)
+    : ProximityIndex(vasculature.points(), vasculature.diameters(), vasculature.sectionOffsets()) {
+}
+
+ProximityIndex::ProximityIndex(const Points& points,
+                               const std::vector<floatType>& diameters,
+                               const std::vector<uint64_t>& sectionOffsets) {
+    if (points.size() != diameters.size()) {
+        throw MorphioError("Vasculature index: there must be as many diameters as points");
+    }
+    if (!sectionOffsets.empty() && sectionOffsets.back() != points.size()) {
+        throw MorphioError(
+            "Vasculature index: the last section offset must be the number of points");
+    }
+    for (size_t i = 0; i + 1 < sectionOffsets.size(); ++i) {
+        if (sectionOffsets[i] > sectionOffsets[i + 1]) {
+            throw MorphioError("Vasculature index: section offsets must be sorted");
+        }
+        for (uint64_t p = sectionOffsets[i]; p + 1 < sectionOffsets[i + 1]; ++p) {
+            segments_.push_back({points[p], points[p + 1], diameters[p] / 2, diameters[p + 1] / 2});
+            sections_.push_back(static_cast<uint32_t>(i));
+            indices_.push_back(static_cast<uint32_t>(p - sectionOffsets[i]));
+        }
+    }
+    if (segments_.size() > std::numeric_limits<uint32_t>::max()) {
+        throw MorphioError("Vasculature index: more than 2^32 segments are not supported");
+    }
+    build();
+}
+
+void ProximityIndex::build() {
+    const auto count = static_cast<uint32_t>(segments_.size());
+    if (count == 0) {
+        return;
+    }
+
+    // `order` is permuted so that every node covers a contiguous range of it
+    std::vector<uint32_t> order(count);
+    std::vector<Point> mins(count);
+    std::vector<Point> maxs(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        order[i] = i;
+        boxOf(segments_[i], mins[i], maxs[i]);
+    }
+
+    nodes_.reserve(2 * (count / LEAF_SIZE + 1));
+    nodes_.push_back({{}, {}, 0, count});
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const uint32_t n = stack.back();
+        stack.pop_back();
+        const uint32_t first = nodes_[n].first;
+        const uint32_t size = nodes_[n].count;
+
+        Point min = mins[order[first]];
+        Point max = maxs[order[first]];
+        for (uint32_t i = first + 1; i < first + size; ++i) {
+            for (size_t k = 0; k < 3; ++k) {
+                min[k] = std::min(min[k], mins[order[i]][k]);
+                max[k] = std::max(max[k], maxs[order[i]][k]);
+            }
+        }
+        nodes_[n].min = min;
+        nodes_[n].max = max;
+        if (size <= LEAF_SIZE) {
+            continue;
+        }
+
+        // split at the median of the box centers, along the longest axis
+        size_t axis = 0;
+        for (size_t k = 1; k < 3; ++k) {
+            if (max[k] - min[k] > max[axis] - min[axis]) {
+                axis = k;
+            }
+        }
+        const uint32_t half = size / 2;
+        std::nth_element(order.begin() + first,
+                         order.begin() + first + half,
+                         order.begin() + first + size,
+                         [&](uint32_t left, uint32_t right) {
+                             return mins[left][axis] + maxs[left][axis] <
+                                    mins[right][axis] + maxs[right][axis];
+                         });
+        const auto child = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back({{}, {}, first, half});
+        nodes_.push_back({{}, {}, first + half, size - half});
+        nodes_[n].first = child;
+        nodes_[n].count = 0;
+        stack.push_back(child + 1);
+        stack.push_back(child);
+    }
+
+    // store the segments in the order of the leaves, for locality
+    std::vector<Capsule> segments(count);
+    std::vector<uint32_t> sections(count);
+    std::vector<uint32_t> indices(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        segments[i] = segments_[order[i]];
+        sections[i] = sections_[order[i]];
+        indices[i] = indices_[order[i]];
+    }
+    segments_.swap(segments);
+    sections_.swap(sections);
+    indices_.swap(indices);
+}
+
+bool ProximityIndex::nearestSegment(const Capsule& query, SegmentHit& hit) const {
+    if (nodes_.empty()) {
+        return false;
+    }
+    Point min;
+    Point max;
+    boxOf(query, min, max);
+
+    hit.distance = std::numeric_limits<floatType>::infinity();
+    std::vector<std::pair<floatType, uint32_t>> stack{{0, 0}};
+    while (!stack.empty()) {
+        const auto top = stack.back();
+        stack.pop_back();
+        if (top.first > hit.distance) {
+            continue;
+        }
+        const Node& node = nodes_[top.second];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const SegmentHit candidate{sections_[i],
+                                           indices_[i],
+                                           capsuleDistance(query, segments_[i])};
+                if (closer(candidate, hit)) {
+                    hit = candidate;
+                }
+            }
+            continue;
+        }
+        // visit the closest child first
+        const Node& left = nodes_[node.first];
+        const Node& right = nodes_[node.first + 1];
+        const floatType leftDistance = boxDistance(min, max, left.min, left.max);
+        const floatType rightDistance = boxDistance(min, max, right.min, right.max);
+        if (leftDistance <= rightDistance) {
+            stack.emplace_back(rightDistance, node.first + 1);
+            stack.emplace_back(leftDistance, node.first);
+        } else {
+            stack.emplace_back(leftDistance, node.first);
+            stack.emplace_back(rightDistance, node.first + 1);
+        }
+    }
+    return true;
+}
+
+std::vector<SegmentHit> ProximityIndex::segmentsWithin(const Capsule& query,
+                                                       floatType radius) const {
+    std::vector<SegmentHit> hits;
+    if (nodes_.empty()) {
+        return hits;
+    }
+    Point min;
+    Point max;
+    boxOf(query, min, max);
+
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (boxDistance(min, max, node.min, node.max) > radius) {
+            continue;
+        }
+        if (node.count == 0) {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            const floatType distance = capsuleDistance(query, segments_[i]);
+            if (distance <= radius) {
+                hits.push_back({sections_[i], indices_[i], distance});
+            }
+        }
+    }
+    std::sort(hits.begin(), hits.end(), closer);
+    return hits;
+}
+
+std::vector<std::vector<SegmentHit>> ProximityIndex::nearest(const Points& points,
+                                                             unsigned int nThreads) const {
+    std::vector<std::vector<SegmentHit>> hits(points.size());
+    details::parallelFor(
+        points.size(),
+        [&](size_t i) {
+            SegmentHit hit{};
+            if (nearestSegment({points[i], points[i], 0, 0}, hit)) {
+                hits[i].push_back(hit);
+            }
+        },
+        nThreads);
+    return hits;
+}
+
+std::vector<std::vector<SegmentHit>> ProximityIndex::within(const Points& points,
+                                                            floatType radius,
+                                                            unsigned int nThreads) const {
+    std::vector<std::vector<SegmentHit>> hits(points.size());
+    details::parallelFor(
+        points.size(),
+        [&](size_t i) { hits[i] = segmentsWithin({points[i], points[i], 0, 0}, radius); },
+        nThreads);
+    return hits;
+}
+
+std::vector<SegmentHit> ProximityIndex::nearest(const Point& point,
+                                                size_t k,
+                                                floatType maxDistance) const {
+    // a max-heap of the k closest hits found so far
+    std::vector<SegmentHit> hits;
+    if (nodes_.empty() || k == 0) {
+        return hits;
+    }
+    const Capsule query{point, point, 0, 0};
+    const auto bound = [&]() {
+        return hits.size() < k ? maxDistance : hits.front().distance;
+    };
+
+    std::vector<std::pair<floatType, uint32_t>> stack{{0, 0}};
+    while (!stack.empty()) {
+        const auto top = stack.back();
+        stack.pop_back();
+        if (top.first > bound()) {
+            continue;
+        }
+        const Node& node = nodes_[top.second];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const SegmentHit candidate{sections_[i],
+                                           indices_[i],
+                                           capsuleDistance(query, segments_[i])};
+                if (candidate.distance > maxDistance) {
+                    continue;
+                }
+                if (hits.size() < k) {
+                    hits.push_back(candidate);
+                    std::push_heap(hits.begin(), hits.end(), closer);
+                } else if (closer(candidate, hits.front())) {
+                    std::pop_heap(hits.begin(), hits.end(), closer);
+                    hits.back() = candidate;
+                    std::push_heap(hits.begin(), hits.end(), closer);
+                }
+            }
+            continue;
+        }
+        // visit the closest child first
+        const Node& left = nodes_[node.first];
+        const Node& right = nodes_[node.first + 1];
+        const floatType leftDistance = boxDistance(point, point, left.min, left.max);
+        const floatType rightDistance = boxDistance(point, point, right.min, right.max);
+        if (leftDistance <= rightDistance) {
+            stack.emplace_back(rightDistance, node.first + 1);
+            stack.emplace_back(leftDistance, node.first);
+        } else {
+            stack.emplace_back(leftDistance, node.first);
+            stack.emplace_back(rightDistance, node.first + 1);
+        }
+    }
+    std::sort_heap(hits.begin(), hits.end(), closer);
+    return hits;
+}
+
+std::vector<SegmentHit> ProximityIndex::within(const Point& point, floatType radius) const {
+    return segmentsWithin({point, point, 0, 0}, radius);
+}
+
+std::vector<SegmentHit> ProximityIndex::inBox(const Point& min, const Point& max) const {
+    std::vector<SegmentHit> hits;
+    if (nodes_.empty()) {
+        return hits;
+    }
+
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (boxDistance(min, max, node.min, node.max) > 0) {
+            continue;
+        }
+        if (node.count == 0) {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            if (axisInBox(segments_[i], min, max)) {
+                hits.push_back({sections_[i], indices_[i], 0});
+            }
+        }
+    }
+    std::sort(hits.begin(), hits.end(), closer);
+    return hits;
+}
+
+MorphologyHits ProximityIndex::nearest(const Morphology& morphology,
+                                       const Transform& transform,
+                                       unsigned int nThreads) const {
+    return query(morphology, transform, 0, false, nThreads);
+}
+
+MorphologyHits ProximityIndex::within(const Morphology& morphology,
+                                      floatType radius,
+                                      const Transform& transform,
+                                      unsigned int nThreads) const {
+    return query(morphology, transform, radius, true, nThreads);
+}
+
+MorphologyHits ProximityIndex::query(const Morphology& morphology,
+                                     const Transform& transform,
+                                     floatType radius,
+                                     bool all,
+                                     unsigned int nThreads) const {
+    MorphologyHits result;
+    std::vector<Capsule> queries;
+
+    const Soma soma = morphology.soma();
+    const bool hasSoma = !soma.points().empty();
+    if (hasSoma) {
+        const Point center = soma.center();
+        floatType somaRadius = 0;
+        for (size_t i = 0; i < soma.points().size(); ++i) {
+            somaRadius = std::max(somaRadius,
+                                  euclidean_distance(center, soma.points()[i]) +
+                                      soma.diameters()[i] / 2);
+        }
+        const Point placed = transform.apply(center);
+        queries.push_back({placed, placed, somaRadius, somaRadius});
+    }
+
+    for (const morphio::Section& section : morphology.sections()) {
+        const auto points = section.points();
+        const auto diameters = section.diameters();
+        Point previous = points.empty() ? Point{} : transform.apply(points[0]);
+        for (size_t i = 0; i + 1 < points.size(); ++i) {
+            const Point next = transform.apply(points[i + 1]);
+            queries.push_back({previous, next, diameters[i] / 2, diameters[i + 1] / 2});
+            result.sections.push_back(section.id());
+            result.segments.push_back(static_cast<uint32_t>(i));
+            previous = next;
+        }
+    }
+
+    std::vector<std::vector<SegmentHit>> hits(queries.size());
+    details::parallelFor(
+        queries.size(),
+        [&](size_t i) {
+            if (all) {
+                hits[i] = segmentsWithin(queries[i], radius);
+                return;
+            }
+            SegmentHit hit{};
+            if (nearestSegment(queries[i], hit)) {
+                hits[i].push_back(hit);
+            }
+        },
+        nThreads);
+
+    auto first = hits.begin();
+    if (hasSoma) {
+        result.soma = std::move(hits.front());
+        ++first;
+    }
+    result.hits.assign(std::make_move_iterator(first), std::make_move_iterator(hits.end()));
+    return result;
+}
+
+}  // namespace vasculature
+}  // namespace morphio
@@ -59,16 +59,16 @@ std::vector<Section> Vasculature::sections() const {
     return sections_;
 }
 
-const std::vector<uint32_t> Vasculature::sectionOffsets() const noexcept {
+const std::vector<uint64_t> Vasculature::sectionOffsets() const noexcept {
     // Vasculature section property is a single value representing the offset
     const auto& offsets = properties_->get<property::VascSection>();
 
     const auto size = offsets.size();
-    std::vector<uint32_t> indices(size + 1);
+    std::vector<uint64_t> indices(size + 1);
 
     std::copy(offsets.begin(), offsets.end(), indices.begin());
 
-    indices[size] = static_cast<uint32_t>(this->points().size());
+    indices[size] = this->points().size();
 
     return indices;
 }
@@ -79,11 +79,49 @@ std::string WrongDuplicate::msg() const {
     return "\n" + details::errorLink(uri, 0, readers::ErrorLevel::WARNING) + oss.str();
 }
 
+WarningHandler::WarningHandler(const WarningHandler& other) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    ignoredWarnings_ = other.ignoredWarnings_;
+}
+
+WarningHandler::WarningHandler(WarningHandler&& other) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    ignoredWarnings_ = std::move(other.ignoredWarnings_);
+}
+
+WarningHandler& WarningHandler::operator=(const WarningHandler& other) {
+    if (this != &other) {
+        std::set<enums::Warning> ignored;
+        {
+            std::lock_guard<std::mutex> lock(other.mutex_);
+            ignored = other.ignoredWarnings_;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        ignoredWarnings_ = std::move(ignored);
+    }
+    return *this;
+}
+
+WarningHandler& WarningHandler::operator=(WarningHandler&& other) {
+    if (this != &other) {
+        std::set<enums::Warning> ignored;
+        {
+            std::lock_guard<std::mutex> lock(other.mutex_);
+            ignored = std::move(other.ignoredWarnings_);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        ignoredWarnings_ = std::move(ignored);
+    }
+    return *this;
+}
+
 bool WarningHandler::isIgnored(enums::Warning warning) {
+    std::lock_guard<std::mutex> lock(mutex_);
     return ignoredWarnings_.find(warning) != ignoredWarnings_.end();
 }
 
 void WarningHandler::setIgnoredWarning(enums::Warning warning, bool ignore) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (ignore) {
         ignoredWarnings_.insert(warning);
     } else {
@@ -92,30 +130,40 @@ void WarningHandler::setIgnoredWarning(enums::Warning warning, bool ignore) {
 }
 
 int32_t WarningHandlerPrinter::getMaxWarningCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return maxWarningCount_;
 }
 
 void WarningHandlerPrinter::setMaxWarningCount(int32_t warningCount) {
+    std::lock_guard<std::mutex> lock(mutex_);
     maxWarningCount_ = warningCount;
 }
 
 bool WarningHandlerPrinter::getRaiseWarnings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return raiseWarnings_;
 }
 void WarningHandlerPrinter::setRaiseWarnings(bool raise) {
+    std::lock_guard<std::mutex> lock(mutex_);
     raiseWarnings_ = raise;
 }
 
 void WarningHandlerPrinter::emit(std::shared_ptr<morphio::WarningMessage> wm) {
-    const int maxWarningCount = getMaxWarningCount();
-
     const auto& warning = wm->warning();
 
-    if (isIgnored(warning) || maxWarningCount == 0) {
+    if (isIgnored(warning)) {
+        return;
+    }
+
+    // held while printing so that concurrent warnings are not interleaved on STDERR
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int maxWarningCount = maxWarningCount_;
+
+    if (maxWarningCount == 0) {
         return;
     }
 
-    if (getRaiseWarnings()) {
+    if (raiseWarnings_) {
         throw morphio::MorphioError(wm->msg());
     }
 
@@ -147,14 +195,18 @@ void WarningHandlerCollector::setRaiseWarnings(bool /*raise*/) {
 }
 
 void WarningHandlerCollector::emit(std::shared_ptr<WarningMessage> wm) {
-    m.emplace_back(isIgnored(wm->warning()), wm);
+    const bool ignored = isIgnored(wm->warning());
+    std::lock_guard<std::mutex> lock(mutex_);
+    m.emplace_back(ignored, wm);
 }
 
 void WarningHandlerCollector::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
     m.erase(m.begin());
 }
 
 std::vector<WarningHandlerCollector::Emission> WarningHandlerCollector::getAll() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return m;
 }
 
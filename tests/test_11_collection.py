@@ -1,7 +1,12 @@
 # Copyright (c) 2013-2023, EPFL/Blue Brain Project
 # SPDX-License-Identifier: Apache-2.0
+import multiprocessing
+import shutil
+import sys
+from concurrent.futures import Future
 from pathlib import Path
 
+import h5py
 import numpy as np
 import pytest
 
@@ -86,3 +91,122 @@ def test_container_with_warning_handler():
         warning_handler = morphio.WarningHandlerCollector()
         collection.load('neurite_wrong_root_point', warning_handler=warning_handler)
         assert len(warning_handler.get_all()) == 3
+
+
+@pytest.mark.parametrize("collection_path", COLLECTION_PATHS)
+def test_collection_cell_families(collection_path):
+    with morphio.Collection(collection_path) as collection:
+        glia = collection.load("glia", cell_family=morphio.CellFamily.GLIA)
+        assert isinstance(glia, morphio.GlialCell)
+
+        spine = collection.load("simple-dendritric-spine", cell_family=morphio.CellFamily.SPINE)
+        assert isinstance(spine, morphio.DendriticSpine)
+
+        with pytest.raises(morphio.RawDataError):
+            collection.load("simple", cell_family=morphio.CellFamily.GLIA)
+        with pytest.raises(ValueError):
+            collection.load("glia", mutable=True, cell_family=morphio.CellFamily.GLIA)
+
+        morphology_names = ["simple-dendritric-spine", "simple-dendritric-spine"]
+        loop_indices = []
+        for k, morph in collection.load_unordered(morphology_names,
+                                                  cell_family=morphio.CellFamily.SPINE):
+            assert isinstance(morph, morphio.DendriticSpine)
+            loop_indices.append(k)
+        assert sorted(loop_indices) == [0, 1]
+
+
+class DirectorySource(morphio.ByteSource):
+    def __init__(self, directory):
+        super().__init__()
+        self.directory = directory
+
+    def get(self, morph_name):
+        path = self.directory / f"{morph_name}.h5"
+        return path.read_bytes(), "h5"
+
+    def argsort(self, morphology_names):
+        return sorted(range(len(morphology_names)), key=morphology_names.__getitem__)
+
+
+def test_collection_from_byte_source():
+    collection = morphio.Collection(DirectorySource(DATA_DIR / "h5/v1"))
+    check_load_from_collection(collection)
+
+    morphology_names = available_morphologies()
+    assert collection.argsort(morphology_names) == [3, 1, 2, 0, 4]
+
+    for k, morph in collection.load_unordered(morphology_names):
+        expected = morphio.Morphology(DATA_DIR / "h5/v1" / f"{morphology_names[k]}.h5")
+        np.testing.assert_array_equal(morph.points, expected.points)
+
+    with pytest.raises(FileNotFoundError):
+        collection.load("missing")
+
+
+class BatchSource(DirectorySource):
+    """Reads batches itself, the second one is requested while the first is parsed"""
+    def __init__(self, directory):
+        super().__init__(directory)
+        self.batches = []
+        self.async_batches = []
+
+    def get_batch(self, morph_names):
+        self.batches.append(list(morph_names))
+        return super().get_batch(morph_names)
+
+    def get_async(self, morph_names):
+        self.async_batches.append(list(morph_names))
+        future = Future()
+        future.set_result(super().get_batch(morph_names))
+        return future
+
+
+def test_collection_from_byte_source_batches():
+    # two batches of 16 morphologies
+    morphology_names = available_morphologies() * 4
+    for source in [DirectorySource(DATA_DIR / "h5/v1"), BatchSource(DATA_DIR / "h5/v1")]:
+        collection = morphio.Collection(source)
+        loaded = 0
+        for k, morph in collection.load_unordered(morphology_names):
+            expected = morphio.Morphology(DATA_DIR / "h5/v1" / f"{morphology_names[k]}.h5")
+            np.testing.assert_array_equal(morph.points, expected.points)
+            loaded += 1
+        assert loaded == len(morphology_names)
+
+    sorted_names = sorted(morphology_names)
+    assert source.batches == [sorted_names[:16]]
+    assert source.async_batches == [sorted_names[16:]]
+
+
+_FORKED_COLLECTION = None
+
+
+def _load_points(morph_name):
+    return _FORKED_COLLECTION.load(morph_name).points
+
+
+@pytest.mark.skipif(sys.platform != "linux", reason="fork is the default on Linux only")
+def test_container_after_fork(tmp_path):
+    global _FORKED_COLLECTION  # pylint: disable=global-statement
+    morphology_names = available_morphologies()
+    path = tmp_path / "merged.h5"
+    shutil.copyfile(DATA_DIR / "h5/v1/merged.h5", path)
+    # the same container, with every morphology moved to the next name
+    shifted = tmp_path / "shifted.h5"
+    with h5py.File(path, "r") as source, h5py.File(shifted, "w") as target:
+        for k, name in enumerate(morphology_names):
+            source.copy(source[morphology_names[k - 1]], target, name=name)
+
+    _FORKED_COLLECTION = morphio.Collection(path)
+    expected = [_load_points(name) for name in morphology_names]
+
+    with multiprocessing.get_context("fork").Pool(2) as pool:
+        # the parent closes the file and rewrites it in place: the workers only read the new
+        # contents if they open the file again rather than reuse the handle they inherited
+        _FORKED_COLLECTION = None
+        path.write_bytes(shifted.read_bytes())
+        points = pool.map(_load_points, morphology_names * 3)
+
+    for k, actual in enumerate(points):
+        np.testing.assert_array_equal(actual, expected[(k - 1) % len(morphology_names)])
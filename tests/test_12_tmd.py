@@ -0,0 +1,36 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+from numpy.testing import assert_array_almost_equal
+
+import morphio
+from morphio import Collection, Morphology, SectionType, TMDFiltration
+
+DATA_DIR = Path(__file__).parent / "data"
+
+
+def test_persistence_barcode():
+    m = Morphology(DATA_DIR / "simple.swc")
+
+    assert_array_almost_equal(morphio.persistence_barcode(m, SectionType.basal_dendrite),
+                              [[np.sqrt(50), 5], [np.sqrt(61), 0]])
+    assert_array_almost_equal(morphio.persistence_barcode(m, SectionType.axon),
+                              [[np.sqrt(41), 4], [np.sqrt(52), 0]])
+    assert_array_almost_equal(
+        morphio.persistence_barcode(m, SectionType.basal_dendrite, TMDFiltration.path_distance),
+        [[10, 5], [11, 0]])
+    assert morphio.persistence_barcode(m).shape == (4, 2)
+    assert morphio.persistence_barcode(m, SectionType.apical_dendrite).shape == (0, 2)
+
+
+def test_persistence_barcodes():
+    names = ["simple", "simple-all-types", "complexe"]
+    collection = Collection(DATA_DIR, extensions=[".swc"])
+    barcodes = morphio.persistence_barcodes(collection, names, n_threads=2)
+
+    assert len(barcodes) == len(names)
+    for name, barcode in zip(names, barcodes):
+        expected = morphio.persistence_barcode(Morphology(DATA_DIR / f"{name}.swc"))
+        assert_array_almost_equal(barcode, expected)
@@ -0,0 +1,41 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import pytest
+from numpy.testing import assert_array_almost_equal
+
+from morphio import BoundingVolumes, Morphology, MorphioError, SectionType
+
+DATA_DIR = Path(__file__).parent / "data"
+
+
+def test_bounding_volumes():
+    volumes = BoundingVolumes(Morphology(DATA_DIR / "simple.swc"), n_threads=2)
+
+    assert volumes.neurite_types == [SectionType.basal_dendrite, SectionType.axon]
+    assert_array_almost_equal(volumes.neurite_bounding_boxes,
+                              [[[-5, 0, 0], [6, 5, 0]],
+                               [[-5, -4, 0], [6, 0, 0]]])
+    assert_array_almost_equal(volumes.neurite_hull_volumes, [0, 0])
+    # Flat hulls count both sides
+    assert_array_almost_equal(volumes.neurite_hull_areas, [55, 44])
+
+    bounds = volumes.morphology
+    assert_array_almost_equal(bounds.bounding_box, [[-5, -4, 0], [6, 5, 0]])
+    assert bounds.hull_vertices.shape == (4, 3)
+    assert bounds.hull_area == pytest.approx(198)
+    assert bounds.oriented_volume == 0
+
+    assert volumes.neurite_type(SectionType.axon).hull_area == pytest.approx(44)
+    with pytest.raises(MorphioError):
+        volumes.neurite_type(SectionType.apical_dendrite)
+
+
+def test_bounding_volumes_cached():
+    morphology = Morphology(DATA_DIR / "simple.swc")
+    volumes = BoundingVolumes(morphology)
+    # the second one shares the volumes computed for the first one
+    cached = BoundingVolumes(morphology)
+    assert_array_almost_equal(cached.neurite_bounding_boxes, volumes.neurite_bounding_boxes)
+    assert cached.morphology.hull_area == pytest.approx(198)
@@ -0,0 +1,38 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+
+from morphio import MeshStyle, Morphology, tessellate
+
+DATA_DIR = Path(__file__).parent / "data"
+
+
+def test_tessellate():
+    m = Morphology(DATA_DIR / "simple.swc")
+
+    mesh = tessellate(m, resolution=8)
+    assert mesh.vertices.shape == (6 * (2 * 8 + 2), 3)
+    assert mesh.vertices.dtype == np.float32
+    assert mesh.triangles.shape == (6 * 2 * 2 * 8, 3)
+    assert mesh.triangles.max() < len(mesh.vertices)
+    np.testing.assert_array_equal(np.unique(mesh.triangle_sections), np.arange(6))
+
+    capsules = tessellate(m, MeshStyle.capsules, resolution=8)
+    assert len(capsules.triangles) > len(mesh.triangles)
+
+    coarse = tessellate(m, resolution=8, level_of_detail=1)
+    assert len(coarse.triangles) == len(mesh.triangles) // 2
+
+
+def test_write_mesh(tmp_path):
+    mesh = tessellate(Morphology(DATA_DIR / "simple.swc"))
+
+    mesh.write_obj(tmp_path / "simple.obj")
+    lines = (tmp_path / "simple.obj").read_text().splitlines()
+    assert sum(line.startswith("v ") for line in lines) == len(mesh.vertices)
+    assert sum(line.startswith("f ") for line in lines) == len(mesh.triangles)
+
+    mesh.write_ply(tmp_path / "simple.ply")
+    assert (tmp_path / "simple.ply").read_bytes().startswith(b"ply\n")
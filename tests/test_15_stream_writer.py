@@ -0,0 +1,60 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import h5py
+import pytest
+from numpy.testing import assert_array_equal
+
+from morphio import Morphology, MorphioError, SectionType, SomaType
+from morphio.mut import StreamWriter
+
+DATA_DIR = Path(__file__).parent / "data"
+
+
+@pytest.mark.parametrize("ext", ["swc", "asc", "h5"])
+def test_stream_writer(tmp_path, ext):
+    m = Morphology(DATA_DIR / "simple.swc")
+    ids = {}
+    with StreamWriter(tmp_path / f"stream.{ext}") as writer:
+        writer.begin_soma(m.soma.type, m.soma.points, m.soma.diameters)
+        for section in m.iter():
+            parent = -1 if section.is_root else ids[section.parent.id]
+            ids[section.id] = writer.add_section(section.type, parent,
+                                                 section.points, section.diameters)
+
+    written = Morphology(tmp_path / f"stream.{ext}")
+    assert_array_equal(written.points, m.points)
+    assert_array_equal(written.diameters, m.diameters)
+    assert_array_equal(written.section_types, m.section_types)
+
+
+def test_stream_writer_order(tmp_path):
+    points = [[0, 0, 0], [1, 1, 1]]
+    writer = StreamWriter(tmp_path / "order.swc")
+    writer.begin_soma(SomaType.SOMA_SINGLE_POINT, [[0, 0, 0]], [1])
+    root = writer.add_section(SectionType.axon, -1, points, [1, 1])
+    first = writer.add_section(SectionType.axon, root, points, [1, 1])
+    writer.add_section(SectionType.axon, root, points, [1, 1])
+
+    with pytest.raises(MorphioError):
+        writer.add_section(SectionType.axon, first, points, [1, 1])
+    writer.finish()
+    with pytest.raises(MorphioError):
+        writer.finish()
+
+
+def test_stream_writer_h5_contiguous(tmp_path):
+    """The readers of containers locate the datasets by their offset in the file"""
+    m = Morphology(DATA_DIR / "simple.swc")
+    ids = {}
+    with StreamWriter(tmp_path / "stream.h5") as writer:
+        writer.begin_soma(m.soma.type, m.soma.points, m.soma.diameters)
+        for section in m.iter():
+            parent = -1 if section.is_root else ids[section.parent.id]
+            ids[section.id] = writer.add_section(section.type, parent,
+                                                 section.points, section.diameters)
+
+    with h5py.File(tmp_path / "stream.h5", "r") as h5_file:
+        assert h5_file["points"].chunks is None
+        assert h5_file["structure"].chunks is None
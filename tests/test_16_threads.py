@@ -0,0 +1,112 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+import sys
+import sysconfig
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+import numpy as np
+import pytest
+from numpy.testing import assert_array_equal
+
+import morphio
+from morphio import Morphology
+
+DATA_DIR = Path(__file__).parent / "data"
+
+FILES = [
+    DATA_DIR / "simple.swc",
+    DATA_DIR / "complexe.swc",
+    DATA_DIR / "simple.asc",
+    DATA_DIR / "h5/v1/simple.h5",
+    DATA_DIR / "h5/v1/mitochondria.h5",
+]
+
+FREE_THREADED = bool(sysconfig.get_config_var("Py_GIL_DISABLED"))
+N_THREADS = 4
+
+
+def _features(path):
+    """Load `path` and compute a few per-section features"""
+    m = Morphology(path)
+    lengths = [np.linalg.norm(np.diff(s.points, axis=0), axis=1).sum() for s in m.iter()]
+    return (m.n_points,
+            np.array(lengths),
+            np.array([s.type for s in m.iter()]),
+            m.diameters.mean())
+
+
+def _shared_features(m):
+    """Per-section features of an already loaded morphology"""
+    return (np.array([len(s.points) for s in m.iter()]),
+            np.array([s.parent.id if not s.is_root else -1 for s in m.iter()]),
+            m.section_offsets,
+            m.points.sum(axis=0),
+            m.mitochondria.diameters)
+
+
+def _check_same(expected, actual):
+    for e, a in zip(expected, actual):
+        assert_array_equal(e, a)
+
+
+@pytest.mark.skipif(not FREE_THREADED, reason="requires a free-threaded CPython")
+def test_module_does_not_enable_the_gil():
+    # importing a module that does not declare itself GIL-free re-enables the GIL
+    assert not sys._is_gil_enabled()
+
+
+def test_parallel_loads():
+    expected = [_features(path) for path in FILES]
+    paths = FILES * 20
+
+    with ThreadPoolExecutor(max_workers=N_THREADS) as executor:
+        results = list(executor.map(_features, paths))
+
+    for path, result in zip(paths, results):
+        _check_same(expected[FILES.index(path)], result)
+
+
+def test_parallel_loads_shared_warning_handler():
+    path = DATA_DIR / "neurite_wrong_root_point.swc"
+    n_loads = 50
+
+    warnings = morphio.WarningHandlerCollector()
+    Morphology(path, warning_handler=warnings)
+    per_load = len(warnings.get_all())
+
+    warnings = morphio.WarningHandlerCollector()
+    with ThreadPoolExecutor(max_workers=N_THREADS) as executor:
+        list(executor.map(lambda _: Morphology(path, warning_handler=warnings), range(n_loads)))
+
+    assert len(warnings.get_all()) == n_loads * per_load
+
+
+def test_parallel_loads_default_warning_handler():
+    path = DATA_DIR / "neurite_wrong_root_point.swc"
+    morphio.set_maximum_warnings(0)
+    try:
+        with ThreadPoolExecutor(max_workers=N_THREADS) as executor:
+            morphs = list(executor.map(lambda _: Morphology(path), range(50)))
+    finally:
+        morphio.set_maximum_warnings(100)
+    assert all(len(m.root_sections) == len(morphs[0].root_sections) for m in morphs)
+
+
+def test_concurrent_reads_of_shared_objects():
+    # the threads start together, so that they read the same objects at the same time
+    morphs = [Morphology(path) for path in FILES]
+    expected = [_shared_features(m) for m in morphs]
+    barrier = threading.Barrier(N_THREADS)
+
+    def read_all(_):
+        barrier.wait()
+        return [_shared_features(m) for m in morphs * 10]
+
+    with ThreadPoolExecutor(max_workers=N_THREADS) as executor:
+        results = list(executor.map(read_all, range(N_THREADS)))
+
+    for result in results:
+        for i, features in enumerate(result):
+            _check_same(expected[i % len(FILES)], features)
@@ -0,0 +1,73 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import pytest
+from numpy.testing import assert_array_equal
+
+import morphio
+from morphio import ArrowFormat, ArrowTable, Morphology
+
+DATA_DIR = Path(__file__).parent / "data"
+
+NAMES = ["simple", "complexe"]
+MORPHOLOGIES = [Morphology(DATA_DIR / f"{name}.swc") for name in NAMES]
+
+
+def _assert_same(actual, expected):
+    assert_array_equal(actual.points, expected.points)
+    assert_array_equal(actual.diameters, expected.diameters)
+    assert_array_equal(actual.section_types, expected.section_types)
+    assert_array_equal(actual.soma.points, expected.soma.points)
+    assert actual.connectivity == expected.connectivity
+    assert actual.soma_type == expected.soma_type
+
+
+@pytest.mark.parametrize("format", [ArrowFormat.file, ArrowFormat.stream])
+def test_round_trip(format):
+    names, morphologies = morphio.arrow_deserialize(
+        *(morphio.arrow_serialize(table, NAMES, MORPHOLOGIES, format)
+          for table in (ArrowTable.morphologies, ArrowTable.sections, ArrowTable.points)))
+    assert names == NAMES
+    for actual, expected in zip(morphologies, MORPHOLOGIES):
+        _assert_same(actual, expected)
+
+
+def test_directory(tmp_path):
+    morphio.write_arrow(tmp_path, NAMES, MORPHOLOGIES)
+    assert sorted(p.name for p in tmp_path.iterdir()) == [
+        "morphologies.arrow", "points.arrow", "sections.arrow"]
+    names, morphologies = morphio.read_arrow(tmp_path)
+    assert names == NAMES
+    _assert_same(morphologies[1], MORPHOLOGIES[1])
+
+    with pytest.raises(morphio.RawDataError):
+        morphio.read_arrow(tmp_path / "missing")
+
+
+def test_pyarrow(tmp_path):
+    pa = pytest.importorskip("pyarrow")
+    ipc = pytest.importorskip("pyarrow.ipc")
+
+    morphio.write_arrow(tmp_path, NAMES, MORPHOLOGIES)
+    points = ipc.open_file(tmp_path / "points.arrow").read_all()
+    assert points.column_names == [
+        "morphology", "section", "x", "y", "z", "diameter", "perimeter"]
+    assert points.num_rows == sum(len(m.soma.points) + len(m.points) for m in MORPHOLOGIES)
+    assert ipc.open_file(tmp_path / "morphologies.arrow").read_all()["name"].to_pylist() == NAMES
+
+    # written back by pyarrow, in several record batches and with other column widths
+    out = tmp_path / "pyarrow"
+    out.mkdir()
+    for name in ("morphologies", "sections", "points"):
+        table = ipc.open_file(tmp_path / f"{name}.arrow").read_all()
+        if name == "points":
+            table = table.set_column(2, "x", table["x"].cast(pa.float64()))
+        with ipc.new_file(out / f"{name}.arrow", table.schema) as writer:
+            for batch in table.to_batches(max_chunksize=5):
+                writer.write_batch(batch)
+
+    names, morphologies = morphio.read_arrow(out)
+    assert names == NAMES
+    for actual, expected in zip(morphologies, MORPHOLOGIES):
+        _assert_same(actual, expected)
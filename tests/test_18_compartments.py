@@ -0,0 +1,41 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+from numpy.testing import assert_array_equal, assert_allclose
+
+from morphio import CompartmentOrdering, Morphology, compartmentalize
+
+DATA_DIR = Path(__file__).parent / "data"
+SIMPLE = Morphology(DATA_DIR / "simple.swc")
+
+
+def test_compartmentalize():
+    tree = compartmentalize(SIMPLE)
+    assert len(tree) == 7
+    assert_array_equal(tree.parents, [-1, 0, 1, 1, 0, 4, 4])
+    assert_array_equal(tree.sections, [-1, 0, 1, 2, 3, 4, 5])
+    assert_allclose(tree.areas[:2], [4 * np.pi, 10 * np.pi], rtol=1e-5)
+    assert_allclose(tree.centers[1], [0, 2.5, 0])
+    assert_allclose(tree.axial_resistance_factors[1], 2.5 / np.pi, rtol=1e-5)
+
+    tree = compartmentalize(SIMPLE, max_length=2)
+    assert_array_equal(tree.sections[:4], [-1, 0, 0, 0])
+    assert np.all(tree.parents < np.arange(len(tree)))
+
+
+def test_compartmentalize_population():
+    morphologies = [SIMPLE, Morphology(DATA_DIR / "complexe.swc")]
+    single = [compartmentalize(m, max_length=3) for m in morphologies]
+
+    for ordering in (CompartmentOrdering.concatenated, CompartmentOrdering.interleaved):
+        forest = compartmentalize(morphologies, max_length=3, ordering=ordering)
+        assert len(forest) == sum(len(tree) for tree in single)
+        assert np.all(forest.parents < np.arange(len(forest)))
+        for cell, tree in enumerate(single):
+            nodes = forest.cell_nodes[forest.cells == cell]
+            assert sorted(nodes) == list(range(len(tree)))
+
+    forest = compartmentalize(morphologies, ordering=CompartmentOrdering.interleaved)
+    assert_array_equal(forest.cells[:4], [0, 1, 0, 1])
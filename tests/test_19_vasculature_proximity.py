@@ -0,0 +1,62 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+from numpy.testing import assert_allclose, assert_array_equal
+
+from morphio import Morphology
+from morphio.vasculature import ProximityIndex, Vasculature
+
+DATA_DIR = Path(__file__).parent / "data"
+
+# two straight vessels along x: y = 0 (diameter 2) and y = 10 (diameter 4)
+INDEX = ProximityIndex(
+    np.array([[0, 0, 0], [5, 0, 0], [10, 0, 0], [0, 10, 0], [10, 10, 0]], dtype=np.float32),
+    [2, 2, 2, 4, 4],
+    [0, 3, 5])
+
+
+def test_points():
+    assert len(INDEX) == 3
+    sections, segments, distances = INDEX.nearest(
+        np.array([[7, 3, 0], [2, 7, 0], [-3, 4, 0]], dtype=np.float32))
+    assert_array_equal(sections, [0, 1, 0])
+    assert_array_equal(segments, [1, 0, 0])
+    assert_allclose(distances, [2, 1, 4], atol=1e-5)
+
+    offsets, sections, segments, distances = INDEX.within(
+        np.array([[5, 4, 0], [5, 40, 0]], dtype=np.float32), 5)
+    assert_array_equal(offsets, [0, 3, 3])
+    assert_array_equal(sections, [0, 0, 1])
+    assert_allclose(distances, [3, 3, 4], atol=1e-5)
+
+
+def test_morphology():
+    morphology = Morphology(DATA_DIR / "simple.swc")
+    query_sections, query_segments, sections, segments, distances = INDEX.nearest(morphology)
+    assert_array_equal(query_sections, [-1, 0, 1, 2, 3, 4, 5])
+    assert_array_equal(query_segments, [-1, 0, 0, 0, 0, 0, 0])
+    assert sections[0] == 0
+    assert distances[0] == 0
+
+    distances = INDEX.nearest(morphology, translation=[0, -20, 0], n_threads=2)[4]
+    assert_allclose(distances[0], 18, atol=1e-5)
+
+    rotation = np.diag([-1, -1, 1])
+    query_sections, _, offsets, _, _, _ = INDEX.within(morphology, 1000, rotation=rotation)
+    assert_array_equal(np.diff(offsets), [len(INDEX)] * len(query_sections))
+
+
+def test_vasculature():
+    vasculature = Vasculature(DATA_DIR / "h5/vasculature1.h5")
+    index = ProximityIndex(vasculature)
+    offsets = vasculature.section_offsets
+    assert len(index) == np.sum(np.maximum(np.diff(offsets.astype(np.int64)) - 1, 0))
+
+    # the points of the sections with segments are on a vessel
+    points = np.concatenate(
+        [section.points for section in vasculature.sections[:50] if section.n_points > 1])
+    sections, _, distances = index.nearest(points)
+    assert np.all(sections >= 0)
+    assert_array_equal(distances, 0)
@@ -0,0 +1,42 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+import pytest
+from numpy.testing import assert_allclose
+
+from morphio import DendriticSpine, Morphology, SpineLibrary, place_spines
+
+DATA_DIR = Path(__file__).parent / "data"
+HOST = Morphology(DATA_DIR / "simple.swc")
+# a straight spine along z, from (1, 1, 1) to (1, 1, 3)
+SPINE = Morphology("1 3 1 1 1 0.2 -1\n2 3 1 1 2 0.2 1\n3 3 1 1 3 1.0 2\n", "swc")
+
+
+def test_place_spines():
+    library = SpineLibrary([SPINE])
+    assert len(library) == 1
+    assert_allclose(library.roots, [[1, 1, 1]])
+    assert_allclose(library.axes, [[0, 0, 1]])
+
+    # section 0: from (0, 0, 0) to (0, 5, 0), radius 1; the reference direction is -z
+    placed = place_spines(HOST, library, [0, 0], [0, 0], [0.5, 0.5], [0, np.pi / 2])
+    assert [p.section for p in placed] == [0, 0]
+    assert_allclose(library.points(placed[0]), [[0, 2.5, -1], [0, 2.5, -2], [0, 2.5, -3]],
+                    atol=1e-5)
+    assert_allclose(library.points(placed[1])[[0, 2]], [[-1, 2.5, 0], [-3, 2.5, 0]], atol=1e-5)
+    rotation = placed[1].rotation
+    assert_allclose(rotation @ rotation.T, np.eye(3), atol=1e-5)
+
+    instance = library.instantiate(placed[1])
+    assert_allclose(instance.root_sections[0].points[0], [-1, 2.5, 0], atol=1e-5)
+
+    with pytest.raises(ValueError):
+        place_spines(HOST, library, [0], [0, 1], [0.5])
+
+
+def test_dendritic_spine_library():
+    library = SpineLibrary([DendriticSpine(DATA_DIR / "h5/v1/simple-dendritric-spine.h5")])
+    assert_allclose(library.roots, [[0, 5, 0]])
+    assert_allclose(library.axes, [[0, 1, 0]], atol=1e-5)
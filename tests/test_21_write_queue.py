@@ -0,0 +1,36 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import pytest
+from numpy.testing import assert_array_equal
+
+from morphio import Morphology, WriterError
+from morphio.mut import Morphology as MutMorphology
+from morphio.mut import WriteQueue
+
+DATA_DIR = Path(__file__).parent / "data"
+
+
+@pytest.mark.parametrize("ext", ["swc", "h5"])
+def test_write_queue(tmp_path, ext):
+    m = MutMorphology(DATA_DIR / "simple.swc")
+    with WriteQueue(n_threads=2, capacity=3) as queue:
+        for i in range(10):
+            queue.push(m, tmp_path / f"{i}.{ext}")
+            assert queue.pending <= 3
+    assert queue.pending == 0
+
+    for i in range(10):
+        assert_array_equal(Morphology(tmp_path / f"{i}.{ext}").points, m.as_immutable().points)
+
+
+def test_write_queue_errors(tmp_path):
+    queue = WriteQueue()
+    m = MutMorphology(DATA_DIR / "simple.swc")
+    queue.push(m, tmp_path / "out.unknown")
+    queue.push(m, tmp_path / "out.swc")
+    with pytest.raises(WriterError, match="out.unknown"):
+        queue.flush()
+    assert (tmp_path / "out.swc").exists()
+    queue.flush()
@@ -0,0 +1,67 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+import pytest
+from numpy.testing import assert_array_equal
+
+from morphio import (ByteSource, Collection, Morphology, RawDataError, VariantCollection,
+                     delta_apply, delta_deserialize, delta_diff, delta_serialize, read_delta,
+                     write_delta)
+
+DATA_DIR = Path(__file__).parent / "data"
+BASE = Morphology(DATA_DIR / "complexe.swc")
+
+
+def make_variant():
+    variant = BASE.as_mutable()
+    variant.section(0).diameters = 2 * variant.section(0).diameters
+    return variant.as_immutable()
+
+
+def assert_same(a, b):
+    assert_array_equal(a.points, b.points)
+    assert_array_equal(a.diameters, b.diameters)
+    assert_array_equal(a.section_types, b.section_types)
+    assert_array_equal(a.section_offsets, b.section_offsets)
+    assert_array_equal(a.soma.points, b.soma.points)
+
+
+def test_diff_apply():
+    variant = make_variant()
+    delta = delta_diff(BASE, variant, "complexe")
+    assert delta.base == "complexe"
+    assert len(delta) == len(variant.sections)
+    assert not delta.soma_changed
+    assert not delta.has_perimeters
+    assert np.count_nonzero(delta.base_sections == -1) == 1
+    assert len(delta.points) == len(variant.section(0).points)
+    assert_same(delta_apply(BASE, delta), variant)
+
+
+def test_serialization(tmp_path):
+    variant = make_variant()
+    delta = delta_diff(BASE, variant, "complexe")
+    assert_same(delta_apply(BASE, delta_deserialize(delta_serialize(delta))), variant)
+
+    write_delta(delta, tmp_path / "variant.delta")
+    assert_same(delta_apply(BASE, read_delta(tmp_path / "variant.delta")), variant)
+
+    with pytest.raises(RawDataError):
+        delta_deserialize(b"not a delta")
+
+
+def test_variant_collection(tmp_path):
+    variant = make_variant()
+    write_delta(delta_diff(BASE, variant, "complexe"), tmp_path / "variant.delta")
+    collection = VariantCollection(Collection(DATA_DIR, [".swc"]), tmp_path, cache_size=1)
+    assert_same(collection.load("variant"), variant)
+    assert_same(collection.base("complexe"), BASE)
+
+    class DeltaSource(ByteSource):
+        def get(self, morph_name):
+            return (delta_serialize(delta_diff(BASE, variant, "complexe")), "delta")
+
+    collection = VariantCollection(Collection(DATA_DIR, [".swc"]), DeltaSource())
+    assert_same(collection.load("anything"), variant)
@@ -0,0 +1,41 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+import pytest
+from numpy.testing import assert_allclose, assert_array_equal
+
+from morphio import CloneParameters, Morphology, clone_morphologies, clone_morphology
+
+DATA_DIR = Path(__file__).parent / "data"
+EXEMPLAR = Morphology(DATA_DIR / "complexe.swc")
+
+
+def test_no_transformation():
+    clone = clone_morphology(EXEMPLAR, CloneParameters(), seed=0)
+    assert_array_equal(clone.points, EXEMPLAR.points)
+
+
+def test_clone_morphologies():
+    parameters = CloneParameters(scale_sigma=0.1, length_sigma=0.1, angle_sigma=0.2,
+                                 subtree_rotation=0.5)
+    assert parameters.angle_sigma == pytest.approx(0.2)
+
+    clones = clone_morphologies(EXEMPLAR, parameters, count=4, seed=42, first_index=3)
+    assert len(clones) == 4
+    for i, clone in enumerate(clones):
+        assert_array_equal(clone.points, clone_morphology(EXEMPLAR, parameters, 42, 3 + i).points)
+        assert_array_equal(clone.diameters, EXEMPLAR.diameters)
+        assert_array_equal(clone.section_offsets, EXEMPLAR.section_offsets)
+    assert not np.array_equal(clones[0].points, clones[1].points)
+
+
+def test_scaling():
+    clone = clone_morphology(EXEMPLAR, CloneParameters(scale_sigma=0.2), seed=3)
+    center = EXEMPLAR.soma.center
+    distances = np.linalg.norm(EXEMPLAR.points - center, axis=1)
+    cloned = np.linalg.norm(clone.points - center, axis=1)
+    factor = cloned[-1] / distances[-1]
+    assert factor != 1
+    assert_allclose(cloned, factor * distances, rtol=1e-4)
@@ -0,0 +1,37 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+import numpy as np
+import pytest
+from numpy.testing import assert_allclose, assert_array_equal
+
+from morphio import Morphology, RawDataError, Unravelled, unravel
+
+# an axon zigzagging along x
+SWC = "1 1 0 0 0 1 -1\n" + "".join(
+    f"{i + 2} 2 {i} {i % 2} 0 0.5 {i + 1}\n" for i in range(9))
+ORIGINAL = Morphology(SWC, "swc")
+
+
+def segment_lengths(points):
+    return np.linalg.norm(np.diff(points, axis=0), axis=1)
+
+
+def test_unravel():
+    straight = unravel(ORIGINAL, window_half_length=20)
+    assert_array_equal(straight.section_offsets, ORIGINAL.section_offsets)
+    axon = straight.section(0).points
+    assert_allclose(segment_lengths(axon), segment_lengths(ORIGINAL.section(0).points),
+                    rtol=1e-5)
+    assert_allclose(np.diff(axon[:, 0]), np.sqrt(2), rtol=1e-4)
+    assert_allclose(axon[:, 1], axon[0, 1], atol=0.05)
+
+
+def test_map():
+    result = Unravelled(ORIGINAL, window_half_length=2, n_threads=2)
+    assert_array_equal(result.original.points, ORIGINAL.points)
+    points = ORIGINAL.points
+    mapped = result.map(points[[2, 5]], [0, 0])
+    assert_allclose(mapped, result.morphology.points[[2, 5]], atol=1e-5)
+
+    with pytest.raises(RawDataError):
+        result.map(points[[2]], [100])
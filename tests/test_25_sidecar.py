@@ -0,0 +1,51 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+import pytest
+from numpy.testing import assert_allclose, assert_array_equal
+
+from morphio import Morphology, SidecarCache, content_hash
+
+DATA_DIR = Path(__file__).parent / "data"
+MORPHOLOGY = Morphology(DATA_DIR / "complexe.swc")
+
+
+def test_content_hash():
+    assert content_hash(MORPHOLOGY) == content_hash(Morphology(DATA_DIR / "complexe.swc"))
+    modified = MORPHOLOGY.as_mutable()
+    modified.section(0).points = modified.section(0).points + 1
+    assert content_hash(MORPHOLOGY) != content_hash(modified.as_immutable())
+
+
+def test_sidecar_cache(tmp_path):
+    cache = SidecarCache(tmp_path / "cache")
+    lengths = cache.section_lengths(MORPHOLOGY)
+    expected = [np.linalg.norm(np.diff(s.points, axis=0), axis=1).sum()
+                for s in MORPHOLOGY.sections]
+    assert_allclose(lengths, expected, rtol=1e-5)
+    assert not lengths.flags.writeable
+    assert len(list((tmp_path / "cache").iterdir())) == 1
+
+    order = SidecarCache(tmp_path / "cache").depth_first_order(MORPHOLOGY)
+    assert_array_equal(order, [s.id for s in MORPHOLOGY.iter()])
+    assert len(cache.path_distances(MORPHOLOGY)) == len(MORPHOLOGY.sections)
+
+
+def test_get_or_compute(tmp_path):
+    cache = SidecarCache.next_to(tmp_path)
+    assert cache.directory == str(tmp_path / ".morphio-cache")
+    calls = []
+
+    def compute(morphology):
+        calls.append(1)
+        return morphology.diameters
+
+    for _ in range(2):
+        values = cache.get_or_compute(MORPHOLOGY, "diameters", compute)
+        assert_allclose(values, MORPHOLOGY.diameters)
+    assert len(calls) == 1
+
+    with pytest.raises(Exception):
+        cache.get_or_compute(MORPHOLOGY, "../diameters", compute)
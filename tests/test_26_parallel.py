@@ -0,0 +1,49 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import pytest
+
+from morphio import Morphology, SectionOrder, parallel_for_sections
+
+DATA_DIR = Path(__file__).parent / "data"
+MORPHOLOGY = Morphology(DATA_DIR / "complexe.swc")
+
+
+@pytest.mark.parametrize("n_threads", [1, 4])
+def test_unordered(n_threads):
+    visited = []
+    parallel_for_sections(MORPHOLOGY, lambda section: visited.append(section.id),
+                          n_threads=n_threads)
+    assert sorted(visited) == [section.id for section in MORPHOLOGY.iter()]
+
+
+@pytest.mark.parametrize("n_threads", [1, 4])
+def test_top_down(n_threads):
+    depth = {}
+
+    def visit(section):
+        depth[section.id] = 0 if section.is_root else depth[section.parent.id] + 1
+
+    parallel_for_sections(MORPHOLOGY, visit, SectionOrder.top_down, n_threads)
+    assert len(depth) == len(MORPHOLOGY.sections)
+
+
+@pytest.mark.parametrize("n_threads", [1, 4])
+def test_bottom_up(n_threads):
+    size = {}
+
+    def visit(section):
+        size[section.id] = 1 + sum(size[child.id] for child in section.children)
+
+    parallel_for_sections(MORPHOLOGY, visit, SectionOrder.bottom_up, n_threads)
+    assert sum(size[root.id] for root in MORPHOLOGY.root_sections) == len(MORPHOLOGY.sections)
+
+
+def test_exception():
+    def visit(section):
+        if section.id == 2:
+            raise ValueError("section 2")
+
+    with pytest.raises(ValueError):
+        parallel_for_sections(MORPHOLOGY, visit, SectionOrder.top_down, n_threads=4)
@@ -0,0 +1,47 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+import pytest
+from numpy.testing import assert_allclose, assert_array_equal
+
+from morphio import Morphology, subtree_aggregates
+
+DATA_DIR = Path(__file__).parent / "data"
+
+# a root section of length 10 and two children of length 10, all of radius 1
+FORK = Morphology("1 1 0 0 0 1 -1\n"
+                  "2 3 0 0 0 1 1\n"
+                  "3 3 0 10 0 1 2\n"
+                  "4 3 10 10 0 1 3\n"
+                  "5 3 -10 10 0 1 3\n", "swc")
+
+
+def test_fork():
+    result = subtree_aggregates(FORK)
+    assert_allclose(result.length, [30, 10, 10])
+    assert_allclose(result.area, np.array([60, 20, 20]) * np.pi, rtol=1e-6)
+    assert_allclose(result.volume, np.array([30, 10, 10]) * np.pi, rtol=1e-6)
+    assert_array_equal(result.tips, [2, 1, 1])
+    assert_array_equal(result.bifurcations, [1, 0, 0])
+    assert_allclose(result.max_path_length, [20, 10, 10])
+
+
+def test_same_as_iterating():
+    morphology = Morphology(DATA_DIR / "nrn_ordering.swc")
+    result = subtree_aggregates(morphology)
+    for section in morphology.iter():
+        subtree = list(section.iter())
+        length = sum(np.linalg.norm(np.diff(s.points, axis=0), axis=1).sum() for s in subtree)
+        assert result.length[section.id] == pytest.approx(length, rel=1e-4)
+        assert result.tips[section.id] == sum(1 for s in subtree if not s.children)
+
+
+def test_views():
+    result = subtree_aggregates(FORK)
+    length = result.length
+    del result
+    assert_allclose(length, [30, 10, 10])
+    with pytest.raises(ValueError):
+        length[0] = 0
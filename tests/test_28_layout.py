@@ -0,0 +1,51 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+from numpy.testing import assert_array_equal
+
+from morphio import AccessTrace, Collection, access_order, reorder_container
+
+DATA_DIR = Path(__file__).parent / "data"
+NAMES = ["simple", "glia", "mitochondria", "endoplasmic-reticulum", "simple-dendritric-spine"]
+
+
+def test_record_accesses(tmp_path):
+    collection = Collection(DATA_DIR, [".swc"])
+    trace = AccessTrace()
+    collection.record_accesses(trace)
+    assert collection.access_trace is trace
+
+    collection.load("simple")
+    for _ in collection.load_unordered(["complexe", "soma_cylinders"]):
+        pass
+    assert trace.names == ["simple", "complexe", "soma_cylinders"]
+
+    collection.record_accesses(None)
+    collection.load("simple")
+    assert len(trace.names) == 3
+
+    trace.save(tmp_path / "job.trace")
+    assert AccessTrace.read(tmp_path / "job.trace") == trace.names
+
+
+def test_access_order():
+    names = ["a", "b", "c", "d"]
+    assert access_order(names, [["a", "b", "c"], ["a", "c"], ["a", "c"]]) == ["b", "a", "c", "d"]
+    assert access_order(names, []) == names
+
+
+def test_reorder_container(tmp_path):
+    trace = AccessTrace()
+    with Collection(DATA_DIR / "h5/v1/merged.h5") as collection:
+        collection.record_accesses(trace)
+        collection.load("mitochondria")
+        collection.load("glia")
+
+    output = tmp_path / "reordered.h5"
+    reorder_container(DATA_DIR / "h5/v1/merged.h5", output, [trace, ["glia", "simple"]])
+
+    with Collection(output) as reordered, Collection(DATA_DIR / "h5/v1/merged.h5") as original:
+        assert reordered.argsort(["mitochondria", "glia", "simple"]) == [0, 1, 2]
+        for name in NAMES:
+            assert_array_equal(reordered.load(name).points, original.load(name).points)
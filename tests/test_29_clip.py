@@ -0,0 +1,44 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+import pytest
+from numpy.testing import assert_allclose, assert_array_equal
+
+from morphio import ClipBox, ClipPlane, ClipSlab, Morphology, clip
+
+# a root section from the soma to (10, 0, 0), forking along y and along x
+FORK = Morphology("1 1 0 0 0 1 -1\n"
+                  "2 3 0 0 0 1 1\n"
+                  "3 3 10 0 0 1 2\n"
+                  "4 3 10 10 0 2 3\n"
+                  "5 3 20 0 0 1 3\n", "swc")
+
+
+def test_clip_box():
+    clipped = clip(FORK, ClipBox([-1, -1, -1], [15, 5, 1]))
+    assert_array_equal(clipped.sections, [0, 1, 2])
+    assert_allclose(clipped.offsets, [0, 1, 0, 0.5, 0, 0.5])
+    morphology = clipped.morphology
+    assert len(morphology.root_sections) == 1
+    assert_allclose(morphology.section(1).points[-1], [10, 5, 0])
+    assert_allclose(morphology.section(1).diameters[-1], 3)
+    assert_allclose(morphology.section(2).points[-1], [15, 0, 0])
+
+
+def test_clip_plane():
+    morphology = clip(FORK, ClipPlane([5, 0, 0], [1, 0, 0])).morphology
+    assert_allclose(morphology.section(0).points[0], [5, 0, 0])
+    assert len(morphology.section(0).children) == 2
+    assert len(morphology.soma.points) == 0
+
+
+def test_clip_slab():
+    clipped = clip(FORK, ClipSlab([0, 2, 0], [0, 1, 0], 3))
+    assert_array_equal(clipped.sections, [1])
+    assert_allclose(clipped.offsets, [0.2, 0.5], rtol=1e-6)
+    assert_allclose(clipped.morphology.points, [[10, 2, 0], [10, 5, 0]], rtol=1e-6)
+    assert_allclose(clipped.morphology.diameters, [2.4, 3], rtol=1e-6)
+
+
+def test_clip_invalid():
+    with pytest.raises(ValueError):
+        clip(FORK, [0, 0, 0])
@@ -0,0 +1,51 @@
+# Copyright (c) 2013-2023, EPFL/Blue Brain Project
+# SPDX-License-Identifier: Apache-2.0
+from pathlib import Path
+
+import numpy as np
+import pytest
+from numpy.testing import assert_allclose, assert_array_equal
+
+from morphio import CircuitIndex, Collection
+
+DATA_DIR = Path(__file__).parent / "data"
+
+# two copies of simple.swc, 100um apart along x
+NAMES = ["simple", "simple"]
+TRANSLATIONS = [[0, 0, 0], [100, 0, 0]]
+
+
+def circuit_index(**kwargs):
+    return CircuitIndex(Collection(DATA_DIR, [".swc"]), NAMES,
+                        translations=TRANSLATIONS, **kwargs)
+
+
+def test_cell_boxes():
+    index = circuit_index()
+    assert len(index) == 2
+    assert_allclose(index.cell_box(0), [[-7, -6, -2], [8, 6.5, 2]])
+    assert_allclose(index.cell_box(1), [[93, -6, -2], [108, 6.5, 2]])
+    assert index.resident_cells == 0
+
+
+def test_queries():
+    index = circuit_index(max_resident_cells=1)
+    offsets, cells, sections, segments, distances = index.nearest([[103, 5, 0], [3, 5, 0]])
+    assert_array_equal(offsets, [0, 1, 2])
+    assert_array_equal(cells, [1, 0])
+    assert sections[0] == sections[1]
+    assert_allclose(distances, [0, 0])
+    assert index.resident_cells == 1
+
+    offsets, cells, _, _, distances = index.in_sphere([[50, 0, 0]], 1000)
+    assert_array_equal(offsets, [0, 12])
+    assert np.all(np.diff(distances) >= 0)
+
+    offsets, cells, _, _, _ = index.in_box([[[90, -10, -10], [110, 10, 10]]])
+    assert_array_equal(offsets, [0, 6])
+    assert_array_equal(cells, [1] * 6)
+
+
+def test_invalid_placements():
+    with pytest.raises(ValueError):
+        CircuitIndex(Collection(DATA_DIR, [".swc"]), NAMES, translations=[[0, 0, 0]])
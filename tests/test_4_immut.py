@@ -90,6 +90,7 @@ def test_iter():
 def test_section_offsets():
     for cell in CELLS:
         assert_array_equal(CELLS[cell].section_offsets, [0, 2, 4, 6, 8, 10, 12])
+        assert CELLS[cell].section_offsets.dtype == np.uint64
 
 
 def test_connectivity():
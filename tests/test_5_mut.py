@@ -339,6 +339,18 @@ def test_mitochondria():
                        np.array([0.6, 0.7, 0.8, 0.9], dtype=np.float32))
 
 
+def test_mitochondria_append_sections():
+    mito = Morphology().mitochondria
+    roots = mito.append_sections([[0, -1], [2, 0], [4, -1]],
+                                 MitochondriaPointLevel([0, 0, 1, 1, 2, 2],
+                                                        [0.1, 0.2, 0.3, 0.4, 0.5, 0.6],
+                                                        [1, 2, 3, 4, 5, 6]))
+    assert [root.id for root in roots] == [0, 2]
+    assert [child.id for child in mito.children(roots[0])] == [1]
+    assert_array_equal(mito.section(1).diameters, [3, 4])
+    assert_array_equal(mito.section(2).neurite_section_ids, [2, 2])
+
+
 def test_iterators():
     assert_array_equal([sec.id for sec in SIMPLE.section(5).iter(IterType.upstream)],
                        [5, 3])
@@ -0,0 +1,115 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+
+#include <morphio/arrow.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/soma.h>
+
+namespace {
+void checkSameMorphology(const morphio::Morphology& actual, const morphio::Morphology& expected) {
+    CHECK(actual.points() == expected.points());
+    CHECK(actual.diameters() == expected.diameters());
+    CHECK(actual.perimeters() == expected.perimeters());
+    CHECK(actual.sectionTypes() == expected.sectionTypes());
+    CHECK(actual.sectionOffsets() == expected.sectionOffsets());
+    CHECK(actual.connectivity() == expected.connectivity());
+    CHECK(actual.soma().points() == expected.soma().points());
+    CHECK(actual.soma().diameters() == expected.soma().diameters());
+    CHECK(actual.somaType() == expected.somaType());
+    CHECK(actual.cellFamily() == expected.cellFamily());
+    CHECK(actual.version() == expected.version());
+}
+
+morphio::Morphology withPerimeters() {
+    morphio::mut::Morphology morph;
+    morph.soma()->points() = {{0, 0, 0}};
+    morph.soma()->diameters() = {2};
+    auto root = morph.appendRootSection(
+        morphio::Property::PointLevel({{0, 0, 0}, {1, 0, 0}}, {1, 1}, {3, 4}),
+        morphio::SECTION_DENDRITE);
+    root->appendSection(morphio::Property::PointLevel({{1, 0, 0}, {2, 1, 0}}, {1, 0.5}, {4, 5}),
+                        morphio::SECTION_DENDRITE);
+    root->appendSection(morphio::Property::PointLevel({{1, 0, 0}, {2, -1, 0}}, {1, 0.5}, {4, 6}),
+                        morphio::SECTION_DENDRITE);
+    return morphio::Morphology(morph);
+}
+}  // anonymous namespace
+
+TEST_CASE("arrow", "[arrow]") {
+    using namespace morphio::arrow;
+    const std::vector<std::string> names{"simple", "complexe", "perimeters", "empty"};
+    const std::vector<morphio::Morphology> morphologies{
+        morphio::Morphology("data/simple.swc"),
+        morphio::Morphology("data/complexe.swc"),
+        withPerimeters(),
+        morphio::Morphology(morphio::mut::Morphology())};
+
+    SECTION("round trip") {
+        for (const auto format : {IPC_STREAM, IPC_FILE}) {
+            const auto population = deserialize(serialize(MORPHOLOGIES, names, morphologies, format),
+                                                serialize(SECTIONS, names, morphologies, format),
+                                                serialize(POINTS, names, morphologies, format));
+            CHECK(population.names == names);
+            REQUIRE(population.morphologies.size() == morphologies.size());
+            for (size_t i = 0; i < morphologies.size(); ++i) {
+                checkSameMorphology(population.morphologies[i], morphologies[i]);
+            }
+        }
+    }
+
+    SECTION("file format framing") {
+        const auto file = serialize(POINTS, names, morphologies, IPC_FILE);
+        CHECK(file.substr(0, 6) == "ARROW1");
+        CHECK(file.substr(file.size() - 6) == "ARROW1");
+
+        const auto stream = serialize(POINTS, names, morphologies, IPC_STREAM);
+        // the file format embeds the stream after its 8 bytes magic
+        CHECK(file.substr(8, stream.size()) == stream);
+    }
+
+    SECTION("directory") {
+        const auto directory = std::filesystem::temp_directory_path() / "test_arrow.cpp";
+        std::filesystem::create_directories(directory);
+        write(directory.string(), names, morphologies);
+        for (const auto table : {MORPHOLOGIES, SECTIONS, POINTS}) {
+            CHECK(std::filesystem::exists(directory / (tableName(table) + ".arrow")));
+        }
+        const auto population = read(directory.string());
+        CHECK(population.names == names);
+        checkSameMorphology(population.morphologies[1], morphologies[1]);
+        std::filesystem::remove_all(directory);
+
+        CHECK_THROWS_AS(write((directory / "missing").string(), names, morphologies),
+                        morphio::MorphioError);
+        CHECK_THROWS_AS(read(directory.string()), morphio::RawDataError);
+    }
+
+    SECTION("errors") {
+        CHECK_THROWS_AS(serialize(POINTS, {"one"}, morphologies), morphio::MorphioError);
+
+        const auto morphologiesTable = serialize(MORPHOLOGIES, names, morphologies);
+        const auto sectionsTable = serialize(SECTIONS, names, morphologies);
+        const auto pointsTable = serialize(POINTS, names, morphologies);
+
+        // missing columns
+        CHECK_THROWS_AS(deserialize(sectionsTable, sectionsTable, pointsTable),
+                        morphio::RawDataError);
+        CHECK_THROWS_AS(deserialize(morphologiesTable, pointsTable, pointsTable),
+                        morphio::RawDataError);
+
+        // truncated and invalid data
+        CHECK_THROWS_AS(deserialize(morphologiesTable,
+                                    sectionsTable,
+                                    pointsTable.substr(0, pointsTable.size() / 2)),
+                        morphio::RawDataError);
+        CHECK_THROWS_AS(deserialize("", sectionsTable, pointsTable), morphio::RawDataError);
+        CHECK_THROWS_AS(deserialize(std::string(64, '\xff'), sectionsTable, pointsTable),
+                        morphio::RawDataError);
+    }
+}
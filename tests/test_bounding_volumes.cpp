@@ -0,0 +1,188 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <random>
+
+#include <morphio/bounding_volumes.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+
+#include "../src/convex_hull.h"
+
+namespace {
+void checkPoint(const morphio::Point& actual, const morphio::Point& expected) {
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK_THAT(actual[i], Catch::WithinAbs(expected[i], 1e-5));
+    }
+}
+
+morphio::Property::PointLevel pointLevel(const morphio::Points& points) {
+    return {points, std::vector<morphio::floatType>(points.size(), 1.)};
+}
+}  // anonymous namespace
+
+TEST_CASE("convexHull", "[boundingVolumes]") {
+    using morphio::details::convexHull;
+
+    SECTION("cube") {
+        morphio::Points points;
+        for (int x = 0; x < 2; ++x) {
+            for (int y = 0; y < 2; ++y) {
+                for (int z = 0; z < 2; ++z) {
+                    points.push_back(
+                        {morphio::floatType(x), morphio::floatType(y), morphio::floatType(z)});
+                }
+            }
+        }
+        points.push_back({0.5, 0.5, 0.5});
+        points.push_back({0.5, 0.5, 1.});
+
+        const auto hull = convexHull(points);
+        CHECK_THAT(hull.volume, Catch::WithinAbs(1, 1e-9));
+        CHECK_THAT(hull.area, Catch::WithinAbs(6, 1e-9));
+        CHECK(hull.vertices.size() == 8);
+        CHECK(hull.faces.size() == 12);
+    }
+
+    SECTION("random points are all inside") {
+        std::mt19937 generator(0);
+        std::normal_distribution<morphio::floatType> normal;
+        morphio::Points points(2000);
+        for (auto& point : points) {
+            point = {normal(generator), normal(generator), normal(generator)};
+        }
+
+        const auto hull = convexHull(points);
+        REQUIRE(hull.volume > 0);
+        // Euler's formula for a triangulated closed surface
+        CHECK(hull.faces.size() == 2 * hull.vertices.size() - 4);
+        for (const auto& face : hull.faces) {
+            const auto& a = hull.vertices[face[0]];
+            const auto& b = hull.vertices[face[1]];
+            const auto& c = hull.vertices[face[2]];
+            const double u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const double v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            const double n[3] = {u[1] * v[2] - u[2] * v[1],
+                                 u[2] * v[0] - u[0] * v[2],
+                                 u[0] * v[1] - u[1] * v[0]};
+            for (const auto& p : points) {
+                const double d[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+                CHECK(n[0] * d[0] + n[1] * d[1] + n[2] * d[2] < 1e-5);
+            }
+        }
+    }
+
+    SECTION("degenerate") {
+        CHECK(convexHull({}).vertices.empty());
+        CHECK(convexHull({{1, 2, 3}, {1, 2, 3}}).vertices.size() == 1);
+
+        const auto segment = convexHull({{0, 0, 0}, {1, 1, 1}, {2, 2, 2}});
+        CHECK(segment.vertices.size() == 2);
+        CHECK(segment.area == 0);
+
+        const auto square = convexHull({{0, 0, 1}, {2, 0, 1}, {1, 1, 1}, {2, 2, 1}, {0, 2, 1}});
+        CHECK(square.vertices.size() == 4);
+        CHECK(square.volume == 0);
+        CHECK_THAT(square.area, Catch::WithinAbs(8, 1e-9));
+    }
+}
+
+TEST_CASE("BoundingVolumes", "[boundingVolumes]") {
+    SECTION("planar morphology") {
+        const auto volumes = morphio::BoundingVolumes(morphio::Morphology("data/simple.swc"));
+        REQUIRE(volumes.neurites().size() == 2);
+        CHECK(volumes.neuriteTypes() == std::vector<morphio::SectionType>{
+                                            morphio::SECTION_DENDRITE, morphio::SECTION_AXON});
+
+        const auto& dendrite = volumes.neurites()[0];
+        checkPoint(dendrite.boundingBox.min, {-5, 0, 0});
+        checkPoint(dendrite.boundingBox.max, {6, 5, 0});
+        CHECK(dendrite.convexHull.volume == 0);
+        CHECK_THAT(dendrite.convexHull.area, Catch::WithinAbs(2 * 27.5, 1e-5));
+        CHECK_THAT(volumes.neurites()[1].convexHull.area, Catch::WithinAbs(2 * 22, 1e-5));
+
+        const auto& all = volumes.morphology();
+        checkPoint(all.boundingBox.min, {-5, -4, 0});
+        checkPoint(all.boundingBox.max, {6, 5, 0});
+        CHECK(all.convexHull.vertices.size() == 4);
+        CHECK_THAT(all.convexHull.area, Catch::WithinAbs(2 * 99, 1e-5));
+        CHECK(all.orientedBoundingBox.volume() == 0);
+
+        CHECK_THAT(volumes.neuriteType(morphio::SECTION_AXON).convexHull.area,
+                   Catch::WithinAbs(2 * 22, 1e-5));
+        CHECK_THROWS_AS(volumes.neuriteType(morphio::SECTION_APICAL_DENDRITE),
+                        morphio::MorphioError);
+    }
+
+    SECTION("oriented boxes") {
+        morphio::mut::Morphology morph;
+
+        // Unit cube, split over two sections
+        auto cube = morph.appendRootSection(
+            pointLevel({{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}}), morphio::SECTION_DENDRITE);
+        cube->appendSection(pointLevel({{0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}),
+                            morphio::SECTION_DENDRITE);
+
+        // 4 x 2 x 1 box, rotated by 45 degrees around z and centered on (10, 0, 0)
+        using morphio::floatType;
+        const floatType c = std::sqrt(floatType(0.5));
+        morphio::Points box;
+        for (const floatType x : {floatType(-2), floatType(2)}) {
+            for (const floatType y : {floatType(-1), floatType(1)}) {
+                for (const floatType z : {floatType(-0.5), floatType(0.5)}) {
+                    box.push_back({10 + c * (x - y), c * (x + y), z});
+                }
+            }
+        }
+        morph.appendRootSection(pointLevel(box), morphio::SECTION_AXON);
+
+        const auto volumes = morphio::BoundingVolumes(morphio::Morphology(morph), 2);
+        REQUIRE(volumes.neurites().size() == 2);
+
+        const auto& unitCube = volumes.neurites()[0];
+        CHECK_THAT(unitCube.convexHull.volume, Catch::WithinAbs(1, 1e-5));
+        CHECK_THAT(unitCube.convexHull.area, Catch::WithinAbs(6, 1e-5));
+        CHECK(unitCube.orientedBoundingBox.volume() >= unitCube.convexHull.volume);
+
+        const auto& rotated = volumes.neurites()[1];
+        CHECK_THAT(rotated.convexHull.volume, Catch::WithinAbs(8, 1e-4));
+        CHECK_THAT(rotated.orientedBoundingBox.volume(), Catch::WithinAbs(8, 1e-4));
+        checkPoint(rotated.orientedBoundingBox.halfExtents, {2, 1, 0.5});
+        checkPoint(rotated.orientedBoundingBox.center, {10, 0, 0});
+        CHECK_THAT(std::fabs(rotated.orientedBoundingBox.axes[0][0]), Catch::WithinAbs(c, 1e-5));
+        CHECK_THAT(std::fabs(rotated.orientedBoundingBox.axes[2][2]), Catch::WithinAbs(1, 1e-5));
+
+        const auto& boundingBox = rotated.boundingBox;
+        const auto aabbVolume = (boundingBox.max[0] - boundingBox.min[0]) *
+                                (boundingBox.max[1] - boundingBox.min[1]) *
+                                (boundingBox.max[2] - boundingBox.min[2]);
+        CHECK_THAT(aabbVolume, Catch::WithinAbs(18, 1e-4));
+
+        const auto& all = volumes.morphology();
+        CHECK(all.convexHull.volume > 9);
+        checkPoint(all.boundingBox.min, {0, -3 * c, -0.5});
+        checkPoint(all.boundingBox.max, {10 + 3 * c, 3 * c, 1});
+        checkPoint(volumes.neuriteType(morphio::SECTION_AXON).boundingBox.min,
+                   rotated.boundingBox.min);
+    }
+}
+
+TEST_CASE("BoundingVolumes cache", "[boundingVolumes]") {
+    const morphio::Morphology morphology("data/simple.swc");
+    const auto volumes = morphio::BoundingVolumes::cached(morphology);
+    CHECK(volumes->neurites().size() == 2);
+
+    // copies share their data
+    const morphio::Morphology copy = morphology;
+    CHECK(morphio::BoundingVolumes::cached(copy, 2) == volumes);
+
+    const morphio::Morphology other("data/simple.swc");
+    const auto otherVolumes = morphio::BoundingVolumes::cached(other);
+    CHECK(otherVolumes != volumes);
+    checkPoint(otherVolumes->morphology().boundingBox.max, volumes->morphology().boundingBox.max);
+}
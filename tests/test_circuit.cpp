@@ -0,0 +1,114 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <random>
+
+#include <morphio/circuit.h>
+#include <morphio/collection.h>
+#include <morphio/morphology.h>
+
+using morphio::circuit::SegmentHit;
+using morphio::circuit::SpatialIndex;
+
+namespace {
+/** Two copies of simple.swc 100um apart along x, and complexe.swc 100um above along y */
+std::vector<morphio::circuit::Cell> cells() {
+    morphio::Transform moved;
+    moved.translation = {100, 0, 0};
+    morphio::Transform rotated;
+    rotated.rotation = {{{0, -1, 0}, {1, 0, 0}, {0, 0, 1}}};
+    rotated.translation = {0, 100, 0};
+    return {{"simple", morphio::Transform()}, {"simple", moved}, {"complexe", rotated}};
+}
+
+morphio::Collection collection() {
+    return morphio::Collection("data", {".swc"});
+}
+
+void checkSameHits(const std::vector<SegmentHit>& actual, const std::vector<SegmentHit>& expected) {
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        CHECK(actual[i].cell == expected[i].cell);
+        CHECK(actual[i].section == expected[i].section);
+        CHECK(actual[i].segment == expected[i].segment);
+        CHECK(actual[i].distance == Approx(expected[i].distance));
+    }
+}
+}  // namespace
+
+TEST_CASE("circuit_index_boxes", "[circuit]") {
+    const SpatialIndex index(collection(), cells());
+    REQUIRE(index.size() == 3);
+
+    // radii included: (-5, -4) and (6, -4) have a radius of 2, (0, 5) and (-5, 5) 1 and 1.5
+    const auto& box = index.cellBox(0);
+    CHECK(box.min == morphio::Point{-7, -6, -2});
+    CHECK(box.max == morphio::Point{8, 6.5, 2});
+    CHECK(index.cellBox(1).min == morphio::Point{93, -6, -2});
+    CHECK(index.cellBox(1).max == morphio::Point{108, 6.5, 2});
+    CHECK(index.residentCells() == 0);
+}
+
+TEST_CASE("circuit_index_queries", "[circuit]") {
+    const SpatialIndex index(collection(), cells());
+
+    // inside the section from (0, 5) to (6, 5) of the moved copy
+    const auto nearest = index.nearest(morphio::Point{103, 5, 0}, 1);
+    REQUIRE(nearest.size() == 1);
+    CHECK(nearest[0].cell == 1);
+    CHECK(nearest[0].distance == 0);
+    const auto sphere = index.inSphere(morphio::Point{103, 5, 0}, 0.5);
+    REQUIRE(!sphere.empty());
+    for (const auto& hit : sphere) {
+        CHECK(hit.cell == 1);
+    }
+    CHECK(index.residentCells() == 1);
+
+    // every segment is in a box enclosing the whole circuit
+    const morphio::Morphology complexe("data/complexe.swc");
+    size_t nSegments = 12;
+    for (const auto& section : complexe.sections()) {
+        nSegments += section.points().size() - 1;
+    }
+    const auto all = index.inBox(morphio::BoundingBox{{-1000, -1000, -1000}, {1000, 1000, 1000}});
+    CHECK(all.size() == nSegments);
+    CHECK(index.inBox(morphio::BoundingBox{{200, 200, 200}, {300, 300, 300}}).empty());
+    CHECK(index.residentCells() == 3);
+
+    // the nearest segments are the closest ones in a sphere enclosing everything
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<morphio::floatType> coordinate(-20, 120);
+    morphio::Points points;
+    for (size_t i = 0; i < 20; ++i) {
+        points.push_back({coordinate(generator), coordinate(generator), coordinate(generator)});
+    }
+    const auto bulk = index.nearest(points, 5, 3);
+    for (size_t i = 0; i < points.size(); ++i) {
+        auto expected = index.inSphere(points[i], 1000);
+        expected.resize(5);
+        checkSameHits(bulk[i], expected);
+    }
+}
+
+TEST_CASE("circuit_index_resident_cells", "[circuit]") {
+    const SpatialIndex bounded(collection(), cells(), 1, morphio::NO_MODIFIER, 2);
+    const SpatialIndex unbounded(collection(), cells());
+
+    const morphio::Points centers{{0, 0, 0}, {100, 0, 0}, {0, 100, 0}, {50, 50, 0}};
+    const auto expected = unbounded.inSphere(centers, 60, 1);
+    const auto actual = bounded.inSphere(centers, 60, 4);
+    for (size_t i = 0; i < centers.size(); ++i) {
+        checkSameHits(actual[i], expected[i]);
+    }
+    CHECK(bounded.residentCells() == 1);
+
+    const std::vector<morphio::BoundingBox> boxes{{{-10, -10, -10}, {10, 10, 10}},
+                                                  {{90, -10, -10}, {110, 10, 10}}};
+    const auto inBoxes = bounded.inBox(boxes, 2);
+    checkSameHits(inBoxes[0], unbounded.inBox(boxes[0]));
+    checkSameHits(inBoxes[1], unbounded.inBox(boxes[1]));
+    CHECK(inBoxes[0].size() == 6);
+}
@@ -0,0 +1,109 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <morphio/clip.h>
+#include <morphio/exceptions.h>
+#include <morphio/morphology.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+
+namespace {
+/** A root section from the soma to (10, 0, 0), forking along y and along x */
+morphio::Morphology fork() {
+    return morphio::Morphology(
+        "1 1 0 0 0 1 -1\n"
+        "2 3 0 0 0 1 1\n"
+        "3 3 10 0 0 1 2\n"
+        "4 3 10 10 0 2 3\n"
+        "5 3 20 0 0 1 3\n",
+        "swc");
+}
+
+void checkPoint(const morphio::Point& actual, const morphio::Point& expected) {
+    for (size_t k = 0; k < 3; ++k) {
+        CHECK(actual[k] == Approx(expected[k]));
+    }
+}
+}  // namespace
+
+TEST_CASE("clip box", "[clip]") {
+    using morphio::clip::Box;
+    const auto clipped = morphio::clip::clip(fork(), Box{{-1, -1, -1}, {15, 5, 1}}, 2);
+    const auto& morphology = clipped.morphology;
+
+    REQUIRE(morphology.sections().size() == 3);
+    CHECK(clipped.sections == std::vector<uint32_t>{0, 1, 2});
+    CHECK(clipped.offsets == std::vector<morphio::floatType>{0, 1, 0, 0.5, 0, 0.5});
+    CHECK(morphology.rootSections().size() == 1);
+    CHECK(morphology.section(1).parent().id() == 0);
+    CHECK(morphology.section(2).parent().id() == 0);
+    CHECK(morphology.soma().points().size() == 1);
+
+    const auto child = morphology.section(1);
+    checkPoint(child.points()[1], {10, 5, 0});
+    CHECK(child.diameters()[1] == Approx(3));
+    checkPoint(morphology.section(2).points()[1], {15, 0, 0});
+}
+
+TEST_CASE("clip plane", "[clip]") {
+    using morphio::clip::Plane;
+    const auto clipped = morphio::clip::clip(fork(), Plane{{5, 0, 0}, {2, 0, 0}});
+    const auto& morphology = clipped.morphology;
+
+    REQUIRE(morphology.sections().size() == 3);
+    CHECK(clipped.offsets == std::vector<morphio::floatType>{0.5, 1, 0, 1, 0, 1});
+    checkPoint(morphology.section(0).points()[0], {5, 0, 0});
+    CHECK(morphology.rootSections().size() == 1);
+    CHECK(morphology.section(0).children().size() == 2);
+
+    // the soma is outside
+    CHECK(morphology.soma().points().empty());
+    CHECK(morphology.somaType() == morphio::SOMA_UNDEFINED);
+}
+
+TEST_CASE("clip slab", "[clip]") {
+    using morphio::clip::Plane;
+    using morphio::clip::Slab;
+    const auto clipped = morphio::clip::clip(fork(), Slab{Plane{{0, 2, 0}, {0, 1, 0}}, 3});
+    const auto& morphology = clipped.morphology;
+
+    // only the part of the child along y between 2 and 5 is kept, as a root section
+    REQUIRE(morphology.sections().size() == 1);
+    CHECK(clipped.sections == std::vector<uint32_t>{1});
+    CHECK(morphology.section(0).isRoot());
+    CHECK(clipped.offsets[0] == Approx(0.2));
+    CHECK(clipped.offsets[1] == Approx(0.5));
+    checkPoint(morphology.points()[0], {10, 2, 0});
+    checkPoint(morphology.points()[1], {10, 5, 0});
+    CHECK(morphology.diameters()[0] == Approx(2.4));
+    CHECK(morphology.diameters()[1] == Approx(3));
+}
+
+TEST_CASE("clip section leaving and entering the region", "[clip]") {
+    using morphio::clip::Plane;
+    const morphio::Morphology zigzag(
+        "1 1 0 0 0 1 -1\n"
+        "2 3 0 0 0 1 1\n"
+        "3 3 5 10 0 1 2\n"
+        "4 3 10 0 0 1 3\n",
+        "swc");
+    const auto clipped = morphio::clip::clip(zigzag, Plane{{0, 5, 0}, {0, -1, 0}});
+
+    REQUIRE(clipped.morphology.sections().size() == 2);
+    CHECK(clipped.sections == std::vector<uint32_t>{0, 0});
+    CHECK(clipped.offsets == std::vector<morphio::floatType>{0, 0.5, 1.5, 2});
+    CHECK(clipped.morphology.rootSections().size() == 2);
+    checkPoint(clipped.morphology.section(1).points()[0], {7.5, 5, 0});
+}
+
+TEST_CASE("clip invalid regions", "[clip]") {
+    using namespace morphio::clip;
+    const auto morphology = fork();
+    CHECK_THROWS_AS(clip(morphology, Box{{1, 0, 0}, {0, 1, 1}}), morphio::MorphioError);
+    CHECK_THROWS_AS(clip(morphology, Plane{{0, 0, 0}, {0, 0, 0}}), morphio::MorphioError);
+    CHECK_THROWS_AS(clip(morphology, Slab{Plane{{0, 0, 0}, {1, 0, 0}}, -1}),
+                    morphio::MorphioError);
+}
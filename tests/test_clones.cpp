@@ -0,0 +1,98 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include <morphio/clones.h>
+#include <morphio/morphology.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+
+namespace {
+morphio::floatType distance(const morphio::Point& a, const morphio::Point& b) {
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) +
+                     (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+morphio::floatType segmentLength(const morphio::Section& section, size_t i) {
+    return distance(section.points()[i], section.points()[i + 1]);
+}
+
+/** The first point of every child section is still the last point of its parent */
+void checkConnected(const morphio::Morphology& morphology) {
+    for (const auto& section : morphology.sections()) {
+        if (!section.isRoot()) {
+            const auto parentPoints = section.parent().points();
+            const auto& last = parentPoints[parentPoints.size() - 1];
+            CHECK(distance(section.points()[0], last) == Approx(0).margin(1e-3));
+        }
+    }
+}
+}  // namespace
+
+TEST_CASE("clones", "[clones]") {
+    using morphio::clones::CloneParameters;
+    const morphio::Morphology exemplar("data/complexe.swc");
+
+    SECTION("no transformation") {
+        const auto clone = morphio::clones::clone(exemplar, CloneParameters(), 42);
+        CHECK(clone.points() == exemplar.points());
+        CHECK(clone.diameters() == exemplar.diameters());
+        CHECK(clone.connectivity() == exemplar.connectivity());
+    }
+
+    CloneParameters parameters;
+    parameters.scaleSigma = 0.1f;
+    parameters.lengthSigma = 0.1f;
+    parameters.angleSigma = 0.2f;
+    parameters.subtreeRotation = 0.5f;
+
+    SECTION("deterministic") {
+        const auto batch = morphio::clones::clones(exemplar, parameters, 8, 42, 10, 3);
+        REQUIRE(batch.size() == 8);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            CHECK(batch[i].points() ==
+                  morphio::clones::clone(exemplar, parameters, 42, 10 + i).points());
+            CHECK(batch[i].diameters() == exemplar.diameters());
+            CHECK(batch[i].sectionTypes() == exemplar.sectionTypes());
+            checkConnected(batch[i]);
+        }
+        CHECK(batch[0].points() != batch[1].points());
+        CHECK(morphio::clones::clone(exemplar, parameters, 43, 10).points() != batch[0].points());
+    }
+
+    SECTION("rotations keep the segment lengths") {
+        CloneParameters rotations;
+        rotations.angleSigma = 0.3f;
+        rotations.subtreeRotation = 1;
+        const auto clone = morphio::clones::clone(exemplar, rotations, 7);
+        CHECK(clone.points() != exemplar.points());
+        checkConnected(clone);
+        const auto sections = exemplar.sections();
+        const auto clonedSections = clone.sections();
+        for (size_t s = 0; s < sections.size(); ++s) {
+            for (size_t i = 0; i + 1 < sections[s].points().size(); ++i) {
+                CHECK(segmentLength(clonedSections[s], i) ==
+                      Approx(segmentLength(sections[s], i)).epsilon(1e-4));
+            }
+        }
+    }
+
+    SECTION("scaling") {
+        CloneParameters scaling;
+        scaling.scaleSigma = 0.2f;
+        const auto clone = morphio::clones::clone(exemplar, scaling, 3);
+        const auto center = exemplar.soma().center();
+        const auto& points = exemplar.points();
+        const auto& cloned = clone.points();
+        const auto factor = distance(cloned.back(), center) / distance(points.back(), center);
+        CHECK(factor != Approx(1));
+        for (size_t i = 0; i < points.size(); ++i) {
+            CHECK(distance(cloned[i], center) ==
+                  Approx(factor * distance(points[i], center)).epsilon(1e-4));
+        }
+    }
+}
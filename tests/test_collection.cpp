@@ -9,7 +9,11 @@
 #include <morphio/mut/morphology.h>
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
 namespace fs = std::filesystem;
 
 template <class T>
@@ -217,3 +221,159 @@ TEST_CASE("LoadUnordered::Iterator", "[collection]") {
     REQUIRE((*begin).first == k_begin);
     REQUIRE((*++it).first != k_begin);
 }
+
+namespace {
+/** A `ByteSource` serving copies of files from `data/`, counting the reads */
+class InMemorySource: public morphio::ByteSource
+{
+  public:
+    explicit InMemorySource(const std::vector<std::string>& paths) {
+        for (const auto& path : paths) {
+            std::ifstream file(fs::path("data") / path, std::ios::binary);
+            std::stringstream contents;
+            contents << file.rdbuf();
+            auto p = fs::path(path);
+            _morphologies[(p.parent_path() / p.stem()).string()] = {contents.str(), p.extension().string()};
+        }
+    }
+
+    morphio::MorphologyBytes get(const std::string& morph_name) const override {
+        ++n_reads;
+        auto it = _morphologies.find(morph_name);
+        if (it == _morphologies.end()) {
+            throw morphio::MorphioError("Morphology '" + morph_name + "' not found");
+        }
+        return it->second;
+    }
+
+    mutable std::atomic<size_t> n_reads{0};
+
+  private:
+    std::map<std::string, morphio::MorphologyBytes> _morphologies;
+};
+}  // namespace
+
+TEST_CASE("Collection from a ByteSource", "[collection]") {
+    auto source = std::make_shared<InMemorySource>(
+        std::vector<std::string>{"simple.swc", "soma_cylinders.swc", "h5/v1/simple.h5"});
+    auto collection = morphio::Collection(source);
+
+    SECTION("load") {
+        check_collection_vs_single_file<morphio::Morphology>(collection,
+                                                             "soma_cylinders",
+                                                             "data/soma_cylinders.swc");
+        check_collection_vs_single_file<morphio::mut::Morphology>(collection,
+                                                                  "simple",
+                                                                  "data/simple.swc");
+        CHECK(source->n_reads == 2);
+        CHECK_THROWS_AS(collection.load<morphio::Morphology>("missing"), morphio::MorphioError);
+    }
+
+    SECTION("h5") {
+        check_collection_vs_single_file<morphio::Morphology>(collection,
+                                                             "h5/v1/simple",
+                                                             "data/h5/v1/simple.h5");
+    }
+
+    SECTION("load_unordered") {
+        // more names than a single batch
+        std::vector<std::string> morphology_names;
+        for (size_t i = 0; i < 20; ++i) {
+            morphology_names.emplace_back(i % 2 ? "simple" : "soma_cylinders");
+        }
+
+        std::vector<size_t> loop_indices;
+        for (auto [k, morph] :
+             collection.load_unordered<morphio::mut::Morphology>(morphology_names)) {
+            CHECK(morph.rootSections().size() ==
+                  collection.load<morphio::mut::Morphology>(morphology_names[k])
+                      .rootSections()
+                      .size());
+            loop_indices.push_back(k);
+        }
+        check_loop_indices(loop_indices, morphology_names.size());
+    }
+
+    CHECK_THROWS_AS(morphio::Collection(std::shared_ptr<morphio::ByteSource>()),
+                    std::invalid_argument);
+}
+
+TEST_CASE("Collection of glial cells and dendritic spines", "[collection]") {
+    for (const auto& collection_path :
+         std::vector<std::string>{"data/h5/v1", "data/h5/v1/merged.h5"}) {
+        DYNAMIC_SECTION(collection_path) {
+            auto collection = morphio::Collection(collection_path);
+
+            auto glia = collection.load<morphio::GlialCell>("glia");
+            auto expected_glia = morphio::GlialCell("data/h5/v1/glia.h5");
+            CHECK(glia.points() == expected_glia.points());
+
+            auto spine = collection.load<morphio::DendriticSpine>("simple-dendritric-spine");
+            auto expected_spine = morphio::DendriticSpine("data/h5/v1/simple-dendritric-spine.h5");
+            CHECK(spine.points() == expected_spine.points());
+            CHECK(spine.postSynapticDensity().size() ==
+                  expected_spine.postSynapticDensity().size());
+
+            CHECK_THROWS_AS(collection.load<morphio::GlialCell>("simple"), morphio::RawDataError);
+            CHECK_THROWS_AS(collection.load<morphio::DendriticSpine>("glia"),
+                            morphio::RawDataError);
+
+            auto morphology_names = std::vector<std::string>{"simple-dendritric-spine",
+                                                             "simple-dendritric-spine"};
+            std::vector<size_t> loop_indices;
+            for (auto [k, morph] :
+                 collection.load_unordered<morphio::DendriticSpine>(morphology_names)) {
+                CHECK(morph.points() == expected_spine.points());
+                loop_indices.push_back(k);
+            }
+            check_loop_indices(loop_indices, morphology_names.size());
+        }
+    }
+}
+
+TEST_CASE("Collection::record_accesses", "[collection]") {
+    auto trace = std::make_shared<morphio::AccessTrace>();
+
+    SECTION("directory") {
+        auto collection = morphio::Collection("data", {".swc"});
+        collection.load<morphio::Morphology>("simple");
+        collection.record_accesses(trace);
+        CHECK(collection.access_trace() == trace);
+
+        collection.load<morphio::mut::Morphology>("soma_cylinders");
+        for (auto [k, morph] : collection.load_unordered<morphio::Morphology>(
+                 std::vector<std::string>{"complexe", "simple"})) {
+        }
+        CHECK(trace->names() ==
+              std::vector<std::string>{"soma_cylinders", "complexe", "simple"});
+
+        collection.record_accesses(nullptr);
+        collection.load<morphio::Morphology>("simple");
+        CHECK(trace->names().size() == 3);
+    }
+
+    SECTION("ByteSource") {
+        auto source = std::make_shared<InMemorySource>(
+            std::vector<std::string>{"simple.swc", "soma_cylinders.swc"});
+        auto collection = morphio::Collection(source);
+        collection.record_accesses(trace);
+
+        for (auto [k, morph] : collection.load_unordered<morphio::Morphology>(
+                 std::vector<std::string>{"soma_cylinders", "simple"})) {
+        }
+        CHECK(trace->names() == std::vector<std::string>{"soma_cylinders", "simple"});
+    }
+
+    SECTION("save and read") {
+        trace->record("simple");
+        trace->record("soma_cylinders");
+
+        const auto path = fs::temp_directory_path() / "test_collection.cpp.trace";
+        trace->save(path.string());
+        CHECK(morphio::AccessTrace::read(path.string()) == trace->names());
+
+        trace->clear();
+        CHECK(trace->names().empty());
+        CHECK_THROWS_AS(morphio::AccessTrace::read("data/missing.trace"), morphio::MorphioError);
+    }
+}
@@ -0,0 +1,125 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// Run with several ranks, e.g. `mpiexec -n 3 unittests_mpi`
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+
+#include <mpi.h>
+
+#include <morphio/collection.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+const std::string collection_dir = "data/h5/v1";
+
+const std::vector<std::string> morphology_names{
+    "simple", "glia", "mitochondria", "endoplasmic-reticulum", "simple-dendritric-spine"};
+
+/** The loop indices loaded by all the ranks, sorted */
+std::vector<size_t> all_loop_indices(const std::vector<size_t>& loop_indices) {
+    int n_ranks = 0;
+    MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+
+    std::vector<uint64_t> local(loop_indices.begin(), loop_indices.end());
+    auto count = static_cast<int>(local.size());
+    std::vector<int> counts(static_cast<size_t>(n_ranks));
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    std::vector<int> displacements(counts.size(), 0);
+    for (size_t r = 1; r < counts.size(); ++r) {
+        displacements[r] = displacements[r - 1] + counts[r - 1];
+    }
+
+    std::vector<uint64_t> all(static_cast<size_t>(displacements.back() + counts.back()));
+    MPI_Allgatherv(local.data(),
+                   count,
+                   MPI_UINT64_T,
+                   all.data(),
+                   counts.data(),
+                   displacements.data(),
+                   MPI_UINT64_T,
+                   MPI_COMM_WORLD);
+    std::sort(all.begin(), all.end());
+    return {all.begin(), all.end()};
+}
+}  // namespace
+
+TEST_CASE("Collection::load_share", "[collection][mpi]") {
+    morphio::Collection collection(collection_dir + "/merged.h5", MPI_COMM_WORLD);
+
+    SECTION("immutable") {
+        const auto share = collection.load_share<morphio::Morphology>(morphology_names);
+
+        std::vector<size_t> loop_indices;
+        for (const auto& loaded : share) {
+            loop_indices.push_back(loaded.first);
+
+            const auto& actual = loaded.second;
+            const morphio::Morphology expected(collection_dir + "/" +
+                                               morphology_names[loaded.first] + ".h5");
+            CHECK(actual.points() == expected.points());
+            CHECK(actual.diameters() == expected.diameters());
+            CHECK(actual.perimeters() == expected.perimeters());
+            CHECK(actual.sectionTypes() == expected.sectionTypes());
+            CHECK(actual.sectionOffsets() == expected.sectionOffsets());
+            CHECK(actual.soma().points() == expected.soma().points());
+        }
+
+        const auto all = all_loop_indices(loop_indices);
+        REQUIRE(all.size() == morphology_names.size());
+        for (size_t i = 0; i < all.size(); ++i) {
+            CHECK(all[i] == i);
+        }
+    }
+
+    SECTION("mutable") {
+        const auto share = collection.load_share<morphio::mut::Morphology>(morphology_names);
+
+        std::vector<size_t> loop_indices;
+        for (const auto& loaded : share) {
+            loop_indices.push_back(loaded.first);
+
+            const morphio::mut::Morphology expected(collection_dir + "/" +
+                                                    morphology_names[loaded.first] + ".h5");
+            CHECK(loaded.second.sections().size() == expected.sections().size());
+        }
+        CHECK(all_loop_indices(loop_indices).size() == morphology_names.size());
+    }
+
+    SECTION("more ranks than morphologies") {
+        const std::vector<std::string> names{"simple"};
+        const auto share = collection.load_share<morphio::Morphology>(names);
+
+        std::vector<size_t> loop_indices;
+        for (const auto& loaded : share) {
+            loop_indices.push_back(loaded.first);
+        }
+        CHECK(all_loop_indices(loop_indices) == std::vector<size_t>{0});
+    }
+
+    collection.close();
+}
+
+TEST_CASE("Collection::load_share serial", "[collection][mpi]") {
+    morphio::Collection collection(collection_dir);
+    CHECK_THROWS_AS(collection.load_share<morphio::Morphology>(morphology_names),
+                    morphio::MorphioError);
+}
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+    const int result = Catch::Session().run(argc, argv);
+
+    // a failure on any rank fails the run
+    int failed = result != 0 ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Finalize();
+    return failed;
+}
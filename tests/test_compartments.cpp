@@ -0,0 +1,127 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <morphio/compartments.h>
+#include <morphio/morphology.h>
+
+namespace {
+/** Check the Hines order, and that every node keeps its parent of the single cell numbering */
+void checkForest(const morphio::compartments::CompartmentTree& forest,
+                 const std::vector<morphio::compartments::CompartmentTree>& cells) {
+    std::vector<size_t> sizes(cells.size(), 0);
+    for (size_t i = 0; i < forest.size(); ++i) {
+        const auto cell = static_cast<size_t>(forest.cells[i]);
+        const auto node = static_cast<size_t>(forest.cellNodes[i]);
+        ++sizes[cell];
+        CHECK(forest.parents[i] < static_cast<int32_t>(i));
+        CHECK(forest.sections[i] == cells[cell].sections[node]);
+        CHECK(forest.areas[i] == cells[cell].areas[node]);
+        if (forest.parents[i] < 0) {
+            CHECK(cells[cell].parents[node] == -1);
+        } else {
+            const auto parent = static_cast<size_t>(forest.parents[i]);
+            CHECK(forest.cells[parent] == forest.cells[i]);
+            CHECK(forest.cellNodes[parent] == cells[cell].parents[node]);
+        }
+    }
+    for (size_t c = 0; c < cells.size(); ++c) {
+        CHECK(sizes[c] == cells[c].size());
+    }
+}
+}  // anonymous namespace
+
+TEST_CASE("compartmentalize", "[compartments]") {
+    using namespace morphio::compartments;
+    const double PI = morphio::PI;
+    const auto morphology = morphio::Morphology("data/simple.swc");
+
+    SECTION("one compartment per section") {
+        const auto tree = compartmentalize(morphology);
+        CHECK(tree.parents == std::vector<int32_t>{-1, 0, 1, 1, 0, 4, 4});
+        CHECK(tree.sections == std::vector<int32_t>{-1, 0, 1, 2, 3, 4, 5});
+        CHECK(tree.cellNodes == std::vector<int32_t>{0, 1, 2, 3, 4, 5, 6});
+
+        // soma: single point of diameter 2
+        CHECK_THAT(tree.areas[0], Catch::WithinRel(4 * PI, 1e-5));
+        CHECK_THAT(tree.diameters[0], Catch::WithinRel(2., 1e-5));
+        CHECK(tree.axialResistanceFactors[0] == 0);
+
+        // section 0: cylinder of radius 1 and length 5
+        CHECK_THAT(tree.areas[1], Catch::WithinRel(10 * PI, 1e-5));
+        CHECK(tree.centers[1] == morphio::Point{0, 2.5, 0});
+        CHECK_THAT(tree.axialResistanceFactors[1], Catch::WithinRel(2.5 / PI, 1e-5));
+
+        // section 1: radius from 1 to 1.5 over 5; half of section 0, then the first half of
+        // section 1 (radius from 1 to 1.25)
+        CHECK_THAT(tree.diameters[2], Catch::WithinRel(2.5, 1e-5));
+        CHECK_THAT(tree.axialResistanceFactors[2], Catch::WithinRel(2.5 / PI + 2 / PI, 1e-5));
+        CHECK_THAT(tree.areas[2],
+                   Catch::WithinRel(PI * (1 + 1.5) * std::sqrt(25 + 0.25), 1e-5));
+
+        const auto noSoma = compartmentalize(morphology, {0, false});
+        CHECK(noSoma.parents == std::vector<int32_t>{-1, 0, 0, -1, 3, 3});
+        CHECK(noSoma.axialResistanceFactors[0] == 0);
+    }
+
+    SECTION("max length") {
+        CompartmentOptions options;
+        options.maxLength = 2;
+        const auto tree = compartmentalize(morphology, options);
+
+        // section 0 (length 5) is split in 3 compartments
+        CHECK(std::vector<int32_t>(tree.sections.begin(), tree.sections.begin() + 4) ==
+              std::vector<int32_t>{-1, 0, 0, 0});
+        CHECK(std::vector<int32_t>(tree.parents.begin(), tree.parents.begin() + 4) ==
+              std::vector<int32_t>{-1, 0, 1, 2});
+        morphio::floatType sectionArea = 0;
+        for (size_t i = 1; i < 4; ++i) {
+            sectionArea += tree.areas[i];
+            const double center = 5. / 3 * (static_cast<double>(i) - 0.5);
+            CHECK_THAT(tree.centers[i][1], Catch::WithinRel(center, 1e-5));
+        }
+        CHECK_THAT(sectionArea, Catch::WithinRel(10 * PI, 1e-5));
+        CHECK_THAT(tree.axialResistanceFactors[2], Catch::WithinRel(5. / 3 / PI, 1e-5));
+
+        for (size_t i = 0; i < tree.size(); ++i) {
+            CHECK(tree.parents[i] < static_cast<int32_t>(i));
+        }
+        CHECK_THROWS_AS(compartmentalize(morphology, {-1}), morphio::MorphioError);
+    }
+
+    SECTION("populations") {
+        const std::vector<morphio::Morphology> morphologies{
+            morphology, morphio::Morphology("data/complexe.swc"), morphology};
+        CompartmentOptions options;
+        options.maxLength = 3;
+        std::vector<CompartmentTree> cells;
+        for (const auto& m : morphologies) {
+            cells.push_back(compartmentalize(m, options));
+        }
+
+        const auto concatenated = compartmentalize(morphologies, options);
+        checkForest(concatenated, cells);
+        CHECK(concatenated.cells.front() == 0);
+        CHECK(concatenated.cells.back() == 2);
+
+        options.ordering = INTERLEAVED;
+        for (const unsigned int groupSize : {1u, 2u, 32u}) {
+            options.groupSize = groupSize;
+            const auto interleaved = compartmentalize(morphologies, options);
+            checkForest(interleaved, cells);
+        }
+
+        // the roots of the cells of a group come first, then the nodes of the next level in turn
+        options.groupSize = 32;
+        const auto interleaved = compartmentalize(morphologies, options);
+        CHECK(interleaved.cells[0] == 0);
+        CHECK(interleaved.cells[1] == 1);
+        CHECK(interleaved.cells[2] == 2);
+        CHECK(interleaved.parents[0] == -1);
+        CHECK(interleaved.parents[2] == -1);
+        CHECK(interleaved.cells[3] == 0);
+        CHECK(interleaved.cells[4] == 1);
+    }
+}
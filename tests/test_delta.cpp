@@ -0,0 +1,149 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+
+#include <morphio/delta.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+#include <morphio/mut/soma.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+
+namespace {
+void checkEqual(const morphio::Morphology& a, const morphio::Morphology& b) {
+    CHECK(a.points() == b.points());
+    CHECK(a.diameters() == b.diameters());
+    CHECK(a.perimeters() == b.perimeters());
+    CHECK(a.sectionTypes() == b.sectionTypes());
+    CHECK(a.sectionOffsets() == b.sectionOffsets());
+    CHECK(a.connectivity() == b.connectivity());
+    CHECK(a.soma().points() == b.soma().points());
+    CHECK(a.soma().diameters() == b.soma().diameters());
+    CHECK(a.somaType() == b.somaType());
+    CHECK(a.version() == b.version());
+}
+}  // namespace
+
+TEST_CASE("Delta", "[delta]") {
+    namespace delta = morphio::delta;
+    const morphio::Morphology base("data/complexe.swc");
+
+    morphio::mut::Morphology mutable_(base);
+    mutable_.section(0)->diameters()[0] *= 2;
+    const auto leaf = mutable_.section(base.sections().back().id());
+    leaf->appendSection(
+        morphio::Property::PointLevel({leaf->points().back(), {10, 10, 10}}, {1, 1}),
+        morphio::SECTION_DENDRITE);
+    const morphio::Morphology variant(mutable_);
+
+    SECTION("diff and apply") {
+        const auto d = delta::diff(base, variant, "complexe");
+        CHECK(d.base == "complexe");
+        CHECK(d.size() == variant.sections().size());
+        CHECK_FALSE(d.somaChanged);
+        size_t stored = 0;
+        for (const auto section : d.baseSections) {
+            stored += section == -1;
+        }
+        // the modified section and the new one
+        CHECK(stored == 2);
+        CHECK(d.offsets.size() == 3);
+        checkEqual(delta::apply(base, d), variant);
+
+        const auto identity = delta::diff(base, base);
+        CHECK(identity.points.empty());
+        checkEqual(delta::apply(base, identity), base);
+    }
+
+    SECTION("soma") {
+        morphio::mut::Morphology moved(base);
+        moved.soma()->points()[0][0] += 1;
+        const morphio::Morphology movedSoma(moved);
+        const auto d = delta::diff(base, movedSoma);
+        CHECK(d.somaChanged);
+        CHECK(d.points.empty());
+        checkEqual(delta::apply(base, d), movedSoma);
+    }
+
+    SECTION("serialization") {
+        const auto d = delta::diff(base, variant, "complexe");
+        const auto contents = delta::serialize(d);
+        checkEqual(delta::apply(base, delta::deserialize(contents)), variant);
+
+        CHECK_THROWS_AS(delta::deserialize("not a delta"), morphio::RawDataError);
+        CHECK_THROWS_AS(delta::deserialize(contents.substr(0, contents.size() - 1)),
+                        morphio::RawDataError);
+        CHECK_THROWS_AS(delta::deserialize(contents + "x"), morphio::RawDataError);
+    }
+
+    SECTION("perimeters") {
+        morphio::mut::Morphology withPerimeters;
+        withPerimeters.soma()->points() = {{0, 0, 0}};
+        withPerimeters.soma()->diameters() = {2};
+        const auto root = withPerimeters.appendRootSection(
+            morphio::Property::PointLevel({{0, 0, 0}, {0, 5, 0}}, {1, 1}, {3, 3}),
+            morphio::SECTION_AXON);
+        root->appendSection(morphio::Property::PointLevel({{0, 5, 0}, {5, 5, 0}}, {1, 1}, {3, 4}),
+                            morphio::SECTION_AXON);
+        const morphio::Morphology perimetersBase(withPerimeters);
+        REQUIRE(perimetersBase.perimeters().size() == 4);
+
+        // no section is stored, the perimeters all come from the base
+        const auto identity = delta::diff(perimetersBase, perimetersBase);
+        CHECK(identity.hasPerimeters);
+        CHECK(identity.perimeters.empty());
+        checkEqual(delta::apply(perimetersBase, identity), perimetersBase);
+
+        withPerimeters.soma()->diameters() = {4};
+        const morphio::Morphology biggerSoma(withPerimeters);
+        const auto somaOnly = delta::deserialize(
+            delta::serialize(delta::diff(perimetersBase, biggerSoma)));
+        CHECK(somaOnly.hasPerimeters);
+        CHECK(somaOnly.somaChanged);
+        checkEqual(delta::apply(perimetersBase, somaOnly), biggerSoma);
+
+        withPerimeters.section(1)->perimeters() = {3, 5};
+        const morphio::Morphology changed(withPerimeters);
+        const auto d = delta::deserialize(delta::serialize(delta::diff(perimetersBase, changed)));
+        CHECK(d.perimeters == std::vector<morphio::floatType>{3, 5});
+        checkEqual(delta::apply(perimetersBase, d), changed);
+
+        // the base has no perimeters to copy
+        CHECK_THROWS_AS(delta::apply(base, identity), morphio::RawDataError);
+    }
+
+    SECTION("mismatched base") {
+        auto d = delta::diff(base, variant);
+        d.baseSections[0] = 1000;
+        CHECK_THROWS_AS(delta::apply(base, d), morphio::RawDataError);
+        d = delta::diff(base, variant);
+        d.offsets.pop_back();
+        CHECK_THROWS_AS(delta::apply(base, d), morphio::RawDataError);
+    }
+
+    SECTION("VariantCollection") {
+        const auto tmpDirectory = std::filesystem::temp_directory_path() / "test_delta.cpp";
+        std::filesystem::remove_all(tmpDirectory);
+        std::filesystem::create_directories(tmpDirectory);
+
+        delta::write(delta::diff(base, variant, "complexe"),
+                     (tmpDirectory / "variant.delta").string());
+        delta::write(delta::diff(base, base, "complexe"),
+                     (tmpDirectory / "identity.delta").string());
+
+        const delta::VariantCollection collection(morphio::Collection("data", {".swc"}),
+                                                  tmpDirectory.string(),
+                                                  1);
+        checkEqual(collection.load("variant"), variant);
+        checkEqual(collection.load("identity"), base);
+        checkEqual(collection.base("complexe"), base);
+        CHECK_THROWS_AS(collection.load("missing"), morphio::RawDataError);
+
+        std::filesystem::remove_all(tmpDirectory);
+    }
+}
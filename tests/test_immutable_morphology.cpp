@@ -234,7 +234,7 @@ TEST_CASE("iter", "[immutableMorphology]") {
 
 TEST_CASE("section_offsets", "[immutableMorphology]") {
     Files files;
-    std::vector<uint32_t> expectedSectionOffsets = {0, 2, 4, 6, 8, 10, 12};
+    std::vector<uint64_t> expectedSectionOffsets = {0, 2, 4, 6, 8, 10, 12};
     for (const auto& morph : files.morphs()) {
         REQUIRE(morph.sectionOffsets() == expectedSectionOffsets);
     }
@@ -0,0 +1,62 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+
+#include <morphio/collection.h>
+#include <morphio/layout.h>
+#include <morphio/morphology.h>
+
+namespace fs = std::filesystem;
+
+TEST_CASE("layout::accessOrder", "[layout]") {
+    using names = std::vector<std::string>;
+    const names morphology_names{"a", "b", "c", "d", "e", "f"};
+
+    SECTION("chains in the order of first access") {
+        // "x" is not in the container and is skipped
+        const auto order = morphio::layout::accessOrder(
+            morphology_names, {{"c", "d", "e"}, {"c", "d"}, {"a", "x", "f"}});
+        CHECK(order == names{"c", "d", "e", "a", "f", "b"});
+    }
+
+    SECTION("the most frequent pairs are adjacent") {
+        const auto order = morphio::layout::accessOrder(
+            morphology_names, {{"a", "b", "c"}, {"a", "c"}, {"a", "c"}, {"a", "c"}});
+        CHECK(order == names{"b", "a", "c", "d", "e", "f"});
+    }
+
+    SECTION("no traces") {
+        CHECK(morphio::layout::accessOrder(morphology_names, {}) == morphology_names);
+    }
+}
+
+TEST_CASE("layout::reorderContainer", "[layout]") {
+    const std::string input = "data/h5/v1/merged.h5";
+    const auto output = (fs::temp_directory_path() / "test_layout.cpp.h5").string();
+
+    const std::vector<std::vector<std::string>> traces{{"glia", "simple"},
+                                                       {"mitochondria", "glia", "simple"}};
+    morphio::layout::reorderContainer(input, output, traces);
+
+    const morphio::Collection reordered(output);
+    // one chain, starting from its end accessed first
+    const std::vector<std::string> accessed{"simple", "glia", "mitochondria"};
+    CHECK(reordered.argsort(accessed) == std::vector<size_t>{0, 1, 2});
+
+    const morphio::Collection original(input);
+    for (const auto& name : std::vector<std::string>{"simple",
+                                                     "glia",
+                                                     "mitochondria",
+                                                     "endoplasmic-reticulum",
+                                                     "simple-dendritric-spine"}) {
+        CHECK(reordered.load<morphio::Morphology>(name).points() ==
+              original.load<morphio::Morphology>(name).points());
+    }
+
+    CHECK_THROWS_AS(morphio::layout::reorderContainer(input, input, traces),
+                    morphio::WriterError);
+}
@@ -0,0 +1,169 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <morphio/mesh.h>
+#include <morphio/morphology.h>
+
+namespace {
+
+/** Every edge must be used exactly once in each direction */
+bool isClosed(const morphio::mesh::Mesh& mesh) {
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (const auto& triangle : mesh.triangles) {
+        for (size_t i = 0; i < 3; ++i) {
+            ++edges[{triangle[i], triangle[(i + 1) % 3]}];
+        }
+    }
+    for (const auto& edge : edges) {
+        const auto reverse = edges.find({edge.first.second, edge.first.first});
+        if (edge.second != 1 || reverse == edges.end() || reverse->second != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Volume enclosed by the triangles of the given section */
+double sectionVolume(const morphio::mesh::Mesh& mesh, uint32_t sectionId) {
+    double volume = 0;
+    for (size_t i = 0; i < mesh.triangles.size(); ++i) {
+        if (mesh.triangleSections[i] != sectionId) {
+            continue;
+        }
+        const auto& a = mesh.vertices[mesh.triangles[i][0]];
+        const auto& b = mesh.vertices[mesh.triangles[i][1]];
+        const auto& c = mesh.vertices[mesh.triangles[i][2]];
+        volume += static_cast<double>(a[0] * (b[1] * c[2] - b[2] * c[1]) +
+                                      a[1] * (b[2] * c[0] - b[0] * c[2]) +
+                                      a[2] * (b[0] * c[1] - b[1] * c[0])) /
+                  6;
+    }
+    return volume;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("tessellate", "[mesh]") {
+    using namespace morphio::mesh;
+    const auto m = morphio::Morphology("data/simple.swc");
+    const double pi = std::acos(-1.);
+
+    SECTION("tubes") {
+        MeshOptions options;
+        options.resolution = 64;
+        const auto mesh = tessellate(m, options);
+
+        // 6 sections of 2 points: 2 rings and 2 cap centers each
+        CHECK(mesh.vertices.size() == 6 * (2 * 64 + 2));
+        CHECK(mesh.triangles.size() == 6 * 2 * 2 * 64);
+        CHECK(mesh.triangleSections.size() == mesh.triangles.size());
+        CHECK(isClosed(mesh));
+
+        // Section 0: a cylinder of length 5 and radius 1
+        const double polygonFactor = 64 / (2 * pi) * std::sin(2 * pi / 64);
+        CHECK_THAT(sectionVolume(mesh, 0), Catch::WithinRel(5 * pi * polygonFactor, 1e-4));
+        // Section 1: a frustum of length 5 and radii 1 and 1.5
+        CHECK_THAT(sectionVolume(mesh, 1),
+                   Catch::WithinRel(pi * 5 / 3 * (1 + 1.5 + 1.5 * 1.5) * polygonFactor, 1e-4));
+    }
+
+    SECTION("frustums and capsules") {
+        const auto complexe = morphio::Morphology("data/complexe.swc");
+        for (const auto style : {FRUSTUMS, CAPSULES}) {
+            MeshOptions options;
+            options.style = style;
+            const auto mesh = tessellate(complexe, options);
+            CHECK(isClosed(mesh));
+            for (uint32_t id = 0; id < complexe.sectionTypes().size(); ++id) {
+                CHECK(sectionVolume(mesh, id) > 0);
+            }
+        }
+
+        MeshOptions options;
+        options.style = CAPSULES;
+        options.resolution = 64;
+        const auto mesh = tessellate(m, options);
+        // Cylinder of length 5 and radius 1 with two half spheres
+        CHECK_THAT(sectionVolume(mesh, 0), Catch::WithinRel(5 * pi + 4. / 3 * pi, 1e-2));
+    }
+
+    SECTION("level of detail") {
+        const auto complexe = morphio::Morphology("data/complexe.swc");
+        MeshOptions options;
+        const auto full = tessellate(complexe, options);
+        options.levelOfDetail = 1;
+        const auto coarse = tessellate(complexe, options);
+        CHECK(isClosed(coarse));
+        CHECK(coarse.triangles.size() < full.triangles.size() / 2);
+
+        options.levelOfDetail = 10;
+        const auto coarsest = tessellate(complexe, options);
+        // 3 vertices per ring, only the end points of the sections remain
+        CHECK(coarsest.triangles.size() == complexe.sectionTypes().size() * 2 * 2 * 3);
+    }
+
+    SECTION("does not depend on the number of threads") {
+        const auto complexe = morphio::Morphology("data/complexe.swc");
+        MeshOptions options;
+        options.nThreads = 1;
+        const auto serial = tessellate(complexe, options);
+        options.nThreads = 4;
+        const auto parallel = tessellate(complexe, options);
+        CHECK(serial.vertices == parallel.vertices);
+        CHECK(serial.triangles == parallel.triangles);
+        CHECK(serial.triangleSections == parallel.triangleSections);
+    }
+}
+
+TEST_CASE("writeMesh", "[mesh]") {
+    using namespace morphio::mesh;
+    const auto mesh = tessellate(morphio::Morphology("data/simple.swc"));
+
+    auto tmpDirectory = std::filesystem::temp_directory_path() / "test_mesh.cpp";
+    std::filesystem::create_directories(tmpDirectory);
+
+    SECTION("obj") {
+        const auto path = tmpDirectory / "simple.obj";
+        writeOBJ(mesh, path.string());
+
+        std::ifstream file(path);
+        std::map<char, size_t> counts;
+        std::string line;
+        while (std::getline(file, line)) {
+            ++counts[line[0]];
+        }
+        CHECK(counts['v'] == mesh.vertices.size());
+        CHECK(counts['f'] == mesh.triangles.size());
+    }
+
+    SECTION("ply") {
+        const auto path = tmpDirectory / "simple.ply";
+        writePLY(mesh, path.string());
+
+        std::ifstream file(path, std::ios::binary);
+        std::string line;
+        std::getline(file, line);
+        CHECK(line == "ply");
+        size_t headerSize = line.size() + 1;
+        while (line != "end_header") {
+            std::getline(file, line);
+            headerSize += line.size() + 1;
+        }
+        CHECK(std::filesystem::file_size(path) ==
+              headerSize + 12 * mesh.vertices.size() + 13 * mesh.triangles.size());
+    }
+
+    CHECK_THROWS_AS(writeOBJ(mesh, (tmpDirectory / "missing" / "simple.obj").string()),
+                    morphio::WriterError);
+
+    std::filesystem::remove_all(tmpDirectory);
+}
@@ -6,6 +6,7 @@
 
 #include <morphio/mito_section.h>
 #include <morphio/mitochondria.h>
+#include <morphio/mut/mitochondria.h>
 #include <morphio/section.h>
 
 #include <algorithm>
@@ -115,3 +116,60 @@ TEST_CASE("mitochondria.hasSameShape") {
 
     CHECK(mito0.rootSections()[0].hasSameShape(mito1.rootSections()[0]) == true);
 }
+
+TEST_CASE("mitochondria.flat", "[mitochondria]") {
+    const auto mito = morphio::Morphology("data/h5/v1/mitochondria.h5").mitochondria();
+
+    REQUIRE(mito.sectionOffsets() == std::vector<uint64_t>{0, 2, 6, 10});
+    REQUIRE(mito.sectionParents() == std::vector<int32_t>{-1, 0, -1});
+    REQUIRE_THAT(mito.diameters(),
+                 Catch::Approx(floatTypes{10., 20., 20., 30., 40., 50., 5., 6., 7., 8.}));
+    REQUIRE(mito.neuriteSectionIds().size() == 10);
+    REQUIRE(mito.relativePathLengths().size() == 10);
+}
+
+TEST_CASE("mut.mitochondria.appendSections", "[mitochondria]") {
+    // section 0 is a child of section 2, which is listed after it
+    const std::vector<morphio::Property::MitoSection::Type> sections{{0, 2}, {2, -1}, {4, -1}};
+    const morphio::Property::MitochondriaPointLevel points({0, 0, 1, 1, 2, 2},
+                                                           {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f},
+                                                           {1., 2., 3., 4., 5., 6.});
+
+    morphio::mut::Mitochondria mito;
+    const auto roots = mito.appendSections(sections, points);
+
+    REQUIRE(roots.size() == 2);
+    REQUIRE(roots == mito.rootSections());
+    REQUIRE(roots[0]->id() == 1);
+    REQUIRE(roots[1]->id() == 2);
+    REQUIRE(mito.children(roots[1]) == std::vector<std::shared_ptr<morphio::mut::MitoSection>>{
+                                           mito.section(0)});
+    REQUIRE(mito.section(0)->parent() == roots[1]);
+    REQUIRE(!mito.isRoot(mito.section(0)));
+    REQUIRE(mito.section(0)->diameters() == floatTypes{1., 2.});
+    REQUIRE(mito.sections().size() == 3);
+
+    // sections are still editable one by one
+    auto child = roots[0]->appendSection(points);
+    REQUIRE(child->id() == 3);
+    REQUIRE(mito.parent(child) == roots[0]);
+    REQUIRE(mito.sections().size() == 4);
+
+    // written breadth first, one mitochondrion after the other
+    morphio::Property::Properties properties;
+    mito._buildMitochondria(properties);
+    REQUIRE(properties._mitochondriaSectionLevel._sections ==
+            std::vector<morphio::Property::MitoSection::Type>{{0, -1}, {2, 0}, {8, -1}, {10, 2}});
+    REQUIRE(properties._mitochondriaPointLevel._diameters ==
+            floatTypes{3., 4., 1., 2., 3., 4., 5., 6., 5., 6., 1., 2.});
+
+    CHECK_THROWS_AS(mito.appendSections({{0, 1}}, points), morphio::SectionBuilderError);
+    CHECK_THROWS_AS(mito.appendSections({{0, -1}, {8, -1}}, points),
+                    morphio::SectionBuilderError);
+    CHECK_THROWS_AS(mito.appendSections({{0, -2}}, points), morphio::RawDataError);
+    CHECK_THROWS_AS(mito.appendSections({{0, -1}, {2, 2}, {4, 1}}, points),
+                    morphio::RawDataError);
+    // the failures appended nothing
+    CHECK(mito.sections().size() == 4);
+    CHECK(mito.rootSections().size() == 2);
+}
@@ -0,0 +1,126 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/parallel.h>
+#include <morphio/section.h>
+
+namespace {
+/** A binary tree of `depth` levels, as a single neurite */
+morphio::Morphology binaryTree(size_t depth) {
+    morphio::mut::Morphology morph;
+    const auto level = [](morphio::floatType x, morphio::floatType y) {
+        return morphio::Property::PointLevel({{x, y, 0}, {x + 1, y, 0}}, {1, 1});
+    };
+    std::vector<std::shared_ptr<morphio::mut::Section>> current{
+        morph.appendRootSection(level(0, 0), morphio::SECTION_AXON)};
+    for (size_t i = 1; i < depth; ++i) {
+        std::vector<std::shared_ptr<morphio::mut::Section>> next;
+        for (const auto& section : current) {
+            const auto& last = section->points().back();
+            for (const morphio::floatType dy : {morphio::floatType(-1), morphio::floatType(1)}) {
+                auto points = level(last[0], last[1]);
+                points._points[1][1] += dy;
+                next.push_back(section->appendSection(points, morphio::SECTION_AXON));
+            }
+        }
+        current = next;
+    }
+    return morphio::Morphology(morph);
+}
+}  // namespace
+
+TEST_CASE("parallel", "[parallel]") {
+    using morphio::parallel::forEachSection;
+    const morphio::Morphology morphology = binaryTree(11);
+    const size_t nSections = morphology.sections().size();
+    REQUIRE(nSections == 2047);
+
+    for (const unsigned int nThreads : {1U, 4U}) {
+        SECTION("unordered " + std::to_string(nThreads)) {
+            std::vector<std::atomic<int>> visits(nSections);
+            forEachSection(
+                morphology,
+                [&](const morphio::Section& section) { ++visits[section.id()]; },
+                morphio::parallel::UNORDERED,
+                nThreads);
+            for (const auto& count : visits) {
+                CHECK(count == 1);
+            }
+        }
+
+        SECTION("top down " + std::to_string(nThreads)) {
+            // the depth of the parent must already be there
+            std::vector<int> depth(nSections, -1);
+            forEachSection(
+                morphology,
+                [&](const morphio::Section& section) {
+                    depth[section.id()] = section.isRoot() ? 0 : depth[section.parent().id()] + 1;
+                },
+                morphio::parallel::TOP_DOWN,
+                nThreads);
+            for (const auto& section : morphology.sections()) {
+                CHECK(depth[section.id()] >= 0);
+                if (!section.isRoot()) {
+                    CHECK(depth[section.id()] == depth[section.parent().id()] + 1);
+                }
+            }
+            CHECK(depth.back() == 10);
+        }
+
+        SECTION("bottom up " + std::to_string(nThreads)) {
+            // the sizes of the children must already be there
+            std::vector<size_t> size(nSections, 0);
+            std::atomic<bool> ordered(true);
+            forEachSection(
+                morphology,
+                [&](const morphio::Section& section) {
+                    size_t total = 1;
+                    for (const auto& child : section.children()) {
+                        if (size[child.id()] == 0) {
+                            ordered = false;
+                        }
+                        total += size[child.id()];
+                    }
+                    size[section.id()] = total;
+                },
+                morphio::parallel::BOTTOM_UP,
+                nThreads);
+            CHECK(ordered);
+            CHECK(size[0] == nSections);
+        }
+
+        SECTION("exception " + std::to_string(nThreads)) {
+            std::atomic<size_t> visited(0);
+            CHECK_THROWS_AS(forEachSection(
+                                morphology,
+                                [&](const morphio::Section& section) {
+                                    ++visited;
+                                    if (section.id() == 3) {
+                                        throw std::runtime_error("section 3");
+                                    }
+                                },
+                                morphio::parallel::TOP_DOWN,
+                                nThreads),
+                            std::runtime_error);
+            CHECK(visited <= nSections);
+        }
+    }
+
+    SECTION("soma only") {
+        const morphio::Morphology soma("1 1 0 0 0 1 -1\n", "swc");
+        size_t visited = 0;
+        forEachSection(
+            soma, [&](const morphio::Section&) { ++visited; }, morphio::parallel::BOTTOM_UP, 4);
+        CHECK(visited == 0);
+    }
+}
@@ -81,6 +81,20 @@ TEST_CASE("morphio::SectionLevel") {
         CHECK(sl0 != sl1);
         CHECK(sl0.diff(sl1));
     }
+
+    SECTION("offsets beyond 32 bits") {
+        const int64_t large = int64_t(1) << 33;
+        auto sl1 = SectionLevel{{{large, 0}, {large + 1, 0}, {large + 2, 0}, {large + 3, 0}},
+                                sectionTypes,
+                                children};
+        CHECK(sl1._sections[3][0] == large + 3);
+        CHECK(sl0 == sl1);
+
+        auto sl2 = SectionLevel{{{large, 0}, {large + 1, 0}, {large + 2, 0}, {large + 4, 0}},
+                                sectionTypes,
+                                children};
+        CHECK(sl0 != sl2);
+    }
 }
 
 
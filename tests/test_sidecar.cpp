@@ -0,0 +1,106 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+#include <morphio/section.h>
+#include <morphio/sidecar.h>
+
+TEST_CASE("sidecar", "[sidecar]") {
+    namespace sidecar = morphio::sidecar;
+    const auto tmpDirectory = std::filesystem::temp_directory_path() / "test_sidecar.cpp";
+    std::filesystem::remove_all(tmpDirectory);
+
+    const morphio::Morphology morphology("data/complexe.swc");
+
+    SECTION("derived arrays") {
+        const auto lengths = sidecar::sectionLengths(morphology);
+        const auto distances = sidecar::pathDistances(morphology);
+        const auto order = sidecar::depthFirstOrder(morphology);
+        REQUIRE(lengths.size() == morphology.sections().size());
+        REQUIRE(order.size() == lengths.size());
+        CHECK(order[0] == morphology.rootSections()[0].id());
+        for (const auto& section : morphology.sections()) {
+            const auto parent = section.isRoot() ? 0 : distances[section.parent().id()];
+            CHECK(distances[section.id()] == Approx(parent + lengths[section.id()]));
+        }
+    }
+
+    SECTION("content hash") {
+        const auto hash = sidecar::contentHash(morphology);
+        CHECK(hash == sidecar::contentHash(morphio::Morphology("data/complexe.swc")));
+        morphio::mut::Morphology modified(morphology);
+        modified.section(0)->points()[1][0] += 1;
+        CHECK(hash != sidecar::contentHash(morphio::Morphology(modified)));
+    }
+
+    SECTION("cache") {
+        const sidecar::SidecarCache cache((tmpDirectory / "cache").string());
+        CHECK(std::filesystem::is_directory(tmpDirectory / "cache"));
+
+        size_t computed = 0;
+        const auto compute = [&computed](const morphio::Morphology& m) {
+            ++computed;
+            return sidecar::sectionLengths(m);
+        };
+        const auto first = cache.getOrCompute<morphio::floatType>(morphology, "lengths", compute);
+        const auto second = cache.getOrCompute<morphio::floatType>(morphology, "lengths", compute);
+        CHECK(computed == 1);
+        const auto expected = sidecar::sectionLengths(morphology);
+        const auto values = second->values<morphio::floatType>();
+        CHECK(std::vector<morphio::floatType>(values.begin(), values.end()) == expected);
+        CHECK(first->size() == expected.size());
+        CHECK_THROWS_AS(second->values<uint16_t>(), morphio::MorphioError);
+
+        // another instance, as another process would
+        const auto order = sidecar::SidecarCache((tmpDirectory / "cache").string())
+                               .depthFirstOrder(morphology);
+        const auto orderValues = order->values<uint32_t>();
+        CHECK(std::vector<uint32_t>(orderValues.begin(), orderValues.end()) ==
+              sidecar::depthFirstOrder(morphology));
+
+        // invalidated when the morphology changes
+        morphio::mut::Morphology modified(morphology);
+        modified.section(0)->points()[1][0] += 1;
+        cache.getOrCompute<morphio::floatType>(morphio::Morphology(modified), "lengths", compute);
+        CHECK(computed == 2);
+
+        // corrupted files are recomputed
+        const auto hash = sidecar::contentHash(morphology);
+        CHECK(cache.load(hash, "lengths", sizeof(morphio::floatType)));
+        CHECK_FALSE(cache.load(hash, "lengths", 0));
+        CHECK_THROWS_AS(cache.store(hash, "empty", nullptr, 0, 0), morphio::MorphioError);
+        for (const auto& entry : std::filesystem::directory_iterator(tmpDirectory / "cache")) {
+            // a null element size in the header, after the magic and the version
+            std::fstream file(entry.path(), std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(12);
+            file.write("\0\0\0\0", 4);
+        }
+        CHECK_FALSE(cache.load(hash, "lengths", 0));
+        for (const auto& entry : std::filesystem::directory_iterator(tmpDirectory / "cache")) {
+            std::ofstream(entry.path(), std::ios::trunc) << "garbage";
+        }
+        CHECK_FALSE(cache.load(hash, "lengths", sizeof(morphio::floatType)));
+        cache.getOrCompute<morphio::floatType>(morphology, "lengths", compute);
+        CHECK(computed == 3);
+
+        CHECK_THROWS_AS(cache.load(hash, "../lengths", 4), morphio::MorphioError);
+    }
+
+    SECTION("next to a source") {
+        std::filesystem::create_directories(tmpDirectory / "morphologies");
+        CHECK(sidecar::SidecarCache::nextTo((tmpDirectory / "morphologies").string()).directory() ==
+              (tmpDirectory / "morphologies" / ".morphio-cache").string());
+        CHECK(sidecar::SidecarCache::nextTo((tmpDirectory / "cells.h5").string()).directory() ==
+              (tmpDirectory / "cells.h5").string() + ".morphio-cache");
+    }
+
+    std::filesystem::remove_all(tmpDirectory);
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <morphio/dendritic_spine.h>
+#include <morphio/mut/section.h>
+#include <morphio/spines.h>
+
+namespace {
+void checkPoint(const morphio::Point& actual, const morphio::Point& expected) {
+    for (size_t k = 0; k < 3; ++k) {
+        CHECK_THAT(actual[k], Catch::WithinAbs(expected[k], 1e-5));
+    }
+}
+
+/** A straight spine along z, from (1, 1, 1) to (1, 1, 3) */
+morphio::Morphology straightSpine() {
+    return morphio::Morphology(
+        "1 3 1 1 1 0.2 -1\n"
+        "2 3 1 1 2 0.2 1\n"
+        "3 3 1 1 3 1.0 2\n",
+        "swc");
+}
+}  // anonymous namespace
+
+TEST_CASE("spines_place", "[spines]") {
+    using namespace morphio::spines;
+    const morphio::Morphology host("data/simple.swc");
+    const SpineLibrary library(std::vector<morphio::Morphology>{straightSpine()});
+    REQUIRE(library.size() == 1);
+    checkPoint(library.roots()[0], {1, 1, 1});
+    checkPoint(library.axes()[0], {0, 0, 1});
+
+    // section 0: from (0, 0, 0) to (0, 5, 0), radius 1; the reference direction is -z
+    const std::vector<SpineLocation> locations{{0, 0, 0.5, 0}, {0, 0, 0.5, morphio::PI / 2}};
+    const auto placed = place(host, library, locations);
+    REQUIRE(placed.size() == 2);
+    CHECK(placed[0].section == 0);
+    CHECK(placed[0].offset == Approx(0.5));
+
+    auto points = library.points(placed[0]);
+    REQUIRE(points.size() == 3);
+    checkPoint(points[0], {0, 2.5, -1});
+    checkPoint(points[2], {0, 2.5, -3});
+    points = library.points(placed[1]);
+    checkPoint(points[0], {-1, 2.5, 0});
+    checkPoint(points[2], {-3, 2.5, 0});
+
+    // rotations are orthonormal
+    for (const auto& spine : placed) {
+        const auto& r = spine.transform.rotation;
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                const morphio::floatType product = r[0][i] * r[0][j] + r[1][i] * r[1][j] +
+                                                   r[2][i] * r[2][j];
+                CHECK_THAT(product, Catch::WithinAbs(i == j ? 1 : 0, 1e-5));
+            }
+        }
+    }
+
+    const auto instance = library.instantiate(placed[1]);
+    const auto& section = instance.rootSections().front();
+    checkPoint(section->points().front(), {-1, 2.5, 0});
+    // the library is left untouched
+    checkPoint(library.spine(0).points()[0], {1, 1, 1});
+
+    // same placement whatever the number of threads
+    std::vector<SpineLocation> many;
+    for (uint32_t i = 0; i < 100; ++i) {
+        many.push_back({0, i % 6, static_cast<morphio::floatType>(i) / 100,
+                        static_cast<morphio::floatType>(i)});
+    }
+    const auto serial = place(host, library, many, 1);
+    const auto parallel = place(host, library, many, 4);
+    for (size_t i = 0; i < many.size(); ++i) {
+        CHECK(serial[i].transform.rotation == parallel[i].transform.rotation);
+        CHECK(serial[i].transform.translation == parallel[i].transform.translation);
+    }
+
+    CHECK_THROWS_AS(place(host, library, {{1, 0, 0.5, 0}}), morphio::RawDataError);
+    CHECK_THROWS_AS(place(host, library, {{0, 6, 0.5, 0}}), morphio::RawDataError);
+}
+
+TEST_CASE("spines_library_dendritic_spine", "[spines]") {
+    using namespace morphio::spines;
+    const SpineLibrary library(std::vector<morphio::DendriticSpine>{
+        morphio::DendriticSpine("data/h5/v1/simple-dendritric-spine.h5")});
+    // root: first point of the first root section; axis: toward the first post synaptic density
+    checkPoint(library.roots()[0], {0, 5, 0});
+    checkPoint(library.axes()[0], {0, 1, 0});
+}
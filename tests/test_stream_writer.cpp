@@ -0,0 +1,212 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include <highfive/H5File.hpp>
+
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+#include <morphio/mut/stream_writer.h>
+
+namespace {
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/** Write `morph` with the stream writer, in the order of the existing writers */
+void stream(const morphio::mut::Morphology& morph, const std::filesystem::path& path) {
+    morphio::mut::writer::StreamWriter writer(path.string(),
+                                              std::make_shared<morphio::WarningHandlerCollector>());
+    const auto& soma = morph.soma();
+    writer.beginSoma(soma->type(), soma->points(), soma->diameters());
+
+    std::unordered_map<uint32_t, int> streamIds;
+    for (auto it = morph.depth_begin(); it != morph.depth_end(); ++it) {
+        const auto& section = *it;
+        const int parent = section->isRoot() ? -1 : streamIds.at(section->parent()->id());
+        streamIds[section->id()] = static_cast<int>(writer.addSection(
+            section->type(), parent, section->points(), section->diameters()));
+    }
+    writer.finish();
+}
+
+}  // anonymous namespace
+
+TEST_CASE("StreamWriter", "[writers]") {
+    using morphio::mut::writer::StreamWriter;
+    const auto tmpDirectory = std::filesystem::temp_directory_path() / "test_stream_writer.cpp";
+    std::filesystem::create_directories(tmpDirectory);
+
+    SECTION("same output as the existing writers") {
+        for (const auto* name : {"simple", "complexe", "simple-heterogeneous-neurite"}) {
+            const auto morph =
+                morphio::mut::Morphology(std::string("data/") + name + ".swc",
+                                         morphio::NO_MODIFIER,
+                                         std::make_shared<morphio::WarningHandlerCollector>());
+            for (const auto* extension : {".swc", ".asc"}) {
+                const auto expected = tmpDirectory / (std::string("expected") + extension);
+                const auto actual = tmpDirectory / (std::string("actual") + extension);
+                try {
+                    morph.write(expected.string());
+                } catch (const morphio::WriterError&) {
+                    CHECK_THROWS_AS(stream(morph, actual), morphio::WriterError);
+                    continue;
+                }
+                stream(morph, actual);
+                CHECK(readFile(actual) == readFile(expected));
+            }
+        }
+    }
+
+    SECTION("soma only and empty morphologies") {
+        auto handler = std::make_shared<morphio::WarningHandlerCollector>();
+        {
+            StreamWriter writer((tmpDirectory / "empty.swc").string(), handler);
+            writer.finish();
+        }
+        CHECK(!std::filesystem::exists(tmpDirectory / "empty.swc"));
+        REQUIRE(handler->getAll().size() == 1);
+        CHECK(handler->getAll()[0].warning->warning() == morphio::Warning::WRITE_EMPTY_MORPHOLOGY);
+
+        StreamWriter writer((tmpDirectory / "soma.swc").string(), handler);
+        writer.beginSoma(morphio::SOMA_SINGLE_POINT, {{1, 2, 3}}, {4});
+        writer.finish();
+        CHECK(morphio::mut::Morphology((tmpDirectory / "soma.swc").string()).soma()->points() ==
+              morphio::Points{{1, 2, 3}});
+    }
+
+    SECTION("sections must be streamed in depth-first order") {
+        const morphio::Points points{{0, 0, 0}, {1, 1, 1}};
+        const std::vector<morphio::floatType> diameters{1, 1};
+
+        StreamWriter writer((tmpDirectory / "order.swc").string(),
+                            std::make_shared<morphio::WarningHandlerCollector>());
+        const auto root = static_cast<int>(
+            writer.addSection(morphio::SECTION_AXON, -1, points, diameters));
+        const auto child = static_cast<int>(
+            writer.addSection(morphio::SECTION_AXON, root, points, diameters));
+        writer.addSection(morphio::SECTION_AXON, child, points, diameters);
+        writer.addSection(morphio::SECTION_AXON, child, points, diameters);
+        writer.addSection(morphio::SECTION_AXON, root, points, diameters);
+
+        // `child` has been closed when its sibling was added
+        CHECK_THROWS_AS(writer.addSection(morphio::SECTION_AXON, child, points, diameters),
+                        morphio::WriterError);
+        CHECK_THROWS_AS(writer.addSection(morphio::SECTION_AXON, 42, points, diameters),
+                        morphio::WriterError);
+        CHECK_THROWS_AS(writer.beginSoma(morphio::SOMA_SINGLE_POINT, {{0, 0, 0}}, {1}),
+                        morphio::WriterError);
+        CHECK_THROWS_AS(writer.addSection(morphio::SECTION_AXON, -1, {{0, 0, 0}}, {1}),
+                        morphio::SectionBuilderError);
+        CHECK_THROWS_AS(writer.addSection(morphio::SECTION_AXON, root, points, {1}),
+                        morphio::WriterError);
+
+        writer.finish();
+        CHECK_THROWS_AS(writer.finish(), morphio::WriterError);
+
+        const morphio::mut::Morphology written((tmpDirectory / "order.swc").string());
+        CHECK(written.rootSections().size() == 1);
+        CHECK(written.rootSections()[0]->children().size() == 2);
+    }
+
+    SECTION("SWC rejects single children") {
+        const morphio::Points points{{0, 0, 0}, {1, 1, 1}};
+        const std::vector<morphio::floatType> diameters{1, 1};
+
+        {
+            StreamWriter writer((tmpDirectory / "single-child.swc").string(),
+                                std::make_shared<morphio::WarningHandlerCollector>());
+            const auto root = static_cast<int>(
+                writer.addSection(morphio::SECTION_AXON, -1, points, diameters));
+            writer.addSection(morphio::SECTION_AXON, root, points, diameters);
+            CHECK_THROWS_AS(writer.finish(), morphio::WriterError);
+        }
+        {
+            // the first child of the root has a single child, found when the second one comes
+            StreamWriter writer((tmpDirectory / "single-grandchild.swc").string(),
+                                std::make_shared<morphio::WarningHandlerCollector>());
+            const auto root = static_cast<int>(
+                writer.addSection(morphio::SECTION_AXON, -1, points, diameters));
+            const auto child = static_cast<int>(
+                writer.addSection(morphio::SECTION_AXON, root, points, diameters));
+            writer.addSection(morphio::SECTION_AXON, child, points, diameters);
+            CHECK_THROWS_AS(writer.addSection(morphio::SECTION_AXON, root, points, diameters),
+                            morphio::WriterError);
+        }
+
+        // the single children are not written, like with the existing writer
+        const morphio::Property::PointLevel pointLevel(points, diameters);
+        morphio::mut::Morphology singleChild(std::make_shared<morphio::WarningHandlerCollector>());
+        singleChild.appendRootSection(pointLevel, morphio::SECTION_AXON)
+            ->appendSection(pointLevel, morphio::SECTION_AXON);
+        CHECK_THROWS_AS(singleChild.write((tmpDirectory / "single-child-expected.swc").string()),
+                        morphio::WriterError);
+        CHECK(readFile(tmpDirectory / "single-child.swc") ==
+              readFile(tmpDirectory / "single-child-expected.swc"));
+
+        morphio::mut::Morphology singleGrandchild(
+            std::make_shared<morphio::WarningHandlerCollector>());
+        const auto root = singleGrandchild.appendRootSection(pointLevel, morphio::SECTION_AXON);
+        root->appendSection(pointLevel, morphio::SECTION_AXON)
+            ->appendSection(pointLevel, morphio::SECTION_AXON);
+        root->appendSection(pointLevel, morphio::SECTION_AXON);
+        CHECK_THROWS_AS(
+            singleGrandchild.write((tmpDirectory / "single-grandchild-expected.swc").string()),
+            morphio::WriterError);
+        CHECK(readFile(tmpDirectory / "single-grandchild.swc") ==
+              readFile(tmpDirectory / "single-grandchild-expected.swc"));
+    }
+
+    SECTION("H5 datasets are contiguous, like those of writer::h5") {
+        const morphio::mut::Morphology morph("data/simple.swc");
+        const auto expected = tmpDirectory / "expected.h5";
+        const auto actual = tmpDirectory / "actual.h5";
+        morph.write(expected.string());
+        stream(morph, actual);
+
+        const morphio::Morphology written(actual.string());
+        const morphio::Morphology reference(expected.string());
+        CHECK(written.points() == reference.points());
+        CHECK(written.diameters() == reference.diameters());
+        CHECK(written.sectionOffsets() == reference.sectionOffsets());
+
+        // the readers of containers locate the datasets by their offset in the file
+        const HighFive::File file(actual.string(), HighFive::File::ReadOnly);
+        for (const auto* name : {"points", "structure"}) {
+            const auto properties = file.getDataSet(name).getCreatePropertyList();
+            CHECK(H5Pget_layout(properties.getId()) == H5D_CONTIGUOUS);
+        }
+    }
+
+    SECTION("H5 perimeters are given for all sections or none") {
+        const morphio::Points points{{0, 0, 0}, {1, 1, 1}};
+        const std::vector<morphio::floatType> diameters{1, 1};
+
+        StreamWriter writer((tmpDirectory / "perimeters.h5").string(),
+                            std::make_shared<morphio::WarningHandlerCollector>());
+        const auto root = static_cast<int>(
+            writer.addSection(morphio::SECTION_AXON, -1, points, diameters));
+        CHECK_THROWS_WITH(writer.addSection(morphio::SECTION_AXON, root, points, diameters, {1, 1}),
+                          Catch::Contains("2 perimeters, expected 0"));
+    }
+
+    SECTION("unknown extension") {
+        CHECK_THROWS_AS(StreamWriter((tmpDirectory / "morph.abc").string()),
+                        morphio::UnknownFileType);
+        CHECK_THROWS_AS(StreamWriter((tmpDirectory / "morph").string()), morphio::UnknownFileType);
+    }
+
+    std::filesystem::remove_all(tmpDirectory);
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <morphio/morphology.h>
+#include <morphio/section.h>
+#include <morphio/subtree.h>
+
+TEST_CASE("subtree", "[subtree]") {
+    using morphio::PI;
+
+    SECTION("fork") {
+        // a root section of length 10 and two children of length 10, all of radius 1
+        const morphio::Morphology morphology(
+            "1 1 0 0 0 1 -1\n"
+            "2 3 0 0 0 1 1\n"
+            "3 3 0 10 0 1 2\n"
+            "4 3 10 10 0 1 3\n"
+            "5 3 -10 10 0 1 3\n",
+            "swc");
+        const auto result = morphio::subtree::aggregates(morphology);
+        REQUIRE(result.length.size() == 3);
+
+        CHECK(result.length[0] == Approx(30));
+        CHECK(result.area[0] == Approx(60 * PI));
+        CHECK(result.volume[0] == Approx(30 * PI));
+        CHECK(result.tips[0] == 2);
+        CHECK(result.bifurcations[0] == 1);
+        CHECK(result.maxPathLength[0] == Approx(20));
+
+        for (const size_t child : {size_t(1), size_t(2)}) {
+            CHECK(result.length[child] == Approx(10));
+            CHECK(result.area[child] == Approx(20 * PI));
+            CHECK(result.volume[child] == Approx(10 * PI));
+            CHECK(result.tips[child] == 1);
+            CHECK(result.bifurcations[child] == 0);
+            CHECK(result.maxPathLength[child] == Approx(10));
+        }
+    }
+
+    SECTION("same as iterating the subtrees") {
+        const morphio::Morphology morphology("data/nrn_ordering.swc");
+        const auto result = morphio::subtree::aggregates(morphology);
+
+        const auto sectionLength = [](const morphio::Section& section) {
+            const auto points = section.points();
+            morphio::floatType length = 0;
+            for (size_t i = 0; i + 1 < points.size(); ++i) {
+                const auto dx = points[i + 1][0] - points[i][0];
+                const auto dy = points[i + 1][1] - points[i][1];
+                const auto dz = points[i + 1][2] - points[i][2];
+                length += std::sqrt(dx * dx + dy * dy + dz * dz);
+            }
+            return length;
+        };
+
+        for (const auto& section : morphology.sections()) {
+            morphio::floatType length = 0;
+            uint32_t tips = 0;
+            uint32_t bifurcations = 0;
+            for (auto it = section.breadth_begin(); it != section.breadth_end(); ++it) {
+                const auto& descendant = *it;
+                length += sectionLength(descendant);
+                tips += descendant.children().empty() ? 1U : 0U;
+                bifurcations += descendant.children().size() >= 2 ? 1U : 0U;
+            }
+            CHECK(result.length[section.id()] == Approx(length));
+            CHECK(result.tips[section.id()] == tips);
+            CHECK(result.bifurcations[section.id()] == bifurcations);
+            CHECK(result.maxPathLength[section.id()] <=
+                  result.length[section.id()] * morphio::floatType(1.0001));
+
+            morphio::floatType longestChild = 0;
+            for (const auto& child : section.children()) {
+                longestChild = std::max(longestChild, result.maxPathLength[child.id()]);
+            }
+            CHECK(result.maxPathLength[section.id()] ==
+                  Approx(sectionLength(section) + longestChild));
+        }
+    }
+
+    SECTION("soma only") {
+        const morphio::Morphology morphology("1 1 0 0 0 1 -1\n", "swc");
+        const auto result = morphio::subtree::aggregates(morphology);
+        CHECK(result.length.empty());
+        CHECK(result.tips.empty());
+    }
+}
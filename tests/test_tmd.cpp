@@ -0,0 +1,74 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include <morphio/collection.h>
+#include <morphio/morphology.h>
+#include <morphio/tmd.h>
+
+namespace {
+void checkBarcode(const morphio::tmd::Barcode& actual, const morphio::tmd::Barcode& expected) {
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        CHECK_THAT(actual[i][0], Catch::WithinAbs(expected[i][0], 1e-5));
+        CHECK_THAT(actual[i][1], Catch::WithinAbs(expected[i][1], 1e-5));
+    }
+}
+}  // anonymous namespace
+
+TEST_CASE("persistenceBarcode", "[tmd]") {
+    using morphio::tmd::persistenceBarcode;
+    const auto m = morphio::Morphology("data/simple.swc");
+
+    const morphio::floatType dendriteLeft = std::sqrt(50.f);
+    const morphio::floatType dendriteRight = std::sqrt(61.f);
+    const morphio::floatType axonLeft = std::sqrt(41.f);
+    const morphio::floatType axonRight = std::sqrt(52.f);
+
+    SECTION("radial distance") {
+        checkBarcode(persistenceBarcode(m, morphio::SECTION_DENDRITE),
+                     {{dendriteLeft, 5}, {dendriteRight, 0}});
+        checkBarcode(persistenceBarcode(m, morphio::SECTION_AXON),
+                     {{axonLeft, 4}, {axonRight, 0}});
+        checkBarcode(persistenceBarcode(m),
+                     {{dendriteLeft, 5}, {dendriteRight, 0}, {axonLeft, 4}, {axonRight, 0}});
+        CHECK(persistenceBarcode(m, morphio::SECTION_APICAL_DENDRITE).empty());
+    }
+
+    SECTION("path distance") {
+        checkBarcode(
+            persistenceBarcode(m, morphio::SECTION_DENDRITE, morphio::tmd::PATH_DISTANCE),
+            {{10, 5}, {11, 0}});
+        checkBarcode(persistenceBarcode(m, morphio::SECTION_AXON, morphio::tmd::PATH_DISTANCE),
+                     {{9, 4}, {10, 0}});
+    }
+}
+
+TEST_CASE("persistenceBarcodes", "[tmd]") {
+    const auto collection = morphio::Collection("data", {".swc"});
+    const std::vector<std::string> names{"simple", "simple-all-types", "complexe"};
+
+    const auto barcodes = morphio::tmd::persistenceBarcodes(
+        collection, names, morphio::SECTION_ALL, morphio::tmd::RADIAL_DISTANCE, 0, 2);
+
+    REQUIRE(barcodes.size() == names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        const auto expected = morphio::tmd::persistenceBarcode(
+            morphio::Morphology("data/" + names[i] + ".swc"));
+        checkBarcode(barcodes[i], expected);
+    }
+
+    std::vector<morphio::Morphology> morphologies;
+    for (const auto& name : names) {
+        morphologies.emplace_back("data/" + name + ".swc");
+    }
+    const auto fromMorphologies = morphio::tmd::persistenceBarcodes(morphologies);
+    REQUIRE(fromMorphologies.size() == names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        checkBarcode(fromMorphologies[i], barcodes[i]);
+    }
+}
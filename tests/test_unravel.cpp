@@ -0,0 +1,110 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include <morphio/morphology.h>
+#include <morphio/section.h>
+#include <morphio/soma.h>
+#include <morphio/unravel.h>
+
+namespace {
+morphio::floatType distance(const morphio::Point& a, const morphio::Point& b) {
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) +
+                     (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+/** An axon zigzagging along x, with a child zigzagging along y */
+morphio::Morphology zigzag() {
+    std::string swc = "1 1 0 0 0 1 -1\n";
+    for (int i = 0; i < 9; ++i) {
+        swc += std::to_string(i + 2) + " 2 " + std::to_string(i) + " " +
+               std::to_string(i % 2) + " 0 0.5 " + std::to_string(i + 1) + "\n";
+    }
+    // forks at the end of the axon
+    for (int i = 1; i < 6; ++i) {
+        swc += std::to_string(i + 10) + " 2 " + std::to_string(8 + i % 2) + " " +
+               std::to_string(i) + " 0 0.5 " + std::to_string(i == 1 ? 10 : i + 9) + "\n";
+    }
+    swc += "16 2 8 -1 0 0.5 10\n";
+    return morphio::Morphology(swc, "swc");
+}
+}  // namespace
+
+TEST_CASE("unravel", "[unravel]") {
+    using morphio::unravel::Unravelled;
+    const auto original = zigzag();
+    const Unravelled result(original, 2, 3);
+    const auto& unravelled = result.morphology();
+
+    SECTION("topology and segment lengths are kept") {
+        REQUIRE(unravelled.points().size() == original.points().size());
+        CHECK(unravelled.sectionOffsets() == original.sectionOffsets());
+        CHECK(unravelled.diameters() == original.diameters());
+        CHECK(unravelled.soma().points() == original.soma().points());
+
+        const auto sections = original.sections();
+        const auto unravelledSections = unravelled.sections();
+        for (size_t s = 0; s < sections.size(); ++s) {
+            const auto points = sections[s].points();
+            const auto newPoints = unravelledSections[s].points();
+            for (size_t i = 0; i + 1 < points.size(); ++i) {
+                CHECK(distance(newPoints[i], newPoints[i + 1]) ==
+                      Approx(distance(points[i], points[i + 1])).epsilon(1e-5));
+            }
+            if (!sections[s].isRoot()) {
+                const auto parent = unravelledSections[s].parent().points();
+                CHECK(distance(newPoints[0], parent[parent.size() - 1]) ==
+                      Approx(0).margin(1e-5));
+            }
+        }
+        CHECK(unravelled.points()[0] == original.points()[0]);
+    }
+
+    SECTION("the zigzag is straightened") {
+        const auto axon = unravelled.section(0).points();
+        for (const auto& point : axon) {
+            CHECK(std::abs(point[1] - axon[0][1]) < morphio::floatType(0.6));
+        }
+        // the path is stretched along x
+        CHECK(axon[axon.size() - 1][0] > original.section(0).points()[8][0]);
+    }
+
+    SECTION("the whole section as a window") {
+        const auto straight = morphio::unravel::unravel(original, 20);
+        const auto axon = straight.section(0).points();
+        for (size_t i = 1; i < axon.size(); ++i) {
+            CHECK(axon[i][0] - axon[i - 1][0] == Approx(std::sqrt(2.0)).epsilon(1e-4));
+            CHECK(axon[i][1] == Approx(axon[0][1]).margin(0.05));
+        }
+    }
+
+    SECTION("map") {
+        const auto& points = original.points();
+        const auto& newPoints = unravelled.points();
+        CHECK(distance(result.map(points[3], 0), newPoints[3]) == Approx(0).margin(1e-5));
+
+        // the middle of a segment, and a position off the segment at the same distance
+        morphio::Point middle;
+        for (size_t k = 0; k < 3; ++k) {
+            middle[k] = (points[2][k] + points[3][k]) / 2;
+        }
+        const auto mapped = result.map(middle, 0);
+        CHECK(distance(mapped, newPoints[2]) == Approx(distance(mapped, newPoints[3])));
+        const auto off = result.map({middle[0], middle[1], 1}, 0);
+        CHECK(distance(off, mapped) == Approx(1).epsilon(1e-5));
+
+        const auto batch = result.map({points[3], middle}, {0, 0}, 2);
+        CHECK(batch[1] == mapped);
+
+        CHECK_THROWS_AS(result.map(middle, 100), morphio::RawDataError);
+        CHECK_THROWS_AS(result.map(middle, std::numeric_limits<uint32_t>::max()),
+                        morphio::RawDataError);
+        CHECK_THROWS_AS(result.map({middle}, {0, 0}), morphio::RawDataError);
+    }
+}
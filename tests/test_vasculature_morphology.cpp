@@ -30,14 +30,14 @@ TEST_CASE("vasculature_section_offsets", "[vasculature]") {
     const auto& sections = morph.sections();
     size_t n_offsets = sections.size() + 1;
 
-    std::vector<uint32_t> expected_section_offsets;
+    std::vector<uint64_t> expected_section_offsets;
     expected_section_offsets.reserve(n_offsets);
 
-    uint32_t offset = 0;
+    uint64_t offset = 0;
     expected_section_offsets.push_back(offset);
 
     for (const auto& section : sections) {
-        offset += static_cast<uint32_t>(section.points().size());
+        offset += section.points().size();
         expected_section_offsets.push_back(offset);
     }
 
@@ -0,0 +1,189 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <random>
+
+#include <morphio/exceptions.h>
+#include <morphio/morphology.h>
+#include <morphio/vasc/proximity.h>
+#include <morphio/vasc/vasculature.h>
+
+using morphio::vasculature::ProximityIndex;
+using morphio::vasculature::SegmentHit;
+
+namespace {
+/** Two straight vessels along x: y = 0 (diameter 2) and y = 10 (diameter 4) */
+ProximityIndex twoVessels() {
+    return ProximityIndex({{0, 0, 0}, {5, 0, 0}, {10, 0, 0}, {0, 10, 0}, {10, 10, 0}},
+                          {2, 2, 2, 4, 4},
+                          {0, 3, 5});
+}
+}  // anonymous namespace
+
+TEST_CASE("vasculature_proximity_points", "[vasculature]") {
+    const auto index = twoVessels();
+    CHECK(index.size() == 3);
+
+    const auto nearest = index.nearest(
+        morphio::Points{{7, 3, 0}, {2, 7, 0}, {-3, 4, 0}, {5, 0, 0}});
+    REQUIRE(nearest.size() == 4);
+    CHECK(nearest[0][0].section == 0);
+    CHECK(nearest[0][0].segment == 1);
+    CHECK_THAT(nearest[0][0].distance, Catch::WithinAbs(2, 1e-5));
+    CHECK(nearest[1][0].section == 1);
+    CHECK(nearest[1][0].segment == 0);
+    CHECK_THAT(nearest[1][0].distance, Catch::WithinAbs(1, 1e-5));
+    CHECK(nearest[2][0].section == 0);
+    CHECK(nearest[2][0].segment == 0);
+    CHECK_THAT(nearest[2][0].distance, Catch::WithinAbs(4, 1e-5));
+    // inside the vessel
+    CHECK(nearest[3][0].distance == 0);
+
+    const auto within = index.within(morphio::Points{{5, 4, 0}}, 5);
+    REQUIRE(within[0].size() == 3);
+    CHECK(within[0][0].section == 0);
+    CHECK_THAT(within[0][0].distance, Catch::WithinAbs(3, 1e-5));
+    CHECK(within[0][2].section == 1);
+    CHECK_THAT(within[0][2].distance, Catch::WithinAbs(4, 1e-5));
+    CHECK(index.within(morphio::Points{{5, 4, 0}}, 2.5)[0].empty());
+
+    const ProximityIndex empty({}, {}, {});
+    CHECK(empty.nearest(morphio::Points{{0, 0, 0}})[0].empty());
+    CHECK_THROWS_AS(ProximityIndex({{0, 0, 0}}, {}, {0, 1}), morphio::MorphioError);
+    CHECK_THROWS_AS(ProximityIndex({{0, 0, 0}}, {1}, {0, 2}), morphio::MorphioError);
+}
+
+TEST_CASE("vasculature_proximity_single_point", "[vasculature]") {
+    const auto index = twoVessels();
+
+    const auto nearest = index.nearest(morphio::Point{7, 3, 0}, 2);
+    REQUIRE(nearest.size() == 2);
+    CHECK(nearest[0].section == 0);
+    CHECK(nearest[0].segment == 1);
+    CHECK(nearest[1].section == 0);
+    CHECK(nearest[1].segment == 0);
+    CHECK_THAT(nearest[1].distance, Catch::WithinAbs(std::sqrt(13) - 1, 1e-5));
+    const auto all = index.nearest(morphio::Point{7, 3, 0}, 5);
+    REQUIRE(all.size() == 3);
+    CHECK(all[2].section == 1);
+    CHECK_THAT(all[2].distance, Catch::WithinAbs(5, 1e-5));
+    CHECK(index.nearest(morphio::Point{7, 3, 0}, 5, 4).size() == 2);
+    CHECK(index.nearest(morphio::Point{7, 3, 0}, 0).empty());
+
+    const auto within = index.within(morphio::Point{5, 4, 0}, 5);
+    REQUIRE(within.size() == 3);
+    CHECK_THAT(within[0].distance, Catch::WithinAbs(3, 1e-5));
+
+    // only the axes count: the box touches the surface of the first vessel, not its axis
+    const auto inBox = index.inBox({4, -1, -1}, {6, 10, 1});
+    REQUIRE(inBox.size() == 3);
+    CHECK(inBox[0].section == 0);
+    CHECK(inBox[0].segment == 0);
+    CHECK(inBox[2].section == 1);
+    CHECK(index.inBox({4, 0.5, -1}, {6, 9, 1}).empty());
+}
+
+TEST_CASE("vasculature_proximity_brute_force", "[vasculature]") {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<morphio::floatType> coordinate(-50, 50);
+    std::uniform_real_distribution<morphio::floatType> diameter(0.5, 4);
+
+    morphio::Points points;
+    std::vector<morphio::floatType> diameters;
+    std::vector<uint64_t> offsets;
+    for (size_t section = 0; section < 60; ++section) {
+        offsets.push_back(points.size());
+        morphio::Point point{coordinate(generator), coordinate(generator), coordinate(generator)};
+        for (size_t i = 0; i < 1 + section % 7; ++i) {
+            points.push_back(point);
+            diameters.push_back(diameter(generator));
+            for (auto& value : point) {
+                value += coordinate(generator) / 10;
+            }
+        }
+    }
+    offsets.push_back(points.size());
+    const ProximityIndex index(points, diameters, offsets);
+
+    morphio::Points queries;
+    for (size_t i = 0; i < 200; ++i) {
+        queries.push_back({coordinate(generator), coordinate(generator), coordinate(generator)});
+    }
+    // every segment is within 1000 of every query: the brute force result
+    const auto all = index.within(queries, 1000, 1);
+    const auto nearest = index.nearest(queries, 4);
+    const auto within = index.within(queries, 8, 4);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        REQUIRE(all[i].size() == index.size());
+        CHECK(nearest[i][0].section == all[i][0].section);
+        CHECK(nearest[i][0].segment == all[i][0].segment);
+        CHECK(nearest[i][0].distance == all[i][0].distance);
+        size_t count = 0;
+        while (count < all[i].size() && all[i][count].distance <= 8) {
+            ++count;
+        }
+        CHECK(within[i].size() == count);
+    }
+}
+
+TEST_CASE("vasculature_proximity_morphology", "[vasculature]") {
+    const auto index = twoVessels();
+    const morphio::Morphology morphology("data/simple.swc");
+
+    const auto hits = index.nearest(morphology);
+    // simple.swc: 6 sections of 2 points
+    CHECK(hits.sections == std::vector<uint32_t>{0, 1, 2, 3, 4, 5});
+    CHECK(hits.segments == std::vector<uint32_t>(6, 0));
+    REQUIRE(hits.hits.size() == 6);
+    REQUIRE(hits.soma.size() == 1);
+    // the soma (radius 1 at the origin) overlaps the first vessel
+    CHECK(hits.soma[0].section == 0);
+    CHECK(hits.soma[0].distance == 0);
+
+    // moved 20 down along y, the soma is 19 from the first vessel's axis
+    morphio::Transform transform;
+    transform.translation = {0, -20, 0};
+    const auto moved = index.nearest(morphology, transform, 2);
+    CHECK_THAT(moved.soma[0].distance, Catch::WithinAbs(18, 1e-5));
+
+    // rotated by 180 degrees around z
+    transform.rotation = {{{-1, 0, 0}, {0, -1, 0}, {0, 0, 1}}};
+    transform.translation = {0, 0, 0};
+    const auto rotated = index.within(morphology, 1000, transform);
+    CHECK(rotated.hits.size() == 6);
+    for (const auto& segmentHits : rotated.hits) {
+        CHECK(segmentHits.size() == index.size());
+    }
+    CHECK(index.within(morphology, 0, transform).soma.size() == 1);
+}
+
+TEST_CASE("vasculature_proximity_file", "[vasculature]") {
+    const morphio::vasculature::Vasculature vasculature("data/h5/vasculature1.h5");
+    const ProximityIndex index(vasculature);
+
+    size_t nSegments = 0;
+    const auto offsets = vasculature.sectionOffsets();
+    for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+        nSegments += offsets[i + 1] > offsets[i] ? offsets[i + 1] - offsets[i] - 1 : 0;
+    }
+    CHECK(index.size() == nSegments);
+
+    // every point of a section with segments is on a vessel
+    const auto& points = vasculature.points();
+    for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+        if (offsets[i + 1] - offsets[i] < 2) {
+            continue;
+        }
+        const morphio::Points sectionPoints(
+            points.begin() + static_cast<std::ptrdiff_t>(offsets[i]),
+            points.begin() + static_cast<std::ptrdiff_t>(offsets[i + 1]));
+        for (const auto& hit : index.nearest(sectionPoints, 1)) {
+            REQUIRE(hit.size() == 1);
+            CHECK(hit[0].distance == 0);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <memory>
+
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+#include <morphio/mut/write_queue.h>
+
+TEST_CASE("WriteQueue", "[writers]") {
+    using morphio::mut::WriteQueue;
+    const auto tmpDirectory = std::filesystem::temp_directory_path() / "test_write_queue.cpp";
+    std::filesystem::remove_all(tmpDirectory);
+    std::filesystem::create_directories(tmpDirectory);
+
+    const morphio::Morphology source("data/complexe.swc");
+    // the ASC writer warns about the soma
+    const auto collector = std::make_shared<morphio::WarningHandlerCollector>();
+    const auto path = [&](size_t i, const char* extension) {
+        return (tmpDirectory / (std::to_string(i) + extension)).string();
+    };
+
+    SECTION("writes everything on flush") {
+        WriteQueue queue(3, 4);
+        for (size_t i = 0; i < 20; ++i) {
+            queue.push(std::make_unique<morphio::mut::Morphology>(source), path(i, ".swc"));
+            CHECK(queue.pending() <= 4);
+        }
+        queue.flush();
+        CHECK(queue.pending() == 0);
+        for (size_t i = 0; i < 20; ++i) {
+            const morphio::Morphology written(path(i, ".swc"));
+            CHECK(written.points() == source.points());
+            CHECK(written.diameters() == source.diameters());
+        }
+    }
+
+    SECTION("reports the errors on flush") {
+        WriteQueue queue(2);
+        queue.push(std::make_unique<morphio::mut::Morphology>(source), path(0, ".swc"));
+        queue.push(std::make_unique<morphio::mut::Morphology>(source), path(1, ".unknown"));
+        auto invalid = std::make_unique<morphio::mut::Morphology>();
+        invalid->appendRootSection(morphio::Property::PointLevel({{0, 0, 0}}, {1}),
+                                   morphio::SECTION_AXON);
+        queue.push(std::move(invalid), path(2, ".swc"));
+        queue.push(
+            std::make_unique<morphio::mut::Morphology>(source, morphio::NO_MODIFIER, collector),
+            path(3, ".asc"));
+        try {
+            queue.flush();
+            FAIL("flush should throw");
+        } catch (const morphio::WriterError& e) {
+            const std::string message = e.what();
+            CHECK(message.find("2 morphologies could not be written") != std::string::npos);
+            CHECK(message.find("1.unknown") != std::string::npos);
+            CHECK(message.find("2.swc: Root sections must have at least 2 points") !=
+                  std::string::npos);
+        }
+        // the other writes went through, and the errors were reported once
+        CHECK(std::filesystem::exists(path(0, ".swc")));
+        CHECK(std::filesystem::exists(path(3, ".asc")));
+        CHECK_NOTHROW(queue.flush());
+
+        CHECK_THROWS_AS(queue.push(nullptr, path(4, ".swc")), morphio::WriterError);
+    }
+
+    SECTION("destruction waits for the writes") {
+        {
+            WriteQueue queue(1, 2);
+            for (size_t i = 0; i < 5; ++i) {
+                queue.push(std::make_unique<morphio::mut::Morphology>(
+                               source, morphio::NO_MODIFIER, collector),
+                           path(i, ".asc"));
+            }
+        }
+        for (size_t i = 0; i < 5; ++i) {
+            CHECK(std::filesystem::exists(path(i, ".asc")));
+        }
+    }
+
+    std::filesystem::remove_all(tmpDirectory);
+}